@@ -0,0 +1,294 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     ammclib_bench.c
+*
+* @date     March-28-2017
+*
+* @brief    Micro-benchmark of the host AMMCLIB subset
+*
+* Every function runs over the same pseudo-random input table. The printed
+* time per call is the mean of the best of several repetitions, the checksum
+* hashes the bit patterns of all outputs of one repetition. Equal checksums on
+* two builds mean bit-identical results, a faster kernel has to keep them.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "amclib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define BENCH_SAMPLES		1024U		// input table length
+#define BENCH_PASSES		2000U		// passes over the table per repetition
+#define BENCH_REPEAT		5U			// repetitions, the fastest one is reported
+
+/*! Runs BODY over the input table, sample index k, and reports it under NAME */
+#define BENCH_RUN(NAME, INIT, BODY)										\
+	do																	\
+	{																	\
+		double		bestNs = 1.0e30, ns;								\
+		uint32_t	rep, pass, k;										\
+																		\
+		for (rep = 0U; rep < BENCH_REPEAT; rep++)						\
+		{																\
+			INIT;														\
+			benchSum = 2166136261U;										\
+			ns = BENCH_Now();											\
+			for (pass = 0U; pass < BENCH_PASSES; pass++)				\
+			{															\
+				for (k = 0U; k < BENCH_SAMPLES; k++)					\
+				{														\
+					BODY;												\
+				}														\
+			}															\
+			ns = BENCH_Now() - ns;										\
+			bestNs = (ns < bestNs) ? ns : bestNs;						\
+		}																\
+		BENCH_Report(NAME, bestNs);										\
+	} while (0)
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static tFloat				inA[BENCH_SAMPLES];		// <-1;1)
+static tFloat				inB[BENCH_SAMPLES];		// <-1;1)
+static tFloat				inAngle[BENCH_SAMPLES];	// <-pi;pi)
+static tFrac32				inF32[BENCH_SAMPLES];
+
+static uint32_t				benchSum;
+
+static SWLIBS_2Syst_FLT		out2;
+static SWLIBS_3Syst_FLT		out3;
+static tFloat				outF;
+static tFloat				outF2;
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Monotonic time in nanoseconds
+******************************************************************************/
+static double BENCH_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+}
+
+/**************************************************************************//*!
+@brief			Folds a 32-bit word into the checksum (FNV-1a step)
+******************************************************************************/
+static inline void BENCH_FoldU32(uint32_t u32X)
+{
+	benchSum = (benchSum ^ u32X) * 16777619U;
+}
+
+/**************************************************************************//*!
+@brief			Folds the bit pattern of a floating point result into the checksum
+******************************************************************************/
+static inline void BENCH_Fold(tFloat fltX)
+{
+	uint32_t u32X;
+
+	memcpy(&u32X, &fltX, sizeof(u32X));
+	BENCH_FoldU32(u32X);
+}
+
+/**************************************************************************//*!
+@brief			Prints one result line, the checksum of the last repetition
+******************************************************************************/
+static void BENCH_Report(const char *name, double ns)
+{
+	printf("%-28s %8.2f ns  %08x\n", name,
+		   ns / ((double)BENCH_PASSES * (double)BENCH_SAMPLES), (unsigned int)benchSum);
+}
+
+/**************************************************************************//*!
+@brief			Fills the input tables from a fixed-seed generator
+******************************************************************************/
+static void BENCH_Inputs(void)
+{
+	uint32_t	seed = 0x12345678U;
+	uint32_t	k;
+
+	for (k = 0U; k < BENCH_SAMPLES; k++)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		inA[k] = (tFloat)((int32_t)seed) * (1.0F / 2147483648.0F);
+		seed = seed * 1664525U + 1013904223U;
+		inB[k] = (tFloat)((int32_t)seed) * (1.0F / 2147483648.0F);
+		inAngle[k] = inA[k] * FLOAT_PI;
+		inF32[k] = (tFrac32)(seed >> 4);
+	}
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Runs all benchmarks
+******************************************************************************/
+int main(void)
+{
+	SWLIBS_2Syst_FLT				in2, sinCos, iDQFbck, iDQReq;
+	SWLIBS_3Syst_FLT				in3;
+	GFLIB_VECTORLIMIT_T_FLT			vectorLimit = {0.9F};
+	GMCLIB_ELIMDCBUSRIP_T_FLT		elimDcbRip = {0.866025403784439F, 0.0F};
+	GDFLIB_FILTER_MA_T_FLT			filterMA;
+	GFLIB_INTEGRATOR_TR_T_F32		integF32;
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	piR;
+	GFLIB_CONTROLLER_PIAW_P_T_FLT	piP;
+	AMCLIB_CURRENT_LOOP_T_FLT		currentLoop;
+	AMCLIB_FW_SPEED_LOOP_T_FLT		fwSpeedLoop;
+	AMCLIB_BEMF_OBSRV_DQ_T_FLT		bemfObsrv;
+	AMCLIB_TRACK_OBSRV_T_FLT		trackObsrv;
+	tFloat							fltUQReq = 0.0F, fltIQFbck = 0.0F;
+
+	BENCH_Inputs();
+
+	printf("%-28s %11s  %s\n", "function", "time/call", "checksum");
+
+	/* GMCLIB */
+	BENCH_RUN("GMCLIB_Clark_FLT", (void)0,
+		in3.fltArg1 = inA[k]; in3.fltArg2 = inB[k]; in3.fltArg3 = -inA[k] - inB[k];
+		GMCLIB_Clark_FLT(&out2, &in3);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	GFLIB_SinCos_FLT(0.7F, &sinCos, GFLIB_SINCOS_DEFAULT_FLT);
+
+	BENCH_RUN("GMCLIB_Park_FLT", (void)0,
+		in2.fltArg1 = inA[k]; in2.fltArg2 = inB[k];
+		GMCLIB_Park_FLT(&out2, &sinCos, &in2);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	BENCH_RUN("GMCLIB_ParkInv_FLT", (void)0,
+		in2.fltArg1 = inA[k]; in2.fltArg2 = inB[k];
+		GMCLIB_ParkInv_FLT(&out2, &sinCos, &in2);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	BENCH_RUN("GMCLIB_ElimDcBusRip_FLT", (void)0,
+		in2.fltArg1 = 6.0F * inA[k]; in2.fltArg2 = 6.0F * inB[k];
+		elimDcbRip.fltArgDcBusMsr = 12.0F + inA[k];
+		GMCLIB_ElimDcBusRip_FLT(&out2, &in2, &elimDcbRip);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	BENCH_RUN("GMCLIB_SvmStd_FLT", (void)0,
+		in2.fltArg1 = 0.9F * inA[k]; in2.fltArg2 = 0.9F * inB[k];
+		BENCH_FoldU32(GMCLIB_SvmStd_FLT(&out3, &in2));
+		BENCH_Fold(out3.fltArg1); BENCH_Fold(out3.fltArg2); BENCH_Fold(out3.fltArg3));
+
+	/* GFLIB */
+	BENCH_RUN("GFLIB_SinCos_FLT", (void)0,
+		GFLIB_SinCos_FLT(inAngle[k], &out2, GFLIB_SINCOS_DEFAULT_FLT);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	BENCH_RUN("GFLIB_AtanYX_FLT", (void)0,
+		BENCH_Fold(GFLIB_AtanYX_FLT(inA[k], inB[k])));
+
+	BENCH_RUN("GFLIB_Sqrt_FLT", (void)0,
+		BENCH_Fold(GFLIB_Sqrt_FLT(inA[k] + 1.0F)));
+
+	BENCH_RUN("GFLIB_VectorLimit_FLT", (void)0,
+		in2.fltArg1 = inA[k]; in2.fltArg2 = inB[k];
+		BENCH_FoldU32(GFLIB_VectorLimit_FLT(&out2, &in2, &vectorLimit));
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	BENCH_RUN("GFLIB_IntegratorTR_F32",
+		(integF32.f32State = 0, integF32.f32InK1 = 0, integF32.f32C1 = 0x00C00000, integF32.u16NShift = 2U),
+		BENCH_FoldU32((uint32_t)GFLIB_IntegratorTR_F32(inF32[k], &integF32)));
+
+	BENCH_RUN("GFLIB_ControllerPIrAW_FLT",
+		(piR.fltCC1sc = 0.17184F, piR.fltCC2sc = -0.12188F, piR.fltAcc = 0.0F, piR.fltInErrK1 = 0.0F,
+		 piR.fltUpperLimit = 1.0F, piR.fltLowerLimit = -1.0F),
+		BENCH_Fold(GFLIB_ControllerPIrAW_FLT(inA[k], &piR)));
+
+	BENCH_RUN("GFLIB_ControllerPIpAW_FLT",
+		(piP.fltPropGain = 0.05F, piP.fltIntegGain = 0.002F, piP.fltIntegPartK_1 = 0.0F, piP.fltInK_1 = 0.0F,
+		 piP.fltUpperLimit = 4.0F, piP.fltLowerLimit = -4.0F, piP.u16LimitFlag = 0U),
+		BENCH_Fold(GFLIB_ControllerPIpAW_FLT(100.0F * inA[k], &piP)));
+
+	/* GDFLIB */
+	BENCH_RUN("GDFLIB_FilterMA_FLT",
+		(filterMA.fltLambda = 1.0F / 8.0F, GDFLIB_FilterMAInit_FLT(&filterMA)),
+		BENCH_Fold(GDFLIB_FilterMA_FLT(inA[k], &filterMA)));
+
+	/* AMCLIB */
+	currentLoop.pPIrAWD.fltCC1sc		= 0.17184F;
+	currentLoop.pPIrAWD.fltCC2sc		= -0.12188F;
+	currentLoop.pPIrAWD.fltUpperLimit	= 0.9F;
+	currentLoop.pPIrAWD.fltLowerLimit	= -0.9F;
+	currentLoop.pPIrAWQ					= currentLoop.pPIrAWD;
+	currentLoop.pIDQReq					= &iDQReq;
+	currentLoop.pIDQFbck				= &iDQFbck;
+
+	BENCH_RUN("AMCLIB_CurrentLoop_FLT", AMCLIB_CurrentLoopInit_FLT(&currentLoop),
+		iDQReq.fltArg1 = 0.0F; iDQReq.fltArg2 = 2.0F * inA[k];
+		iDQFbck.fltArg1 = 0.1F * inB[k]; iDQFbck.fltArg2 = 2.0F * inB[k];
+		AMCLIB_CurrentLoop_FLT(12.0F, &out2, &currentLoop);
+		BENCH_Fold(out2.fltArg1); BENCH_Fold(out2.fltArg2));
+
+	fwSpeedLoop.pFilterW.fltLambda			= 1.0F / 4.0F;
+	fwSpeedLoop.pFilterFW.fltLambda			= 1.0F / 8.0F;
+	fwSpeedLoop.pPIpAWQ.fltPropGain			= 0.05F;
+	fwSpeedLoop.pPIpAWQ.fltIntegGain		= 0.002F;
+	fwSpeedLoop.pPIpAWQ.fltUpperLimit		= 4.0F;
+	fwSpeedLoop.pPIpAWQ.fltLowerLimit		= -4.0F;
+	fwSpeedLoop.pPIpAWFW.fltPropGain		= 0.1F;
+	fwSpeedLoop.pPIpAWFW.fltIntegGain		= 0.01F;
+	fwSpeedLoop.pPIpAWFW.fltUpperLimit		= 0.0F;
+	fwSpeedLoop.pPIpAWFW.fltLowerLimit		= -FLOAT_PI_DIVBY_2;
+	fwSpeedLoop.pRamp.fltRampUp				= 1.0F;
+	fwSpeedLoop.pRamp.fltRampDown			= 1.0F;
+	fwSpeedLoop.pIQFbck						= &fltIQFbck;
+	fwSpeedLoop.pUQReq						= &fltUQReq;
+	fwSpeedLoop.pUQLim						= &currentLoop.pPIrAWQ.fltUpperLimit;
+	fwSpeedLoop.fltUmaxDivImax				= 1.0F;
+	currentLoop.pPIrAWQ.fltUpperLimit		= 6.0F;
+
+	BENCH_RUN("AMCLIB_FWSpeedLoop_FLT",
+		(AMCLIB_FWSpeedLoopInit_FLT(&fwSpeedLoop), iDQReq.fltArg1 = 0.0F, iDQReq.fltArg2 = 0.0F),
+		fltIQFbck = 2.0F * inB[k]; fltUQReq = 6.0F * inA[k];
+		AMCLIB_FWSpeedLoop_FLT(300.0F, 300.0F + 20.0F * inA[k], &iDQReq, &fwSpeedLoop);
+		BENCH_Fold(iDQReq.fltArg1); BENCH_Fold(iDQReq.fltArg2));
+
+	bemfObsrv.pParamD.fltCC1sc		= 0.17184F;
+	bemfObsrv.pParamD.fltCC2sc		= -0.12188F;
+	bemfObsrv.pParamD.fltUpperLimit	= FLOAT_MAX;
+	bemfObsrv.pParamD.fltLowerLimit	= FLOAT_MIN;
+	bemfObsrv.pParamQ				= bemfObsrv.pParamD;
+	bemfObsrv.fltIGain				= 0.79856F;
+	bemfObsrv.fltUGain				= 0.17986F;
+	bemfObsrv.fltWIGain				= 7.8237e-5F;
+	bemfObsrv.fltEGain				= 0.17986F;
+
+	BENCH_RUN("AMCLIB_BemfObsrvDQ_FLT", AMCLIB_BemfObsrvDQInit_FLT(&bemfObsrv),
+		in2.fltArg1 = inA[k]; in2.fltArg2 = inB[k];
+		out2.fltArg1 = 4.0F * inB[k]; out2.fltArg2 = 4.0F * inA[k];
+		BENCH_Fold(AMCLIB_BemfObsrvDQ_FLT(&in2, &out2, 300.0F, inAngle[k], &bemfObsrv)));
+
+	trackObsrv.pParamPI.fltCC1sc		= 316.01F;
+	trackObsrv.pParamPI.fltCC2sc		= -312.31F;
+	trackObsrv.pParamPI.fltUpperLimit	= FLOAT_MAX;
+	trackObsrv.pParamPI.fltLowerLimit	= FLOAT_MIN;
+	trackObsrv.pParamInteg.fltC1		= 0.000075F;
+
+	BENCH_RUN("AMCLIB_TrackObsrv_FLT", AMCLIB_TrackObsrvInit_FLT(&trackObsrv),
+		AMCLIB_TrackObsrv_FLT(0.01F * inA[k], &outF, &outF2, &trackObsrv);
+		BENCH_Fold(outF); BENCH_Fold(outF2));
+
+	return (EXIT_SUCCESS);
+}
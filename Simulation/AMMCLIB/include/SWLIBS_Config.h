@@ -0,0 +1,34 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     SWLIBS_Config.h
+*
+* @date     March-28-2017
+*
+* @brief    Default implementation selection of the host reference AMMCLIB subset
+*
+*******************************************************************************/
+#ifndef _SWLIBS_CONFIG_H_
+#define _SWLIBS_CONFIG_H_
+
+#include "SWLIBS_Defines.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* The application project selects the floating point implementation
+ * (SWLIBS_DEFAULT_IMPLEMENTATION=SWLIBS_DEFAULT_IMPLEMENTATION_FLT), which
+ * is the only one provided by the host reference subset. */
+#ifndef SWLIBS_DEFAULT_IMPLEMENTATION
+#define SWLIBS_DEFAULT_IMPLEMENTATION	SWLIBS_DEFAULT_IMPLEMENTATION_FLT
+#endif
+
+#if (SWLIBS_DEFAULT_IMPLEMENTATION != SWLIBS_DEFAULT_IMPLEMENTATION_FLT)
+#error "Host reference AMMCLIB subset supports the FLT default implementation only"
+#endif
+
+#endif /* _SWLIBS_CONFIG_H_ */
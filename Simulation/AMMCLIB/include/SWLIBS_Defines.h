@@ -0,0 +1,51 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     SWLIBS_Defines.h
+*
+* @date     March-28-2017
+*
+* @brief    Constants and conversion macros of the host reference AMMCLIB subset
+*
+*******************************************************************************/
+#ifndef _SWLIBS_DEFINES_H_
+#define _SWLIBS_DEFINES_H_
+
+#include "SWLIBS_Typedefs.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#define SWLIBS_DEFAULT_IMPLEMENTATION_F32	(1U)
+#define SWLIBS_DEFAULT_IMPLEMENTATION_F16	(2U)
+#define SWLIBS_DEFAULT_IMPLEMENTATION_FLT	(3U)
+
+#define SFRACT_MIN			(-1.0)
+#define SFRACT_MAX			(0.999969482421875)
+#define FRACT_MIN			(-1.0)
+#define FRACT_MAX			(0.9999999995343387)
+
+#define INT16TYPE_MIN		((tS16)0x8000)
+#define INT16TYPE_MAX		((tS16)0x7FFF)
+#define INT32TYPE_MIN		((tS32)0x80000000)
+#define INT32TYPE_MAX		((tS32)0x7FFFFFFF)
+
+#define FLOAT_MIN			((tFloat)(-3.4028234e+38F))
+#define FLOAT_MAX			((tFloat)(3.4028234e+38F))
+
+#define FLOAT_PI			((tFloat)3.14159265358979F)
+#define FLOAT_PI_DIVBY_2	((tFloat)1.57079632679490F)
+#define FLOAT_PI_DIVBY_4	((tFloat)0.78539816339745F)
+#define FLOAT_2_PI			((tFloat)6.28318530717959F)
+#define FLOAT_DIVBY_SQRT3	((tFloat)0.57735026918963F)
+#define FLOAT_SQRT3_DIVBY_2	((tFloat)0.86602540378444F)
+
+/*! Conversion of a real number <-1;1) to the 16/32-bit fractional format */
+#define FRAC16(x)	((tFrac16)(((x) < SFRACT_MAX) ? (((x) >= SFRACT_MIN) ? ((x)*32768.0) : INT16TYPE_MIN) : INT16TYPE_MAX))
+#define FRAC32(x)	((tFrac32)(((x) < FRACT_MAX) ? (((x) >= FRACT_MIN) ? ((x)*2147483648.0) : INT32TYPE_MIN) : INT32TYPE_MAX))
+
+#endif /* _SWLIBS_DEFINES_H_ */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     SWLIBS_Typedefs.h
+*
+* @date     March-28-2017
+*
+* @brief    Basic types of the host reference AMMCLIB subset
+*
+*******************************************************************************/
+#ifndef _SWLIBS_TYPEDEFS_H_
+#define _SWLIBS_TYPEDEFS_H_
+
+#include <stdint.h>
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+typedef unsigned char		tBool;
+typedef int8_t				tS8;
+typedef int16_t				tS16;
+typedef int32_t				tS32;
+typedef int64_t				tS64;
+typedef uint8_t				tU8;
+typedef uint16_t			tU16;
+typedef uint32_t			tU32;
+typedef uint64_t			tU64;
+typedef tS16				tFrac16;
+typedef tS32				tFrac32;
+typedef float				tFloat;
+typedef double				tDouble;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Two- and three-component vectors shared by all library functions
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFrac16		f16Arg1;
+	tFrac16		f16Arg2;
+}SWLIBS_2Syst_F16;
+
+typedef struct
+{
+	tFrac32		f32Arg1;
+	tFrac32		f32Arg2;
+}SWLIBS_2Syst_F32;
+
+typedef struct
+{
+	tFloat		fltArg1;
+	tFloat		fltArg2;
+}SWLIBS_2Syst_FLT;
+
+typedef struct
+{
+	tFloat		fltArg1;
+	tFloat		fltArg2;
+	tFloat		fltArg3;
+}SWLIBS_3Syst_FLT;
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#ifndef TRUE
+#define TRUE	((tBool)1)
+#endif
+
+#ifndef FALSE
+#define FALSE	((tBool)0)
+#endif
+
+#endif /* _SWLIBS_TYPEDEFS_H_ */
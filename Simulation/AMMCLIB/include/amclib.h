@@ -0,0 +1,121 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     amclib.h
+*
+* @date     March-28-2017
+*
+* @brief    Advanced motor control library - host reference subset
+*
+*******************************************************************************/
+#ifndef _AMCLIB_H_
+#define _AMCLIB_H_
+
+#include "mlib.h"
+#include "gflib.h"
+#include "gdflib.h"
+#include "gmclib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Default implementation dispatch (FLT) */
+#define AMCLIB_CurrentLoop(udc, pUDQ, pCtrl)		AMCLIB_CurrentLoop_FLT((udc), (pUDQ), (pCtrl))
+#define AMCLIB_CurrentLoopInit(pCtrl)				AMCLIB_CurrentLoopInit_FLT((pCtrl))
+#define AMCLIB_CurrentLoopSetState(ud, uq, pCtrl)	AMCLIB_CurrentLoopSetState_FLT((ud), (uq), (pCtrl))
+#define AMCLIB_FWSpeedLoop(wReq, wFbck, pIDQ, pCtrl)	AMCLIB_FWSpeedLoop_FLT((wReq), (wFbck), (pIDQ), (pCtrl))
+#define AMCLIB_FWSpeedLoopInit(pCtrl)				AMCLIB_FWSpeedLoopInit_FLT((pCtrl))
+#define AMCLIB_FWSpeedLoopSetState(ramp, wErr, iq, fw, wFilt, pCtrl) \
+		AMCLIB_FWSpeedLoopSetState_FLT((ramp), (wErr), (iq), (fw), (wFilt), (pCtrl))
+#define AMCLIB_BemfObsrvDQ(pI, pU, w, th, pCtrl)	AMCLIB_BemfObsrvDQ_FLT((pI), (pU), (w), (th), (pCtrl))
+#define AMCLIB_BemfObsrvDQInit(pCtrl)				AMCLIB_BemfObsrvDQInit_FLT((pCtrl))
+#define AMCLIB_TrackObsrv(err, pTh, pW, pCtrl)		AMCLIB_TrackObsrv_FLT((err), (pTh), (pW), (pCtrl))
+#define AMCLIB_TrackObsrvInit(pCtrl)				AMCLIB_TrackObsrvInit_FLT((pCtrl))
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  DQ current loop
+
+@details	The D controller limits hold the ratio of the maximal phase voltage
+			Udcb/sqrt(3) available to the loop. The Q controller limits are
+			recalculated every call in volts from the remaining voltage headroom.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	pPIrAWD;	// D-axis current controller
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	pPIrAWQ;	// Q-axis current controller
+	SWLIBS_2Syst_FLT				*pIDQReq;	// required DQ currents
+	SWLIBS_2Syst_FLT				*pIDQFbck;	// DQ current feedback
+}AMCLIB_CURRENT_LOOP_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Speed loop with field weakening
+
+@details	The speed controller output is the required current magnitude, the
+			field weakening controller output is the current vector angle
+			within <-pi/2;0>, measured from the Q axis.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	GDFLIB_FILTER_MA_T_FLT			pFilterW;		// speed feedback filter
+	GDFLIB_FILTER_MA_T_FLT			pFilterFW;		// field weakening error filter
+	GFLIB_CONTROLLER_PIAW_P_T_FLT	pPIpAWQ;		// speed controller
+	GFLIB_CONTROLLER_PIAW_P_T_FLT	pPIpAWFW;		// field weakening controller
+	GFLIB_RAMP_T_FLT				pRamp;			// speed request ramp
+	tFloat							*pIQFbck;		// Q current feedback
+	tFloat							*pUQReq;		// Q voltage request of the current loop
+	tFloat							*pUQLim;		// Q voltage limit of the current loop
+	tFloat							fltUmaxDivImax;	// voltage to current scale of the FW error
+}AMCLIB_FW_SPEED_LOOP_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Back-EMF observer in the estimated (gamma-delta) reference frame
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	SWLIBS_2Syst_FLT				pEObsrv;		// estimated back-EMF
+	SWLIBS_2Syst_FLT				pIObsrv;		// estimated current
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	pParamD;		// gamma axis back-EMF controller
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	pParamQ;		// delta axis back-EMF controller
+	SWLIBS_2Syst_FLT				pIObsrvIn_1;	// measured current of the previous step
+	tFloat							fltIGain;		// L/(L+R*Ts)
+	tFloat							fltUGain;		// Ts/(L+R*Ts)
+	tFloat							fltWIGain;		// Lq*Ts/(L+R*Ts)
+	tFloat							fltEGain;		// Ts/(L+R*Ts)
+}AMCLIB_BEMF_OBSRV_DQ_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Angle tracking observer
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	pParamPI;		// speed estimation controller
+	GFLIB_INTEGRATOR_TR_T_FLT		pParamInteg;	// position integrator
+}AMCLIB_TRACK_OBSRV_T_FLT;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void		AMCLIB_CurrentLoop_FLT(tFloat fltUDcBus, SWLIBS_2Syst_FLT *pUDQReq, AMCLIB_CURRENT_LOOP_T_FLT *pCtrl);
+extern void		AMCLIB_CurrentLoopInit_FLT(AMCLIB_CURRENT_LOOP_T_FLT *pCtrl);
+extern void		AMCLIB_CurrentLoopSetState_FLT(tFloat fltUDReq, tFloat fltUQReq, AMCLIB_CURRENT_LOOP_T_FLT *pCtrl);
+
+extern void		AMCLIB_FWSpeedLoop_FLT(tFloat fltVelocityReq, tFloat fltVelocityFbck, SWLIBS_2Syst_FLT *pIDQReq, AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl);
+extern void		AMCLIB_FWSpeedLoopInit_FLT(AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl);
+extern void		AMCLIB_FWSpeedLoopSetState_FLT(tFloat fltRampState, tFloat fltSpeedErrK1, tFloat fltIQIntegState,
+											   tFloat fltFWIntegState, tFloat fltSpeedFiltState, AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl);
+
+extern tFloat	AMCLIB_BemfObsrvDQ_FLT(const SWLIBS_2Syst_FLT *pIAlBe, const SWLIBS_2Syst_FLT *pUAlBe, tFloat fltSpeed,
+									   tFloat fltPhase, AMCLIB_BEMF_OBSRV_DQ_T_FLT *pCtrl);
+extern void		AMCLIB_BemfObsrvDQInit_FLT(AMCLIB_BEMF_OBSRV_DQ_T_FLT *pCtrl);
+
+extern void		AMCLIB_TrackObsrv_FLT(tFloat fltPhaseErr, tFloat *pPosEst, tFloat *pVelocityEst, AMCLIB_TRACK_OBSRV_T_FLT *pCtrl);
+extern void		AMCLIB_TrackObsrvInit_FLT(AMCLIB_TRACK_OBSRV_T_FLT *pCtrl);
+
+#endif /* _AMCLIB_H_ */
@@ -0,0 +1,46 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gdflib.h
+*
+* @date     March-28-2017
+*
+* @brief    General digital filters library - host reference subset
+*
+*******************************************************************************/
+#ifndef _GDFLIB_H_
+#define _GDFLIB_H_
+
+#include "mlib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Default implementation dispatch (FLT) */
+#define GDFLIB_FILTER_MA_T				GDFLIB_FILTER_MA_T_FLT
+#define GDFLIB_FilterMA(x, pParam)		GDFLIB_FilterMA_FLT((x), (pParam))
+#define GDFLIB_FilterMAInit(pParam)		GDFLIB_FilterMAInit_FLT((pParam))
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Recursive moving average filter
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltAcc;			// filter state (output)
+	tFloat	fltLambda;		// filter coefficient, 1/number of samples
+}GDFLIB_FILTER_MA_T_FLT;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void		GDFLIB_FilterMAInit_FLT(GDFLIB_FILTER_MA_T_FLT *pParam);
+extern tFloat	GDFLIB_FilterMA_FLT(tFloat fltIn, GDFLIB_FILTER_MA_T_FLT *pParam);
+
+#endif /* _GDFLIB_H_ */
@@ -0,0 +1,130 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gflib.h
+*
+* @date     March-28-2017
+*
+* @brief    General functions library - host reference subset
+*
+*******************************************************************************/
+#ifndef _GFLIB_H_
+#define _GFLIB_H_
+
+#include "mlib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#define GFLIB_SINCOS_DEFAULT_FLT		&gflibSinCosCoef_flt
+
+/* Default implementation dispatch (FLT) */
+#define GFLIB_Sqrt(x)					GFLIB_Sqrt_FLT((x))
+#define GFLIB_SinCos(x, pOut, pParam)	GFLIB_SinCos_FLT((x), (pOut), (pParam))
+#define GFLIB_AtanYX(y, x)				GFLIB_AtanYX_FLT((y), (x))
+#define GFLIB_VectorLimit(pOut, pIn, pParam)	GFLIB_VectorLimit_FLT((pOut), (pIn), (pParam))
+#define GFLIB_ControllerPIrAW(x, pParam)	GFLIB_ControllerPIrAW_FLT((x), (pParam))
+#define GFLIB_ControllerPIpAW(x, pParam)	GFLIB_ControllerPIpAW_FLT((x), (pParam))
+#define GFLIB_Ramp(x, pParam)			GFLIB_Ramp_FLT((x), (pParam))
+#define GFLIB_IntegratorTR(x, pParam)	GFLIB_IntegratorTR_FLT((x), (pParam))
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Polynomial coefficients of the sine approximation on <-pi/2;pi/2>
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltA[6];
+}GFLIB_SINCOS_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Recurrent form PI controller with anti-windup
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltCC1sc;		// coefficient of the actual error
+	tFloat	fltCC2sc;		// coefficient of the previous error
+	tFloat	fltAcc;			// controller output state
+	tFloat	fltInErrK1;		// previous error
+	tFloat	fltUpperLimit;	// upper output limit
+	tFloat	fltLowerLimit;	// lower output limit
+}GFLIB_CONTROLLER_PIAW_R_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Parallel form PI controller with anti-windup
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltPropGain;		// proportional gain
+	tFloat	fltIntegGain;		// integral gain (includes Ts/2 of the trapezoidal rule)
+	tFloat	fltIntegPartK_1;	// integral part state
+	tFloat	fltInK_1;			// previous input error
+	tFloat	fltUpperLimit;		// upper output limit
+	tFloat	fltLowerLimit;		// lower output limit
+	tU16	u16LimitFlag;		// output saturation flag
+}GFLIB_CONTROLLER_PIAW_P_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Ramp
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltState;		// actual ramp output
+	tFloat	fltRampUp;		// increment per call
+	tFloat	fltRampDown;	// decrement per call
+}GFLIB_RAMP_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Trapezoidal integrator, 32-bit fractional
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFrac32	f32State;		// integrator state
+	tFrac32	f32InK1;		// previous input
+	tFrac32	f32C1;			// integration constant
+	tU16	u16NShift;		// scaling shift of the integration constant
+}GFLIB_INTEGRATOR_TR_T_F32;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Trapezoidal integrator, floating point
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltState;		// integrator state
+	tFloat	fltInK1;		// previous input
+	tFloat	fltC1;			// integration constant (Ts/2)
+}GFLIB_INTEGRATOR_TR_T_FLT;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Vector limit
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltLimit;		// maximal vector magnitude
+}GFLIB_VECTORLIMIT_T_FLT;
+
+/******************************************************************************
+| Exported Variables
+-----------------------------------------------------------------------------*/
+extern const GFLIB_SINCOS_T_FLT gflibSinCosCoef_flt;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern tFloat	GFLIB_Sqrt_FLT(tFloat fltIn);
+extern void		GFLIB_SinCos_FLT(tFloat fltIn, SWLIBS_2Syst_FLT *pOut, const GFLIB_SINCOS_T_FLT *const pParam);
+extern tFloat	GFLIB_AtanYX_FLT(tFloat fltInY, tFloat fltInX);
+extern tBool	GFLIB_VectorLimit_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn, const GFLIB_VECTORLIMIT_T_FLT *const pParam);
+extern tFloat	GFLIB_ControllerPIrAW_FLT(tFloat fltInErr, GFLIB_CONTROLLER_PIAW_R_T_FLT *const pParam);
+extern tFloat	GFLIB_ControllerPIpAW_FLT(tFloat fltInErr, GFLIB_CONTROLLER_PIAW_P_T_FLT *const pParam);
+extern tFloat	GFLIB_Ramp_FLT(tFloat fltIn, GFLIB_RAMP_T_FLT *const pParam);
+extern tFrac32	GFLIB_IntegratorTR_F32(tFrac32 f32In, GFLIB_INTEGRATOR_TR_T_F32 *const pParam);
+extern tFloat	GFLIB_IntegratorTR_FLT(tFloat fltIn, GFLIB_INTEGRATOR_TR_T_FLT *const pParam);
+
+#endif /* _GFLIB_H_ */
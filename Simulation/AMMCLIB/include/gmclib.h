@@ -0,0 +1,52 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gmclib.h
+*
+* @date     March-28-2017
+*
+* @brief    General motor control library - host reference subset
+*
+*******************************************************************************/
+#ifndef _GMCLIB_H_
+#define _GMCLIB_H_
+
+#include "mlib.h"
+#include "gflib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Default implementation dispatch (FLT) */
+#define GMCLIB_Clark(pOut, pIn)						GMCLIB_Clark_FLT((pOut), (pIn))
+#define GMCLIB_Park(pOut, pInAngle, pIn)			GMCLIB_Park_FLT((pOut), (pInAngle), (pIn))
+#define GMCLIB_ParkInv(pOut, pInAngle, pIn)			GMCLIB_ParkInv_FLT((pOut), (pInAngle), (pIn))
+#define GMCLIB_ElimDcBusRip(pOut, pIn, pParam)		GMCLIB_ElimDcBusRip_FLT((pOut), (pIn), (pParam))
+#define GMCLIB_SvmStd(pOut, pIn)					GMCLIB_SvmStd_FLT((pOut), (pIn))
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  DC-bus ripple elimination
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat	fltModIndex;		// modulation index, sqrt(3)/2 for the standard SVM
+	tFloat	fltArgDcBusMsr;		// measured DC-bus voltage
+}GMCLIB_ELIMDCBUSRIP_T_FLT;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void		GMCLIB_Clark_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_3Syst_FLT *const pIn);
+extern void		GMCLIB_Park_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pInAngle, const SWLIBS_2Syst_FLT *const pIn);
+extern void		GMCLIB_ParkInv_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pInAngle, const SWLIBS_2Syst_FLT *const pIn);
+extern void		GMCLIB_ElimDcBusRip_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn, const GMCLIB_ELIMDCBUSRIP_T_FLT *const pParam);
+extern tU16		GMCLIB_SvmStd_FLT(SWLIBS_3Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn);
+
+#endif /* _GMCLIB_H_ */
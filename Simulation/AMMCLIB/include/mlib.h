@@ -0,0 +1,106 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     mlib.h
+*
+* @date     March-28-2017
+*
+* @brief    Math library - host reference subset
+*
+* @details	Only the functions referenced by the PMSM application are provided.
+*			All functions are inline, as in the target library, so the host
+*			build sees the same call structure as the target build.
+*
+*******************************************************************************/
+#ifndef _MLIB_H_
+#define _MLIB_H_
+
+#include "SWLIBS_Config.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Default implementation dispatch (FLT) */
+#define MLIB_Add(a, b)				MLIB_Add_FLT((a), (b))
+#define MLIB_Sub(a, b)				MLIB_Sub_FLT((a), (b))
+#define MLIB_Mul(a, b)				MLIB_Mul_FLT((a), (b))
+#define MLIB_Div(a, b)				MLIB_Div_FLT((a), (b))
+#define MLIB_Neg(a)					MLIB_Neg_FLT((a))
+#define MLIB_Abs(a)					MLIB_Abs_FLT((a))
+
+/******************************************************************************
+| Inline functions
+-----------------------------------------------------------------------------*/
+static inline tFloat MLIB_Add_FLT(tFloat fltIn1, tFloat fltIn2)
+{
+	return (fltIn1 + fltIn2);
+}
+
+static inline tFloat MLIB_Sub_FLT(tFloat fltIn1, tFloat fltIn2)
+{
+	return (fltIn1 - fltIn2);
+}
+
+static inline tFloat MLIB_Mul_FLT(tFloat fltIn1, tFloat fltIn2)
+{
+	return (fltIn1 * fltIn2);
+}
+
+static inline tFloat MLIB_Div_FLT(tFloat fltIn1, tFloat fltIn2)
+{
+	return (fltIn1 / fltIn2);
+}
+
+static inline tFloat MLIB_Neg_FLT(tFloat fltIn)
+{
+	return (-fltIn);
+}
+
+static inline tFloat MLIB_Abs_FLT(tFloat fltIn)
+{
+	return ((fltIn < 0.0F) ? -fltIn : fltIn);
+}
+
+/*! Wrapping 32-bit fractional subtraction */
+static inline tFrac32 MLIB_Sub_F32(tFrac32 f32In1, tFrac32 f32In2)
+{
+	return ((tFrac32)((tU32)f32In1 - (tU32)f32In2));
+}
+
+/*! Saturating 32-bit fractional multiplication */
+static inline tFrac32 MLIB_MulSat_F32(tFrac32 f32In1, tFrac32 f32In2)
+{
+	tS64 s64Temp = ((tS64)f32In1 * (tS64)f32In2) >> 31;
+
+	if (s64Temp > (tS64)INT32TYPE_MAX)	return INT32TYPE_MAX;
+	if (s64Temp < (tS64)INT32TYPE_MIN)	return INT32TYPE_MIN;
+	return ((tFrac32)s64Temp);
+}
+
+/*! 32-bit fractional left shift, the result is not saturated */
+static inline tFrac32 MLIB_ShL_F32(tFrac32 f32In, tU16 u16N)
+{
+	return ((tFrac32)((tU32)f32In << u16N));
+}
+
+/*! Conversion of a <-1;1) floating point value to the saturated Q31 format */
+static inline tFrac32 MLIB_ConvertPU_F32FLT(tFloat fltIn)
+{
+	tFloat fltTemp = fltIn * 2147483648.0F;
+
+	if (fltTemp >= 2147483648.0F)		return INT32TYPE_MAX;
+	if (fltTemp <= -2147483648.0F)		return INT32TYPE_MIN;
+	return ((tFrac32)fltTemp);
+}
+
+/*! Conversion of a Q31 value to floating point <-1;1) */
+static inline tFloat MLIB_ConvertPU_FLTF32(tFrac32 f32In)
+{
+	return ((tFloat)f32In * (1.0F / 2147483648.0F));
+}
+
+#endif /* _MLIB_H_ */
@@ -0,0 +1,240 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     amclib.c
+*
+* @date     March-28-2017
+*
+* @brief    Advanced motor control library - host reference subset
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "amclib.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief		DQ current loop
+
+@param[in]		fltUDcBus	Measured DC-bus voltage
+@param[out]		pUDQReq		Required DQ voltages
+@param[in,out]	pCtrl		Current loop structure
+
+@details	The D voltage is limited to pPIrAWD.fltUpperLimit*Udcb/sqrt(3),
+			the Q voltage to the remaining headroom sqrt(Umax^2 - Ud^2). The Q
+			limits are stored in pPIrAWQ in volts and read back by the field
+			weakening loop.
+******************************************************************************/
+void AMCLIB_CurrentLoop_FLT(tFloat fltUDcBus, SWLIBS_2Syst_FLT *pUDQReq, AMCLIB_CURRENT_LOOP_T_FLT *pCtrl)
+{
+	tFloat fltUmax, fltLimD, fltLimDLow, fltUQmax;
+
+	fltUmax = pCtrl->pPIrAWD.fltUpperLimit * fltUDcBus * FLOAT_DIVBY_SQRT3;
+
+	/* D controller runs with the voltage limit, the stored ratio is kept */
+	fltLimD		= pCtrl->pPIrAWD.fltUpperLimit;
+	fltLimDLow	= pCtrl->pPIrAWD.fltLowerLimit;
+	pCtrl->pPIrAWD.fltUpperLimit = fltUmax;
+	pCtrl->pPIrAWD.fltLowerLimit = -fltUmax;
+	pUDQReq->fltArg1 = GFLIB_ControllerPIrAW_FLT(pCtrl->pIDQReq->fltArg1 - pCtrl->pIDQFbck->fltArg1, &pCtrl->pPIrAWD);
+	pCtrl->pPIrAWD.fltUpperLimit = fltLimD;
+	pCtrl->pPIrAWD.fltLowerLimit = fltLimDLow;
+
+	fltUQmax = GFLIB_Sqrt_FLT(fltUmax * fltUmax - pUDQReq->fltArg1 * pUDQReq->fltArg1);
+	pCtrl->pPIrAWQ.fltUpperLimit = fltUQmax;
+	pCtrl->pPIrAWQ.fltLowerLimit = -fltUQmax;
+	pUDQReq->fltArg2 = GFLIB_ControllerPIrAW_FLT(pCtrl->pIDQReq->fltArg2 - pCtrl->pIDQFbck->fltArg2, &pCtrl->pPIrAWQ);
+}
+
+/**************************************************************************//*!
+@brief		Clears the current loop controller states
+******************************************************************************/
+void AMCLIB_CurrentLoopInit_FLT(AMCLIB_CURRENT_LOOP_T_FLT *pCtrl)
+{
+	pCtrl->pPIrAWD.fltAcc		= 0.0F;
+	pCtrl->pPIrAWD.fltInErrK1	= 0.0F;
+	pCtrl->pPIrAWQ.fltAcc		= 0.0F;
+	pCtrl->pPIrAWQ.fltInErrK1	= 0.0F;
+}
+
+/**************************************************************************//*!
+@brief		Presets the current loop controller outputs
+******************************************************************************/
+void AMCLIB_CurrentLoopSetState_FLT(tFloat fltUDReq, tFloat fltUQReq, AMCLIB_CURRENT_LOOP_T_FLT *pCtrl)
+{
+	pCtrl->pPIrAWD.fltAcc		= fltUDReq;
+	pCtrl->pPIrAWD.fltInErrK1	= 0.0F;
+	pCtrl->pPIrAWQ.fltAcc		= fltUQReq;
+	pCtrl->pPIrAWQ.fltInErrK1	= 0.0F;
+}
+
+/**************************************************************************//*!
+@brief		Speed loop with field weakening
+
+@param[in]		fltVelocityReq	Required electrical speed
+@param[in]		fltVelocityFbck	Electrical speed feedback
+@param[out]		pIDQReq			Required DQ currents
+@param[in,out]	pCtrl			Speed loop structure
+
+@details	The speed controller gives the current magnitude. The field
+			weakening controller turns the current vector towards the negative
+			D axis once the Q voltage request reaches the Q voltage limit.
+******************************************************************************/
+void AMCLIB_FWSpeedLoop_FLT(tFloat fltVelocityReq, tFloat fltVelocityFbck, SWLIBS_2Syst_FLT *pIDQReq,
+							AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl)
+{
+	tFloat fltSpeedRamp, fltSpeedFilt, fltIReq, fltFWErr, fltAngle;
+	SWLIBS_2Syst_FLT sinCos;
+
+	fltSpeedRamp = GFLIB_Ramp_FLT(fltVelocityReq, &pCtrl->pRamp);
+	fltSpeedFilt = GDFLIB_FilterMA_FLT(fltVelocityFbck, &pCtrl->pFilterW);
+	fltIReq		 = GFLIB_ControllerPIpAW_FLT(fltSpeedRamp - fltSpeedFilt, &pCtrl->pPIpAWQ);
+
+	fltFWErr = MLIB_Abs_FLT(*pCtrl->pUQLim) - MLIB_Abs_FLT(*pCtrl->pUQReq)
+			 - pCtrl->fltUmaxDivImax * MLIB_Abs_FLT(pIDQReq->fltArg2 - *pCtrl->pIQFbck);
+	fltFWErr = GDFLIB_FilterMA_FLT(fltFWErr, &pCtrl->pFilterFW);
+	fltAngle = GFLIB_ControllerPIpAW_FLT(fltFWErr, &pCtrl->pPIpAWFW);
+
+	GFLIB_SinCos_FLT(fltAngle, &sinCos, GFLIB_SINCOS_DEFAULT_FLT);
+
+	pIDQReq->fltArg1 = MLIB_Abs_FLT(fltIReq) * sinCos.fltArg1;
+	pIDQReq->fltArg2 = fltIReq * sinCos.fltArg2;
+}
+
+/**************************************************************************//*!
+@brief		Clears the speed and field weakening loop states
+******************************************************************************/
+void AMCLIB_FWSpeedLoopInit_FLT(AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl)
+{
+	pCtrl->pRamp.fltState			= 0.0F;
+	pCtrl->pFilterW.fltAcc			= 0.0F;
+	pCtrl->pFilterFW.fltAcc			= 0.0F;
+	pCtrl->pPIpAWQ.fltIntegPartK_1	= 0.0F;
+	pCtrl->pPIpAWQ.fltInK_1			= 0.0F;
+	pCtrl->pPIpAWQ.u16LimitFlag		= 0U;
+	pCtrl->pPIpAWFW.fltIntegPartK_1	= 0.0F;
+	pCtrl->pPIpAWFW.fltInK_1		= 0.0F;
+	pCtrl->pPIpAWFW.u16LimitFlag	= 0U;
+}
+
+/**************************************************************************//*!
+@brief		Presets the speed and field weakening loop states
+******************************************************************************/
+void AMCLIB_FWSpeedLoopSetState_FLT(tFloat fltRampState, tFloat fltSpeedErrK1, tFloat fltIQIntegState,
+									tFloat fltFWIntegState, tFloat fltSpeedFiltState, AMCLIB_FW_SPEED_LOOP_T_FLT *pCtrl)
+{
+	pCtrl->pRamp.fltState			= fltRampState;
+	pCtrl->pPIpAWQ.fltInK_1			= fltSpeedErrK1;
+	pCtrl->pPIpAWQ.fltIntegPartK_1	= fltIQIntegState;
+	pCtrl->pPIpAWFW.fltIntegPartK_1	= fltFWIntegState;
+	pCtrl->pPIpAWFW.fltInK_1		= 0.0F;
+	pCtrl->pFilterW.fltAcc			= fltSpeedFiltState;
+}
+
+/**************************************************************************//*!
+@brief		Back-EMF observer in the estimated reference frame
+
+@param[in]		pIAlBe		Measured alpha/beta current
+@param[in]		pUAlBe		Alpha/beta voltage applied during the last period
+@param[in]		fltSpeed	Estimated electrical speed
+@param[in]		fltPhase	Estimated electrical position
+@param[in,out]	pCtrl		Observer structure
+
+@return		Angle between the estimated and the real rotor frame,
+			positive when the estimate lags behind the rotor.
+
+@details	The observer runs a virtual copy of the motor model
+				i(k) = IGain*i(k-1) + UGain*u - EGain*e +- WIGain*w*i_other(k-1)
+			whose current is compared with the measured one; the PI controllers
+			of both axes drive the estimated back-EMF until the model current
+			tracks the motor current. The controllers are tuned like the current
+			loop, so the observer bandwidth follows the current loop bandwidth.
+******************************************************************************/
+tFloat AMCLIB_BemfObsrvDQ_FLT(const SWLIBS_2Syst_FLT *pIAlBe, const SWLIBS_2Syst_FLT *pUAlBe, tFloat fltSpeed,
+							  tFloat fltPhase, AMCLIB_BEMF_OBSRV_DQ_T_FLT *pCtrl)
+{
+	SWLIBS_2Syst_FLT sinCos, iGaDe, uGaDe;
+	tFloat fltEDelta;
+
+	GFLIB_SinCos_FLT(fltPhase, &sinCos, GFLIB_SINCOS_DEFAULT_FLT);
+	GMCLIB_Park_FLT(&iGaDe, &sinCos, pIAlBe);
+	GMCLIB_Park_FLT(&uGaDe, &sinCos, pUAlBe);
+
+	/* Back-EMF from the model current error */
+	pCtrl->pEObsrv.fltArg1 = GFLIB_ControllerPIrAW_FLT(pCtrl->pIObsrv.fltArg1 - iGaDe.fltArg1, &pCtrl->pParamD);
+	pCtrl->pEObsrv.fltArg2 = GFLIB_ControllerPIrAW_FLT(pCtrl->pIObsrv.fltArg2 - iGaDe.fltArg2, &pCtrl->pParamQ);
+
+	/* Model current for the next step */
+	pCtrl->pIObsrv.fltArg1 = pCtrl->fltIGain * pCtrl->pIObsrv.fltArg1 + pCtrl->fltUGain * uGaDe.fltArg1
+						   - pCtrl->fltEGain * pCtrl->pEObsrv.fltArg1 + pCtrl->fltWIGain * fltSpeed * iGaDe.fltArg2;
+	pCtrl->pIObsrv.fltArg2 = pCtrl->fltIGain * pCtrl->pIObsrv.fltArg2 + pCtrl->fltUGain * uGaDe.fltArg2
+						   - pCtrl->fltEGain * pCtrl->pEObsrv.fltArg2 - pCtrl->fltWIGain * fltSpeed * iGaDe.fltArg1;
+
+	pCtrl->pIObsrvIn_1 = iGaDe;
+
+	fltEDelta = pCtrl->pEObsrv.fltArg2;
+	if (fltEDelta < 0.0F)
+	{
+		return (GFLIB_AtanYX_FLT(pCtrl->pEObsrv.fltArg1, -fltEDelta));
+	}
+	return (GFLIB_AtanYX_FLT(-pCtrl->pEObsrv.fltArg1, fltEDelta));
+}
+
+/**************************************************************************//*!
+@brief		Clears the back-EMF observer states
+******************************************************************************/
+void AMCLIB_BemfObsrvDQInit_FLT(AMCLIB_BEMF_OBSRV_DQ_T_FLT *pCtrl)
+{
+	pCtrl->pEObsrv.fltArg1		= 0.0F;
+	pCtrl->pEObsrv.fltArg2		= 0.0F;
+	pCtrl->pIObsrv.fltArg1		= 0.0F;
+	pCtrl->pIObsrv.fltArg2		= 0.0F;
+	pCtrl->pIObsrvIn_1.fltArg1	= 0.0F;
+	pCtrl->pIObsrvIn_1.fltArg2	= 0.0F;
+	pCtrl->pParamD.fltAcc		= 0.0F;
+	pCtrl->pParamD.fltInErrK1	= 0.0F;
+	pCtrl->pParamQ.fltAcc		= 0.0F;
+	pCtrl->pParamQ.fltInErrK1	= 0.0F;
+}
+
+/**************************************************************************//*!
+@brief		Angle tracking observer
+
+@param[in]		fltPhaseErr		Position error, e.g. the back-EMF observer output
+@param[out]		pPosEst			Estimated electrical position <-pi;pi)
+@param[out]		pVelocityEst	Estimated electrical speed
+@param[in,out]	pCtrl			Observer structure
+******************************************************************************/
+void AMCLIB_TrackObsrv_FLT(tFloat fltPhaseErr, tFloat *pPosEst, tFloat *pVelocityEst, AMCLIB_TRACK_OBSRV_T_FLT *pCtrl)
+{
+	tFloat fltSpeed, fltPos;
+
+	fltSpeed = GFLIB_ControllerPIrAW_FLT(fltPhaseErr, &pCtrl->pParamPI);
+	fltPos	 = GFLIB_IntegratorTR_FLT(fltSpeed, &pCtrl->pParamInteg);
+
+	if (fltPos >= FLOAT_PI)			fltPos -= FLOAT_2_PI;
+	else if (fltPos < -FLOAT_PI)	fltPos += FLOAT_2_PI;
+	pCtrl->pParamInteg.fltState = fltPos;
+
+	*pVelocityEst	= fltSpeed;
+	*pPosEst		= fltPos;
+}
+
+/**************************************************************************//*!
+@brief		Clears the angle tracking observer states
+******************************************************************************/
+void AMCLIB_TrackObsrvInit_FLT(AMCLIB_TRACK_OBSRV_T_FLT *pCtrl)
+{
+	pCtrl->pParamPI.fltAcc			= 0.0F;
+	pCtrl->pParamPI.fltInErrK1		= 0.0F;
+	pCtrl->pParamInteg.fltState		= 0.0F;
+	pCtrl->pParamInteg.fltInK1		= 0.0F;
+}
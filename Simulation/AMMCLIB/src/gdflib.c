@@ -0,0 +1,42 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gdflib.c
+*
+* @date     March-28-2017
+*
+* @brief    General digital filters library - host reference subset
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gdflib.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief		Clears the moving average filter state
+******************************************************************************/
+void GDFLIB_FilterMAInit_FLT(GDFLIB_FILTER_MA_T_FLT *pParam)
+{
+	pParam->fltAcc = 0.0F;
+}
+
+/**************************************************************************//*!
+@brief		Recursive moving average filter
+
+@details	y(k) = y(k-1) + lambda*(x(k) - y(k-1))
+******************************************************************************/
+tFloat GDFLIB_FilterMA_FLT(tFloat fltIn, GDFLIB_FILTER_MA_T_FLT *pParam)
+{
+	pParam->fltAcc += pParam->fltLambda * (fltIn - pParam->fltAcc);
+
+	return (pParam->fltAcc);
+}
@@ -0,0 +1,275 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gflib.c
+*
+* @date     March-28-2017
+*
+* @brief    General functions library - host reference subset
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <math.h>
+#include "gflib.h"
+
+/******************************************************************************
+| Global variable definitions   (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*! Taylor coefficients of sin(x) up to x^11, error < 6e-8 on <-pi/2;pi/2> */
+const GFLIB_SINCOS_T_FLT gflibSinCosCoef_flt =
+{
+	{
+		1.0F,
+		-1.6666666666666667e-1F,
+		8.3333333333333333e-3F,
+		-1.9841269841269841e-4F,
+		2.7557319223985891e-6F,
+		-2.5052108385441719e-8F
+	}
+};
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+/*! Taylor coefficients of atan(x) up to x^15, error < 2e-8 on <-tan(pi/8);tan(pi/8)> */
+static const tFloat gflibAtanCoef_flt[8] =
+{
+	1.0F,
+	-3.3333333333333333e-1F,
+	2.0e-1F,
+	-1.4285714285714286e-1F,
+	1.1111111111111111e-1F,
+	-9.0909090909090909e-2F,
+	7.6923076923076923e-2F,
+	-6.6666666666666667e-2F
+};
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+/*! Odd polynomial evaluation for |x| <= pi/2 */
+static inline tFloat GFLIB_SinPoly(tFloat fltX, const GFLIB_SINCOS_T_FLT *const pParam)
+{
+	tFloat fltX2 = fltX * fltX;
+
+	return (fltX * (pParam->fltA[0] + fltX2 * (pParam->fltA[1] + fltX2 * (pParam->fltA[2]
+	      + fltX2 * (pParam->fltA[3] + fltX2 * (pParam->fltA[4] + fltX2 * pParam->fltA[5]))))));
+}
+
+/*! Odd polynomial evaluation of atan for |x| <= tan(pi/8) */
+static inline tFloat GFLIB_AtanPoly(tFloat fltX)
+{
+	tFloat fltX2 = fltX * fltX;
+
+	return (fltX * (gflibAtanCoef_flt[0] + fltX2 * (gflibAtanCoef_flt[1] + fltX2 * (gflibAtanCoef_flt[2]
+	      + fltX2 * (gflibAtanCoef_flt[3] + fltX2 * (gflibAtanCoef_flt[4] + fltX2 * (gflibAtanCoef_flt[5]
+	      + fltX2 * (gflibAtanCoef_flt[6] + fltX2 * gflibAtanCoef_flt[7]))))))));
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief		Square root, returns 0 for non-positive inputs
+******************************************************************************/
+tFloat GFLIB_Sqrt_FLT(tFloat fltIn)
+{
+	return ((fltIn > 0.0F) ? sqrtf(fltIn) : 0.0F);
+}
+
+/**************************************************************************//*!
+@brief		Sine and cosine of the input angle
+
+@param[in]	fltIn		Angle in radians, any value (wrapped to <-pi;pi))
+@param[out]	pOut		fltArg1 = sin(fltIn), fltArg2 = cos(fltIn)
+@param[in]	pParam		Polynomial coefficients, GFLIB_SINCOS_DEFAULT_FLT
+******************************************************************************/
+void GFLIB_SinCos_FLT(tFloat fltIn, SWLIBS_2Syst_FLT *pOut, const GFLIB_SINCOS_T_FLT *const pParam)
+{
+	tFloat fltS, fltC;
+
+	if ((fltIn >= FLOAT_PI) || (fltIn < -FLOAT_PI))
+	{
+		fltIn -= FLOAT_2_PI * floorf((fltIn + FLOAT_PI) * (1.0F / FLOAT_2_PI));
+	}
+
+	/* sin: fold <pi/2;pi) and <-pi;-pi/2) back to <-pi/2;pi/2> */
+	fltS = fltIn;
+	if (fltS > FLOAT_PI_DIVBY_2)		fltS = FLOAT_PI - fltS;
+	else if (fltS < -FLOAT_PI_DIVBY_2)	fltS = -FLOAT_PI - fltS;
+
+	/* cos(x) = sin(pi/2 - |x|), the argument is within <-pi/2;pi/2> */
+	fltC = FLOAT_PI_DIVBY_2 - MLIB_Abs_FLT(fltIn);
+
+	pOut->fltArg1 = GFLIB_SinPoly(fltS, pParam);
+	pOut->fltArg2 = GFLIB_SinPoly(fltC, pParam);
+}
+
+/**************************************************************************//*!
+@brief		Four-quadrant arctangent of Y/X in radians
+
+@details	The ratio of the smaller to the larger magnitude is folded into
+			<0;1>, ratios above tan(pi/8) use atan(t) = pi/4 + atan((t-1)/(t+1)).
+			Only basic IEEE operations are used, the result does not depend
+			on the C library. Returns 0 for a zero vector.
+******************************************************************************/
+tFloat GFLIB_AtanYX_FLT(tFloat fltInY, tFloat fltInX)
+{
+	tFloat	fltAbsY = MLIB_Abs_FLT(fltInY);
+	tFloat	fltAbsX = MLIB_Abs_FLT(fltInX);
+	tFloat	fltT, fltOut;
+	tBool	bSwap = (fltAbsY > fltAbsX);
+
+	if ((fltAbsX == 0.0F) && (fltAbsY == 0.0F))
+	{
+		return (0.0F);
+	}
+
+	fltT = bSwap ? (fltAbsX / fltAbsY) : (fltAbsY / fltAbsX);
+
+	if (fltT > 0.41421356F)
+	{
+		fltOut = FLOAT_PI_DIVBY_4 + GFLIB_AtanPoly((fltT - 1.0F) / (fltT + 1.0F));
+	}
+	else
+	{
+		fltOut = GFLIB_AtanPoly(fltT);
+	}
+
+	if (bSwap)				fltOut = FLOAT_PI_DIVBY_2 - fltOut;
+	if (fltInX < 0.0F)		fltOut = FLOAT_PI - fltOut;
+	if (fltInY < 0.0F)		fltOut = -fltOut;
+
+	return (fltOut);
+}
+
+/**************************************************************************//*!
+@brief		Limits the magnitude of a two-component vector
+
+@return		true when the input vector was limited
+******************************************************************************/
+tBool GFLIB_VectorLimit_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn,
+							const GFLIB_VECTORLIMIT_T_FLT *const pParam)
+{
+	tFloat fltMag2 = pIn->fltArg1 * pIn->fltArg1 + pIn->fltArg2 * pIn->fltArg2;
+	tFloat fltScale;
+
+	if (fltMag2 <= pParam->fltLimit * pParam->fltLimit)
+	{
+		pOut->fltArg1 = pIn->fltArg1;
+		pOut->fltArg2 = pIn->fltArg2;
+		return (0U);
+	}
+
+	fltScale = pParam->fltLimit / sqrtf(fltMag2);
+	pOut->fltArg1 = pIn->fltArg1 * fltScale;
+	pOut->fltArg2 = pIn->fltArg2 * fltScale;
+	return (1U);
+}
+
+/**************************************************************************//*!
+@brief		Recurrent PI controller with anti-windup
+
+@details	y(k) = y(k-1) + CC1sc*e(k) + CC2sc*e(k-1), y limited to
+			<fltLowerLimit;fltUpperLimit>
+******************************************************************************/
+tFloat GFLIB_ControllerPIrAW_FLT(tFloat fltInErr, GFLIB_CONTROLLER_PIAW_R_T_FLT *const pParam)
+{
+	tFloat fltAcc = pParam->fltAcc + pParam->fltCC1sc * fltInErr + pParam->fltCC2sc * pParam->fltInErrK1;
+
+	if (fltAcc > pParam->fltUpperLimit)			fltAcc = pParam->fltUpperLimit;
+	else if (fltAcc < pParam->fltLowerLimit)	fltAcc = pParam->fltLowerLimit;
+
+	pParam->fltAcc		= fltAcc;
+	pParam->fltInErrK1	= fltInErr;
+
+	return (fltAcc);
+}
+
+/**************************************************************************//*!
+@brief		Parallel PI controller with anti-windup
+
+@details	The integral part uses the trapezoidal rule and is limited to the
+			output limits. u16LimitFlag is set when the output saturates.
+******************************************************************************/
+tFloat GFLIB_ControllerPIpAW_FLT(tFloat fltInErr, GFLIB_CONTROLLER_PIAW_P_T_FLT *const pParam)
+{
+	tFloat fltIntegPart, fltOut;
+
+	fltIntegPart = pParam->fltIntegPartK_1 + pParam->fltIntegGain * (fltInErr + pParam->fltInK_1);
+
+	if (fltIntegPart > pParam->fltUpperLimit)			fltIntegPart = pParam->fltUpperLimit;
+	else if (fltIntegPart < pParam->fltLowerLimit)		fltIntegPart = pParam->fltLowerLimit;
+
+	pParam->fltIntegPartK_1	= fltIntegPart;
+	pParam->fltInK_1		= fltInErr;
+
+	fltOut = pParam->fltPropGain * fltInErr + fltIntegPart;
+
+	pParam->u16LimitFlag = 1U;
+	if (fltOut > pParam->fltUpperLimit)				fltOut = pParam->fltUpperLimit;
+	else if (fltOut < pParam->fltLowerLimit)		fltOut = pParam->fltLowerLimit;
+	else											pParam->u16LimitFlag = 0U;
+
+	return (fltOut);
+}
+
+/**************************************************************************//*!
+@brief		Ramp towards the input value
+******************************************************************************/
+tFloat GFLIB_Ramp_FLT(tFloat fltIn, GFLIB_RAMP_T_FLT *const pParam)
+{
+	tFloat fltState = pParam->fltState;
+
+	if (fltIn > fltState)
+	{
+		fltState += pParam->fltRampUp;
+		if (fltState > fltIn)	fltState = fltIn;
+	}
+	else
+	{
+		fltState -= pParam->fltRampDown;
+		if (fltState < fltIn)	fltState = fltIn;
+	}
+
+	pParam->fltState = fltState;
+	return (fltState);
+}
+
+/**************************************************************************//*!
+@brief		Trapezoidal integrator, 32-bit fractional
+
+@details	y(k) = y(k-1) + ((C1*(x(k) + x(k-1))) << NShift), the state wraps
+			around, which makes the integrator usable as an angle generator.
+******************************************************************************/
+tFrac32 GFLIB_IntegratorTR_F32(tFrac32 f32In, GFLIB_INTEGRATOR_TR_T_F32 *const pParam)
+{
+	tS64 s64Temp = (((tS64)f32In + (tS64)pParam->f32InK1) * (tS64)pParam->f32C1) >> 31;
+
+	s64Temp = (tS64)((tU64)s64Temp << pParam->u16NShift);
+
+	pParam->f32State	= (tFrac32)((tU32)pParam->f32State + (tU32)s64Temp);
+	pParam->f32InK1		= f32In;
+
+	return (pParam->f32State);
+}
+
+/**************************************************************************//*!
+@brief		Trapezoidal integrator, floating point
+
+@details	y(k) = y(k-1) + C1*(x(k) + x(k-1))
+******************************************************************************/
+tFloat GFLIB_IntegratorTR_FLT(tFloat fltIn, GFLIB_INTEGRATOR_TR_T_FLT *const pParam)
+{
+	pParam->fltState	+= pParam->fltC1 * (fltIn + pParam->fltInK1);
+	pParam->fltInK1		= fltIn;
+
+	return (pParam->fltState);
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     gmclib.c
+*
+* @date     March-28-2017
+*
+* @brief    General motor control library - host reference subset
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gmclib.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief		Clarke transformation, amplitude invariant
+
+@details	alpha = a, beta = (a + 2b)/sqrt(3)
+******************************************************************************/
+void GMCLIB_Clark_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_3Syst_FLT *const pIn)
+{
+	pOut->fltArg1 = pIn->fltArg1;
+	pOut->fltArg2 = (pIn->fltArg1 + 2.0F * pIn->fltArg2) * FLOAT_DIVBY_SQRT3;
+}
+
+/**************************************************************************//*!
+@brief		Park transformation
+
+@param[in]	pInAngle	fltArg1 = sin(theta), fltArg2 = cos(theta)
+******************************************************************************/
+void GMCLIB_Park_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pInAngle,
+					 const SWLIBS_2Syst_FLT *const pIn)
+{
+	tFloat fltAl = pIn->fltArg1;
+	tFloat fltBe = pIn->fltArg2;
+
+	pOut->fltArg1 = fltAl * pInAngle->fltArg2 + fltBe * pInAngle->fltArg1;
+	pOut->fltArg2 = fltBe * pInAngle->fltArg2 - fltAl * pInAngle->fltArg1;
+}
+
+/**************************************************************************//*!
+@brief		Inverse Park transformation
+
+@param[in]	pInAngle	fltArg1 = sin(theta), fltArg2 = cos(theta)
+******************************************************************************/
+void GMCLIB_ParkInv_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pInAngle,
+						const SWLIBS_2Syst_FLT *const pIn)
+{
+	tFloat fltD = pIn->fltArg1;
+	tFloat fltQ = pIn->fltArg2;
+
+	pOut->fltArg1 = fltD * pInAngle->fltArg2 - fltQ * pInAngle->fltArg1;
+	pOut->fltArg2 = fltD * pInAngle->fltArg1 + fltQ * pInAngle->fltArg2;
+}
+
+/**************************************************************************//*!
+@brief		DC-bus ripple elimination
+
+@details	Scales the alpha/beta voltage in volts to the <-1;1> range of the
+			space vector modulation: out = ModIndex*in/(Udcb/2). With the
+			standard ModIndex = sqrt(3)/2, 1.0 is the maximal linear amplitude
+			Udcb/sqrt(3). The output is saturated to <-1;1>.
+******************************************************************************/
+void GMCLIB_ElimDcBusRip_FLT(SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn,
+							 const GMCLIB_ELIMDCBUSRIP_T_FLT *const pParam)
+{
+	tFloat fltHalfDcBus = 0.5F * pParam->fltArgDcBusMsr;
+	tFloat fltArg1 = pParam->fltModIndex * pIn->fltArg1;
+	tFloat fltArg2 = pParam->fltModIndex * pIn->fltArg2;
+
+	if (fltHalfDcBus > MLIB_Abs_FLT(fltArg1))	fltArg1 = fltArg1 / fltHalfDcBus;
+	else										fltArg1 = (fltArg1 < 0.0F) ? -1.0F : 1.0F;
+
+	if (fltHalfDcBus > MLIB_Abs_FLT(fltArg2))	fltArg2 = fltArg2 / fltHalfDcBus;
+	else										fltArg2 = (fltArg2 < 0.0F) ? -1.0F : 1.0F;
+
+	pOut->fltArg1 = fltArg1;
+	pOut->fltArg2 = fltArg2;
+}
+
+/**************************************************************************//*!
+@brief		Standard space vector modulation
+
+@details	Min-max zero sequence injection of the normalised alpha/beta
+			vector, |in| = 1 is the inscribed circle of the voltage hexagon.
+			The duty cycles are limited to <0;1>.
+
+@return		Sector 1..6 of the input vector (60 degree sectors starting at the
+			alpha axis), i.e. sector 1: A>B>C, 2: B>A>C, 3: B>C>A, 4: C>B>A,
+			5: C>A>B, 6: A>C>B.
+******************************************************************************/
+tU16 GMCLIB_SvmStd_FLT(SWLIBS_3Syst_FLT *pOut, const SWLIBS_2Syst_FLT *const pIn)
+{
+	tFloat fltUa, fltUb, fltUc, fltMax, fltMin, fltOffset;
+	tU16 u16Sector;
+
+	fltUa = pIn->fltArg1;
+	fltUb = -0.5F * pIn->fltArg1 + FLOAT_SQRT3_DIVBY_2 * pIn->fltArg2;
+	fltUc = -0.5F * pIn->fltArg1 - FLOAT_SQRT3_DIVBY_2 * pIn->fltArg2;
+
+	if (fltUa >= fltUb)
+	{
+		if (fltUb >= fltUc)			{ u16Sector = 1U; fltMax = fltUa; fltMin = fltUc; }
+		else if (fltUa >= fltUc)	{ u16Sector = 6U; fltMax = fltUa; fltMin = fltUb; }
+		else						{ u16Sector = 5U; fltMax = fltUc; fltMin = fltUb; }
+	}
+	else
+	{
+		if (fltUa >= fltUc)			{ u16Sector = 2U; fltMax = fltUb; fltMin = fltUc; }
+		else if (fltUb >= fltUc)	{ u16Sector = 3U; fltMax = fltUb; fltMin = fltUa; }
+		else						{ u16Sector = 4U; fltMax = fltUc; fltMin = fltUa; }
+	}
+
+	fltOffset = 0.5F * (fltMax + fltMin);
+
+	fltUa = 0.5F + (fltUa - fltOffset) * FLOAT_DIVBY_SQRT3;
+	fltUb = 0.5F + (fltUb - fltOffset) * FLOAT_DIVBY_SQRT3;
+	fltUc = 0.5F + (fltUc - fltOffset) * FLOAT_DIVBY_SQRT3;
+
+	pOut->fltArg1 = (fltUa > 1.0F) ? 1.0F : ((fltUa < 0.0F) ? 0.0F : fltUa);
+	pOut->fltArg2 = (fltUb > 1.0F) ? 1.0F : ((fltUb < 0.0F) ? 0.0F : fltUb);
+	pOut->fltArg3 = (fltUc > 1.0F) ? 1.0F : ((fltUc < 0.0F) ? 0.0F : fltUc);
+
+	return (u16Sector);
+}
@@ -0,0 +1,287 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     actuate_bench.c
+*
+* @date     March-28-2017
+*
+* @brief    Equivalence test and benchmark of ACTUATE_SetDutycycle
+*
+* Compares the ACTUATE_SetDutycycle of Sources/actuate_s32k.c
+* with the switch based reference (actuate_ref.c) for every sector 0..7 and
+* a grid of duty triplets covering the full range, including triplets that do
+* not match the sector, with the default and with modified pulse width
+* settings. All outputs (edges, pre-trigger delays, duty and center pulse
+* counts, PDB1 delay registers) have to be identical. The time per call of
+* both implementations is measured on sector consistent duties.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "S32K144.h"
+#include "actuate_s32k.h"
+#include "gmclib.h"
+#include "ftm_common.h"
+#include "sim_platform.h"
+
+/******************************************************************************
+| External declarations
+-----------------------------------------------------------------------------*/
+extern tBool ACTUATE_SetDutycycleRef(actuatePwm_t *ptr, SWLIBS_3Syst_FLT *fltpwm, tU16 sector);
+
+extern uint32_t					minZeroPulseCnt;
+extern uint32_t					minSamplingPulseCnt;
+extern uint32_t					minSumPulseCnt;
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define BENCH_GRID_STEP		20U			// duty grid step in FTM counts
+#define BENCH_RANDOM		1000000U	// random duty triplets per setting
+#define BENCH_SAMPLES		1024U		// timing input table length
+#define BENCH_PASSES		500U		// passes over the table per repetition
+#define BENCH_REPEAT		20U			// repetitions, the fastest one is reported
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+typedef struct
+{
+	PWM_3PHASE_EDGES_TYPE	edges;
+	SWLIBS_3Syst_U16		dutyCnt;
+	SWLIBS_3Syst_U16		halfWidthCnt;
+	tU16					pretrigDelay[5];
+	uint32_t				pdbDly[5];
+	tBool					state;
+}benchOutput_t;
+
+typedef tBool (*benchSetDuty_t)(actuatePwm_t *ptr, SWLIBS_3Syst_FLT *fltpwm, tU16 sector);
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static SWLIBS_3Syst_FLT		inDuty[BENCH_SAMPLES];
+static tU16					inSector[BENCH_SAMPLES];
+static actuatePwm_t			benchPwm = ACTUATE_PWM_BINDING(FTM3, 3U, PDB1, ADC1, 0U);
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Monotonic time in nanoseconds
+******************************************************************************/
+static double BENCH_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+}
+
+/**************************************************************************//*!
+@brief			Runs one implementation from a cleared state, returns all outputs
+******************************************************************************/
+static void BENCH_Call(benchSetDuty_t fcn, SWLIBS_3Syst_FLT *duty, tU16 sector, benchOutput_t *out)
+{
+	uint32_t i;
+
+	memset(&benchPwm.pwmEdgesFoc, 0xA5, sizeof(benchPwm.pwmEdgesFoc));
+	memset(&benchPwm.pwmDutyCnt, 0xA5, sizeof(benchPwm.pwmDutyCnt));
+	memset(&benchPwm.pwmCenterPulseHalfWidthCnt, 0xA5, sizeof(benchPwm.pwmCenterPulseHalfWidthCnt));
+	memset(benchPwm.pdbPretrigDelay, 0xA5, sizeof(benchPwm.pdbPretrigDelay));
+
+	memset(out, 0, sizeof(*out));
+	out->state			= fcn(&benchPwm, duty, sector);
+	out->edges			= benchPwm.pwmEdgesFoc;
+	out->dutyCnt		= benchPwm.pwmDutyCnt;
+	out->halfWidthCnt	= benchPwm.pwmCenterPulseHalfWidthCnt;
+	for (i = 0U; i < 5U; i++)
+	{
+		out->pretrigDelay[i] = benchPwm.pdbPretrigDelay[i];
+		out->pdbDly[i] = PDB1->CH[0].DLY[i];
+	}
+}
+
+/**************************************************************************//*!
+@brief			Compares both implementations for one input
+
+@return			1 when any output differs, 0 otherwise
+******************************************************************************/
+static unsigned long BENCH_Compare(SWLIBS_3Syst_FLT *duty, tU16 sector)
+{
+	static unsigned long	reported;
+	benchOutput_t			outRef, outNew;
+
+	BENCH_Call(ACTUATE_SetDutycycleRef, duty, sector, &outRef);
+	BENCH_Call(ACTUATE_SetDutycycle, duty, sector, &outNew);
+
+	if (memcmp(&outRef, &outNew, sizeof(outRef)) == 0)
+	{
+		return (0UL);
+	}
+	if (reported++ < 10UL)
+	{
+		printf("mismatch sector %u duty %.6f %.6f %.6f\n", (unsigned int)sector,
+			   (double)duty->fltArg1, (double)duty->fltArg2, (double)duty->fltArg3);
+	}
+	return (1UL);
+}
+
+/**************************************************************************//*!
+@brief			Compares both implementations over all sectors and the duty grid
+
+@return			Number of mismatching calls
+******************************************************************************/
+static unsigned long BENCH_Verify(unsigned long *calls)
+{
+	SWLIBS_3Syst_FLT	duty;
+	unsigned long		errors = 0UL;
+	uint32_t			a, b, c, k, seed = 0x9E3779B9U;
+	tU16				sector;
+
+	for (sector = 0U; sector < 8U; sector++)
+	{
+		for (a = 0U; a <= FTM_PERIOD_MOD; a += BENCH_GRID_STEP)
+		{
+			for (b = 0U; b <= FTM_PERIOD_MOD; b += BENCH_GRID_STEP)
+			{
+				for (c = 0U; c <= FTM_PERIOD_MOD; c += BENCH_GRID_STEP)
+				{
+					/* a quarter count offset exercises the float to count truncation */
+					duty.fltArg1 = ((tFloat)a + 0.25F) / (tFloat)FTM_PERIOD_MOD;
+					duty.fltArg2 = ((tFloat)b + 0.25F) / (tFloat)FTM_PERIOD_MOD;
+					duty.fltArg3 = ((tFloat)c + 0.25F) / (tFloat)FTM_PERIOD_MOD;
+					errors += BENCH_Compare(&duty, sector);
+					(*calls)++;
+				}
+			}
+		}
+	}
+
+	/* off-grid duties, every count difference around the sampling window limits */
+	for (k = 0U; k < BENCH_RANDOM; k++)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		sector = (tU16)(seed >> 29);
+		a = (seed >> 8) % (FTM_PERIOD_MOD + 1U);
+		seed = seed * 1664525U + 1013904223U;
+		b = (a + (seed >> 24) - 128U) % (FTM_PERIOD_MOD + 1U);
+		c = (b + ((seed >> 8) & 0xFFU) - 128U) % (FTM_PERIOD_MOD + 1U);
+		duty.fltArg1 = (tFloat)a / (tFloat)FTM_PERIOD_MOD;
+		duty.fltArg2 = (tFloat)b / (tFloat)FTM_PERIOD_MOD;
+		duty.fltArg3 = (tFloat)c / (tFloat)FTM_PERIOD_MOD;
+		errors += BENCH_Compare(&duty, sector);
+		(*calls)++;
+	}
+
+	return (errors);
+}
+
+/**************************************************************************//*!
+@brief			Fills the timing table with SVM duties and their sectors
+******************************************************************************/
+static void BENCH_Inputs(void)
+{
+	SWLIBS_2Syst_FLT	uAlBe;
+	uint32_t			seed = 0x12345678U;
+	uint32_t			k;
+
+	for (k = 0U; k < BENCH_SAMPLES; k++)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		uAlBe.fltArg1 = 0.6F * (tFloat)((int32_t)seed) * (1.0F / 2147483648.0F);
+		seed = seed * 1664525U + 1013904223U;
+		uAlBe.fltArg2 = 0.6F * (tFloat)((int32_t)seed) * (1.0F / 2147483648.0F);
+		inSector[k] = (tU16)GMCLIB_SvmStd(&inDuty[k], &uAlBe);
+	}
+}
+
+/**************************************************************************//*!
+@brief			Time per call of one pass over the timing table
+******************************************************************************/
+static double BENCH_Time(benchSetDuty_t fcn)
+{
+	double		ns;
+	uint32_t	pass, k;
+
+	ns = BENCH_Now();
+	for (pass = 0U; pass < BENCH_PASSES; pass++)
+	{
+		for (k = 0U; k < BENCH_SAMPLES; k++)
+		{
+			(void)fcn(&benchPwm, &inDuty[k], inSector[k]);
+		}
+	}
+	ns = BENCH_Now() - ns;
+
+	return (ns / ((double)BENCH_PASSES * (double)BENCH_SAMPLES));
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			The bench never enables the outputs, FTM3 is not simulated here
+******************************************************************************/
+status_t FTM_DRV_MaskOutputChannels(uint32_t instance, uint32_t channelsMask, bool softwareTrigger)
+{
+	(void)instance;
+	(void)channelsMask;
+	(void)softwareTrigger;
+
+	return (STATUS_SUCCESS);
+}
+
+/**************************************************************************//*!
+@brief			Runs the equivalence test and the benchmark
+******************************************************************************/
+int main(void)
+{
+	unsigned long	calls = 0UL, errors;
+	double			ns, nsRef = 1.0e30, nsNew = 1.0e30;
+	uint32_t		rep;
+
+	SIM_PlatformInit();
+
+	/* default pulse widths */
+	errors = BENCH_Verify(&calls);
+
+	/* modified pulse widths and trigger offset, minSumPulseCnt not in sync */
+	minZeroPulseCnt		= 40U;
+	minSamplingPulseCnt	= 200U;
+	minSumPulseCnt		= 300U;
+	pdbTriggerOffset	= 60U;
+	errors += BENCH_Verify(&calls);
+
+	minZeroPulseCnt		= 80U;
+	minSamplingPulseCnt	= 120U;
+	minSumPulseCnt		= 200U;
+	pdbTriggerOffset	= 40U;
+
+	printf("ACTUATE_SetDutycycle   %lu calls compared, %lu mismatches\n", calls, errors);
+
+	/* both implementations alternate, so a frequency change affects both alike */
+	BENCH_Inputs();
+	for (rep = 0U; rep < BENCH_REPEAT; rep++)
+	{
+		ns = BENCH_Time(ACTUATE_SetDutycycleRef);
+		nsRef = (ns < nsRef) ? ns : nsRef;
+		ns = BENCH_Time(ACTUATE_SetDutycycle);
+		nsNew = (ns < nsNew) ? ns : nsNew;
+	}
+	printf("switch reference       %8.2f ns/call\n", nsRef);
+	printf("sector switch inlined  %8.2f ns/call\n", nsNew);
+
+	return ((errors == 0UL) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
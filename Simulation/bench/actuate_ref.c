@@ -0,0 +1,335 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     actuate_ref.c
+*
+* @date     March-28-2017
+*
+* @brief    Reference ACTUATE_SetDutycycle for the actuator benchmark
+*
+* Verbatim copy of the switch based ACTUATE_SetDutycycle with six written out
+* cases, which the shared sector body in Sources/actuate_s32k.c replaced,
+* renamed and moved out of the RAM section. It writes the same actuator variables.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "S32K144.h"
+#include "actuate_s32k.h"
+#include "gflib.h"
+
+/******************************************************************************
+| External declarations
+-----------------------------------------------------------------------------*/
+extern uint32_t					minZeroPulseCnt;
+extern uint32_t					minSamplingPulseCnt;
+extern uint32_t					minSumPulseCnt;
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief Set PWM dytycyle, switch based reference implementation
+
+@param	ptr,                    input, PWM actuator of the inverter
+		fltpwm,                 input, pwm duty in float format
+		sector,                 input, sector number used to sort the 3 phase duties;
+
+@return
+******************************************************************************/
+tBool ACTUATE_SetDutycycleRef(actuatePwm_t *ptr, SWLIBS_3Syst_FLT *fltpwm, tU16 sector)
+{
+	tBool   state_pwm = true;
+	tU32    diffUV, diffVW, diffWU, temp;
+
+	ptr->pwmDutyCnt.u16Arg1 = MLIB_Mul(fltpwm->fltArg1, FTM_PERIOD_MOD);
+	ptr->pwmDutyCnt.u16Arg2 = MLIB_Mul(fltpwm->fltArg2, FTM_PERIOD_MOD);
+	ptr->pwmDutyCnt.u16Arg3 = MLIB_Mul(fltpwm->fltArg3, FTM_PERIOD_MOD);
+
+	switch (sector) {
+	case 1:		//duty A > duty B > duty C
+		diffUV = ptr->pwmDutyCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg2;
+		diffVW = ptr->pwmDutyCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffVW)<minSamplingPulseCnt)?(minSumPulseCnt - diffVW):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffUV)<(temp - minZeroPulseCnt))?(temp - diffUV):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhA current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhC current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhC current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhA current sampling
+
+		break;
+
+	case 2:		//duty B > duty A > duty C
+		diffUV = ptr->pwmDutyCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg1;
+		diffWU = ptr->pwmDutyCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffWU)<minSamplingPulseCnt)?(minSumPulseCnt - diffWU):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffUV)<(temp - minZeroPulseCnt))?(temp - diffUV):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhB current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhC current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhC current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhB current sampling
+
+
+		break;
+
+	case 3:		//duty B > duty C > duty A
+		diffWU = ptr->pwmDutyCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg1;
+		diffVW = ptr->pwmDutyCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffWU)<minSamplingPulseCnt)?(minSumPulseCnt - diffWU):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffVW)<(temp - minZeroPulseCnt))?(temp - diffVW):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhB current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhA current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhA current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhB current sampling
+
+		break;
+
+	case 4:		//duty C > duty B > duty A
+		diffUV = ptr->pwmDutyCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg1;
+		diffVW = ptr->pwmDutyCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg2;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffUV)<minSamplingPulseCnt)?(minSumPulseCnt - diffUV):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffVW)<(temp - minZeroPulseCnt))?(temp - diffVW):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhC current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhA current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhA current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhC current sampling
+
+		break;
+
+	case 5:		//duty C > duty A > duty B
+		diffUV = ptr->pwmDutyCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg2;
+		diffWU = ptr->pwmDutyCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg1;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffUV)<minSamplingPulseCnt)?(minSumPulseCnt - diffUV):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffWU)<(temp - minZeroPulseCnt))?(temp - diffWU):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhC current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhB current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhB current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhC current sampling
+
+		break;
+
+	case 6:		//duty A > duty C > duty B
+		diffWU = ptr->pwmDutyCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg3;
+		diffVW = ptr->pwmDutyCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg2;
+
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = minZeroPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffVW)<minSamplingPulseCnt)?(minSumPulseCnt - diffVW):minZeroPulseCnt;
+		temp         				       = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + minSamplingPulseCnt;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffWU)<(temp - minZeroPulseCnt))?(temp - diffWU):minZeroPulseCnt;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhA current sampling
+		ptr->pdbPretrigDelay[1] = ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhB current sampling
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhB current sampling
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD + ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhA current sampling
+
+		break;
+
+	default:
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = 80;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = 80;
+		ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = 80;
+
+		//Calculate Phase A B C PWM edges for consecutive two periods;
+		//PhaseA 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 - ptr->pwmDutyCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		//PhaseA 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1;
+		ptr->pwmEdgesFoc.EdgesPhaseA.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 + ptr->pwmDutyCnt.u16Arg1;
+
+		//PhaseB 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 - ptr->pwmDutyCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		//PhaseB 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2;
+		ptr->pwmEdgesFoc.EdgesPhaseB.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 + ptr->pwmDutyCnt.u16Arg2;
+
+		//PhaseC 1st 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 - ptr->pwmDutyCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		//PhaseC 2nd 25uS PWM Edges;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge3 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3;
+		ptr->pwmEdgesFoc.EdgesPhaseC.u16Edge4 = ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 + ptr->pwmDutyCnt.u16Arg3;
+
+		ptr->pdbPretrigDelay[0] = FTM_PERIOD_MOD-600;
+		ptr->pdbPretrigDelay[1] = FTM_PERIOD_MOD-400;
+		ptr->pdbPretrigDelay[2] = FTM_PERIOD_MOD;
+		ptr->pdbPretrigDelay[3] = FTM_PERIOD_MOD+400;
+		ptr->pdbPretrigDelay[4] = FTM_PERIOD_MOD+600;
+
+		break;
+}
+
+	ACTUATE_PdbUpdatePretrigDelay(ptr);
+
+	state_pwm = false;
+
+	return(state_pwm);
+}
+
+/* End of file */
@@ -0,0 +1,357 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     cloop_bench.c
+*
+* @date     April-20-2017
+*
+* @brief    Step response and benchmark of the dq current controllers
+*
+* Runs AMCLIB_CurrentLoop_FLT with the motor_tune.h gains and the deadbeat
+* controller of Sources/cloop_deadbeat.c against the continuous dq model of
+* the motor at constant speed. The current is sampled CLOOP_DB_SAMPLE after
+* the start of every control loop, the voltage written by a loop is applied
+* from the start of the next one on, as with the PDB1 reload of the target.
+* After the loops settled at zero current the q-axis reference steps, the
+* control loops to 90% and into the 2% band, the overshoot and the d-axis
+* excursion are printed per case, including plant parameters off the
+* controller model and a step beyond the voltage limit. The time per call of
+* both controllers is measured on the settled loop. The deadbeat controller
+* with the gain 1 has to settle within 2 control loops without overshoot
+* with the exact model, else the exit code is a failure.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "gflib.h"
+#include "amclib.h"
+#include "PMSM_appconfig.h"
+#include "motor_tune.h"
+#include "cloop_deadbeat.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define BENCH_UDCB			(12.0F)		// DC bus voltage [V]
+#define BENCH_SUBSTEPS		120U		// plant integration steps per control loop, a multiple of FOC_PWM_PERIODS
+#define BENCH_PRE_LOOPS		200U		// control loops at zero current before the step
+#define BENCH_LOOPS			40U			// control loops of the step response
+#define BENCH_BAND			(0.02)		// settling band, share of the step
+#define BENCH_CALLS			100000U		// calls per timing repetition
+#define BENCH_REPEAT		20U			// repetitions, the fastest one is reported
+#define BENCH_DB_SETTLE		2U			// control loops of the deadbeat with the gain 1 and the exact model
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+typedef struct
+{
+	const char				*name;
+	double					wEl;		// electrical speed [rad/s]
+	double					rsScale;	// plant parameters over the controller model
+	double					lScale;
+	double					keScale;
+	tFloat					iqStep;		// q-axis reference step [A]
+	tBool					exact;		// plant of the controller model within the voltage limit
+}benchCase_t;
+
+typedef struct
+{
+	unsigned int			rise;		// control loops to 90% of the step, 0 not reached
+	unsigned int			settle;		// control loops into the band for good, 0 not settled
+	double					overshoot;	// beyond the step, share of the step
+	double					idPeak;		// largest d-axis current [A]
+}benchResult_t;
+
+typedef struct
+{
+	double					id;
+	double					iq;
+}benchPlant_t;
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static const benchCase_t	benchCases[] =
+{
+	{ "standstill",				0.0,	1.0,	1.0,	1.0,	1.0F,	TRUE },
+	{ "750rpm",					157.08,	1.0,	1.0,	1.0,	1.0F,	TRUE },
+	{ "750rpm L +30%",			157.08,	1.0,	1.3,	1.0,	1.0F,	FALSE },
+	{ "750rpm L -30%",			157.08,	1.0,	0.7,	1.0,	1.0F,	FALSE },
+	{ "750rpm Rs +50% Ke -10%",	157.08,	1.5,	1.0,	0.9,	1.0F,	FALSE },
+	{ "1500rpm saturated",		314.16,	1.0,	1.0,	1.0,	2.0F,	FALSE },
+};
+
+static motorParam_t				benchParam;
+static SWLIBS_2Syst_FLT			benchIDQReq;
+static SWLIBS_2Syst_FLT			benchIDQFbck;
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Monotonic time in nanoseconds
+******************************************************************************/
+static double BENCH_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+}
+
+/**************************************************************************//*!
+@brief			Current derivative of the dq model
+******************************************************************************/
+static void BENCH_Deriv(const benchPlant_t *x, const benchCase_t *c, double ud, double uq, benchPlant_t *dx)
+{
+	double rs = c->rsScale * (double)benchParam.rs;
+	double ld = c->lScale * (double)benchParam.ld;
+	double lq = c->lScale * (double)benchParam.lq;
+	double ke = c->keScale * (double)benchParam.ke;
+
+	dx->id = (ud - rs * x->id + c->wEl * lq * x->iq) / ld;
+	dx->iq = (uq - rs * x->iq - c->wEl * (ld * x->id + ke)) / lq;
+}
+
+/**************************************************************************//*!
+@brief			Part of a control loop of the plant with a constant voltage, RK4
+
+@param[in]		steps	Integration steps, BENCH_SUBSTEPS a control loop
+******************************************************************************/
+static void BENCH_Plant(benchPlant_t *x, const benchCase_t *c, const SWLIBS_2Syst_FLT *u, uint32_t steps)
+{
+	benchPlant_t	k1, k2, k3, k4, y;
+	double			h = (double)CLOOP_DB_TS / (double)BENCH_SUBSTEPS;
+	uint32_t		n;
+
+	for (n = 0U; n < steps; n++)
+	{
+		BENCH_Deriv(x, c, u->fltArg1, u->fltArg2, &k1);
+		y.id = x->id + 0.5 * h * k1.id;		y.iq = x->iq + 0.5 * h * k1.iq;
+		BENCH_Deriv(&y, c, u->fltArg1, u->fltArg2, &k2);
+		y.id = x->id + 0.5 * h * k2.id;		y.iq = x->iq + 0.5 * h * k2.iq;
+		BENCH_Deriv(&y, c, u->fltArg1, u->fltArg2, &k3);
+		y.id = x->id + h * k3.id;			y.iq = x->iq + h * k3.iq;
+		BENCH_Deriv(&y, c, u->fltArg1, u->fltArg2, &k4);
+		x->id += h / 6.0 * (k1.id + 2.0 * k2.id + 2.0 * k3.id + k4.id);
+		x->iq += h / 6.0 * (k1.iq + 2.0 * k2.iq + 2.0 * k3.iq + k4.iq);
+	}
+}
+
+/**************************************************************************//*!
+@brief			Current loop with the PI controllers of the application
+******************************************************************************/
+static void BENCH_PiInit(AMCLIB_CURRENT_LOOP_T_FLT *pCtrl, const tuneGains_t *pGains)
+{
+	pCtrl->pPIrAWD.fltCC1sc			= pGains->dCC1sc;
+	pCtrl->pPIrAWD.fltCC2sc			= pGains->dCC2sc;
+	pCtrl->pPIrAWD.fltLowerLimit	= MLIB_Neg(CLOOP_LIMIT);
+	pCtrl->pPIrAWD.fltUpperLimit	= CLOOP_LIMIT;
+	pCtrl->pPIrAWQ.fltCC1sc			= pGains->qCC1sc;
+	pCtrl->pPIrAWQ.fltCC2sc			= pGains->qCC2sc;
+	pCtrl->pPIrAWQ.fltLowerLimit	= MLIB_Neg(CLOOP_LIMIT);
+	pCtrl->pPIrAWQ.fltUpperLimit	= CLOOP_LIMIT;
+	pCtrl->pIDQReq					= &benchIDQReq;
+	pCtrl->pIDQFbck					= &benchIDQFbck;
+	AMCLIB_CurrentLoopInit_FLT(pCtrl);
+}
+
+/**************************************************************************//*!
+@brief			Step response of one controller in one case
+
+@param[in]		deadbeat	FALSE the PI controllers, TRUE the deadbeat one
+@param[in]		dbGain		Gain of the deadbeat controller
+******************************************************************************/
+static void BENCH_Step(const benchCase_t *c, tBool deadbeat, tFloat dbGain, const tuneGains_t *pGains,
+					   benchResult_t *r, double *pNs)
+{
+	AMCLIB_CURRENT_LOOP_T_FLT	pi;
+	cloopDeadbeat_t				db;
+	benchPlant_t				x = { 0.0, 0.0 };
+	SWLIBS_2Syst_FLT			uDQReq = { 0.0F, 0.0F }, uApplied = { 0.0F, 0.0F };
+	double						e, ns, nsMin = 1.0e30;
+	uint32_t					k, n, rep, newSteps;
+
+	// Steps from the loop start to the sample, the new voltage is applied during them
+	newSteps = (uint32_t)((tFloat)BENCH_SUBSTEPS * CLOOP_DB_SAMPLE + 0.5F);
+
+	BENCH_PiInit(&pi, pGains);
+	db.gain		= dbGain;
+	db.obsGain	= CLOOP_DB_OBS_GAIN;
+	CLOOP_DeadbeatSetModel(&db, &benchParam, CLOOP_DB_TS);
+	CLOOP_DeadbeatInit(&db);
+
+	benchIDQReq.fltArg1 = 0.0F;
+	benchIDQReq.fltArg2 = 0.0F;
+
+	r->rise			= 0U;
+	r->settle		= 0U;
+	r->overshoot	= 0.0;
+	r->idPeak		= 0.0;
+
+	for (k = 0U; k < (BENCH_PRE_LOOPS + BENCH_LOOPS); k++)
+	{
+		if (k == BENCH_PRE_LOOPS)
+		{
+			benchIDQReq.fltArg2 = c->iqStep;
+		}
+
+		// Sample, compute, the voltage of the last loop is still applied until the loop ends
+		benchIDQFbck.fltArg1 = (tFloat)x.id;
+		benchIDQFbck.fltArg2 = (tFloat)x.iq;
+		if (deadbeat)
+		{
+			CLOOP_DeadbeatUpdate(&db, BENCH_UDCB, &uDQReq, &pi, (tFloat)c->wEl);
+		}
+		else
+		{
+			AMCLIB_CurrentLoop_FLT(BENCH_UDCB, &uDQReq, &pi);
+		}
+		BENCH_Plant(&x, c, &uApplied, BENCH_SUBSTEPS - newSteps);
+		uApplied = uDQReq;
+		BENCH_Plant(&x, c, &uApplied, newSteps);
+
+		if (k >= BENCH_PRE_LOOPS)
+		{
+			n = k + 1U - BENCH_PRE_LOOPS;
+			e = (x.iq - (double)c->iqStep) / (double)c->iqStep;
+			if ((r->rise == 0U) && (e >= -0.1))
+			{
+				r->rise = n;
+			}
+			if ((e > BENCH_BAND) || (e < -BENCH_BAND))
+			{
+				r->settle = n + 1U;
+			}
+			else if (r->settle == 0U)
+			{
+				r->settle = n;
+			}
+			if (e > r->overshoot)
+			{
+				r->overshoot = e;
+			}
+			if (((x.id < 0.0) ? -x.id : x.id) > r->idPeak)
+			{
+				r->idPeak = (x.id < 0.0) ? -x.id : x.id;
+			}
+		}
+	}
+
+	if (r->settle > BENCH_LOOPS)
+	{
+		r->settle = 0U;
+	}
+
+	// Time per call on the settled loop, the feedback kept at the last sample
+	for (rep = 0U; rep < BENCH_REPEAT; rep++)
+	{
+		ns = BENCH_Now();
+		for (n = 0U; n < BENCH_CALLS; n++)
+		{
+			if (deadbeat)
+			{
+				CLOOP_DeadbeatUpdate(&db, BENCH_UDCB, &uDQReq, &pi, (tFloat)c->wEl);
+			}
+			else
+			{
+				AMCLIB_CurrentLoop_FLT(BENCH_UDCB, &uDQReq, &pi);
+			}
+		}
+		ns = (BENCH_Now() - ns) / (double)BENCH_CALLS;
+		nsMin = (ns < nsMin) ? ns : nsMin;
+	}
+	*pNs = nsMin;
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Control loop count of a result, "-" for none
+******************************************************************************/
+static const char *BENCH_Loops(char *buf, unsigned int loops)
+{
+	if (loops == 0U)
+	{
+		return ("-");
+	}
+	sprintf(buf, "%u", loops);
+	return (buf);
+}
+
+/**************************************************************************//*!
+@brief			Runs all cases with both controllers
+******************************************************************************/
+int main(void)
+{
+	tuneMotor_t		tune;
+	benchResult_t	r;
+	double			ns, nsPi = 1.0e30, nsDb = 1.0e30;
+	uint32_t		c, deadbeat;
+	char			bufRise[12], bufSettle[12];
+	tBool			ok;
+	int				status = EXIT_SUCCESS;
+
+	TUNE_Init(&tune);
+	if (!TUNE_Design(&tune.gains, &tune.param, &tune.spec))
+	{
+		printf("gain synthesis rejected the default motor\n");
+		return (EXIT_FAILURE);
+	}
+	benchParam = tune.param;
+
+	printf("q-axis current step, %u us control loop, %.1f V, limit %.2f, deadbeat gain %.2f\n",
+		   (unsigned int)FOC_PERIOD_US, (double)BENCH_UDCB, (double)CLOOP_LIMIT, (double)CLOOP_DB_GAIN);
+	printf("case                     controller  step[A]  90%%[loops]  2%%[loops]  overshoot  |id|max[A]\n");
+	for (c = 0U; c < (sizeof(benchCases) / sizeof(benchCases[0])); c++)
+	{
+		for (deadbeat = 0U; deadbeat < 2U; deadbeat++)
+		{
+			BENCH_Step(&benchCases[c], (tBool)deadbeat, CLOOP_DB_GAIN, &tune.gains, &r, &ns);
+			if (deadbeat)
+			{
+				nsDb = (ns < nsDb) ? ns : nsDb;
+			}
+			else
+			{
+				nsPi = (ns < nsPi) ? ns : nsPi;
+			}
+			printf("%-24s %-10s  %7.2f  %11s  %10s  %8.1f%%  %10.3f\n", benchCases[c].name,
+				   deadbeat ? "deadbeat" : "PI", (double)benchCases[c].iqStep, BENCH_Loops(bufRise, r.rise),
+				   BENCH_Loops(bufSettle, r.settle), 100.0 * r.overshoot, r.idPeak);
+		}
+	}
+	printf("AMCLIB_CurrentLoop_FLT %8.2f ns/call\n", nsPi);
+	printf("CLOOP_DeadbeatUpdate   %8.2f ns/call\n", nsDb);
+
+	// Deadbeat with the gain 1 on the exact model
+	for (c = 0U; c < (sizeof(benchCases) / sizeof(benchCases[0])); c++)
+	{
+		if (!benchCases[c].exact)
+		{
+			continue;
+		}
+		BENCH_Step(&benchCases[c], TRUE, 1.0F, &tune.gains, &r, &ns);
+		ok = (r.settle != 0U) && (r.settle <= BENCH_DB_SETTLE) && (r.overshoot <= BENCH_BAND);
+		if (!ok)
+		{
+			status = EXIT_FAILURE;
+		}
+		printf("deadbeat gain 1 %-24s %s loops, overshoot %.1f%%: %s\n", benchCases[c].name,
+			   BENCH_Loops(bufSettle, r.settle), 100.0 * r.overshoot, ok ? "ok" : "FAILED");
+	}
+
+	return (status);
+}
@@ -0,0 +1,118 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     freemaster.h
+*
+* @date     March-28-2017
+*
+* @brief    FreeMASTER driver API - host simulation stand-in
+*
+* @details	The target driver lives in a submodule which is not part of the
+*			host build. This header keeps the API used by the application and
+*			expands the TSA macros to real tables, so every TSA entry of
+*			PMSM_appfreemaster_TSA.h is checked by the compiler (member names,
+*			variable names) and can be listed by the simulator.
+*
+*******************************************************************************/
+#ifndef _FREEMASTER_H_
+#define _FREEMASTER_H_
+
+#include <stddef.h>
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Entry information flags */
+#define FMSTR_TSA_INFO_STRUCT		0U
+#define FMSTR_TSA_INFO_MEMBER		1U
+#define FMSTR_TSA_INFO_RO_VAR		2U
+#define FMSTR_TSA_INFO_RW_VAR		3U
+
+/* Type codes */
+#define FMSTR_TSA_UINT8				"u8"
+#define FMSTR_TSA_UINT16			"u16"
+#define FMSTR_TSA_UINT32			"u32"
+#define FMSTR_TSA_SINT8				"s8"
+#define FMSTR_TSA_SINT16			"s16"
+#define FMSTR_TSA_SINT32			"s32"
+#define FMSTR_TSA_FRAC16			"f16"
+#define FMSTR_TSA_FRAC32			"f32"
+#define FMSTR_TSA_FLOAT				"flt"
+#define FMSTR_TSA_DOUBLE			"dbl"
+#define FMSTR_TSA_USERTYPE(type)	#type
+
+/* Table definition */
+#define FMSTR_TSA_TABLE_BEGIN(id) \
+	const FMSTR_TSA_ENTRY *FMSTR_TsaGetTable_##id(unsigned int *pTableSize); \
+	const FMSTR_TSA_ENTRY *FMSTR_TsaGetTable_##id(unsigned int *pTableSize) \
+	{ \
+		static const FMSTR_TSA_ENTRY fmstr_tsatable[] = {
+
+#define FMSTR_TSA_TABLE_END() \
+		}; \
+		if (pTableSize) *pTableSize = (unsigned int)(sizeof(fmstr_tsatable) / sizeof(fmstr_tsatable[0])); \
+		return fmstr_tsatable; \
+	}
+
+#define FMSTR_TSA_STRUCT(type) \
+		{ #type, NULL, NULL, 0U, sizeof(type), FMSTR_TSA_INFO_STRUCT },
+
+#define FMSTR_TSA_MEMBER(parenttype, name, type) \
+		{ #name, type, NULL, offsetof(parenttype, name), sizeof(((parenttype *)0)->name), FMSTR_TSA_INFO_MEMBER },
+
+#define FMSTR_TSA_RO_VAR(name, type) \
+		{ #name, type, (const volatile void *)&(name), 0U, sizeof(name), FMSTR_TSA_INFO_RO_VAR },
+
+#define FMSTR_TSA_RW_VAR(name, type) \
+		{ #name, type, (const volatile void *)&(name), 0U, sizeof(name), FMSTR_TSA_INFO_RW_VAR },
+
+#define FMSTR_TSA_RO_MEM(name, type, addr, size) \
+		{ #name, type, (const volatile void *)(addr), 0U, (size), FMSTR_TSA_INFO_RO_VAR },
+
+#define FMSTR_TSA_RW_MEM(name, type, addr, size) \
+		{ #name, type, (const volatile void *)(addr), 0U, (size), FMSTR_TSA_INFO_RW_VAR },
+
+/* Table list */
+#define FMSTR_TSA_TABLE_LIST_BEGIN() \
+	const FMSTR_TSA_GET_TABLE_FUNC FMSTR_TsaTableList[] = {
+
+#define FMSTR_TSA_TABLE(id)			FMSTR_TsaGetTable_##id,
+
+#define FMSTR_TSA_TABLE_LIST_END() \
+		NULL \
+	};
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+typedef unsigned char FMSTR_BOOL;
+
+typedef struct
+{
+	const char					*name;		/*! variable, member or structure name */
+	const char					*type;		/*! type code or user type name */
+	const volatile void			*addr;		/*! variable address, NULL for structures and members */
+	size_t						offset;		/*! member offset */
+	size_t						size;		/*! size in bytes */
+	unsigned int				info;		/*! FMSTR_TSA_INFO_xxx */
+}FMSTR_TSA_ENTRY;
+
+typedef const FMSTR_TSA_ENTRY *(*FMSTR_TSA_GET_TABLE_FUNC)(unsigned int *pTableSize);
+
+/******************************************************************************
+| Exported Variables
+-----------------------------------------------------------------------------*/
+extern const FMSTR_TSA_GET_TABLE_FUNC FMSTR_TsaTableList[];
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern FMSTR_BOOL	FMSTR_Init(void);
+extern void			FMSTR_Poll(void);
+extern void			FMSTR_Recorder(void);
+
+#endif /* _FREEMASTER_H_ */
@@ -0,0 +1,17 @@
+/*******************************************************************************
+*
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     s32k144.h
+*
+* @date     March-28-2017
+*
+* @brief    Lower-case alias of the device header
+*
+* @details	meas_s32k.h includes "s32k144.h", which resolves on the
+*			case-insensitive Windows file system only.
+*
+*******************************************************************************/
+#include "S32K144.h"
@@ -0,0 +1,189 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pmsm_plant.c
+*
+* @date     March-28-2017
+*
+* @brief    PMSM plant model of the host simulation
+*
+* @details	Rotor frame model of a surface/interior PM synchronous motor
+*				Ld*did/dt = ud - Rs*id + wEl*Lq*iq
+*				Lq*diq/dt = uq - Rs*iq - wEl*Ld*id - wEl*Psi
+*				Te        = 1.5*pp*(Psi*iq + (Ld - Lq)*id*iq)
+*				J*dw/dt   = Te - Tload - B*w
+*			With ldSat the incremental d-axis inductance Ld/(1 + ldSat*id)
+*			stands for the iron saturated by the magnet flux, stator current
+*			along the magnet lowers it and current against it raises it.
+*			The model is integrated by semi-implicit Euler, the resistive term is taken
+*			implicitly so the step is stable for any step size. The rotor
+*			position is propagated as a rotating unit vector, so no sin/cos
+*			evaluation is needed per step.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <math.h>
+#include "pmsm_plant.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define PLANT_PI			(3.14159265358979323846)
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Recalculates the implicit resistive step coefficients
+******************************************************************************/
+static void PLANT_UpdateCoef(pmsmPlant_t *ptr, double h)
+{
+	ptr->stepCoefH	= h;
+	ptr->dCoefA		= 1.0 / (1.0 + h * ptr->param.rs / ptr->param.ld);
+	ptr->dCoefB		= ptr->dCoefA * h / ptr->param.ld;
+	ptr->qCoefA		= 1.0 / (1.0 + h * ptr->param.rs / ptr->param.lq);
+	ptr->qCoefB		= ptr->qCoefA * h / ptr->param.lq;
+	ptr->mechCoef	= h / ptr->param.j;
+}
+
+/**************************************************************************//*!
+@brief			Mechanical step and rotation of the position vector
+******************************************************************************/
+static void PLANT_StepMech(pmsmPlant_t *ptr)
+{
+	double tLoad, delta, delta2, sinD, cosD, c, s, norm;
+
+	/* Load torque always opposes the rotation */
+	tLoad = (ptr->wMech > 0.0) ? ptr->tLoad : ((ptr->wMech < 0.0) ? -ptr->tLoad : 0.0);
+
+	ptr->wMech	+= ptr->mechCoef * (ptr->te - tLoad - ptr->param.b * ptr->wMech);
+	ptr->wEl	 = ptr->param.pp * ptr->wMech;
+
+	delta		= ptr->wEl * ptr->stepCoefH;
+	ptr->thEl	+= delta;
+	if (ptr->thEl >= PLANT_PI)			ptr->thEl -= 2.0 * PLANT_PI;
+	else if (ptr->thEl < -PLANT_PI)		ptr->thEl += 2.0 * PLANT_PI;
+
+	/* Rotation by delta, the angle step is well below 0.1 rad per step */
+	delta2	= delta * delta;
+	sinD	= delta * (1.0 - delta2 * (1.0 / 6.0));
+	cosD	= 1.0 - delta2 * (0.5 - delta2 * (1.0 / 24.0));
+	c		= ptr->cosTh * cosD - ptr->sinTh * sinD;
+	s		= ptr->sinTh * cosD + ptr->cosTh * sinD;
+
+	/* One Newton step keeps the vector on the unit circle */
+	norm		= 1.5 - 0.5 * (c * c + s * s);
+	ptr->cosTh	= c * norm;
+	ptr->sinTh	= s * norm;
+
+	ptr->iAlpha	= ptr->id * ptr->cosTh - ptr->iq * ptr->sinTh;
+	ptr->iBeta	= ptr->id * ptr->sinTh + ptr->iq * ptr->cosTh;
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Plant initialization, motor at standstill in the aligned position
+
+@param[out]		ptr		Plant structure
+@param[in]		param	Motor parameters
+******************************************************************************/
+void PLANT_Init(pmsmPlant_t *ptr, const plantParam_t *param)
+{
+	ptr->param		= *param;
+	ptr->id			= 0.0;
+	ptr->iq			= 0.0;
+	ptr->iAlpha		= 0.0;
+	ptr->iBeta		= 0.0;
+	ptr->wMech		= 0.0;
+	ptr->wEl		= 0.0;
+	ptr->te			= 0.0;
+	ptr->tLoad		= 0.0;
+	ptr->uDInt		= 0.0;
+	ptr->uQInt		= 0.0;
+
+	PLANT_SetPosition(ptr, 0.0);
+	PLANT_UpdateCoef(ptr, 1.0e-6);
+}
+
+/**************************************************************************//*!
+@brief			Sets the electrical rotor position
+
+@param[in,out]	ptr		Plant structure
+@param[in]		thEl	Electrical position [rad]
+******************************************************************************/
+void PLANT_SetPosition(pmsmPlant_t *ptr, double thEl)
+{
+	ptr->thEl	= atan2(sin(thEl), cos(thEl));
+	ptr->cosTh	= cos(ptr->thEl);
+	ptr->sinTh	= sin(ptr->thEl);
+}
+
+/**************************************************************************//*!
+@brief			One integration step with the given stator voltage
+
+@param[in,out]	ptr		Plant structure
+@param[in]		uAlpha	Alpha stator voltage, constant during the step [V]
+@param[in]		uBeta	Beta stator voltage, constant during the step [V]
+@param[in]		h		Step size [s]
+******************************************************************************/
+void PLANT_Step(pmsmPlant_t *ptr, double uAlpha, double uBeta, double h)
+{
+	double ud, uq, wEl, ldInc;
+
+	if (h != ptr->stepCoefH)
+	{
+		PLANT_UpdateCoef(ptr, h);
+	}
+
+	if (ptr->param.ldSat != 0.0)
+	{
+		ldInc		= ptr->param.ld / fmax(1.0 + ptr->param.ldSat * ptr->id, 0.5);
+		ptr->dCoefA	= 1.0 / (1.0 + h * ptr->param.rs / ldInc);
+		ptr->dCoefB	= ptr->dCoefA * h / ldInc;
+	}
+
+	ud	= uAlpha * ptr->cosTh + uBeta * ptr->sinTh;
+	uq	= uBeta * ptr->cosTh - uAlpha * ptr->sinTh;
+	wEl	= ptr->wEl;
+	ptr->uDInt += ud * h;
+	ptr->uQInt += uq * h;
+
+	ptr->id = ptr->dCoefA * ptr->id + ptr->dCoefB * (ud + wEl * ptr->param.lq * ptr->iq);
+	ptr->iq = ptr->qCoefA * ptr->iq + ptr->qCoefB * (uq - wEl * (ptr->param.ld * ptr->id + ptr->param.psi));
+	ptr->te = 1.5 * ptr->param.pp * ptr->iq * (ptr->param.psi + (ptr->param.ld - ptr->param.lq) * ptr->id);
+
+	PLANT_StepMech(ptr);
+}
+
+/**************************************************************************//*!
+@brief			One integration step with all inverter switches off
+
+@param[in,out]	ptr		Plant structure
+@param[in]		h		Step size [s]
+
+@details		The stator is treated as open circuit, the free-wheeling diodes
+				are not modelled. The motor coasts.
+******************************************************************************/
+void PLANT_Open(pmsmPlant_t *ptr, double h)
+{
+	ptr->id	= 0.0;
+	ptr->iq	= 0.0;
+	ptr->te	= 0.0;
+
+	if (h != ptr->stepCoefH)
+	{
+		PLANT_UpdateCoef(ptr, h);
+	}
+
+	PLANT_StepMech(ptr);
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pmsm_plant.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the PMSM plant model of the host simulation
+*
+*******************************************************************************/
+#ifndef _PMSM_PLANT_H_
+#define _PMSM_PLANT_H_
+
+#include "PMSM_appconfig.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Default motor parameters, LINIX 45ZWN24-40 as listed in the MCAT header of
+ * PMSM_appconfig.h. Only the pole-pair number is available as a macro there.
+ * Cross-check: WI_Gain/U_Gain of the back-EMF observer equals PLANT_LQ. */
+#define PLANT_PP			((double)MOTOR_PP)	// pole-pairs [-]
+#define PLANT_RS			(0.56)				// stator resistance [Ohm]
+#define PLANT_LD			(0.000375)			// d-axis inductance [H]
+#define PLANT_LQ			(0.000435)			// q-axis inductance [H]
+#define PLANT_PSI			(0.0135281)			// PM flux linkage (back-EMF constant) [V.s/rad]
+#define PLANT_J				(0.12e-4)			// drive inertia [kg.m2]
+#define PLANT_B				(2.0e-4)			// viscous friction [N.m.s/rad], see below
+#define PLANT_LD_SAT		(0.0)				// d-axis saturation [1/A], linear iron by default
+
+/* MCAT lists no friction. Without any damping the rotor swings around the
+ * open-loop angle for ever and the start-up never merges into the estimator,
+ * the default friction (J/B = 60ms) stands for bearings and a light fan load. */
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Motor parameters
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	double		pp;			// pole-pairs
+	double		rs;			// stator resistance
+	double		ld;			// d-axis inductance
+	double		lq;			// q-axis inductance
+	double		psi;		// PM flux linkage
+	double		j;			// inertia
+	double		b;			// viscous friction
+	double		ldSat;		// d-axis saturation, incremental Ld/(1 + ldSat*id)
+}plantParam_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Motor state, currents in the rotor (dq) and stator (alpha/beta) frame
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	plantParam_t	param;
+	double			id;			// d-axis current [A]
+	double			iq;			// q-axis current [A]
+	double			iAlpha;		// alpha current [A]
+	double			iBeta;		// beta current [A]
+	double			wMech;		// mechanical speed [rad/s]
+	double			wEl;		// electrical speed [rad/s]
+	double			thEl;		// electrical position <-pi;pi) [rad]
+	double			cosTh;		// cos(thEl), propagated by rotation
+	double			sinTh;		// sin(thEl), propagated by rotation
+	double			te;			// electromagnetic torque [N.m]
+	double			tLoad;		// load torque [N.m], opposes the rotation
+	double			uDInt;		// d-axis voltage integral of the steps [V.s]
+	double			uQInt;		// q-axis voltage integral of the steps [V.s]
+	double			stepCoefH;	// step size the cached coefficients belong to
+	double			dCoefA;		// 1/(1 + h*Rs/Ld)
+	double			dCoefB;		// h/Ld/(1 + h*Rs/Ld)
+	double			qCoefA;		// 1/(1 + h*Rs/Lq)
+	double			qCoefB;		// h/Lq/(1 + h*Rs/Lq)
+	double			mechCoef;	// h/J
+}pmsmPlant_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void PLANT_Init(pmsmPlant_t *ptr, const plantParam_t *param);
+extern void PLANT_SetPosition(pmsmPlant_t *ptr, double thEl);
+extern void PLANT_Step(pmsmPlant_t *ptr, double uAlpha, double uBeta, double h);
+extern void PLANT_Open(pmsmPlant_t *ptr, double h);
+
+#endif /* _PMSM_PLANT_H_ */
@@ -0,0 +1,414 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_edma.c
+*
+* @date     March-28-2017
+*
+* @brief    eDMA and DMAMUX simulation
+*
+* @details	Executes the transfer control descriptors of the DMA register block
+*			as the eDMA engine does, on a peripheral request routed by DMAMUX:
+*
+*			- minor loop of NBYTES with SOFF/DOFF and equal source and
+*			  destination sizes, no minor loop mapping or modulo,
+*			- major loop completion: SLAST, DLAST or scatter/gather load of
+*			  the next 32 bytes TCD from DLASTSGA, INTMAJOR, DREQ, DONE,
+*			- major loop channel link, a link to the own channel continues
+*			  with the newly loaded TCD within the same request.
+*
+*			The set/clear byte registers (SERQ, CERQ, CDNE, ...) are plain
+*			memory in the simulation. They are kept at NOP and the value the
+*			driver wrote is applied on the next SIM_EdmaUpdate() call, which
+*			also follows every EDMA_DRV_StartChannel() call (linker wrap), so
+*			several channels can be started in a row.
+*			Addresses are 32-bit, the host build links the application below
+*			4GB. Each destination write of the last request is logged.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include "S32K144.h"
+#include "status.h"
+#include "sim_edma.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define SIM_EDMA_CHANNELS		16U
+#define SIM_EDMA_TCD_MAX		256U	// TCDs per request, stops a runaway link loop
+#define SIM_EDMA_NO_LINK		0xFFFFFFFFUL
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+typedef __typeof__(DMA->TCD[0]) simEdmaTcd_t;
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static simEdmaWrite_t	writeLog[SIM_EDMA_LOG_LEN];
+static uint32_t			writeCnt;
+static uint32_t			errorCnt;
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Host pointer of a 32-bit device address
+******************************************************************************/
+static inline volatile void *SIM_EdmaPtr(uint32_t addr)
+{
+	return (volatile void *)(uintptr_t)addr;
+}
+
+/**************************************************************************//*!
+@brief			Configuration error, the channel request is disabled
+******************************************************************************/
+static void SIM_EdmaError(uint32_t ch, const char *reason)
+{
+	if (errorCnt++ < 10U)
+	{
+		fprintf(stderr, "sim: eDMA channel %u: %s\n", (unsigned int)ch, reason);
+	}
+	DMA->ERR |= (1UL << ch);
+	DMA->ERQ &= ~(1UL << ch);
+}
+
+/**************************************************************************//*!
+@brief			Applies a driver write to a set/clear byte register
+
+@param[in]		reg		set/clear register, NOP after the call
+@param[in]		mask	channel bit field the register sets or clears
+@param[in]		set		true - set register, false - clear register
+******************************************************************************/
+static void SIM_EdmaSetClear(volatile uint8_t *reg, volatile uint32_t *mask, bool set)
+{
+	uint32_t value = *reg;
+	uint32_t bits;
+
+	*reg = DMA_SERQ_NOP_MASK;
+
+	if (value & DMA_SERQ_NOP_MASK)
+	{
+		return;
+	}
+
+	bits = (value & DMA_SERQ_SAER_MASK) ? 0xFFFFUL : (1UL << (value & DMA_SERQ_SERQ_MASK));
+	*mask = set ? (*mask | bits) : (*mask & ~bits);
+}
+
+/**************************************************************************//*!
+@brief			Loads the next TCD on scatter/gather
+
+@return			false on a misaligned or missing TCD
+******************************************************************************/
+static bool SIM_EdmaLoadTcd(volatile simEdmaTcd_t *tcd, uint32_t addr)
+{
+	const volatile uint32_t *src;
+	volatile uint32_t		*dst = (volatile uint32_t *)tcd;
+	uint32_t				i;
+
+	if ((addr == 0U) || (addr & 0x1FU))
+	{
+		return false;
+	}
+
+	src = (const volatile uint32_t *)SIM_EdmaPtr(addr);
+	for (i = 0U; i < (sizeof(simEdmaTcd_t) / sizeof(uint32_t)); i++)
+	{
+		dst[i] = src[i];
+	}
+
+	return true;
+}
+
+/**************************************************************************//*!
+@brief			Minor loop, copies NBYTES and logs the destination writes
+
+@return			false on an unsupported transfer setting
+******************************************************************************/
+static bool SIM_EdmaMinorLoop(uint32_t ch, volatile simEdmaTcd_t *tcd)
+{
+	uint32_t	attr = tcd->ATTR;
+	uint32_t	ssize = (attr & DMA_TCD_ATTR_SSIZE_MASK) >> DMA_TCD_ATTR_SSIZE_SHIFT;
+	uint32_t	dsize = (attr & DMA_TCD_ATTR_DSIZE_MASK) >> DMA_TCD_ATTR_DSIZE_SHIFT;
+	uint32_t	nbytes = tcd->NBYTES.MLNO;
+	uint32_t	size, n, value;
+	uint32_t	saddr = tcd->SADDR;
+	uint32_t	daddr = tcd->DADDR;
+
+	if ((ssize != dsize) || (ssize > 2U) || (attr & (DMA_TCD_ATTR_SMOD_MASK | DMA_TCD_ATTR_DMOD_MASK)))
+	{
+		return false;
+	}
+
+	size = 1UL << ssize;
+	if ((nbytes == 0U) || (nbytes % size))
+	{
+		return false;
+	}
+
+	for (n = 0U; n < nbytes; n += size)
+	{
+		switch (size)
+		{
+		case 1U:
+			value = *(volatile uint8_t *)SIM_EdmaPtr(saddr);
+			*(volatile uint8_t *)SIM_EdmaPtr(daddr) = (uint8_t)value;
+			break;
+		case 2U:
+			value = *(volatile uint16_t *)SIM_EdmaPtr(saddr);
+			*(volatile uint16_t *)SIM_EdmaPtr(daddr) = (uint16_t)value;
+			break;
+		default:
+			value = *(volatile uint32_t *)SIM_EdmaPtr(saddr);
+			*(volatile uint32_t *)SIM_EdmaPtr(daddr) = value;
+			break;
+		}
+
+		if (writeCnt < SIM_EDMA_LOG_LEN)
+		{
+			writeLog[writeCnt].addr    = daddr;
+			writeLog[writeCnt].value   = value;
+			writeLog[writeCnt].size    = size;
+			writeLog[writeCnt].channel = ch;
+		}
+		writeCnt++;
+
+		saddr += (uint32_t)(int32_t)(int16_t)tcd->SOFF;
+		daddr += (uint32_t)(int32_t)(int16_t)tcd->DOFF;
+	}
+
+	tcd->SADDR = saddr;
+	tcd->DADDR = daddr;
+
+	return true;
+}
+
+/**************************************************************************//*!
+@brief			Services one channel activation (request or link)
+
+@return			Linked channel to be started, SIM_EDMA_NO_LINK if none
+******************************************************************************/
+static uint32_t SIM_EdmaService(uint32_t ch)
+{
+	volatile simEdmaTcd_t	*tcd = &DMA->TCD[ch];
+	uint32_t				csr, citer, link, k;
+
+	if (DMA->CR & DMA_CR_EMLM_MASK)
+	{
+		SIM_EdmaError(ch, "minor loop mapping not simulated");
+		return SIM_EDMA_NO_LINK;
+	}
+
+	for (k = 0U; k < SIM_EDMA_TCD_MAX; k++)
+	{
+		csr = tcd->CSR;
+		tcd->CSR = (uint16_t)(csr & ~(DMA_TCD_CSR_DONE_MASK | DMA_TCD_CSR_START_MASK));
+
+		if (tcd->CITER.ELINKNO & DMA_TCD_CITER_ELINKNO_ELINK_MASK)
+		{
+			SIM_EdmaError(ch, "minor loop link not simulated");
+			return SIM_EDMA_NO_LINK;
+		}
+		if (!SIM_EdmaMinorLoop(ch, tcd))
+		{
+			SIM_EdmaError(ch, "unsupported transfer attributes");
+			return SIM_EDMA_NO_LINK;
+		}
+
+		citer = (tcd->CITER.ELINKNO & DMA_TCD_CITER_ELINKNO_CITER_MASK) - 1U;
+		if (citer != 0U)
+		{
+			tcd->CITER.ELINKNO = (uint16_t)citer;
+			return SIM_EDMA_NO_LINK;
+		}
+
+		/* Major loop complete */
+		tcd->SADDR += tcd->SLAST;
+		link = (csr & DMA_TCD_CSR_MAJORELINK_MASK) ?
+			   ((csr & DMA_TCD_CSR_MAJORLINKCH_MASK) >> DMA_TCD_CSR_MAJORLINKCH_SHIFT) : SIM_EDMA_NO_LINK;
+
+		if (csr & DMA_TCD_CSR_INTMAJOR_MASK)
+		{
+			DMA->INT |= (1UL << ch);
+		}
+		if (csr & DMA_TCD_CSR_DREQ_MASK)
+		{
+			DMA->ERQ &= ~(1UL << ch);
+		}
+
+		if (csr & DMA_TCD_CSR_ESG_MASK)
+		{
+			if (!SIM_EdmaLoadTcd(tcd, tcd->DLASTSGA))
+			{
+				SIM_EdmaError(ch, "scatter/gather address not 32 bytes aligned");
+				return SIM_EDMA_NO_LINK;
+			}
+		}
+		else
+		{
+			tcd->DADDR += tcd->DLASTSGA;
+			tcd->CITER.ELINKNO = tcd->BITER.ELINKNO;
+			tcd->CSR |= DMA_TCD_CSR_DONE_MASK;
+		}
+
+		if (link != ch)
+		{
+			return link;
+		}
+	}
+
+	SIM_EdmaError(ch, "endless major loop link");
+	return SIM_EDMA_NO_LINK;
+}
+
+/**************************************************************************//*!
+@brief			Services a channel and the channels it links to
+******************************************************************************/
+static void SIM_EdmaActivate(uint32_t ch)
+{
+	uint32_t link, hops;
+
+	link = SIM_EdmaService(ch);
+	for (hops = 0U; (link != SIM_EDMA_NO_LINK) && (hops < SIM_EDMA_CHANNELS); hops++)
+	{
+		link = SIM_EdmaService(link);
+	}
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Sets the set/clear byte registers to NOP, call right after the
+				register blocks are mapped
+******************************************************************************/
+void SIM_EdmaInit(void)
+{
+	DMA->CEEI = DMA_CEEI_NOP_MASK;
+	DMA->SEEI = DMA_SEEI_NOP_MASK;
+	DMA->CERQ = DMA_CERQ_NOP_MASK;
+	DMA->SERQ = DMA_SERQ_NOP_MASK;
+	DMA->CDNE = DMA_CDNE_NOP_MASK;
+	DMA->SSRT = DMA_SSRT_NOP_MASK;
+	DMA->CERR = DMA_CERR_NOP_MASK;
+	DMA->CINT = DMA_CINT_NOP_MASK;
+
+	writeCnt = 0U;
+	errorCnt = 0U;
+}
+
+/**************************************************************************//*!
+@brief			Applies the driver writes to the set/clear byte registers
+
+@details		Clear registers are applied first, a driver disabling and
+				enabling a request between two calls ends with it enabled.
+******************************************************************************/
+void SIM_EdmaUpdate(void)
+{
+	uint32_t	done = 0U, start = 0U, ch;
+
+	SIM_EdmaSetClear(&DMA->CEEI, &DMA->EEI, false);
+	SIM_EdmaSetClear(&DMA->SEEI, &DMA->EEI, true);
+	SIM_EdmaSetClear(&DMA->CERQ, &DMA->ERQ, false);
+	SIM_EdmaSetClear(&DMA->SERQ, &DMA->ERQ, true);
+	SIM_EdmaSetClear(&DMA->CERR, &DMA->ERR, false);
+	SIM_EdmaSetClear(&DMA->CINT, &DMA->INT, false);
+	SIM_EdmaSetClear(&DMA->CDNE, &done, true);
+	SIM_EdmaSetClear(&DMA->SSRT, &start, true);
+
+	if ((done | start) == 0U)
+	{
+		return;
+	}
+
+	for (ch = 0U; ch < SIM_EDMA_CHANNELS; ch++)
+	{
+		if (done & (1UL << ch))
+		{
+			DMA->TCD[ch].CSR &= (uint16_t)~DMA_TCD_CSR_DONE_MASK;
+		}
+		if (start & (1UL << ch))
+		{
+			SIM_EdmaActivate(ch);
+		}
+	}
+}
+
+/**************************************************************************//*!
+@brief			EDMA_DRV_StartChannel() of the SDK followed by SIM_EdmaUpdate(),
+				the SERQ write of the driver is applied before the next one
+******************************************************************************/
+status_t __real_EDMA_DRV_StartChannel(uint8_t virtualChannel);
+status_t __wrap_EDMA_DRV_StartChannel(uint8_t virtualChannel)
+{
+	status_t status = __real_EDMA_DRV_StartChannel(virtualChannel);
+
+	SIM_EdmaUpdate();
+
+	return status;
+}
+
+/**************************************************************************//*!
+@brief			Peripheral DMA request
+
+@param[in]		source	DMAMUX request source, dma_request_source_t
+
+@return			Number of serviced channels
+
+@details		Every enabled channel routed to the source is serviced to the
+				end of its linked transfers, the log holds the writes of this
+				request only.
+******************************************************************************/
+uint32_t SIM_EdmaRequest(uint32_t source)
+{
+	uint32_t	ch, served = 0U;
+	uint8_t		chcfg;
+
+	writeCnt = 0U;
+
+	for (ch = 0U; ch < SIM_EDMA_CHANNELS; ch++)
+	{
+		chcfg = DMAMUX->CHCFG[ch];
+
+		if (!(chcfg & DMAMUX_CHCFG_ENBL_MASK) || ((chcfg & DMAMUX_CHCFG_SOURCE_MASK) != source) ||
+			!(DMA->ERQ & (1UL << ch)))
+		{
+			continue;
+		}
+
+		served++;
+		SIM_EdmaActivate(ch);
+	}
+
+	return served;
+}
+
+/**************************************************************************//*!
+@brief			Destination writes of the last request
+******************************************************************************/
+const simEdmaWrite_t *SIM_EdmaLog(uint32_t *count)
+{
+	*count = (writeCnt < SIM_EDMA_LOG_LEN) ? writeCnt : SIM_EDMA_LOG_LEN;
+
+	return writeLog;
+}
+
+/**************************************************************************//*!
+@brief			Number of configuration errors found so far
+******************************************************************************/
+uint32_t SIM_EdmaErrors(void)
+{
+	return errorCnt;
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_edma.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the eDMA and DMAMUX simulation
+*
+*******************************************************************************/
+#ifndef _SIM_EDMA_H_
+#define _SIM_EDMA_H_
+
+#include <stdint.h>
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#define SIM_EDMA_LOG_LEN		64U		// destination writes kept per request
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  One destination write of the eDMA
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	uint32_t		addr;			// destination address
+	uint32_t		value;			// written value
+	uint32_t		size;			// bytes
+	uint32_t		channel;		// eDMA channel
+}simEdmaWrite_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void					SIM_EdmaInit(void);
+extern void					SIM_EdmaUpdate(void);
+extern uint32_t				SIM_EdmaRequest(uint32_t source);
+extern const simEdmaWrite_t	*SIM_EdmaLog(uint32_t *count);
+extern uint32_t				SIM_EdmaErrors(void);
+
+#endif /* _SIM_EDMA_H_ */
@@ -0,0 +1,61 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_gd3000.c
+*
+* @date     March-28-2017
+*
+* @brief    MC34GD3000 pre-driver replacement of the host simulation
+*
+* @details	The TPP driver talks to the device over LPSPI, which is not
+*			simulated. The simulated pre-driver is always enabled and reports
+*			no faults; its dead time is applied by the inverter model.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "tpp/tpp.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+status_t TPP_ConfigureGpio(tpp_drv_config_t* const drvConfig)
+{
+	(void)drvConfig;
+	return STATUS_SUCCESS;
+}
+
+status_t TPP_ConfigureSpi(tpp_drv_config_t* const drvConfig, spi_sdk_master_config_t* const spiSdkMasterConfig)
+{
+	(void)drvConfig;
+	(void)spiSdkMasterConfig;
+	return STATUS_SUCCESS;
+}
+
+status_t TPP_Init(tpp_drv_config_t* const initConfig, tpp_device_mode_t mode)
+{
+	(void)initConfig;
+	(void)mode;
+	return STATUS_SUCCESS;
+}
+
+status_t TPP_GetStatusRegister(tpp_drv_config_t* const drvConfig, tpp_status_register_t statusRegister, uint8_t* const rxData)
+{
+	(void)drvConfig;
+	(void)statusRegister;
+	*rxData = 0U;
+	return STATUS_SUCCESS;
+}
+
+status_t TPP_ClearInterrupts(tpp_drv_config_t* const drvConfig, uint8_t mask0, uint8_t mask1)
+{
+	(void)drvConfig;
+	(void)mask0;
+	(void)mask1;
+	return STATUS_SUCCESS;
+}
@@ -0,0 +1,891 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_inverter.c
+*
+* @date     March-28-2017
+*
+* @brief    FTM3/PDB1/ADC1 and three-phase inverter simulation
+*
+* @details	Advances the simulated hardware one PWM period at a time:
+*
+*			- FTM3 reload point: CnV registers are latched when PWMLOAD[LDOK]
+*			  is set, the OUTMASK and MOD registers are sampled, the
+*			  initialization trigger starts PDB1 when EXTTRIG[INITTRIGEN] is
+*			  set and the reload ISR is called.
+*			- FTM3 channel match with CnSC[CHIE] and CnSC[DMA] requests the eDMA
+*			  (sim_edma.c) right after the reload. With PWM_RELOAD_DMA each
+*			  request has to write C0V~C5V with the edges of the period parity
+*			  counted from the PDB1 start, EXTTRIG with INITTRIGEN cleared and
+*			  PWMLOAD with LDOK set, in this order. The check starts with the
+*			  first sequence after a PDB1 ISR, which re-aligns the chain.
+*			- FTM3 combined mode: phase output is high for C(n)V <= CNT < C(n+1)V,
+*			  C(n+1)V above MOD continues the pulse into the next period. The
+*			  GD3000 dead time delays the edge given by the phase current sign.
+*			  A masked channel opens all switches (no diode conduction).
+*			- PDB1 one-shot sequence: pre-triggers 0..4 start ADC1 conversions
+*			  of the SC1 register of the same index, the interrupt delay calls
+*			  the PDB1 ISR, the counter stops at MOD.
+*			- FTM3 fault input 0: with the CMP0 output routed by TRGMUX
+*			  (FAST_TRIP) the shunt current at the switching instants of the
+*			  period is compared with the CMP0 DAC level, a trip sets FMS[FAULTF0]
+*			  and opens all switches from the next period on. The trip is thus
+*			  resolved to one PWM period, not to the CMP0 filter delay.
+*			- ADC1: EXT6 samples the DC link current seen by the single shunt,
+*			  i.e. the sum of currents of the phases connected to the positive
+*			  rail, EXT7 samples the DC bus voltage. The ADC1 ISR is called on
+*			  conversion complete of a channel with SC1[AIEN] set, with SC2[DMAEN]
+*			  every conversion complete requests the eDMA first. SC3 hardware
+*			  averaging converts the DC link current in consecutive 1us slots,
+*			  with the phase currents of the conversion start in the switching
+*			  model.
+*
+*			The plant is either stepped once per PWM period with the period
+*			averaged phase voltages (samples interpolate the currents within
+*			the period), or it is integrated between switching instants.
+*			With SIM_PERIOD_STEP the averaged voltages of the PWM periods
+*			without ADC1 samples are summed and applied in one step, and the
+*			FTM3 reload writes the pwmReloadImage[] of the period parity
+*			directly, as checked against the eDMA chain in the default build.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <math.h>
+#include <stdio.h>
+#include "S32K144.h"
+#include "adc_driver.h"
+#include "meas_s32k.h"
+#include "actuate_s32k.h"
+#include "motor_structure.h"
+#include "sim_platform.h"
+#include "sim_edma.h"
+#include "sim_inverter.h"
+
+/******************************************************************************
+| External declarations
+-----------------------------------------------------------------------------*/
+extern void FTM3_Ovf_Reload_IRQHandler(void);
+extern void PDB1_IRQHandler(void);
+extern void ADC1_IRQHandler(void);
+extern void SWI_IRQHandler(void);
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define SIM_PHASES				3U
+#define SIM_PRETRIG_CNT			5U
+#define SIM_FTM_CHANNELS		8U
+#define SIM_TICK_SEC			(1.0 / (double)SIM_CORE_CLOCK_HZ)
+
+#define SIM_ADC_CH_IDCB			ADC_INPUTCHAN_EXT6	// DC link current, single shunt amplifier
+#define SIM_ADC_CH_UDCB			ADC_INPUTCHAN_EXT7	// DC bus voltage divider
+#define SIM_ADC_SAMPLE_TICKS	12U		// middle of the 0.3us sampling window
+#define SIM_ADC_CONV_TICKS		80U		// sampling and conversion, 1us
+#define SIM_ADC_FULL_SCALE		4095.0
+
+#define SIM_SQRT3				1.7320508075688772
+#define SIM_ONE_DIV_SQRT3		0.5773502691896258
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+typedef struct
+{
+	uint32_t	on;				// first tick the high side conducts
+	uint32_t	off;			// first tick the low side conducts
+}phaseOn_t;
+
+typedef struct
+{
+	uint64_t	start;			// tick of the triggering FTM3 reload
+	uint32_t	tick;			// FTM ticks per PDB count
+	bool		running;
+	bool		idlyDone;
+	bool		pretrigDone[SIM_PRETRIG_CNT];
+}pdbSeq_t;
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static pmsmPlant_t		*plantPtr;
+static simInvParam_t	invParam;
+
+static uint64_t			nowTicks;				// tick of the current reload point
+static uint64_t			plantTicks;				// tick the plant state belongs to
+static uint32_t			periodTicks;
+static uint16_t			cnvActive[2U * SIM_PHASES];
+static bool				outputOpen;
+static phaseOn_t		phaseOn[SIM_PHASES];
+static bool				phaseOnAtEnd[SIM_PHASES];	// high side conducts at the end of the last period
+
+static double			iAlphaBeg, iBetaBeg;	// averaged mode interpolation
+static double			iAlphaEnd, iBetaEnd;
+
+#if SIM_PERIOD_STEP
+static double			uAlphaPeriod, uBetaPeriod;	// averaged voltage of the current period
+static bool				periodPending;			// the current period is not stepped yet
+static double			uAlphaSum, uBetaSum;	// voltage-time of the periods not stepped yet [Vs]
+static uint32_t			sumTicks;
+#endif
+
+static pdbSeq_t			pdb;
+static bool				adcIsrPending;
+static uint64_t			adcIsrTicks;
+static double			adcIsrThEl;				// rotor position at the last ADC1 ISR [rad]
+
+static uint32_t			pdbPeriod;				// PWM periods since the PDB1 start
+static bool				reloadAligned;			// PDB1 ISR re-aligned the reload chain
+static bool				reloadChecked;			// DMA writes of this sequence are checked
+static simReloadStats_t	reloadStats;
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Phase currents from the alpha/beta currents
+******************************************************************************/
+static inline void SIM_PhaseCurrents(double iAlpha, double iBeta, double *iAbc)
+{
+	iAbc[0] = iAlpha;
+	iAbc[1] = -0.5 * iAlpha + 0.5 * SIM_SQRT3 * iBeta;
+	iAbc[2] = -0.5 * iAlpha - 0.5 * SIM_SQRT3 * iBeta;
+}
+
+/**************************************************************************//*!
+@brief			Conduction intervals of the high side switches in this period
+
+@details		The dead time delays the rising edge for a positive phase
+				current (low side diode conducts) and the falling edge for a
+				negative one (high side diode conducts). A pulse continuing
+				over the reload point has no edge there.
+******************************************************************************/
+static void SIM_PhaseIntervals(void)
+{
+	double		iAbc[SIM_PHASES];
+	uint32_t	k, c0, c1;
+
+	SIM_PhaseCurrents(plantPtr->iAlpha, plantPtr->iBeta, iAbc);
+
+	for (k = 0U; k < SIM_PHASES; k++)
+	{
+		c0 = cnvActive[2U * k];
+		c1 = cnvActive[2U * k + 1U];
+
+		if ((c0 >= c1) || (c0 >= periodTicks))
+		{
+			c0 = 0U;
+			c1 = 0U;
+		}
+		else if (iAbc[k] > 0.0)
+		{
+			if ((c0 != 0U) || !phaseOnAtEnd[k])
+			{
+				c0 += invParam.deadTimeTicks;
+			}
+		}
+		else
+		{
+			c1 += invParam.deadTimeTicks;
+		}
+
+		phaseOn[k].on  = (c0 < periodTicks) ? c0 : periodTicks;
+		phaseOn[k].off = (c1 < periodTicks) ? c1 : periodTicks;
+
+		if (phaseOn[k].off < phaseOn[k].on)
+		{
+			phaseOn[k].off = phaseOn[k].on;
+		}
+
+		phaseOnAtEnd[k] = !outputOpen && (phaseOn[k].on < periodTicks) &&
+						  (cnvActive[2U * k + 1U] >= periodTicks);
+	}
+}
+
+/**************************************************************************//*!
+@brief			Plant step with the period averaged phase voltages
+******************************************************************************/
+static void SIM_PlantStepAveraged(void)
+{
+	double	h = (double)periodTicks * SIM_TICK_SEC;
+	double	scale = invParam.udc / (double)periodTicks;
+	double	ua, ub, uc;
+
+	iAlphaBeg = plantPtr->iAlpha;
+	iBetaBeg  = plantPtr->iBeta;
+
+	if (outputOpen)
+	{
+		PLANT_Open(plantPtr, h);
+	}
+	else
+	{
+		ua = (double)(phaseOn[0].off - phaseOn[0].on) * scale;
+		ub = (double)(phaseOn[1].off - phaseOn[1].on) * scale;
+		uc = (double)(phaseOn[2].off - phaseOn[2].on) * scale;
+
+#if SIM_PERIOD_STEP
+		uAlphaPeriod	= (2.0 * ua - ub - uc) * (1.0 / 3.0);
+		uBetaPeriod		= (ub - uc) * SIM_ONE_DIV_SQRT3;
+		periodPending	= true;
+		return;
+#else
+		PLANT_Step(plantPtr, (2.0 * ua - ub - uc) * (1.0 / 3.0), (ub - uc) * SIM_ONE_DIV_SQRT3, h);
+#endif
+	}
+
+	iAlphaEnd = plantPtr->iAlpha;
+	iBetaEnd  = plantPtr->iBeta;
+	plantTicks = nowTicks + periodTicks;
+}
+
+#if SIM_PERIOD_STEP
+/**************************************************************************//*!
+@brief			Steps the plant over the current period before its first sample
+
+@details		The summed periods before it go in one step, the current one
+				in its own step, so the samples interpolate within it.
+******************************************************************************/
+static void SIM_PlantStepSampled(void)
+{
+	if (!periodPending)
+	{
+		return;
+	}
+	periodPending = false;
+
+	SIM_InverterPlantFlush();
+
+	iAlphaBeg = plantPtr->iAlpha;
+	iBetaBeg  = plantPtr->iBeta;
+	PLANT_Step(plantPtr, uAlphaPeriod, uBetaPeriod, (double)periodTicks * SIM_TICK_SEC);
+	iAlphaEnd = plantPtr->iAlpha;
+	iBetaEnd  = plantPtr->iBeta;
+	plantTicks = nowTicks + periodTicks;
+}
+
+/**************************************************************************//*!
+@brief			Adds the current period to the sum when it had no sample
+******************************************************************************/
+static void SIM_PlantSumPeriod(void)
+{
+	if (!periodPending)
+	{
+		return;
+	}
+	periodPending = false;
+
+	uAlphaSum += uAlphaPeriod * (double)periodTicks;
+	uBetaSum  += uBetaPeriod * (double)periodTicks;
+	sumTicks  += periodTicks;
+}
+#endif
+
+/**************************************************************************//*!
+@brief			Integrates the plant between switching instants up to tEnd
+******************************************************************************/
+static void SIM_PlantAdvanceSwitching(uint64_t tEnd)
+{
+	uint32_t	pos, next, k;
+	double		u[SIM_PHASES];
+
+	while (plantTicks < tEnd)
+	{
+		pos  = (uint32_t)(plantTicks - nowTicks);
+		next = (uint32_t)(tEnd - nowTicks);
+
+		for (k = 0U; k < SIM_PHASES; k++)
+		{
+			if ((phaseOn[k].on > pos) && (phaseOn[k].on < next))
+			{
+				next = phaseOn[k].on;
+			}
+			if ((phaseOn[k].off > pos) && (phaseOn[k].off < next))
+			{
+				next = phaseOn[k].off;
+			}
+		}
+
+		if (outputOpen)
+		{
+			PLANT_Open(plantPtr, (double)(next - pos) * SIM_TICK_SEC);
+		}
+		else
+		{
+			for (k = 0U; k < SIM_PHASES; k++)
+			{
+				u[k] = ((pos >= phaseOn[k].on) && (pos < phaseOn[k].off)) ? invParam.udc : 0.0;
+			}
+			PLANT_Step(plantPtr, (2.0 * u[0] - u[1] - u[2]) * (1.0 / 3.0), (u[1] - u[2]) * SIM_ONE_DIV_SQRT3,
+					   (double)(next - pos) * SIM_TICK_SEC);
+		}
+
+		plantTicks = nowTicks + next;
+	}
+}
+
+/**************************************************************************//*!
+@brief			Single shunt current at tick t of the current period
+******************************************************************************/
+static double SIM_ShuntCurrent(uint64_t t)
+{
+	double		iAbc[SIM_PHASES], frac, idc = 0.0;
+	uint32_t	pos = (uint32_t)(t - nowTicks);
+	uint32_t	k;
+
+	if (outputOpen)
+	{
+		return 0.0;
+	}
+
+	if (invParam.switching)
+	{
+		SIM_PhaseCurrents(plantPtr->iAlpha, plantPtr->iBeta, iAbc);
+	}
+	else
+	{
+		frac = (double)pos / (double)periodTicks;
+		SIM_PhaseCurrents(iAlphaBeg + frac * (iAlphaEnd - iAlphaBeg),
+						  iBetaBeg  + frac * (iBetaEnd  - iBetaBeg), iAbc);
+	}
+
+	for (k = 0U; k < SIM_PHASES; k++)
+	{
+		if ((pos >= phaseOn[k].on) && (pos < phaseOn[k].off))
+		{
+			idc += iAbc[k];
+		}
+	}
+
+	return idc;
+}
+
+/**************************************************************************//*!
+@brief			ADC1 conversion of the SC1 register with index n at tick t
+******************************************************************************/
+static void SIM_AdcConvert(uint32_t n, uint64_t t)
+{
+	uint32_t	sc1 = ADC1->SC1[n];
+	uint32_t	sc3 = ADC1->SC3;
+	uint32_t	avg = (sc3 & ADC_SC3_AVGE_MASK) ? (4UL << ((sc3 & ADC_SC3_AVGS_MASK) >> ADC_SC3_AVGS_SHIFT)) : 1U;
+	uint32_t	k;
+	double		counts;
+
+	switch (sc1 & ADC_SC1_ADCH_MASK)
+	{
+	case SIM_ADC_CH_IDCB:
+		if (avg == 1U)
+		{
+			counts = 2048.0 + SIM_ShuntCurrent(t) * (2048.0 / (double)I_DCB_MAX);
+			break;
+		}
+		for (k = 0U, counts = 0.0; k < avg; k++)
+		{
+			counts += 2048.0 + SIM_ShuntCurrent(t + k * SIM_ADC_CONV_TICKS) * (2048.0 / (double)I_DCB_MAX);
+		}
+		counts /= (double)avg;
+		break;
+	case SIM_ADC_CH_UDCB:
+		counts = invParam.udc * (SIM_ADC_FULL_SCALE / (double)U_DCB_MAX);
+		break;
+	default:
+		counts = 0.0;
+		break;
+	}
+
+	counts = (counts < 0.0) ? 0.0 : ((counts > SIM_ADC_FULL_SCALE) ? SIM_ADC_FULL_SCALE : counts);
+
+	*(volatile uint32_t *)&ADC1->R[n] = (uint32_t)(counts + 0.5);
+	ADC1->SC1[n] = sc1 | ADC_SC1_COCO_MASK;
+
+	if (ADC1->SC2 & ADC_SC2_DMAEN_MASK)
+	{
+		(void)SIM_EdmaRequest(EDMA_REQ_ADC1);
+	}
+
+	if (sc1 & ADC_SC1_AIEN_MASK)
+	{
+		adcIsrPending = true;
+		adcIsrTicks   = t - SIM_ADC_SAMPLE_TICKS + avg * SIM_ADC_CONV_TICKS;
+	}
+}
+
+/**************************************************************************//*!
+@brief			CMP0 fast-trip comparator driving the FTM3 fault input 0
+
+@details		Evaluated once per period at the switching instants, where the
+				shunt current changes. The plus input is the DC link current
+				in ADC counts, the minus input the DAC, (VOSEL + 1)/256 of VDDA.
+******************************************************************************/
+static void SIM_FastTrip(void)
+{
+	uint32_t	sel = (TRGMUX->TRGMUXn[TRGMUX_TARGET_MODULE_FTM3_FAULT0 >> 2U] >>
+					   (8U * (TRGMUX_TARGET_MODULE_FTM3_FAULT0 & 3U))) & 0x3FU;
+	double		level, counts;
+	uint32_t	k;
+
+	if (!(CMP0->C0 & CMP_C0_EN_MASK) || (sel != TRGMUX_TRIG_SOURCE_CMP0_OUT) ||
+		!(FTM3->FLTCTRL & FTM_FLTCTRL_FAULT0EN_MASK) || outputOpen)
+	{
+		return;
+	}
+
+	level = (double)(((CMP0->C1 & CMP_C1_VOSEL_MASK) >> CMP_C1_VOSEL_SHIFT) + 1U) * (4096.0 / 256.0);
+
+	for (k = 0U; k < SIM_PHASES; k++)
+	{
+		counts = 2048.0 + SIM_ShuntCurrent(nowTicks + phaseOn[k].on) * (2048.0 / (double)I_DCB_MAX);
+		if ((counts > level) && (phaseOn[k].on < periodTicks))
+		{
+			FTM3->FMS |= FTM_FMS_FAULTF0_MASK | FTM_FMS_FAULTF_MASK;
+			return;
+		}
+	}
+}
+
+/**************************************************************************//*!
+@brief			Starts the PDB1 sequence on the FTM3 initialization trigger
+******************************************************************************/
+static void SIM_PdbStart(void)
+{
+	static const uint32_t mult[4] = {1U, 10U, 20U, 40U};
+	uint32_t sc = PDB1->SC;
+	uint32_t i;
+
+	pdbPeriod    = 0U;
+	reloadChecked = reloadAligned;
+	reloadAligned = false;
+
+	pdb.start    = nowTicks;
+	pdb.tick     = (1UL << ((sc & PDB_SC_PRESCALER_MASK) >> PDB_SC_PRESCALER_SHIFT))
+				 * mult[(sc & PDB_SC_MULT_MASK) >> PDB_SC_MULT_SHIFT];
+	pdb.running  = true;
+	pdb.idlyDone = false;
+
+	for (i = 0U; i < SIM_PRETRIG_CNT; i++)
+	{
+		pdb.pretrigDone[i] = false;
+	}
+}
+
+/**************************************************************************//*!
+@brief			Processes PDB1 and ADC1 events of the current PWM period
+
+@details		Event times are evaluated from the registers on every pass, so
+				delays rewritten by an ISR are honored within the same sequence.
+				A compare value the counter has already passed never fires.
+******************************************************************************/
+static void SIM_PeriodEvents(void)
+{
+	enum { EV_NONE, EV_PRETRIG, EV_ADC_ISR, EV_PDB_ISR, EV_PDB_END } evType;
+	uint64_t	periodEnd = nowTicks + periodTicks;
+	uint64_t	cursor = nowTicks;
+	uint64_t	evTicks, t;
+	uint32_t	evIdx = 0U, i, c1;
+
+	for (;;)
+	{
+		evType  = EV_NONE;
+		evTicks = periodEnd;
+
+		if (pdb.running)
+		{
+			c1 = PDB1->CH[0].C1;
+
+			for (i = 0U; i < SIM_PRETRIG_CNT; i++)
+			{
+				if (pdb.pretrigDone[i] || !(c1 & (1UL << i)))
+				{
+					continue;
+				}
+
+				t = pdb.start + (uint64_t)(PDB1->CH[0].DLY[i] & PDB_DLY_DLY_MASK) * pdb.tick + SIM_ADC_SAMPLE_TICKS;
+
+				if (t < cursor)
+				{
+					pdb.pretrigDone[i] = true;
+				}
+				else if (t < evTicks)
+				{
+					evType  = EV_PRETRIG;
+					evTicks = t;
+					evIdx   = i;
+				}
+			}
+
+			t = pdb.start + (uint64_t)(PDB1->IDLY & 0xFFFFU) * pdb.tick;
+			if (!pdb.idlyDone && (t >= cursor) && (t < evTicks))
+			{
+				evType  = EV_PDB_ISR;
+				evTicks = t;
+			}
+
+			t = pdb.start + (uint64_t)(PDB1->MOD & 0xFFFFU) * pdb.tick;
+			if (t < evTicks)
+			{
+				evType  = EV_PDB_END;
+				evTicks = (t < cursor) ? cursor : t;
+			}
+		}
+
+		if (adcIsrPending && (adcIsrTicks < evTicks))
+		{
+			evType  = EV_ADC_ISR;
+			evTicks = (adcIsrTicks < cursor) ? cursor : adcIsrTicks;
+		}
+
+		if (evType == EV_NONE)
+		{
+			break;
+		}
+
+		if (invParam.switching)
+		{
+			SIM_PlantAdvanceSwitching(evTicks);
+		}
+		cursor = evTicks;
+
+		switch (evType)
+		{
+		case EV_PRETRIG:
+			pdb.pretrigDone[evIdx] = true;
+#if SIM_PERIOD_STEP
+			SIM_PlantStepSampled();
+#endif
+			SIM_AdcConvert(evIdx, evTicks);
+			break;
+		case EV_ADC_ISR:
+			adcIsrPending = false;
+			/* the averaged model steps the plant at the period end only,
+			 * with SIM_PERIOD_STEP possibly at the end of an earlier one */
+			adcIsrThEl = plantPtr->thEl;
+			if (!invParam.switching)
+			{
+				adcIsrThEl += plantPtr->wEl * (double)(evTicks + periodTicks - plantTicks) * SIM_TICK_SEC;
+			}
+			if (SIM_IsIrqEnabled(ADC1_IRQn))
+			{
+				ADC1_IRQHandler();
+			}
+			/* lowest priority, tail-chained right after the ADC1 ISR */
+			if (SIM_IrqTakePending(SWI_IRQn))
+			{
+				SWI_IRQHandler();
+			}
+			break;
+		case EV_PDB_ISR:
+			pdb.idlyDone = true;
+			PDB1->SC |= PDB_SC_PDBIF_MASK;
+			if ((PDB1->SC & PDB_SC_PDBIE_MASK) && SIM_IsIrqEnabled(PDB1_IRQn))
+			{
+				PDB1_IRQHandler();
+				reloadAligned = ((FTM3->EXTTRIG & FTM_EXTTRIG_INITTRIGEN_MASK) != 0U);
+			}
+			break;
+		default:
+			pdb.running = false;
+			break;
+		}
+	}
+
+	if (invParam.switching)
+	{
+		SIM_PlantAdvanceSwitching(periodEnd);
+	}
+}
+
+/**************************************************************************//*!
+@brief			Checks the eDMA writes of one FTM3 reload request
+
+@return			true when the register write sequence is the expected one
+******************************************************************************/
+static bool SIM_ReloadCheck(void)
+{
+	const simEdmaWrite_t	*log;
+	const PWM_EDGES_TYPE	*edges;
+	uint32_t				cnt, i, cnv;
+
+	log = SIM_EdmaLog(&cnt);
+	if (cnt != PWM_RELOAD_WORDS)
+	{
+		return false;
+	}
+
+	for (i = 0U; i < PWM_RELOAD_WORDS; i++)
+	{
+		if (log[i].size != sizeof(uint32_t))
+		{
+			return false;
+		}
+	}
+
+	for (i = 0U; i < (2U * SIM_PHASES); i++)
+	{
+		edges = &pmsmAxis[PMSM_AXIS_FTM3].pwm.pwmEdgesFtm.EdgesPhase[i >> 1];
+		if (pdbPeriod & 1U)
+		{
+			cnv = (i & 1U) ? edges->u16Edge2 : edges->u16Edge1;
+		}
+		else
+		{
+			cnv = (i & 1U) ? edges->u16Edge4 : edges->u16Edge3;
+		}
+
+		if ((log[i].addr != (uint32_t)(uintptr_t)&FTM3->CONTROLS[i].CnV) || (log[i].value != cnv))
+		{
+			return false;
+		}
+	}
+
+	return ((log[6].addr == (uint32_t)(uintptr_t)&FTM3->EXTTRIG) &&
+			!(log[6].value & FTM_EXTTRIG_INITTRIGEN_MASK) &&
+			(log[7].addr == (uint32_t)(uintptr_t)&FTM3->PWMLOAD) &&
+			(log[7].value & FTM_PWMLOAD_LDOK_MASK));
+}
+
+#if SIM_PERIOD_STEP
+/**************************************************************************//*!
+@brief			FTM3 reload without the eDMA, SIM_PERIOD_STEP
+
+@return			true when the eDMA chain is enabled and its writes are done
+
+@details		Writes what SIM_ReloadCheck() expects from the chain.
+******************************************************************************/
+static bool SIM_ReloadDirect(void)
+{
+	const actuatePwm_t	*pwm = &pmsmAxis[PMSM_AXIS_FTM3].pwm;
+	const tU32			*image;
+	uint32_t			i;
+
+	if (!(DMA->ERQ & (1UL << pwm->dmaChn)))
+	{
+		return false;
+	}
+
+	image = pwm->pwmReloadImage[pdbPeriod & 1U];	// image 1 holds the odd cycle edges
+	for (i = 0U; i < (2U * SIM_PHASES); i++)
+	{
+		FTM3->CONTROLS[i].CnV = image[i];
+	}
+	FTM3->EXTTRIG = image[6];
+	FTM3->PWMLOAD = image[7];
+
+	return true;
+}
+#endif
+
+/**************************************************************************//*!
+@brief			FTM3 channel match DMA requests of the current period
+
+@details		All channel match requests happen right after the reload
+				point, the transfers are complete long before the next one.
+******************************************************************************/
+static void SIM_FtmDmaRequests(void)
+{
+	uint32_t	n, served = 0U;
+	uint32_t	cnsc;
+
+	SIM_EdmaUpdate();
+
+#if SIM_PERIOD_STEP
+	if (SIM_ReloadDirect())
+	{
+		return;
+	}
+#endif
+
+	for (n = 0U; n < SIM_FTM_CHANNELS; n++)
+	{
+		cnsc = FTM3->CONTROLS[n].CnSC;
+		if (((cnsc & (FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK)) == (FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK)) &&
+			((FTM3->CONTROLS[n].CnV & 0xFFFFU) < periodTicks))
+		{
+			FTM3->CONTROLS[n].CnSC = cnsc | FTM_CnSC_CHF_MASK;
+			served += SIM_EdmaRequest(EDMA_REQ_FTM3_OR_CH0_CH7);
+		}
+	}
+
+	if (served == 0U)
+	{
+		return;
+	}
+
+	reloadStats.requests++;
+	if (reloadChecked)
+	{
+		reloadStats.checked++;
+		if (!SIM_ReloadCheck())
+		{
+			if (reloadStats.mismatches++ < 10U)
+			{
+				fprintf(stderr, "sim: FTM3 reload eDMA writes mismatch at %.6f s, period %u of the PDB1 sequence\n",
+						SIM_InverterTime(), (unsigned int)pdbPeriod);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Initializes the simulated hardware, call after the peripheral
+				configuration of the application
+******************************************************************************/
+void SIM_InverterInit(pmsmPlant_t *plant, const simInvParam_t *param)
+{
+	uint32_t i;
+
+	plantPtr      = plant;
+	invParam      = *param;
+	nowTicks      = 0U;
+	plantTicks    = 0U;
+	outputOpen    = true;
+	adcIsrPending = false;
+	pdb.running   = false;
+	pdbPeriod     = 0U;
+	reloadAligned = false;
+	reloadChecked = false;
+	reloadStats.requests   = 0U;
+	reloadStats.checked    = 0U;
+	reloadStats.mismatches = 0U;
+#if SIM_PERIOD_STEP
+	periodPending = false;
+	uAlphaSum     = 0.0;
+	uBetaSum      = 0.0;
+	sumTicks      = 0U;
+#endif
+
+	for (i = 0U; i < (2U * SIM_PHASES); i++)
+	{
+		cnvActive[i] = 0U;
+	}
+}
+
+/**************************************************************************//*!
+@brief			Changes the DC bus voltage from the next conversion on
+******************************************************************************/
+void SIM_InverterSetUdc(double udc)
+{
+	invParam.udc = udc;
+}
+
+/**************************************************************************//*!
+@brief			Simulates one FTM3 PWM period, starting at its reload point
+******************************************************************************/
+void SIM_InverterPeriod(void)
+{
+	uint32_t i;
+
+	periodTicks = ((FTM3->MOD - FTM3->CNTIN) & 0xFFFFU) + 1U;
+
+	/* Reload point */
+	if (FTM3->PWMLOAD & FTM_PWMLOAD_LDOK_MASK)
+	{
+		for (i = 0U; i < (2U * SIM_PHASES); i++)
+		{
+			cnvActive[i] = (uint16_t)FTM3->CONTROLS[i].CnV;
+		}
+		FTM3->PWMLOAD &= ~FTM_PWMLOAD_LDOK_MASK;
+	}
+
+	outputOpen = ((FTM3->OUTMASK & 0x3FU) != 0U) ||
+				 ((FTM3->MODE & FTM_MODE_FAULTM_MASK) && (FTM3->FMS & FTM_FMS_FAULTF_MASK));
+
+	if ((FTM3->EXTTRIG & FTM_EXTTRIG_INITTRIGEN_MASK) && (PDB1->SC & PDB_SC_PDBEN_MASK))
+	{
+		SIM_PdbStart();
+	}
+
+	FTM3->SC |= FTM_SC_TOF_MASK;
+#if !PWM_RELOAD_DMA
+	if ((FTM3->SC & FTM_SC_TOIE_MASK) && SIM_IsIrqEnabled(FTM3_Ovf_Reload_IRQn))
+	{
+		FTM3_Ovf_Reload_IRQHandler();
+	}
+#endif
+
+	SIM_FtmDmaRequests();
+
+	/* Output stage and plant over the period */
+	SIM_PhaseIntervals();
+
+	if (!invParam.switching)
+	{
+#if SIM_PERIOD_STEP
+		if (outputOpen)
+		{
+			SIM_InverterPlantFlush();
+		}
+#endif
+		SIM_PlantStepAveraged();
+	}
+
+	SIM_PeriodEvents();
+	SIM_FastTrip();
+#if SIM_PERIOD_STEP
+	SIM_PlantSumPeriod();
+#endif
+
+	nowTicks += periodTicks;
+	pdbPeriod++;
+}
+
+/**************************************************************************//*!
+@brief			Steps the plant over the periods summed by SIM_PERIOD_STEP,
+				the plant state is then the one of the current time
+******************************************************************************/
+void SIM_InverterPlantFlush(void)
+{
+#if SIM_PERIOD_STEP
+	if (sumTicks == 0U)
+	{
+		return;
+	}
+
+	PLANT_Step(plantPtr, uAlphaSum / (double)sumTicks, uBetaSum / (double)sumTicks, (double)sumTicks * SIM_TICK_SEC);
+	plantTicks += sumTicks;
+	uAlphaSum	= 0.0;
+	uBetaSum	= 0.0;
+	sumTicks	= 0U;
+#endif
+}
+
+/**************************************************************************//*!
+@brief			Simulated time in seconds
+******************************************************************************/
+double SIM_InverterTime(void)
+{
+	return (double)nowTicks * SIM_TICK_SEC;
+}
+
+/**************************************************************************//*!
+@brief			Rotor position at the last ADC1 ISR, not wrapped [rad]
+******************************************************************************/
+double SIM_InverterIsrPosition(void)
+{
+	return adcIsrThEl;
+}
+
+/**************************************************************************//*!
+@brief			FTM3 reload eDMA request statistics
+******************************************************************************/
+const simReloadStats_t *SIM_InverterReloadStats(void)
+{
+	return &reloadStats;
+}
+
+/**************************************************************************//*!
+@brief			Simulated time in FTM3 ticks
+******************************************************************************/
+uint64_t SIM_InverterTicks(void)
+{
+	return nowTicks;
+}
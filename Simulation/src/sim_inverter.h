@@ -0,0 +1,72 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_inverter.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the FTM3/PDB1/ADC1 and inverter simulation
+*
+*******************************************************************************/
+#ifndef _SIM_INVERTER_H_
+#define _SIM_INVERTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pmsm_plant.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* SIM_PERIOD_STEP 0	The averaged plant is stepped every PWM period, the FTM3
+ *						reload eDMA chain is simulated and its writes checked
+ * SIM_PERIOD_STEP 1	Fast build for long runs: the averaged plant is stepped
+ *						only in the PWM periods with ADC1 samples and once over
+ *						the rest of the control period, FMSTR_Poll() simulates a
+ *						control period and the FTM3 reload writes the edges of
+ *						the period parity without the eDMA. The switching model
+ *						is not available. */
+#ifndef SIM_PERIOD_STEP
+#define SIM_PERIOD_STEP			0
+#endif
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Inverter and measurement parameters
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	double			udc;			// DC bus voltage [V]
+	uint32_t		deadTimeTicks;	// effective dead time in FTM ticks, 0 for ideal switches
+	bool			switching;		// true - exact switching instants, false - one averaged step per PWM period
+}simInvParam_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  FTM3 reload eDMA requests, see PWM_RELOAD_DMA
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	uint32_t		requests;		// FTM3 channel match requests serviced by the eDMA
+	uint32_t		checked;		// requests with the register writes checked
+	uint32_t		mismatches;		// checked requests with unexpected writes
+}simReloadStats_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void		SIM_InverterInit(pmsmPlant_t *plant, const simInvParam_t *param);
+extern void		SIM_InverterSetUdc(double udc);
+extern void		SIM_InverterPeriod(void);
+extern void		SIM_InverterPlantFlush(void);
+extern double	SIM_InverterTime(void);
+extern uint64_t	SIM_InverterTicks(void);
+extern double	SIM_InverterIsrPosition(void);
+extern const simReloadStats_t *SIM_InverterReloadStats(void);
+
+#endif /* _SIM_INVERTER_H_ */
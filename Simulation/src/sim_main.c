@@ -0,0 +1,792 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_main.c
+*
+* @date     March-28-2017
+*
+* @brief    Host closed loop simulation of the PMSM FOC application
+*
+* @details	The application sources are compiled unchanged, main() of the
+*			application is renamed to APP_main() by the build. The FreeMASTER
+*			driver is replaced by this module: FMSTR_Init() takes over the
+*			simulated hardware right after the MCU peripheral configuration and
+*			every FMSTR_Poll() call of the application background loop
+*			simulates one PWM period and runs the test scenario. The scenario
+*			end returns from the background loop by longjmp().
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+#include <math.h>
+
+#include "freemaster.h"
+#include "ftm_common.h"
+#include "flexTimer_qd2.h"
+#include "PMSM_appconfig.h"
+#include "PMSM_apprate.h"
+#include "motor_structure.h"
+#include "meas_s32k.h"
+#include "sim_platform.h"
+#include "sim_edma.h"
+#include "sim_inverter.h"
+#include "pmsm_plant.h"
+#include "profiler.h"
+#include "actuate_s32k.h"
+
+/******************************************************************************
+| External declarations
+-----------------------------------------------------------------------------*/
+extern int APP_main(void);
+
+/* Drive observed and commanded by the scenarios */
+#define SIM_AXIS				(pmsmAxis[PMSM_AXIS_BOARD])
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#define SIM_RPM_TO_WEL			((double)WEL_MAX / (double)N_MAX)	// mechanical rpm to el. rad/s
+#define SIM_FW_SPEED_RPM		1700.0	// above the 10V base speed, within the field weakening range
+#define SIM_DEADTIME_TICKS		40U		// GD3000 INIT_DEADTIME 500ns at 80MHz, exceeds FTM3 DTVAL
+#define SIM_STANDSTILL_RPM		10.0	// restart without the flying start: on again below [rpm]
+#define SIM_ACT_WINDOW			1.0		// actuation angle averaged over the end of the run [s]
+#define SIM_IQSTEP_RPM			2000.0	// q-axis current steps: required speed below SPEED_LIM_RAD, 2090 rpm [rpm]
+#define SIM_IQSTEP_UDC			16.0	// q-axis current steps: DC bus voltage [V]
+#define SIM_IQSTEP_ON			4.0		// q-axis current steps: current control mode from [s]
+#define SIM_IQSTEP_HALF			0.02	// q-axis current steps: half period of the square wave [s]
+#define SIM_IQSTEP_AMPL			0.5		// q-axis current steps: amplitude around the speed loop output [A]
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+typedef enum
+{
+	scnStartup	= 0,		// start-up to the required speed
+	scnLoadStep	= 1,		// load torque step and release at the required speed
+	scnFieldWeak= 2,		// maximum speed at reduced DC bus voltage
+	scnRestart	= 3,		// application off and on again with the motor coasting
+	scnIqStep	= 4			// q-axis current square wave in the current control mode at high speed
+}simScenario_t;
+
+typedef struct
+{
+	simScenario_t	scenario;
+	double			duration;		// simulated time [s]
+	double			speedRpm;		// required mechanical speed [rpm]
+	double			loadTorque;		// load step [N.m]
+	double			loadOn;			// load step time [s]
+	double			loadOff;		// load release time [s]
+	double			restart;		// application off and on again [s]
+	double			thEl0;			// initial rotor position [rad]
+	double			olRamp;			// open loop speed ramp to the MCAT one [-]
+	double			tune;			// gain synthesis from the plant parameters requested, <0 never [s]
+	double			tuneCloopHz;	// its current loop bandwidth, 0 MCAT [Hz]
+	double			tuneSpeedHz;	// its speed loop bandwidth, 0 default [Hz]
+	const char		*csvPath;
+	unsigned int	csvDecim;		// CSV row every csvDecim PWM periods
+	bool			profile;		// print the ADC1 ISR stage times on exit
+	bool			hfi;			// manual control mode in the injection position mode
+	simInvParam_t	inv;
+	plantParam_t	plant;
+}simConfig_t;
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static const char * const scenarioName[] = {"startup", "loadstep", "fw", "restart", "iqstep"};
+static const char * const profStageName[PROF_STAGE_CNT] =
+{
+	"isr total", "meas save", "meas get", "fault detection", "state table", "observers",
+	"foc fast", "foc slow", "set dutycycle", "state led", "recorder", "deferred",
+	"pwm shift [cnt]"
+};
+
+static simConfig_t		simCfg;
+static pmsmPlant_t		simPlant;
+static ftm_state_t		simFtm2State;
+static jmp_buf			simExit;
+static FILE				*csvFile;
+static unsigned long	simPeriods;
+static int				simRestartStep;		// restart scenario: 0 running, 1 off, 2 on again, 3 sensorless again
+static double			simRestartTime;		// restart scenario: off to sensorless again [s]
+static double			simRestartRpm;		// restart scenario: plant speed when off [rpm]
+static bool				simTuneReq;			// gain synthesis requested
+static unsigned long	simActN;			// actuation angle: PWM periods averaged, the run state throughout
+static bool				simActValid;		// actuation angle: the window has not left the run state
+static double			simActT0;			// actuation angle: window start [s]
+static double			simActUInt0[2];		// actuation angle: plant dq voltage integrals at the start [V.s]
+static double			simActUReq[2];		// actuation angle: sum of the dq voltage requests [V]
+static double			simActEps;			// actuation angle: sum of the control frame errors at the ADC1 ISR [rad]
+static double			simActW;			// actuation angle: sum of the plant speeds [rad/s]
+static double			simIqHold;			// q-axis current steps: speed loop output at the switch to the current control [A]
+static unsigned long	simIqStepN;			// q-axis current steps: PWM periods summed
+static double			simIqStepErr;		// q-axis current steps: sum of the squared d-axis current errors [A2]
+static double			simIqStepW;			// q-axis current steps: sum of the plant speeds [rad/s]
+#if MOTOR_IDENT
+static bool				simIdentReq;		// identification requested at the first start
+#endif
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Prints command line help
+******************************************************************************/
+static void SIM_Usage(const char *name)
+{
+	printf("usage: %s [options]\n"
+		   "  --scenario startup|loadstep|fw|restart|iqstep  test scenario (default startup)\n"
+		   "  --time <s>        simulated time (default 6 s, loadstep and restart 9 s)\n"
+		   "  --speed <rpm>     required mechanical speed (default 1500, fw 1700, iqstep 2000)\n"
+		   "  --load <Nm>       load torque step (default 0.04)\n"
+		   "  --load-on <s>     load step time (default 6)\n"
+		   "  --load-off <s>    load release time (default 7.5)\n"
+		   "  --restart <s>     application off and on again (default 4)\n"
+		   "  --udc <V>         DC bus voltage (default 12, fw 10, iqstep 16)\n"
+		   "  --deadtime <cnt>  effective dead time in 80MHz ticks (default %u)\n"
+		   "  --switching       integrate between switching instants instead of period averages\n"
+		   "  --theta <rad>     initial rotor position (default 0.5)\n"
+		   "  --olramp <k>      open loop speed ramp, times OL_START_RAMP_INC (default 1)\n"
+		   "  --rs <Ohm> --ld <H> --lq <H> --psi <Vs> --j <kgm2> --b <Nms> --pp <->\n"
+		   "                    motor parameters (default LINIX 45ZWN24-40)\n"
+		   "  --ldsat <1/A>     d-axis saturation, incremental Ld/(1 + ldsat*id) (default 0)\n"
+		   "  --tune <s>        gain synthesis from the plant parameters at that time\n"
+		   "  --tune-cloop <Hz> --tune-speed <Hz>\n"
+		   "                    its current and speed loop bandwidths (default motor_tune.h)\n"
+		   "  --csv <file>      write a trace\n"
+		   "  --decim <n>       trace row every n PWM periods, control periods with SIM_PERIOD_STEP\n"
+		   "                    (default 60)\n"
+		   "  --profile         print the execution times of the ADC1 ISR stages and its load,\n"
+		   "                    needs PROF_ENABLE 1\n"
+		   "  --hfi             manual control mode in the injection position mode, needs POSPE_HFI 1\n"
+		   "  --tsa             list the FreeMASTER TSA table and exit\n",
+		   name, SIM_DEADTIME_TICKS);
+}
+
+/**************************************************************************//*!
+@brief			Lists the TSA tables of the application
+******************************************************************************/
+static void SIM_ListTsa(void)
+{
+	const FMSTR_TSA_GET_TABLE_FUNC	*table;
+	const FMSTR_TSA_ENTRY			*entry;
+	unsigned int					size, i;
+	static const char * const		info[] = {"struct", "member", "ro", "rw"};
+
+	for (table = FMSTR_TsaTableList; *table != NULL; table++)
+	{
+		entry = (*table)(&size);
+
+		for (i = 0U; i < size; i++)
+		{
+			printf("%-7s %-40s %-28s %4lu %4lu\n", info[entry[i].info & 3U], entry[i].name,
+				   (entry[i].type != NULL) ? entry[i].type : "-",
+				   (unsigned long)entry[i].offset, (unsigned long)entry[i].size);
+		}
+	}
+}
+
+/**************************************************************************//*!
+@brief			Prints the profiler statistics, host ticks are ns
+******************************************************************************/
+static void SIM_PrintProfile(void)
+{
+	unsigned int	i, j;
+
+	printf("stage [ns]          count    min   mean    max  log2 histogram\n");
+	for (i = 0U; i < (unsigned int)PROF_STAGE_CNT; i++)
+	{
+		const profStageStats_t *st = &profiler.stage[i];
+
+		if (st->count == 0U)
+		{
+			continue;
+		}
+		printf("%-16s %8lu %6lu %6lu %6lu ", profStageName[i], (unsigned long)st->count,
+			   (unsigned long)st->min, (unsigned long)(st->sum / st->count), (unsigned long)st->max);
+		for (j = 0U; j < PROF_HIST_BINS; j++)
+		{
+			printf(" %lu", (unsigned long)st->hist[j]);
+		}
+		printf("\n");
+	}
+}
+
+/**************************************************************************//*!
+@brief			Prints the ADC1 ISR load of the control loop
+
+@details		The FOC deadline is the time from the latest possible current
+				sample at the end of the second PWM period to the PDB1 ISR,
+				which copies the FOC results to the PWM registers. The maximum
+				of the host times is dominated by the host scheduler, only
+				the mean is printed. On the target profiler.stage[PROF_ISR_TOTAL]
+				holds the same statistics in core cycles.
+******************************************************************************/
+static void SIM_PrintLoad(void)
+{
+	const profStageStats_t	*st = &profiler.stage[PROF_ISR_TOTAL];
+	double					period, deadline;
+
+	if (st->count == 0U)
+	{
+		return;
+	}
+	period   = 1000.0 * (double)FOC_PERIOD_US;
+	deadline = 1.0e9 * (double)(FOC_PDB_IDLY - 2 * FTM_PERIOD_MOD) / (double)SIM_CORE_CLOCK_HZ;
+
+	printf("control loop    %u us, %u PWM periods, FOC deadline %.1f us after the last sample\n",
+		   (unsigned int)FOC_PERIOD_US, (unsigned int)FOC_PWM_PERIODS, deadline / 1000.0);
+	printf("cpu load        ADC1 ISR mean %.3f us, %.2f %% of the control loop (host)\n",
+		   (double)st->sum / (double)st->count / 1000.0, 100.0 * (double)st->sum / (double)st->count / period);
+}
+
+/**************************************************************************//*!
+@brief			Parses the command line into simCfg
+******************************************************************************/
+static int SIM_ParseArgs(int argc, char *argv[])
+{
+	int		i;
+	bool	udcSet = false, speedSet = false, timeSet = false;
+
+	simCfg.scenario			= scnStartup;
+	simCfg.speedRpm			= 1500.0;
+	simCfg.loadTorque		= 0.04;
+	simCfg.loadOn			= 6.0;
+	simCfg.loadOff			= 7.5;
+	simCfg.restart			= 4.0;
+	simCfg.thEl0			= 0.5;
+	simCfg.olRamp			= 1.0;
+	simCfg.tune				= -1.0;
+	simCfg.csvPath			= NULL;
+	simCfg.csvDecim			= 60U;
+	simCfg.profile			= false;
+	simCfg.hfi				= false;
+	simCfg.inv.udc			= 12.0;
+	simCfg.inv.deadTimeTicks= SIM_DEADTIME_TICKS;
+	simCfg.inv.switching	= false;
+	simCfg.plant.pp			= PLANT_PP;
+	simCfg.plant.rs			= PLANT_RS;
+	simCfg.plant.ld			= PLANT_LD;
+	simCfg.plant.lq			= PLANT_LQ;
+	simCfg.plant.psi		= PLANT_PSI;
+	simCfg.plant.j			= PLANT_J;
+	simCfg.plant.b			= PLANT_B;
+	simCfg.plant.ldSat		= PLANT_LD_SAT;
+
+	for (i = 1; i < argc; i++)
+	{
+		const char *opt = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+		if (strcmp(opt, "--switching") == 0)
+		{
+#if SIM_PERIOD_STEP
+			printf("--switching needs a build with SIM_PERIOD_STEP 0\n");
+			return -1;
+#else
+			simCfg.inv.switching = true;
+			continue;
+#endif
+		}
+		if (strcmp(opt, "--profile") == 0)
+		{
+#if PROF_ENABLE
+			simCfg.profile = true;
+			continue;
+#else
+			printf("--profile needs a build with PROF_ENABLE 1, make OPT=\"-O2 -DPROF_ENABLE=1\"\n");
+			return -1;
+#endif
+		}
+		if (strcmp(opt, "--hfi") == 0)
+		{
+#if POSPE_HFI
+			simCfg.hfi = true;
+			continue;
+#else
+			printf("--hfi needs a build with POSPE_HFI 1, make OPT=\"-O2 -DPOSPE_HFI=1\"\n");
+			return -1;
+#endif
+		}
+		if (strcmp(opt, "--tsa") == 0)
+		{
+			SIM_ListTsa();
+			exit(EXIT_SUCCESS);
+		}
+		if ((strcmp(opt, "--help") == 0) || (val == NULL))
+		{
+			SIM_Usage(argv[0]);
+			return -1;
+		}
+
+		i++;
+		if (strcmp(opt, "--scenario") == 0)
+		{
+			if      (strcmp(val, "startup") == 0)	simCfg.scenario = scnStartup;
+			else if (strcmp(val, "loadstep") == 0)	simCfg.scenario = scnLoadStep;
+			else if (strcmp(val, "fw") == 0)		simCfg.scenario = scnFieldWeak;
+			else if (strcmp(val, "restart") == 0)	simCfg.scenario = scnRestart;
+			else if (strcmp(val, "iqstep") == 0)	simCfg.scenario = scnIqStep;
+			else { SIM_Usage(argv[0]); return -1; }
+		}
+		else if (strcmp(opt, "--time") == 0)		{ simCfg.duration = atof(val); timeSet = true; }
+		else if (strcmp(opt, "--speed") == 0)		{ simCfg.speedRpm = atof(val); speedSet = true; }
+		else if (strcmp(opt, "--load") == 0)		simCfg.loadTorque = atof(val);
+		else if (strcmp(opt, "--load-on") == 0)		simCfg.loadOn = atof(val);
+		else if (strcmp(opt, "--load-off") == 0)	simCfg.loadOff = atof(val);
+		else if (strcmp(opt, "--restart") == 0)		simCfg.restart = atof(val);
+		else if (strcmp(opt, "--udc") == 0)			{ simCfg.inv.udc = atof(val); udcSet = true; }
+		else if (strcmp(opt, "--deadtime") == 0)	simCfg.inv.deadTimeTicks = (uint32_t)atoi(val);
+		else if (strcmp(opt, "--theta") == 0)		simCfg.thEl0 = atof(val);
+		else if (strcmp(opt, "--olramp") == 0)		simCfg.olRamp = atof(val);
+		else if (strcmp(opt, "--rs") == 0)			simCfg.plant.rs = atof(val);
+		else if (strcmp(opt, "--ld") == 0)			simCfg.plant.ld = atof(val);
+		else if (strcmp(opt, "--lq") == 0)			simCfg.plant.lq = atof(val);
+		else if (strcmp(opt, "--psi") == 0)			simCfg.plant.psi = atof(val);
+		else if (strcmp(opt, "--j") == 0)			simCfg.plant.j = atof(val);
+		else if (strcmp(opt, "--b") == 0)			simCfg.plant.b = atof(val);
+		else if (strcmp(opt, "--pp") == 0)			simCfg.plant.pp = atof(val);
+		else if (strcmp(opt, "--ldsat") == 0)		simCfg.plant.ldSat = atof(val);
+		else if (strcmp(opt, "--tune") == 0)		simCfg.tune = atof(val);
+		else if (strcmp(opt, "--tune-cloop") == 0)	simCfg.tuneCloopHz = atof(val);
+		else if (strcmp(opt, "--tune-speed") == 0)	simCfg.tuneSpeedHz = atof(val);
+		else if (strcmp(opt, "--csv") == 0)			simCfg.csvPath = val;
+		else if (strcmp(opt, "--decim") == 0)		simCfg.csvDecim = (unsigned int)atoi(val);
+		else { SIM_Usage(argv[0]); return -1; }
+	}
+
+	if (!timeSet)
+	{
+		simCfg.duration = ((simCfg.scenario == scnLoadStep) || (simCfg.scenario == scnRestart)) ? 9.0 : 6.0;
+	}
+	if ((simCfg.scenario == scnFieldWeak) && !udcSet)
+	{
+		simCfg.inv.udc = 10.0;
+	}
+	if ((simCfg.scenario == scnFieldWeak) && !speedSet)
+	{
+		simCfg.speedRpm = SIM_FW_SPEED_RPM;
+	}
+	if ((simCfg.scenario == scnIqStep) && !udcSet)
+	{
+		simCfg.inv.udc = SIM_IQSTEP_UDC;
+	}
+	if ((simCfg.scenario == scnIqStep) && !speedSet)
+	{
+		simCfg.speedRpm = SIM_IQSTEP_RPM;
+	}
+	if (simCfg.csvDecim == 0U)
+	{
+		simCfg.csvDecim = 1U;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//*!
+@brief			Applies the scenario inputs for the current simulated time
+******************************************************************************/
+static void SIM_Scenario(double t)
+{
+	double eD;
+
+	/* FreeMASTER user actions: application on, speed command. Without the
+	 * flying start the restart waits for the standstill, the calibration
+	 * would short the coasting motor by its zero vector with up to
+	 * psi/Ld, at I_PH_OVER, and the alignment assumes a standing rotor. */
+	if ((SIM_AXIS.cntrState.state == ready) && !SIM_AXIS.cntrState.usrControl.switchAppOnOff
+#if !FOC_FLYING_START
+		&& ((simRestartStep != 1) || (fabs(simPlant.wEl) < SIM_STANDSTILL_RPM * SIM_RPM_TO_WEL))
+#endif
+		)
+	{
+		SIM_AXIS.cntrState.usrControl.switchAppOnOff = true;
+#if POSPE_HFI
+		if (simCfg.hfi)
+		{
+			SIM_AXIS.cntrState.usrControl.controlMode = manual;
+			SIM_AXIS.pos_mode = hfi;
+		}
+#endif
+		if (simCfg.olRamp != 1.0)
+		{
+			SIM_AXIS.OL_SpeedRampInc = (tFloat)(simCfg.olRamp * OL_START_RAMP_INC);
+		}
+#if MOTOR_IDENT
+		if (!simIdentReq)
+		{
+			SIM_AXIS.drvFOC.motorIdent.request = true;
+			simIdentReq = true;
+		}
+#endif
+	}
+
+	if (SIM_AXIS.cntrState.state == run)
+	{
+		SIM_AXIS.drvFOC.pospeControl.wRotElReq = (tFloat)(simCfg.speedRpm * SIM_RPM_TO_WEL);
+	}
+
+	/* Restart: off once, the motor coasts until the application is back in
+	 * the sensorless mode */
+	if (simCfg.scenario == scnRestart)
+	{
+		if ((simRestartStep == 0) && (t >= simCfg.restart))
+		{
+			SIM_AXIS.cntrState.usrControl.switchAppOnOff = false;
+			simRestartRpm = simPlant.wEl / SIM_RPM_TO_WEL;
+			simRestartStep = 1;
+		}
+		else if ((simRestartStep == 1) && SIM_AXIS.cntrState.usrControl.switchAppOnOff)
+		{
+			simRestartStep = 2;
+		}
+		else if ((simRestartStep == 2) && (SIM_AXIS.cntrState.state == run) && (SIM_AXIS.pos_mode == sensorless1))
+		{
+			simRestartTime = t - simCfg.restart;
+			simRestartStep = 3;
+		}
+	}
+
+	/* FreeMASTER user action: motor parameters and bandwidths entered, synthesis requested */
+	if ((simCfg.tune >= 0.0) && !simTuneReq && (t >= simCfg.tune))
+	{
+		SIM_AXIS.drvFOC.motorTune.param.rs	= (tFloat)simCfg.plant.rs;
+		SIM_AXIS.drvFOC.motorTune.param.ld	= (tFloat)simCfg.plant.ld;
+		SIM_AXIS.drvFOC.motorTune.param.lq	= (tFloat)simCfg.plant.lq;
+		SIM_AXIS.drvFOC.motorTune.param.ke	= (tFloat)simCfg.plant.psi;
+		SIM_AXIS.drvFOC.motorTune.param.j	= (tFloat)simCfg.plant.j;
+		if (simCfg.tuneCloopHz > 0.0)
+		{
+			SIM_AXIS.drvFOC.motorTune.spec.cloopBw = MLIB_Mul(FLOAT_2_PI, (tFloat)simCfg.tuneCloopHz);
+		}
+		if (simCfg.tuneSpeedHz > 0.0)
+		{
+			SIM_AXIS.drvFOC.motorTune.spec.speedBw = MLIB_Mul(FLOAT_2_PI, (tFloat)simCfg.tuneSpeedHz);
+		}
+		SIM_AXIS.drvFOC.motorTune.request = true;
+#if MOTOR_MTPA
+		SIM_AXIS.drvFOC.motorMtpa.request = true;
+#endif
+		simTuneReq = true;
+	}
+
+	/* q-axis current steps: FreeMASTER user action, the current control mode
+	 * from the speed loop output on, the position mode stays sensorless */
+	if ((simCfg.scenario == scnIqStep) && (SIM_AXIS.cntrState.state == run) && (t >= SIM_IQSTEP_ON))
+	{
+		if (SIM_AXIS.cntrState.usrControl.FOCcontrolMode == speedControl)
+		{
+			simIqHold = SIM_AXIS.drvFOC.iDQReqInLoop.fltArg2;
+			SIM_AXIS.cntrState.usrControl.controlMode = manual;
+			SIM_AXIS.cntrState.usrControl.FOCcontrolMode = currentControl;
+		}
+		SIM_AXIS.drvFOC.iDQReqInLoop.fltArg2 = (tFloat)(simIqHold +
+			((fmod(t - SIM_IQSTEP_ON, 2.0 * SIM_IQSTEP_HALF) < SIM_IQSTEP_HALF) ? SIM_IQSTEP_AMPL : -SIM_IQSTEP_AMPL));
+
+		// d-axis current error from the first full square wave period on
+		if (t >= (SIM_IQSTEP_ON + 2.0 * SIM_IQSTEP_HALF))
+		{
+			eD = SIM_AXIS.drvFOC.iDQFbck.fltArg1 - SIM_AXIS.drvFOC.iDQReqInLoop.fltArg1;
+			simIqStepErr	+= eD * eD;
+			simIqStepW		+= simPlant.wEl;
+			simIqStepN++;
+		}
+	}
+
+	/* Mechanical load */
+	if ((simCfg.scenario == scnLoadStep) && (t >= simCfg.loadOn) && (t < simCfg.loadOff))
+	{
+		simPlant.tLoad = simCfg.loadTorque;
+	}
+	else
+	{
+		simPlant.tLoad = 0.0;
+	}
+
+}
+
+/**************************************************************************//*!
+@brief			Sums the voltage request and the applied plant voltage over the
+				end of the run
+
+@details		The request is in the control frame of the feedback, the applied
+				voltage in the rotor frame of the plant. With the control frame
+				error at the sample added, the angle between the means is the
+				rotation of the voltage by the actuation delay.
+******************************************************************************/
+static void SIM_Actuation(double t)
+{
+	double eps;
+
+	if (t < (simCfg.duration - SIM_ACT_WINDOW))
+	{
+		return;
+	}
+	if (SIM_AXIS.cntrState.state != run)
+	{
+		simActValid = false;
+		return;
+	}
+	if (simActN == 0U)
+	{
+		simActValid		= true;
+		simActT0		= t;
+		simActUInt0[0]	= simPlant.uDInt;
+		simActUInt0[1]	= simPlant.uQInt;
+	}
+
+	eps = atan2(SIM_AXIS.drvFOC.thTransform.fltArg1, SIM_AXIS.drvFOC.thTransform.fltArg2) - SIM_InverterIsrPosition();
+	simActEps		+= atan2(sin(eps), cos(eps));
+	simActUReq[0]	+= SIM_AXIS.drvFOC.uDQReq.fltArg1;
+	simActUReq[1]	+= SIM_AXIS.drvFOC.uDQReq.fltArg2;
+	simActW			+= simPlant.wEl;
+	simActN++;
+}
+
+/**************************************************************************//*!
+@brief			Writes one trace row
+******************************************************************************/
+static void SIM_CsvRow(double t)
+{
+	fprintf(csvFile, "%.6f,%d,%d,%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f,%.3f,%.5f,%.5f,%.3f\n",
+			t, (int)SIM_AXIS.cntrState.state, (int)SIM_AXIS.pos_mode,
+			SIM_AXIS.drvFOC.pospeControl.wRotElReq, SIM_AXIS.drvFOC.pospeSensorless.wRotEl, simPlant.wEl,
+			simPlant.thEl, SIM_AXIS.drvFOC.pospeControl.thRotEl,
+			simPlant.id, simPlant.iq,
+			SIM_AXIS.drvFOC.iDQFbck.fltArg1, SIM_AXIS.drvFOC.iDQFbck.fltArg2,
+			SIM_AXIS.drvFOC.iDQReqInLoop.fltArg1, SIM_AXIS.drvFOC.iDQReqInLoop.fltArg2,
+			SIM_AXIS.drvFOC.uDQReq.fltArg1, SIM_AXIS.drvFOC.uDQReq.fltArg2,
+			(double)SIM_AXIS.drvFOC.fltUdcb,
+			simPlant.te, simPlant.tLoad, simCfg.inv.udc);
+}
+
+/******************************************************************************
+| FreeMASTER driver replacement  (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Called by the application right after the MCU configuration
+******************************************************************************/
+FMSTR_BOOL FMSTR_Init(void)
+{
+	/* McuFtmConfig() registers a stack variable as FTM2 driver state, which is
+	 * used later on by FTM_DRV_QuadDecodeStart(). Re-register a static one. */
+	ftmStatePtr[INST_FLEXTIMER_QD2] = NULL;
+	(void)FTM_DRV_Init(INST_FLEXTIMER_QD2, &flexTimer_qd2_InitConfig, &simFtm2State);
+
+	PLANT_Init(&simPlant, &simCfg.plant);
+	PLANT_SetPosition(&simPlant, simCfg.thEl0);
+	SIM_InverterInit(&simPlant, &simCfg.inv);
+
+	return 1U;
+}
+
+/**************************************************************************//*!
+@brief			Called by the application background loop, one PWM period or
+				with SIM_PERIOD_STEP one control period
+******************************************************************************/
+void FMSTR_Poll(void)
+{
+	double t;
+
+#if SIM_PERIOD_STEP
+	uint32_t i;
+
+	for (i = 0U; i < FOC_PWM_PERIODS; i++)
+	{
+		SIM_InverterPeriod();
+	}
+	SIM_InverterPlantFlush();
+#else
+	SIM_InverterPeriod();
+#endif
+	simPeriods++;
+
+	t = SIM_InverterTime();
+	SIM_Scenario(t);
+	SIM_Actuation(t);
+
+	if ((csvFile != NULL) && ((simPeriods % simCfg.csvDecim) == 0U))
+	{
+		SIM_CsvRow(t);
+	}
+
+	if (t >= simCfg.duration)
+	{
+		longjmp(simExit, 1);
+	}
+}
+
+/**************************************************************************//*!
+@brief			Called by the SWI ISR, the recorder is not simulated
+******************************************************************************/
+void FMSTR_Recorder(void)
+{
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	struct timespec			tStart, tEnd;
+	double					wall, simTime, lag, wMean;
+	const simReloadStats_t	*reload;
+	int						status;
+
+	if (SIM_ParseArgs(argc, argv) != 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (simCfg.csvPath != NULL)
+	{
+		csvFile = fopen(simCfg.csvPath, "w");
+		if (csvFile == NULL)
+		{
+			perror(simCfg.csvPath);
+			return EXIT_FAILURE;
+		}
+		fprintf(csvFile, "t,state,pos_mode,wReq,wEst,wEl,thEl,thCtrl,id,iq,idFbck,iqFbck,idReq,iqReq,udReq,uqReq,udcMeas,te,tLoad,udc\n");
+	}
+
+	SIM_PlatformInit();
+	SIM_EdmaInit();
+
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+	if (setjmp(simExit) == 0)
+	{
+		(void)APP_main();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+
+	wall = (double)(tEnd.tv_sec - tStart.tv_sec) + 1.0e-9 * (double)(tEnd.tv_nsec - tStart.tv_nsec);
+	simTime = SIM_InverterTime();
+
+	if (csvFile != NULL)
+	{
+		fclose(csvFile);
+	}
+
+	printf("scenario        %s, %s model, Udc %.1f V\n", scenarioName[simCfg.scenario],
+		   simCfg.inv.switching ? "switching" : "averaged", simCfg.inv.udc);
+	printf("simulated       %.3f s in %.3f s, %.0fx real time\n", simTime, wall, simTime / wall);
+	printf("state           %d, position mode %d\n", (int)SIM_AXIS.cntrState.state, (int)SIM_AXIS.pos_mode);
+	printf("faults          mcu 0x%04x motor 0x%04x state machine 0x%04x\n",
+		   SIM_AXIS.permFaults.mcu.R, SIM_AXIS.permFaults.motor.R, SIM_AXIS.permFaults.stateMachine.R);
+	printf("speed [rpm]     required %.1f, estimated %.1f, plant %.1f\n",
+		   SIM_AXIS.drvFOC.pospeControl.wRotElReq / SIM_RPM_TO_WEL,
+		   SIM_AXIS.drvFOC.pospeSensorless.wRotEl / SIM_RPM_TO_WEL, simPlant.wEl / SIM_RPM_TO_WEL);
+	printf("current [A]     id %.3f, iq %.3f, id req %.3f, iq req %.3f\n",
+		   simPlant.id, simPlant.iq, SIM_AXIS.drvFOC.iDQReqInLoop.fltArg1, SIM_AXIS.drvFOC.iDQReqInLoop.fltArg2);
+	if (simActValid && (simActN > 1U))
+	{
+		lag = atan2(simActUReq[1], simActUReq[0]) + simActEps / (double)simActN
+			- atan2(simPlant.uQInt - simActUInt0[1], simPlant.uDInt - simActUInt0[0]);
+		lag = atan2(sin(lag), cos(lag));
+		wMean = simActW / (double)simActN;
+		printf("actuation       voltage %.4f rad behind the request, %.2f control loops at %.0f rpm\n", lag,
+			   (fabs(wMean) > 1.0) ? lag / (wMean * (double)FOC_PERIOD_US * 1.0e-6) : 0.0, wMean / SIM_RPM_TO_WEL);
+	}
+	status = (SIM_AXIS.cntrState.state == fault) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (simCfg.scenario == scnIqStep)
+	{
+		if (simIqStepN > 0U)
+		{
+			printf("d current       error %.4f A rms over the q-axis current steps at %.0f rpm\n",
+				   sqrt(simIqStepErr / (double)simIqStepN), simIqStepW / (double)simIqStepN / SIM_RPM_TO_WEL);
+		}
+		else
+		{
+			printf("d current       no q-axis current steps\n");
+			status = EXIT_FAILURE;
+		}
+	}
+	if (simCfg.scenario == scnRestart)
+	{
+		if (simRestartStep == 3)
+		{
+			printf("restart         off at %.1f rpm, sensorless again after %.1f ms\n", simRestartRpm, 1000.0 * simRestartTime);
+		}
+		else
+		{
+			printf("restart         off at %.1f rpm, not sensorless again\n", simRestartRpm);
+			status = EXIT_FAILURE;
+		}
+	}
+#if PWM_RELOAD_DMA && SIM_PERIOD_STEP
+	(void)reload;
+	printf("reload eDMA     not simulated, SIM_PERIOD_STEP\n");
+#elif PWM_RELOAD_DMA
+	reload = SIM_InverterReloadStats();
+	printf("reload eDMA     %u requests, %u checked, %u mismatches, %u eDMA errors\n",
+		   (unsigned int)reload->requests, (unsigned int)reload->checked,
+		   (unsigned int)reload->mismatches, (unsigned int)SIM_EdmaErrors());
+	if ((reload->checked == 0U) || (reload->mismatches != 0U) || (SIM_EdmaErrors() != 0U))
+	{
+		status = EXIT_FAILURE;
+	}
+#else
+	(void)reload;
+#endif
+#if MEAS_ADC_DMA
+	printf("ADC eDMA        %u frames taken, %u missed, %u re-aligned\n",
+		   (unsigned int)SIM_AXIS.meas.adcDma.taken, (unsigned int)SIM_AXIS.meas.adcDma.missed,
+		   (unsigned int)SIM_AXIS.meas.adcDma.resync);
+	if ((SIM_AXIS.meas.adcDma.taken == 0U) || (SIM_EdmaErrors() != 0U))
+	{
+		status = EXIT_FAILURE;
+	}
+#endif
+#if POSPE_IPD
+	printf("position detect %s, %.3f rad (rotor at %.3f rad), saliency %.4f, polarity %.4f\n",
+		   (SIM_AXIS.drvFOC.pospeIpd.status == ipdDone) ? "done" : ((SIM_AXIS.drvFOC.pospeIpd.status == ipdFailed) ? "failed" : "not run"),
+		   SIM_AXIS.drvFOC.pospeIpd.thRotEl, atan2(sin(simCfg.thEl0), cos(simCfg.thEl0)),
+		   SIM_AXIS.drvFOC.pospeIpd.saliency, SIM_AXIS.drvFOC.pospeIpd.polarity);
+#endif
+	if (simTuneReq)
+	{
+		printf("gain synthesis  %s, current Kp %.4f/%.4f V/A, speed Kp %.3e A.s/rad\n",
+			   SIM_AXIS.drvFOC.motorTune.error ? "rejected" :
+			   (SIM_AXIS.drvFOC.motorTune.loaded ? "loaded" : "not loaded"),
+			   0.5 * (SIM_AXIS.drvFOC.CurrentLoop.pPIrAWD.fltCC1sc - SIM_AXIS.drvFOC.CurrentLoop.pPIrAWD.fltCC2sc),
+			   0.5 * (SIM_AXIS.drvFOC.CurrentLoop.pPIrAWQ.fltCC1sc - SIM_AXIS.drvFOC.CurrentLoop.pPIrAWQ.fltCC2sc),
+			   SIM_AXIS.drvFOC.FwSpeedLoop.pPIpAWQ.fltPropGain);
+	}
+#if MOTOR_MTPA
+	printf("MTPA table      %s, flux %.5f to %.5f Vs/rad, plant torque %.4f Nm\n",
+		   SIM_AXIS.drvFOC.motorMtpa.valid ? "built" : (SIM_AXIS.drvFOC.motorMtpa.error ? "rejected" : "not built"),
+		   SIM_AXIS.drvFOC.motorMtpa.psiLow, SIM_AXIS.drvFOC.motorMtpa.psiHigh, simPlant.te);
+#endif
+#if MOTOR_IDENT
+	printf("motor ident     %s, plant in brackets\n"
+		   "                Rs %.4f (%.4f) Ohm, Ld %.4f (%.4f) mH, Lq %.4f (%.4f) mH\n"
+		   "                Ke %.6f (%.6f) Vs/rad, J %.3e (%.3e) kgm2\n",
+		   (SIM_AXIS.drvFOC.motorIdent.status == identDone) ? "done" :
+		   ((SIM_AXIS.drvFOC.motorIdent.status == identFailed) ? "failed" : "not finished"),
+		   SIM_AXIS.drvFOC.motorIdent.param.rs, simCfg.plant.rs,
+		   1.0e3 * SIM_AXIS.drvFOC.motorIdent.param.ld, 1.0e3 * simCfg.plant.ld,
+		   1.0e3 * SIM_AXIS.drvFOC.motorIdent.param.lq, 1.0e3 * simCfg.plant.lq,
+		   SIM_AXIS.drvFOC.motorIdent.param.ke, simCfg.plant.psi,
+		   SIM_AXIS.drvFOC.motorIdent.param.j, simCfg.plant.j);
+#endif
+	if (simCfg.profile)
+	{
+		SIM_PrintProfile();
+		SIM_PrintLoad();
+	}
+
+	return status;
+}
@@ -0,0 +1,226 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_platform.c
+*
+* @date     March-28-2017
+*
+* @brief    Host platform layer of the simulation
+*
+* @details	The peripheral register blocks are backed by anonymous host memory
+*			mapped at the S32K144 addresses, so the device header, the SDK
+*			drivers and the application access them unchanged. SDK services
+*			which need the core (clock, power, NVIC) or the FreeMASTER serial
+*			line are replaced here.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "sim_platform.h"
+#include "clock_manager.h"
+#include "power_manager.h"
+#include "interrupt_manager.h"
+#include "trgmux_driver.h"
+#include "lpuart_driver.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE		0x100000
+#endif
+
+#define SIM_PERIPH_BASE			0x40000000UL	// AIPS peripherals and GPIO
+#define SIM_PERIPH_SIZE			0x00100000UL
+#define SIM_PPB_BASE			0xE0000000UL	// private peripheral bus: SCB, NVIC, LMEM
+#define SIM_PPB_SIZE			0x00100000UL
+#define SIM_IRQ_COUNT			256
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+static bool irqEnabled[SIM_IRQ_COUNT];
+static bool irqPending[SIM_IRQ_COUNT];
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Maps zero initialized host memory at a device address
+******************************************************************************/
+static void SIM_MapRegion(uintptr_t base, size_t size)
+{
+	void *ptr;
+
+	ptr = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+	if ((ptr == MAP_FAILED) || (ptr != (void *)base))
+	{
+		fprintf(stderr, "sim: cannot map register block at 0x%08lx\n", (unsigned long)base);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Maps the register blocks, must be called before any register access
+******************************************************************************/
+void SIM_PlatformInit(void)
+{
+	SIM_MapRegion(SIM_PERIPH_BASE, SIM_PERIPH_SIZE);
+	SIM_MapRegion(SIM_PPB_BASE, SIM_PPB_SIZE);
+}
+
+/**************************************************************************//*!
+@brief			Returns true, when the application enabled the interrupt
+******************************************************************************/
+bool SIM_IsIrqEnabled(IRQn_Type irqNumber)
+{
+	return (((int32_t)irqNumber >= 0) && ((int32_t)irqNumber < SIM_IRQ_COUNT) && irqEnabled[irqNumber]);
+}
+
+/**************************************************************************//*!
+@brief			Returns true and clears the request, when the interrupt is
+				pending and enabled
+******************************************************************************/
+bool SIM_IrqTakePending(IRQn_Type irqNumber)
+{
+	if (!SIM_IsIrqEnabled(irqNumber) || !irqPending[irqNumber])
+	{
+		return false;
+	}
+	irqPending[irqNumber] = false;
+	return true;
+}
+
+/******************************************************************************
+| SDK replacements
+-----------------------------------------------------------------------------*/
+status_t CLOCK_SYS_Init(clock_manager_user_config_t const **clockConfigsPtr, uint8_t configsNumber,
+						clock_manager_callback_user_config_t **callbacksPtr, uint8_t callbacksNumber)
+{
+	(void)clockConfigsPtr;
+	(void)configsNumber;
+	(void)callbacksPtr;
+	(void)callbacksNumber;
+	return STATUS_SUCCESS;
+}
+
+status_t CLOCK_SYS_UpdateConfiguration(uint8_t targetConfigIndex, clock_manager_policy_t policy)
+{
+	(void)targetConfigIndex;
+	(void)policy;
+	return STATUS_SUCCESS;
+}
+
+status_t CLOCK_SYS_GetFreq(clock_names_t clockName, uint32_t *frequency)
+{
+	(void)clockName;
+	if (frequency != NULL)
+	{
+		*frequency = SIM_CORE_CLOCK_HZ;
+	}
+	return STATUS_SUCCESS;
+}
+
+status_t POWER_SYS_Init(power_manager_user_config_t * (*powerConfigsPtr)[], uint8_t configsNumber,
+						power_manager_callback_user_config_t * (*callbacksPtr)[], uint8_t callbacksNumber)
+{
+	(void)powerConfigsPtr;
+	(void)configsNumber;
+	(void)callbacksPtr;
+	(void)callbacksNumber;
+	return STATUS_SUCCESS;
+}
+
+status_t POWER_SYS_SetMode(uint8_t powerModeIndex, power_manager_policy_t policy)
+{
+	(void)powerModeIndex;
+	(void)policy;
+	return STATUS_SUCCESS;
+}
+
+void INT_SYS_EnableIRQ(IRQn_Type irqNumber)
+{
+	if (((int32_t)irqNumber >= 0) && ((int32_t)irqNumber < SIM_IRQ_COUNT))
+	{
+		irqEnabled[irqNumber] = true;
+	}
+}
+
+void INT_SYS_DisableIRQ(IRQn_Type irqNumber)
+{
+	if (((int32_t)irqNumber >= 0) && ((int32_t)irqNumber < SIM_IRQ_COUNT))
+	{
+		irqEnabled[irqNumber] = false;
+	}
+}
+
+void INT_SYS_SetPending(IRQn_Type irqNumber)
+{
+	if (((int32_t)irqNumber >= 0) && ((int32_t)irqNumber < SIM_IRQ_COUNT))
+	{
+		irqPending[irqNumber] = true;
+	}
+}
+
+void INT_SYS_ClearPending(IRQn_Type irqNumber)
+{
+	if (((int32_t)irqNumber >= 0) && ((int32_t)irqNumber < SIM_IRQ_COUNT))
+	{
+		irqPending[irqNumber] = false;
+	}
+}
+
+void INT_SYS_SetPriority(IRQn_Type irqNumber, uint8_t priority)
+{
+	/* Interrupts are dispatched in hardware event order, priorities do not apply */
+	(void)irqNumber;
+	(void)priority;
+}
+
+status_t TRGMUX_DRV_Init(const uint32_t instance, const trgmux_user_config_t * const trgmuxUserConfig)
+{
+	/* FTM3 initialization trigger to PDB1 is the only route the simulation models */
+	(void)instance;
+	(void)trgmuxUserConfig;
+	return STATUS_SUCCESS;
+}
+
+status_t TRGMUX_DRV_SetTrigSourceForTargetModule(const uint32_t instance,
+												 const trgmux_trigger_source_t triggerSource,
+												 const trgmux_target_module_t targetModule)
+{
+	/* Written to the register, sim_inverter.c reads the CMP0 to FTM3 fault route */
+	uint32_t shift = 8U * ((uint32_t)targetModule & 3U);
+	uint32_t reg   = TRGMUX->TRGMUXn[(uint32_t)targetModule >> 2U];
+
+	(void)instance;
+	TRGMUX->TRGMUXn[(uint32_t)targetModule >> 2U] = (reg & ~(0x3FUL << shift)) |
+													 (((uint32_t)triggerSource & 0x3FU) << shift);
+	return STATUS_SUCCESS;
+}
+
+status_t LPUART_DRV_Init(uint32_t instance, lpuart_state_t *lpuartStatePtr, const lpuart_user_config_t *lpuartUserConfig)
+{
+	(void)instance;
+	(void)lpuartStatePtr;
+	(void)lpuartUserConfig;
+	return STATUS_SUCCESS;
+}
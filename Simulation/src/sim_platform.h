@@ -0,0 +1,33 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     sim_platform.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the host platform layer of the simulation
+*
+*******************************************************************************/
+#ifndef _SIM_PLATFORM_H_
+#define _SIM_PLATFORM_H_
+
+#include <stdbool.h>
+#include "S32K144.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#define SIM_CORE_CLOCK_HZ		80000000U		// core, system and FTM/PDB clock
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void SIM_PlatformInit(void);
+extern bool SIM_IsIrqEnabled(IRQn_Type irqNumber);
+extern bool SIM_IrqTakePending(IRQn_Type irqNumber);
+
+#endif /* _SIM_PLATFORM_H_ */
@@ -10,77 +10,94 @@
 #define TSA_TABLE_H_
 
 #include "motor_structure.h"
+#include "profiler.h"
+#include "deferred.h"
 
 /* Structure type information will be available in the FreeMASTER application
   (TSA) by: */
 
 /*	*************** extern variables 		******************* */
-extern 		pmsmDrive_t 					drvFOC;
-extern 		encoderPospe_t					encoderPospe;
+extern		pmsmAxis_t						pmsmAxis[PMSM_AXIS_CNT];
 extern 		fm_scale_t 						fmScale;
-extern	 	pdbStatus_t						pdbStatus;
-extern  	driveStates_t					cntrState;
 extern  	gd3000Status_t					gd3000Status;
 extern		tpp_drv_config_t  				tppDrvConfig;
-extern  	appFaultStatus_t				tempfaults;
-extern  	appFaultStatus_t				permFaults;
-extern  	measModule_t					meas;
-extern  	tPos_mode						pos_mode;
-extern 		switchSensor_t					switchSensor;
-extern 		volatile tFloat					OL_SpeedRampInc, CL_SpeedRampInc, CL_SpeedRampDec;
-extern 		tBool							fieldWeakOnOff;
-extern		volatile tFloat					UDQVectorSum;
-extern		volatile tFloat					FW_PropGainControl;
-extern		volatile tFloat					FW_IntegGainControl;
 extern 		tFloat 							minZeroPulseCnt;
 extern 		tFloat 							minSamplingPulseCnt;
-extern 		tU16							adcRawResultArray[];
 extern		tU16 							pdbTriggerOffset;
-extern		PWM_3PHASE_EDGES_TYPE 			pwmEdgesFtm;
-extern		SWLIBS_3Syst_U16 				pwmDutyCnt;
-extern		SWLIBS_3Syst_U16 				pwmCenterPulseHalfWidthCnt;
-extern		tU16							pdbPretrigDelay[];
+extern		profiler_t						profiler;
+extern		deferMbox_t						deferMbox;
+
+/* Drive state of the board axis under the names used by the FreeMASTER project and MCAT */
+#define TSA_AXIS						(pmsmAxis[PMSM_AXIS_BOARD])
+#define TSA_AXIS_RW(name, type, member)	FMSTR_TSA_RW_MEM(name, type, &TSA_AXIS.member, sizeof(TSA_AXIS.member))
+#define TSA_AXIS_RO(name, type, member)	FMSTR_TSA_RO_MEM(name, type, &TSA_AXIS.member, sizeof(TSA_AXIS.member))
 
 
 /*	*************** begin TSA table - S32K_PMSM   ************* */
 FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
-	FMSTR_TSA_RW_VAR(encoderPospe,        		FMSTR_TSA_USERTYPE(encoderPospe_t))
-	FMSTR_TSA_RW_VAR(drvFOC,        			FMSTR_TSA_USERTYPE(pmsmDrive_t))
+	TSA_AXIS_RW(encoderPospe,        		FMSTR_TSA_USERTYPE(encoderPospe_t),		encoderPospe)
+	TSA_AXIS_RW(drvFOC,        				FMSTR_TSA_USERTYPE(pmsmDrive_t),		drvFOC)
 	FMSTR_TSA_RW_VAR(fmScale,      				FMSTR_TSA_USERTYPE(fm_scale_t))
-	FMSTR_TSA_RW_VAR(pdbStatus,        			FMSTR_TSA_USERTYPE(pdbStatus_t))
-	FMSTR_TSA_RW_VAR(cntrState,        			FMSTR_TSA_USERTYPE(driveStates_t))
+	TSA_AXIS_RW(pdbStatus,        			FMSTR_TSA_USERTYPE(pdbStatus_t),		pdbStatus)
+	TSA_AXIS_RW(cntrState,        			FMSTR_TSA_USERTYPE(driveStates_t),		cntrState)
 	FMSTR_TSA_RW_VAR(gd3000Status,      		FMSTR_TSA_USERTYPE(gd3000Status_t))
 	FMSTR_TSA_RW_VAR(tppDrvConfig,      		FMSTR_TSA_USERTYPE(tpp_drv_config_t))
-	FMSTR_TSA_RW_VAR(tempfaults,       			FMSTR_TSA_USERTYPE(appFaultStatus_t))
-	FMSTR_TSA_RW_VAR(permFaults,        		FMSTR_TSA_USERTYPE(appFaultStatus_t))
-	FMSTR_TSA_RW_VAR(meas,        				FMSTR_TSA_USERTYPE(measModule_t))
-	FMSTR_TSA_RW_VAR(pos_mode,       	 		FMSTR_TSA_USERTYPE(tPos_mode))
-	FMSTR_TSA_RW_VAR(switchSensor,       	 	FMSTR_TSA_USERTYPE(switchSensor_t))
-	FMSTR_TSA_RW_VAR(pwmDutyCnt,       	        FMSTR_TSA_USERTYPE(SWLIBS_3Syst_U16))
-	FMSTR_TSA_RW_VAR(pwmCenterPulseHalfWidthCnt,FMSTR_TSA_USERTYPE(SWLIBS_3Syst_U16))
-	FMSTR_TSA_RW_VAR(pwmEdgesFtm,				FMSTR_TSA_USERTYPE(PWM_3PHASE_EDGES_TYPE))
+	TSA_AXIS_RW(tempfaults,       			FMSTR_TSA_USERTYPE(appFaultStatus_t),	tempfaults)
+	TSA_AXIS_RW(permFaults,        			FMSTR_TSA_USERTYPE(appFaultStatus_t),	permFaults)
+	TSA_AXIS_RW(meas,        				FMSTR_TSA_USERTYPE(measModule_t),		meas)
+	TSA_AXIS_RW(pos_mode,       	 		FMSTR_TSA_USERTYPE(tPos_mode),			pos_mode)
+	TSA_AXIS_RW(switchSensor,       	 	FMSTR_TSA_USERTYPE(switchSensor_t),		switchSensor)
+	TSA_AXIS_RW(pwmDutyCnt,       	        FMSTR_TSA_USERTYPE(SWLIBS_3Syst_U16),	pwm.pwmDutyCnt)
+	TSA_AXIS_RW(pwmCenterPulseHalfWidthCnt,	FMSTR_TSA_USERTYPE(SWLIBS_3Syst_U16),	pwm.pwmCenterPulseHalfWidthCnt)
+	TSA_AXIS_RW(pwmEdgesFtm,				FMSTR_TSA_USERTYPE(PWM_3PHASE_EDGES_TYPE),	pwm.pwmEdgesFtm)
+	TSA_AXIS_RO(ftmFaultStatus,				FMSTR_TSA_UINT32,		pwm.ftmFaultStatus)
+	FMSTR_TSA_RW_VAR(profiler,					FMSTR_TSA_USERTYPE(profiler_t))
+	FMSTR_TSA_RO_VAR(deferMbox,					FMSTR_TSA_USERTYPE(deferMbox_t))
+	TSA_AXIS_RO(smEventQueue,				FMSTR_TSA_USERTYPE(smEventQueue_t),		smEventQueue)
 
 /*  ***************				VARIABLES 			    ******************* */
-    FMSTR_TSA_RW_VAR(CL_SpeedRampDec,   		FMSTR_TSA_FLOAT)
-	FMSTR_TSA_RW_VAR(CL_SpeedRampInc,     		FMSTR_TSA_FLOAT)
-	FMSTR_TSA_RW_VAR(OL_SpeedRampInc,     		FMSTR_TSA_FLOAT)
-	FMSTR_TSA_RW_VAR(fieldWeakOnOff,     		FMSTR_TSA_UINT8)
-	FMSTR_TSA_RW_VAR(UDQVectorSum,     			FMSTR_TSA_FLOAT)
-	FMSTR_TSA_RW_VAR(FW_PropGainControl,     	FMSTR_TSA_FLOAT)
-	FMSTR_TSA_RW_VAR(FW_IntegGainControl,     	FMSTR_TSA_FLOAT)
+	TSA_AXIS_RW(CL_SpeedRampDec,   			FMSTR_TSA_FLOAT,		CL_SpeedRampDec)
+	TSA_AXIS_RW(CL_SpeedRampInc,     		FMSTR_TSA_FLOAT,		CL_SpeedRampInc)
+	TSA_AXIS_RW(OL_SpeedRampInc,     		FMSTR_TSA_FLOAT,		OL_SpeedRampInc)
+	TSA_AXIS_RW(fieldWeakOnOff,     		FMSTR_TSA_UINT8,		fieldWeakOnOff)
+	TSA_AXIS_RW(UDQVectorSum,     			FMSTR_TSA_FLOAT,		UDQVectorSum)
+	TSA_AXIS_RW(FW_PropGainControl,     	FMSTR_TSA_FLOAT,		FW_PropGainControl)
+	TSA_AXIS_RW(FW_IntegGainControl,     	FMSTR_TSA_FLOAT,		FW_IntegGainControl)
 	FMSTR_TSA_RW_VAR(minZeroPulseCnt,     		FMSTR_TSA_UINT16)
 	FMSTR_TSA_RW_VAR(minSamplingPulseCnt,     	FMSTR_TSA_UINT16)
-	FMSTR_TSA_RW_VAR(adcRawResultArray[0],     	FMSTR_TSA_UINT16)
-	FMSTR_TSA_RW_VAR(adcRawResultArray[1],     	FMSTR_TSA_UINT16)
-	FMSTR_TSA_RW_VAR(adcRawResultArray[2],     	FMSTR_TSA_UINT16)
-	FMSTR_TSA_RW_VAR(adcRawResultArray[3],     	FMSTR_TSA_UINT16)
-	FMSTR_TSA_RW_VAR(adcRawResultArray[4],     	FMSTR_TSA_UINT16)
+	TSA_AXIS_RW(adcRawResultArray[0],     	FMSTR_TSA_UINT16,		meas.adcRawResultArray[0])
+	TSA_AXIS_RW(adcRawResultArray[1],     	FMSTR_TSA_UINT16,		meas.adcRawResultArray[1])
+	TSA_AXIS_RW(adcRawResultArray[2],     	FMSTR_TSA_UINT16,		meas.adcRawResultArray[2])
+	TSA_AXIS_RW(adcRawResultArray[3],     	FMSTR_TSA_UINT16,		meas.adcRawResultArray[3])
+	TSA_AXIS_RW(adcRawResultArray[4],     	FMSTR_TSA_UINT16,		meas.adcRawResultArray[4])
+#if MEAS_ADC_DMA
+	TSA_AXIS_RO(adcDma,						FMSTR_TSA_USERTYPE(measAdcDma_t),		meas.adcDma)
+#endif
 	FMSTR_TSA_RW_VAR(pdbTriggerOffset,     		FMSTR_TSA_UINT32)
-	FMSTR_TSA_RW_VAR(pdbPretrigDelay[0],     	FMSTR_TSA_UINT32)
-	FMSTR_TSA_RW_VAR(pdbPretrigDelay[1],     	FMSTR_TSA_UINT32)
-	FMSTR_TSA_RW_VAR(pdbPretrigDelay[2],     	FMSTR_TSA_UINT32)
-	FMSTR_TSA_RW_VAR(pdbPretrigDelay[3],     	FMSTR_TSA_UINT32)
-	FMSTR_TSA_RW_VAR(pdbPretrigDelay[4],     	FMSTR_TSA_UINT32)
+	TSA_AXIS_RW(pdbPretrigDelay[0],     	FMSTR_TSA_UINT32,		pwm.pdbPretrigDelay[0])
+	TSA_AXIS_RW(pdbPretrigDelay[1],     	FMSTR_TSA_UINT32,		pwm.pdbPretrigDelay[1])
+	TSA_AXIS_RW(pdbPretrigDelay[2],     	FMSTR_TSA_UINT32,		pwm.pdbPretrigDelay[2])
+	TSA_AXIS_RW(pdbPretrigDelay[3],     	FMSTR_TSA_UINT32,		pwm.pdbPretrigDelay[3])
+	TSA_AXIS_RW(pdbPretrigDelay[4],     	FMSTR_TSA_UINT32,		pwm.pdbPretrigDelay[4])
+#if ACTUATE_OVERSAMPLING
+	TSA_AXIS_RO(adcAvgCnt,					FMSTR_TSA_UINT16,		pwm.adcAvgCnt)
+#endif
+	TSA_AXIS_RW(pwmModulation,				FMSTR_TSA_UINT8,		pwm.pwmModulation)
+	TSA_AXIS_RO(pwmSwitchEdges,				FMSTR_TSA_UINT8,		pwm.pwmSwitchEdges)
+	TSA_AXIS_RO(switchLossRed,				FMSTR_TSA_FLOAT,		pwm.switchLossRedFilt.fltAcc)
+#if ACTUATE_OVERMODULATION
+	TSA_AXIS_RO(ovmModIndex,				FMSTR_TSA_FLOAT,		pwm.ovmModIndex)
+	TSA_AXIS_RO(ovmMode,					FMSTR_TSA_UINT8,		pwm.ovmMode)
+#endif
+#if ACTUATE_DEADTIME_COMP
+	TSA_AXIS_RW(dtcDeadTimeCnt,				FMSTR_TSA_UINT16,		pwm.dtcDeadTimeCnt)
+	TSA_AXIS_RO(dtcUA,						FMSTR_TSA_FLOAT,		pwm.dtcUAbc.fltArg1)
+	TSA_AXIS_RO(dtcUB,						FMSTR_TSA_FLOAT,		pwm.dtcUAbc.fltArg2)
+	TSA_AXIS_RO(dtcUC,						FMSTR_TSA_FLOAT,		pwm.dtcUAbc.fltArg3)
+#endif
+#if ACTUATE_DEADTIME_COMP == 2
+	FMSTR_TSA_RW_MEM(dtcTable,					FMSTR_TSA_FLOAT,		dtcTable, sizeof(dtcTable))
+#endif
 
 /*	*************** 			STRUCTURES              ******************* */
 	FMSTR_TSA_STRUCT(pospeControl_t)
@@ -101,6 +118,9 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 		FMSTR_TSA_MEMBER(openLoopPospe_t, 		iQUpperLimit, 		FMSTR_TSA_FLOAT)
 		FMSTR_TSA_MEMBER(openLoopPospe_t, 		iQLowerLimit, 		FMSTR_TSA_FLOAT)
 		FMSTR_TSA_MEMBER(openLoopPospe_t, 		thDifOpenLEstim, 	FMSTR_TSA_FLOAT)
+#if FOC_ANGLE_MERGE
+		FMSTR_TSA_MEMBER(openLoopPospe_t, 		thDifMerge, 		FMSTR_TSA_FLOAT)
+#endif
 		FMSTR_TSA_MEMBER(openLoopPospe_t, 		integ, 				FMSTR_TSA_USERTYPE(GFLIB_INTEGRATOR_TR_T_F32))
 
 	FMSTR_TSA_STRUCT(GFLIB_INTEGRATOR_TR_T_F32)
@@ -143,6 +163,95 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 		FMSTR_TSA_MEMBER(sensorLessPospe_t, 	TrackObsrv, 		FMSTR_TSA_USERTYPE(AMCLIB_TRACK_OBSRV_T_FLT))
 		FMSTR_TSA_MEMBER(sensorLessPospe_t, 	bEMFObs, 			FMSTR_TSA_USERTYPE(AMCLIB_BEMF_OBSRV_DQ_T_FLT))
 
+#if POSPE_IPD
+	FMSTR_TSA_STRUCT(ipdPospe_t)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			pulseVoltage, 		FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			pulseCnt, 			FMSTR_TSA_UINT16)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			polPulseCnt, 		FMSTR_TSA_UINT16)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			iResp, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			iPolPos, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			iPolNeg, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			thAxis, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			saliency, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			polarity, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			thRotEl, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(ipdPospe_t, 			status, 			FMSTR_TSA_USERTYPE(ipdStatus_t))
+
+#endif
+#if POSPE_HFI
+	FMSTR_TSA_STRUCT(hfiPospe_t)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			voltage, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			dIDQ, 				FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			phaseErr, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			thRotEl, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			wRotEl, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			wRotElFilt, 		FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(hfiPospe_t, 			TrackObsrv, 		FMSTR_TSA_USERTYPE(AMCLIB_TRACK_OBSRV_T_FLT))
+
+#endif
+	FMSTR_TSA_STRUCT(motorParam_t)
+		FMSTR_TSA_MEMBER(motorParam_t, 			rs, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(motorParam_t, 			ld, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(motorParam_t, 			lq, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(motorParam_t, 			ke, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(motorParam_t, 			j, 					FMSTR_TSA_FLOAT)
+
+	FMSTR_TSA_STRUCT(tuneSpec_t)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			ts, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			speedTs, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			cloopBw, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			cloopXi, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			bemfBw, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			bemfXi, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			toBw, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			toXi, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			speedBw, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(tuneSpec_t, 			speedXi, 			FMSTR_TSA_FLOAT)
+
+	FMSTR_TSA_STRUCT(tuneMotor_t)
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			param, 				FMSTR_TSA_USERTYPE(motorParam_t))
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			spec, 				FMSTR_TSA_USERTYPE(tuneSpec_t))
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			request, 			FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			pending, 			FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			loaded, 			FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(tuneMotor_t, 			error, 				FMSTR_TSA_UINT8)
+
+#if MOTOR_MTPA
+	FMSTR_TSA_STRUCT(mtpaMotor_t)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			iMax, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			uMaxNom, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			request, 			FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			valid, 				FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			error, 				FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			psiLow, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(mtpaMotor_t, 			psiHigh, 			FMSTR_TSA_FLOAT)
+#endif
+
+#if CLOOP_DEADBEAT
+	FMSTR_TSA_STRUCT(cloopDeadbeat_t)
+		FMSTR_TSA_MEMBER(cloopDeadbeat_t, 		gain, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(cloopDeadbeat_t, 		obsGain, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(cloopDeadbeat_t, 		iPred, 				FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+		FMSTR_TSA_MEMBER(cloopDeadbeat_t, 		uDist, 				FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+#endif
+
+#if MOTOR_IDENT
+	FMSTR_TSA_STRUCT(identMotor_t)
+		FMSTR_TSA_MEMBER(identMotor_t, 			current, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			pulseVoltage, 		FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			spinSpeed, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			spinAccel, 			FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			request, 			FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(identMotor_t, 			adopt, 				FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(identMotor_t, 			phase, 				FMSTR_TSA_UINT16)
+		FMSTR_TSA_MEMBER(identMotor_t, 			wEl, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			iDQ, 				FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+		FMSTR_TSA_MEMBER(identMotor_t, 			uDQ, 				FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+		FMSTR_TSA_MEMBER(identMotor_t, 			lag, 				FMSTR_TSA_FLOAT)
+		FMSTR_TSA_MEMBER(identMotor_t, 			param, 				FMSTR_TSA_USERTYPE(motorParam_t))
+		FMSTR_TSA_MEMBER(identMotor_t, 			status, 			FMSTR_TSA_USERTYPE(identStatus_t))
+
+#endif
 	FMSTR_TSA_STRUCT(AMCLIB_TRACK_OBSRV_T_FLT)
 		FMSTR_TSA_MEMBER(AMCLIB_TRACK_OBSRV_T_FLT, 	pParamPI, 		FMSTR_TSA_USERTYPE(GFLIB_CONTROLLER_PIAW_R_T_FLT))
 		FMSTR_TSA_MEMBER(AMCLIB_TRACK_OBSRV_T_FLT, 	pParamInteg, 	FMSTR_TSA_USERTYPE(GFLIB_INTEGRATOR_TR_T_FLT))
@@ -187,6 +296,9 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 	FMSTR_TSA_STRUCT(pmsmDrive_t)
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			alignCntr, 			FMSTR_TSA_UINT16)
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			alignVoltage, 		FMSTR_TSA_FLOAT)
+#if FOC_FLYING_START
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			catchCntr, 			FMSTR_TSA_UINT16)
+#endif
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			svmSector, 			FMSTR_TSA_UINT16)
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			iDQFbck, 			FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			iAlBeFbck, 			FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
@@ -194,6 +306,7 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			iDQReqOutLoop, 		FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uDQReq, 			FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uAlBeReq, 			FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uAlBeReqDTC, 		FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uAlBeReqDCB, 		FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uAlBeReqDCBLim, 	FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			uAlBEReqDCBTest, 	FMSTR_TSA_USERTYPE(SWLIBS_2Syst_FLT))
@@ -208,6 +321,22 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			pospeOpenLoop, 		FMSTR_TSA_USERTYPE(openLoopPospe_t))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			pospeControl, 		FMSTR_TSA_USERTYPE(pospeControl_t))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			pospeSensorless, 	FMSTR_TSA_USERTYPE(sensorLessPospe_t))
+#if POSPE_IPD
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			pospeIpd, 			FMSTR_TSA_USERTYPE(ipdPospe_t))
+#endif
+#if POSPE_HFI
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			pospeHfi, 			FMSTR_TSA_USERTYPE(hfiPospe_t))
+#endif
+#if MOTOR_IDENT
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			motorIdent, 		FMSTR_TSA_USERTYPE(identMotor_t))
+#endif
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			motorTune, 			FMSTR_TSA_USERTYPE(tuneMotor_t))
+#if MOTOR_MTPA
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			motorMtpa, 			FMSTR_TSA_USERTYPE(mtpaMotor_t))
+#endif
+#if CLOOP_DEADBEAT
+		FMSTR_TSA_MEMBER(pmsmDrive_t, 			cloopDeadbeat, 		FMSTR_TSA_USERTYPE(cloopDeadbeat_t))
+#endif
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			scalarControl, 		FMSTR_TSA_USERTYPE(scalarControl_t))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			CurrentLoop, 		FMSTR_TSA_USERTYPE(AMCLIB_CURRENT_LOOP_T_FLT))
 		FMSTR_TSA_MEMBER(pmsmDrive_t, 			FwSpeedLoop, 		FMSTR_TSA_USERTYPE(AMCLIB_FW_SPEED_LOOP_T_FLT))
@@ -402,6 +531,33 @@ FMSTR_TSA_TABLE_BEGIN(S32K_PMSM)
 		FMSTR_TSA_MEMBER(PWM_EDGES_TYPE, 		u16Edge3, 			FMSTR_TSA_UINT16)
 		FMSTR_TSA_MEMBER(PWM_EDGES_TYPE, 		u16Edge4, 			FMSTR_TSA_UINT16)
 
+	FMSTR_TSA_STRUCT(profiler_t)
+		FMSTR_TSA_MEMBER(profiler_t, 			stage, 				FMSTR_TSA_USERTYPE(profStageStats_t))
+		FMSTR_TSA_MEMBER(profiler_t, 			tickFreq, 			FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profiler_t, 			reset, 				FMSTR_TSA_UINT8)
+		FMSTR_TSA_MEMBER(profiler_t, 			resetDeferred, 		FMSTR_TSA_UINT8)
+
+	FMSTR_TSA_STRUCT(profStageStats_t)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		last, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		min, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		max, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		mean, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		count, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(profStageStats_t, 		hist, 				FMSTR_TSA_UINT32)
+
+	FMSTR_TSA_STRUCT(deferMbox_t)
+		FMSTR_TSA_MEMBER(deferMbox_t, 			head, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(deferMbox_t, 			tail, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(deferMbox_t, 			posted, 			FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(deferMbox_t, 			dropped, 			FMSTR_TSA_UINT32)
+
+	FMSTR_TSA_STRUCT(smEventQueue_t)
+		FMSTR_TSA_MEMBER(smEventQueue_t, 		head, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(smEventQueue_t, 		tail, 				FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(smEventQueue_t, 		pending, 			FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(smEventQueue_t, 		highWater, 			FMSTR_TSA_UINT32)
+		FMSTR_TSA_MEMBER(smEventQueue_t, 		dropped, 			FMSTR_TSA_UINT32)
+
 FMSTR_TSA_TABLE_END()
 
 // TSA table list
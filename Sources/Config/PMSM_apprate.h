@@ -0,0 +1,85 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     PMSM_apprate.h
+*
+* @date     March-28-2017
+*
+* @brief    FOC execution rate and the PMSM_appconfig.h constants rescaled to it
+*
+* @details	PMSM_appconfig.h is generated by MCAT for the 150us control loop
+*			(FOC_MCAT_PWM_PERIODS). The fast loop constants - current and
+*			observer PI controllers in the recurrent form, integrator gains,
+*			DQ back-EMF observer plant gains and durations counted in control
+*			loops - are rescaled to FOC_PWM_PERIODS here, the bandwidths and
+*			durations designed in MCAT are kept. The speed loop keeps its
+*			1.5ms period, only SPEED_LOOP_CNTR is rescaled. With the MCAT rate
+*			all constants are used exactly as generated.
+*
+*******************************************************************************/
+#ifndef _PMSM_APPRATE_H_
+#define _PMSM_APPRATE_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "PMSM_appconfig.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* FOC_PWM_PERIODS	FTM3 PWM periods (25us) per control loop, i.e. the ADC1 ISR rate
+ *		6	150us, MCAT default
+ *		5	125us
+ *		4	100us
+ *		3	 75us
+ * The single-shunt current samples take the first two PWM periods of the loop and
+ * the FOC calculation has to be done before the PDB1 ISR in the last one, there is
+ * no time left for it at 50us and 25us. */
+#ifndef FOC_PWM_PERIODS
+#define FOC_PWM_PERIODS			6
+#endif
+
+#if (FOC_PWM_PERIODS < 3) || (FOC_PWM_PERIODS > 6)
+#error "FOC_PWM_PERIODS out of range 3..6"
+#endif
+
+#define FOC_MCAT_PWM_PERIODS	6							// control loop of PMSM_appconfig.h
+#define FOC_PERIOD_US			(25 * FOC_PWM_PERIODS)		// control loop period [us]
+
+/* PDB1 sequence started by the FTM3 initialization trigger, the PDB1 ISR and the
+ * end of the sequence are in the last PWM period of the control loop */
+#define FOC_PDB_MOD				(2000*(FOC_PWM_PERIODS - 1) + 1300)
+#define FOC_PDB_IDLY			(2000*(FOC_PWM_PERIODS - 1) + 1200)
+
+/* Sample time ratio to the MCAT control loop */
+#define FOC_RATE_SAME			(FOC_PWM_PERIODS == FOC_MCAT_PWM_PERIODS)
+#define FOC_RATE_K				((double)FOC_PWM_PERIODS / (double)FOC_MCAT_PWM_PERIODS)
+
+/* Recurrent PI controller, CC1 = Kp + Ki*Ts/2, CC2 = -Kp + Ki*Ts/2 */
+#define FOC_RATE_CC1(cc1, cc2)	(FOC_RATE_SAME ? (cc1) : \
+								 (0.5*((cc1) - (cc2)) + 0.5*((cc1) + (cc2))*FOC_RATE_K))
+#define FOC_RATE_CC2(cc1, cc2)	(FOC_RATE_SAME ? (cc2) : \
+								 (-0.5*((cc1) - (cc2)) + 0.5*((cc1) + (cc2))*FOC_RATE_K))
+
+/* Gain proportional to the sample time, float and 32-bit fractional */
+#define FOC_RATE_GAIN(x)		(FOC_RATE_SAME ? (x) : ((x)*FOC_RATE_K))
+#define FOC_RATE_FRAC32(x)		(FOC_RATE_SAME ? (x) : (tS32)((double)(x)*FOC_RATE_K))
+
+/* Duration counted in control loops */
+#define FOC_RATE_CNT(n)			(((n)*FOC_MCAT_PWM_PERIODS)/FOC_PWM_PERIODS)
+
+/* DQ back-EMF observer plant, I_Gain = (2L - Ts*R)/(2L + Ts*R), U_Gain, E_Gain
+ * and WI_Gain are proportional to Ts/(2L + Ts*R). FOC_BEMF_Q is Ts*R/2L of the
+ * MCAT control loop. */
+#define FOC_BEMF_Q				((1.0 - (I_Gain))/(1.0 + (I_Gain)))
+#define FOC_RATE_BEMF_I(i)		(FOC_RATE_SAME ? (i) : \
+								 ((1.0 - FOC_RATE_K*FOC_BEMF_Q)/(1.0 + FOC_RATE_K*FOC_BEMF_Q)))
+#define FOC_RATE_BEMF(x)		(FOC_RATE_SAME ? (x) : \
+								 ((x)*FOC_RATE_K*(1.0 + FOC_BEMF_Q)/(1.0 + FOC_RATE_K*FOC_BEMF_Q)))
+
+#endif /* _PMSM_APPRATE_H_ */
@@ -17,11 +17,39 @@
 *******************************************************************************/
 #include "peripherals_config.h"
 #include "ftm_hw_access.h"
+#include "actuate_s32k.h"
+#include "PMSM_apprate.h"
+#include "motor_structure.h"
 
 
 ftm_state_t statePwm;
 
-extern uint16_t pdbPretrigDelay[5];
+#if PWM_RELOAD_DMA
+/* FTM3 CnV reload channel, requested by FTM3 channel 6 match */
+static const edma_channel_config_t pwmReloadDmaChnConfig = {
+    .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+    .virtChnConfig = PWM_RELOAD_DMA_CHN,
+    .source = EDMA_REQ_FTM3_OR_CH0_CH7,
+    .callback = NULL,
+    .callbackParam = NULL,
+    .enableTrigger = false
+};
+
+#endif
+
+#if MEAS_ADC_DMA
+/* ADC1 result frame channel, requested by ADC1 conversion complete */
+static edma_chn_state_t adcFrameDmaChnState;
+static const edma_channel_config_t adcFrameDmaChnConfig = {
+    .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+    .virtChnConfig = MEAS_ADC_DMA_CHN,
+    .source = EDMA_REQ_ADC1,
+    .callback = NULL,
+    .callbackParam = NULL,
+    .enableTrigger = false
+};
+
+#endif
 
 #define PWM_DEBUG_MODE	1
 
@@ -75,11 +103,15 @@ void McuIntConfig(void)
     INT_SYS_EnableIRQ(PDB1_IRQn);						// Enable PDB1 interrupt
 	INT_SYS_EnableIRQ(ADC1_IRQn);						// Enable ADC1 interrupt
 	INT_SYS_EnableIRQ(PORTE_IRQn);						// Enable PORTE interrupt
+#if !PWM_RELOAD_DMA
 	INT_SYS_EnableIRQ(FTM3_Ovf_Reload_IRQn);			// Enable FTM3 reload interrupt
+#endif
 	INT_SYS_SetPriority(PDB1_IRQn, 0);
 	INT_SYS_SetPriority(ADC1_IRQn, 2);
 	INT_SYS_SetPriority(PORTE_IRQn, 2);
+#if !PWM_RELOAD_DMA
 	INT_SYS_SetPriority(FTM3_Ovf_Reload_IRQn, 0);
+#endif
 }
 
 /*******************************************************************************
@@ -196,20 +228,20 @@ void McuPdbConfig(void)
 	/* PDB1 CH0 pre-trigger4 initialization */
 	PDB_DRV_ConfigAdcPreTrigger(INST_PDB1, 0, &pdb1_AdcTrigInitConfig4);
 
-	/* Set PDB1 modulus value */
-	PDB_DRV_SetTimerModulusValue(INST_PDB1, 2000*5 + 1300);
+	/* Set PDB1 modulus value, last PWM period of the control loop */
+	PDB_DRV_SetTimerModulusValue(INST_PDB1, FOC_PDB_MOD);
 	/* Set PDB1 delay value for interrupt generation */
-	PDB_DRV_SetValueForTimerInterrupt(INST_PDB1, 2000*5 + 1200);
+	PDB_DRV_SetValueForTimerInterrupt(INST_PDB1, FOC_PDB_IDLY);
 	/* PDB1 CH0 pre-trigger0 delay set to sense DC bus current */
-	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 0, pdbPretrigDelay[0]);
+	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 0, pmsmAxis[PMSM_AXIS_FTM3].pwm.pdbPretrigDelay[0]);
 	/* PDB1 CH0 pre-trigger0 delay set to sense DC bus current */
-	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 1, pdbPretrigDelay[1]);
+	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 1, pmsmAxis[PMSM_AXIS_FTM3].pwm.pdbPretrigDelay[1]);
 	/* PDB1 CH0 pre-trigger0 delay set to sense DC bus voltage */
-	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 2, pdbPretrigDelay[2]);
+	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 2, pmsmAxis[PMSM_AXIS_FTM3].pwm.pdbPretrigDelay[2]);
 	/* PDB1 CH0 pre-trigger0 delay set to sense DC bus current */
-	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 3, pdbPretrigDelay[3]);
+	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 3, pmsmAxis[PMSM_AXIS_FTM3].pwm.pdbPretrigDelay[3]);
 	/* PDB1 CH0 pre-trigger0 delay set to sense DC bus current */
-	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 4, pdbPretrigDelay[4]);
+	PDB_DRV_SetAdcPreTriggerDelayValue(INST_PDB1, 0, 4, pmsmAxis[PMSM_AXIS_FTM3].pwm.pdbPretrigDelay[4]);
 
 	// enable PDB before LDOK
 	PDB_DRV_Enable(INST_PDB1);
@@ -243,14 +275,106 @@ void McuFtmConfig(void)
 	/* FTM3 module initialized as PWM signals generator */
 	FTM_DRV_Init(INST_FLEXTIMER_PWM3, &flexTimer_pwm3_InitConfig, &statePwm);
 
+#if PWM_RELOAD_DMA
+	/* FTM3 reload is served by eDMA, no reload interrupt */
+	FTM_DRV_SetTimerOverflowInt(FTM3, false);
+	INT_SYS_DisableIRQ(FTM3_Ovf_Reload_IRQn);
+
+	/* FTM3 channel 6 output compare shortly after the reload point requests the eDMA
+	 * transfer, the channel 6 pin is not routed to FTM3 */
+	FTM_DRV_SetChnCountVal(FTM3, PWM_RELOAD_FTM_CHN, PWM_RELOAD_FTM_CNT);
+	FTM_DRV_SetChnMSnBAMode(FTM3, PWM_RELOAD_FTM_CHN, 1U);
+	FTM_DRV_SetChnEdgeLevel(FTM3, PWM_RELOAD_FTM_CHN, 1U);
+	FTM_DRV_SetChnDmaCmd(FTM3, PWM_RELOAD_FTM_CHN, true);
+	FTM_DRV_EnableChnInt(FTM3, PWM_RELOAD_FTM_CHN);
+#endif
+
+#if FAST_TRIP
+	/* FTM3 fault input 0 driven by the CMP0 output through TRGMUX, active high, no
+	 * filter (CMP0 has its own), all channels forced to the safe state until cleared
+	 * by software */
+	flexTimer_pwm3_FaultConfig.faultMode = FTM_FAULT_CONTROL_MAN_ALL;
+	flexTimer_pwm3_FaultConfig.ftmFaultChannelParam[0].faultChannelEnabled = true;
+	flexTimer_pwm3_FaultConfig.ftmFaultChannelParam[0].faultFilterEnabled = false;
+	flexTimer_pwm3_FaultConfig.ftmFaultChannelParam[0].ftmFaultPinPolarity = FTM_POLARITY_HIGH;
+#endif
+
 	/* FTM3 module PWM initialization */
 	FTM_DRV_InitPwm(INST_FLEXTIMER_PWM3, &flexTimer_pwm3_PwmConfig);
 
+#if FAST_TRIP
+	/* Drop a fault flag set while the comparator was settling */
+	FTM_DRV_ClearFaultsIsr(FTM3);
+#endif
+
 	/* Mask all FTM3 channels to disable PWM output */
 	FTM_DRV_MaskOutputChannels(INST_FLEXTIMER_PWM3, 0x3F, true);
 
 }
 
+/*******************************************************************************
+*
+* Function: 	void McuCmpConfig(void)
+*
+* Description:  This function configures CMP0 as the hardware fast-trip
+* 				comparator, see FAST_TRIP. The DC-bus current amplifier output
+* 				is compared with the 8-bit DAC set by
+* 				ACTUATE_FastTripThreshold() and the filtered comparator output
+* 				is routed by TRGMUX to the FTM3 fault input 0. Has to be called
+* 				after McuTrigmuxConfig() and before McuFtmConfig().
+*
+*******************************************************************************/
+#if FAST_TRIP
+void McuCmpConfig(void)
+{
+	/* CMP0 clock gate */
+	PCC->PCCn[PCC_CMP0_INDEX] |= PCC_PCCn_CGC_MASK;
+
+	/* Plus input: analog mux, DC-bus current amplifier; minus input: DAC, VIN1 = VDDA */
+	CMP0->C1 = CMP_C1_INPSEL(1U) | CMP_C1_PSEL(FAST_TRIP_CMP_IN) | CMP_C1_INNSEL(0U) |
+			   CMP_C1_DACEN_MASK | CMP_C1_VRSEL(0U);
+
+	/* Nominal amplifier offset, corrected after the calibration */
+	ACTUATE_FastTripThreshold(I_DCB_MAX);
+
+	/* High speed mode, sampled filter and hysteresis against the switching noise */
+	CMP0->C0 = CMP_C0_EN_MASK | CMP_C0_PMODE_MASK | CMP_C0_FILTER_CNT(FAST_TRIP_CMP_FILTER) |
+			   CMP_C0_FPR(FAST_TRIP_CMP_FPR) | CMP_C0_HYSTCTR(1U);
+
+	/* CMP0 output to the FTM3 fault input 0 */
+	TRGMUX_DRV_SetTrigSourceForTargetModule(INST_TRGMUX1, TRGMUX_TRIG_SOURCE_CMP0_OUT,
+											TRGMUX_TARGET_MODULE_FTM3_FAULT0);
+}
+#endif
+
+/*******************************************************************************
+*
+* Function: 	void McuDmaConfig(void)
+*
+* Description:  This function configures eDMA module and the eDMA channels
+* 				which reload the FTM3 PWM registers, see PWM_RELOAD_DMA, and
+* 				capture the ADC1 results, see MEAS_ADC_DMA. The channels are
+* 				started by ACTUATE_PwmReloadDmaInit() and MEAS_AdcDmaInit().
+*
+*******************************************************************************/
+#if PWM_RELOAD_DMA || MEAS_ADC_DMA
+void McuDmaConfig(void)
+{
+	/* eDMA module initialization */
+	EDMA_DRV_Init(&dmaController1_State, &dmaController1_InitConfig0, NULL, NULL, 0U);
+
+#if PWM_RELOAD_DMA
+	/* FTM3 reload channel initialization */
+	EDMA_DRV_ChannelInit(&dmaController1Chn0_State, &pwmReloadDmaChnConfig);
+#endif
+
+#if MEAS_ADC_DMA
+	/* ADC1 result frame channel initialization */
+	EDMA_DRV_ChannelInit(&adcFrameDmaChnState, &adcFrameDmaChnConfig);
+#endif
+}
+#endif
+
 /*******************************************************************************
 *
 * Function: 	void McuCacheConfig(void)
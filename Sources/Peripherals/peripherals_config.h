@@ -50,6 +50,8 @@ void McuLpuartConfig(void);
 void McuAdcConfig(void);
 void McuPdbConfig(void);
 void McuFtmConfig(void);
+void McuCmpConfig(void);
+void McuDmaConfig(void);
 void McuCacheConfig(void);
 //void McuMpuInit(void);
 //void McuLpitConfig(void);
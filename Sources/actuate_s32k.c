@@ -23,6 +23,8 @@
 #include "gdflib.h"
 #include "pdb_driver.h"
 #include "ftm_pwm_driver.h"
+#include "ftm_hw_access.h"
+#include "meas_s32k.h"
 
 /******************************************************************************
 | External declarations
@@ -31,48 +33,455 @@
 /******************************************************************************
 | Defines and macros            (scope: module-local)
 -----------------------------------------------------------------------------*/
+#define PWM_RELOAD_EVEN		0U		// image index of the even cycle edges (Edge3, Edge4)
+#define PWM_RELOAD_ODD		1U		// image index of the odd cycle edges (Edge1, Edge2)
+
+#define OVM_TABLE_SIZE		9U		// points of the overmodulation tables
 
 /******************************************************************************
 | Typedefs and structures       (scope: module-local)
 -----------------------------------------------------------------------------*/
+typedef struct
+{
+	tU8		hi;		//index of the phase with the highest duty
+	tU8		mid;	//index of the phase with the middle duty
+	tU8		lo;		//index of the phase with the lowest duty
+}PWM_SECTOR_ORDER_TYPE;
 
 /******************************************************************************
 | Global variable definitions   (scope: module-exported)
 -----------------------------------------------------------------------------*/
-tU32 pwmCycleCnt = 0;    //it's incremented in each PWM cycle. Different PWM edge values are loaded depending on this value is even or odd
-
-tU16 pdbPretrigDelay[5] =
-{
-	FTM_PERIOD_MOD-600,
-	FTM_PERIOD_MOD-400,
-	FTM_PERIOD_MOD,
-	FTM_PERIOD_MOD+400,
-	FTM_PERIOD_MOD+600
-};	                     //pretrigger delay initial values for PDB1 channel 0 Delay 0 ~ Delay 4 registers
-
 tU16 pdbTriggerOffset = 40;	    //40cnt=0.5uS, this offset duration is the ADC sampling time (not including the conversion time) for one channel;
 
 /******************************************************************************
 | Global variable definitions   (scope: module-local)
 -----------------------------------------------------------------------------*/
-PWM_3PHASE_EDGES_TYPE   pwmEdgesFoc;		        //PWM A B C edges in cnt, calculated by FOC generated PWM duties;
-PWM_3PHASE_EDGES_TYPE   pwmEdgesFtm;		        //PWM A B C edges in cnt, same value as pwmEdgesFoc, used to update to FTM3 CnV registers;
-SWLIBS_3Syst_U16        pwmDutyCnt;		            //PWM A B C duties in cnt;
-SWLIBS_3Syst_U16        pwmCenterPulseHalfWidthCnt;	//PWM center pulse half-width in cnt;
-
 uint32_t                minZeroPulseCnt = 80;		//80cnt = 1uS at 80MHz bus clock; it's the center pulse half width;
 uint32_t                minSamplingPulseCnt = 120;	//min sample time 1.5uS; it's the min time from on Phase Voltage edge to a phase current stable suitable for sampling;
 										            //ADC sample time is 12 cycle, so it's actually 0.3uS; (12/40MHz=0.3uS)
 uint32_t                minSumPulseCnt = 200;		//80 + 120;
 
+#if ACTUATE_DEADTIME_COMP == 2
+tFloat                  dtcTable[ACTUATE_DTC_TABLE_SIZE] =	//part of the dead time error at 0 ~ ACTUATE_DTC_TABLE_I_MAX, to be replaced by the measured one;
+{
+	0.0F, 0.45F, 0.75F, 0.90F, 0.96F, 0.99F, 1.0F, 1.0F, 1.0F
+};
+#endif
+
+static const tU16 pdbPretrigDelayInit[5] = PDB_PRETRIG_DELAY_INIT;
+
+static const PWM_SECTOR_ORDER_TYPE pwmSectorOrder[7] =
+{
+	{0, 0, 0},		//sector 0 is not used, see ACTUATE_SetDefaultEdges
+	{0, 1, 2},		//sector 1: duty A > duty B > duty C
+	{1, 0, 2},		//sector 2: duty B > duty A > duty C
+	{1, 2, 0},		//sector 3: duty B > duty C > duty A
+	{2, 1, 0},		//sector 4: duty C > duty B > duty A
+	{2, 0, 1},		//sector 5: duty C > duty A > duty B
+	{0, 2, 1}		//sector 6: duty A > duty C > duty B
+};
+
+#if ACTUATE_OVERMODULATION
+/* Overmodulation mode I, reference circle radius at the fundamental 1.0 ~ ACTUATE_OVM_MODE2 */
+static const tFloat ovmRadiusTable[OVM_TABLE_SIZE] =
+{
+	1.00029F, 1.00678F, 1.01436F, 1.02302F, 1.03294F, 1.04445F, 1.05815F, 1.07525F, 1.09911F
+};
+
+/* Overmodulation mode II, angle from the side centre where the hold starts, at the fundamental
+ * ACTUATE_OVM_MODE2 ~ ACTUATE_OVM_LIMIT */
+static const tFloat ovmHoldTable[OVM_TABLE_SIZE] =
+{
+	0.42792F, 0.40005F, 0.37015F, 0.33770F, 0.30188F, 0.26128F, 0.21321F, 0.15067F, 0.0F
+};
+
+/* Outer normals of the voltage hexagon sides centred at -150 + side*60 degrees */
+static const SWLIBS_2Syst_FLT ovmSideNormal[6] =
+{
+	{-0.86602540F, -0.5F},
+	{ 0.0F,        -1.0F},
+	{ 0.86602540F, -0.5F},
+	{ 0.86602540F,  0.5F},
+	{ 0.0F,         1.0F},
+	{-0.86602540F,  0.5F}
+};
+#endif
+
 /******************************************************************************
 | Function prototypes           (scope: module-local)
 -----------------------------------------------------------------------------*/
+static void ACTUATE_SetDefaultEdges(actuatePwm_t *ptr);
+static tBool ACTUATE_ClampHi(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order);
+static tBool ACTUATE_ClampLo(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order);
+static void ACTUATE_Dpwm(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order);
+#if ACTUATE_OVERSAMPLING
+static void ACTUATE_Oversample(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order);
+#endif
 
 /******************************************************************************
 | Function implementations      (scope: module-local)
 -----------------------------------------------------------------------------*/
 
+/**************************************************************************//*!
+@brief Calculate the 4 edges of one phase for consecutive two periods
+
+@param	edges,                  output, PWM edges of the phase;
+		halfWidthCnt,           input, center pulse half-width in cnt;
+		dutyCnt,                input, phase duty in cnt;
+
+@return
+******************************************************************************/
+static inline void ACTUATE_CalcEdges(PWM_EDGES_TYPE *edges, tU16 halfWidthCnt, tU16 dutyCnt)
+{
+	//1st 25uS PWM Edges;
+	edges->u16Edge1 = FTM_PERIOD_MOD - halfWidthCnt - dutyCnt;
+	edges->u16Edge2 = FTM_PERIOD_MOD - halfWidthCnt;
+	//2nd 25uS PWM Edges;
+	edges->u16Edge3 = halfWidthCnt;
+	edges->u16Edge4 = halfWidthCnt + dutyCnt;
+}
+
+#if ACTUATE_REDUCED_SHIFT
+/**************************************************************************//*!
+@brief Centre pulse half-width of a phase for the reduced phase shift
+
+@param	diffCnt,                input, duty difference to the phase below, the natural window;
+		baseCnt,                input, centre pulse half-width of the phase below;
+		dutyCnt,                input, phase duty in cnt;
+
+@return	Centre pulse half-width in cnt, 0 when the natural window is wide enough
+
+@details	The phase is shifted by the missing window width, but not by less than
+			minZeroPulseCnt to avoid narrow pulses. The shift is limited to keep the
+			pulses of both periods inside them; the window is narrower then, the
+			voltage stays exact.
+******************************************************************************/
+static inline tU16 ACTUATE_ShiftCnt(tU32 diffCnt, tU32 baseCnt, tU32 dutyCnt)
+{
+	tU32	halfWidth = baseCnt + minSamplingPulseCnt;
+	tU32	limit = FTM_PERIOD_MOD - dutyCnt;
+
+	if(diffCnt >= halfWidth)
+	{
+		return 0U;
+	}
+
+	halfWidth -= diffCnt;
+	if(halfWidth < minZeroPulseCnt)
+	{
+		halfWidth = minZeroPulseCnt;
+	}
+	if(halfWidth > limit)
+	{
+		halfWidth = (limit < minZeroPulseCnt) ? 0U : limit;
+	}
+
+	return (tU16)halfWidth;
+}
+#endif
+
+/**************************************************************************//*!
+@brief Number of edges of one phase in the two periods
+
+@param	dutyCnt,                input, phase duty in cnt;
+		halfWidthCnt,           input, center pulse half-width in cnt;
+
+@return	0 for a clamped phase, 2 without and 4 with the center pulse
+******************************************************************************/
+static inline tU32 ACTUATE_PhaseEdges(tU16 dutyCnt, tU16 halfWidthCnt)
+{
+	if((dutyCnt == 0U) || (dutyCnt >= FTM_PERIOD_MOD))
+	{
+		return 0U;
+	}
+
+	return (halfWidthCnt == 0U) ? 2U : 4U;
+}
+
+/**************************************************************************//*!
+@brief Edges and pre-triggers for an invalid sector
+
+@param	ptr,                    input/output, actuator, pwmDutyCnt are the phase duties in cnt;
+
+@return
+
+@details	Symmetrical pulses with 80cnt center pulse and the initial
+			pre-trigger delays. Not used in the normal operation, so it is
+			kept out of the RAM section.
+******************************************************************************/
+static void ACTUATE_SetDefaultEdges(actuatePwm_t *ptr)
+{
+	tU32 i;
+
+	ptr->pwmCenterPulseHalfWidthCnt.u16Arg1 = 80;
+	ptr->pwmCenterPulseHalfWidthCnt.u16Arg2 = 80;
+	ptr->pwmCenterPulseHalfWidthCnt.u16Arg3 = 80;
+
+	//Calculate Phase A B C PWM edges for consecutive two periods;
+	ACTUATE_CalcEdges(&ptr->pwmEdgesFoc.EdgesPhaseA, ptr->pwmCenterPulseHalfWidthCnt.u16Arg1, ptr->pwmDutyCnt.u16Arg1);
+	ACTUATE_CalcEdges(&ptr->pwmEdgesFoc.EdgesPhaseB, ptr->pwmCenterPulseHalfWidthCnt.u16Arg2, ptr->pwmDutyCnt.u16Arg2);
+	ACTUATE_CalcEdges(&ptr->pwmEdgesFoc.EdgesPhaseC, ptr->pwmCenterPulseHalfWidthCnt.u16Arg3, ptr->pwmDutyCnt.u16Arg3);
+
+	for(i = 0; i<5; i++)
+	{
+		ptr->pdbPretrigDelay[i] = pdbPretrigDelayInit[i];
+	}
+	ptr->adcAvgCnt = 1U;
+	ptr->phaseShiftCnt = 0U;
+}
+
+/**************************************************************************//*!
+@brief Clamp the highest duty phase to the positive rail
+
+@param	ptr,                    input/output, actuator, pwmDutyCnt and pwmCenterPulseHalfWidthCnt are
+								modified when the phase is clamped;
+		order,                  input, phases sorted by their duties;
+
+@return	true when clamped, false when the hi window would be too narrow
+
+@details	A common offset moves the highest duty to 100%, the phase loses its
+			center pulse. The hi window lasts from the start of the period to the
+			rising edge of the middle phase, the middle phase keeps its center
+			pulse for the lo window.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+static tBool ACTUATE_ClampHi(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order)
+{
+	tU16	*dutyCnt = ptr->pwmDutyCnt.u16Arg;
+	tU16	*halfWidthCnt = ptr->pwmCenterPulseHalfWidthCnt.u16Arg;
+	tU32	diffHi = dutyCnt[order->hi] - dutyCnt[order->mid];
+	tU32	offset;
+
+	if(diffHi < ((tU32)halfWidthCnt[order->mid] + minSamplingPulseCnt))
+	{
+		return false;
+	}
+
+	offset = FTM_PERIOD_MOD - dutyCnt[order->hi];
+	dutyCnt[order->lo]  += offset;
+	dutyCnt[order->mid] += offset;
+	dutyCnt[order->hi]   = FTM_PERIOD_MOD;
+	halfWidthCnt[order->hi] = 0U;
+
+	return true;
+}
+
+/**************************************************************************//*!
+@brief Clamp the lowest duty phase to the negative rail
+
+@param	ptr,                    input/output, actuator, pwmDutyCnt and pwmCenterPulseHalfWidthCnt are
+								modified when the phase is clamped;
+		order,                  input, phases sorted by their duties;
+
+@return	true when clamped, false when the lo window would be too narrow or the
+		highest phase would not fit into the period
+
+@details	A common offset moves the lowest duty to 0%. The lo window ends with
+			the first falling edge of the two other phases, the lowest phase takes
+			that center pulse to place pre-trigger 1 there.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+static tBool ACTUATE_ClampLo(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order)
+{
+	tU16	*dutyCnt = ptr->pwmDutyCnt.u16Arg;
+	tU16	*halfWidthCnt = ptr->pwmCenterPulseHalfWidthCnt.u16Arg;
+	tU32	diffMid = dutyCnt[order->mid] - dutyCnt[order->lo];
+	tU32	halfWidthMid = halfWidthCnt[order->mid];
+	tU32	halfWidthLo, offset;
+
+	offset = dutyCnt[order->lo];
+	halfWidthLo = (halfWidthCnt[order->hi] > halfWidthMid) ? halfWidthCnt[order->hi] : halfWidthMid;
+	if(((diffMid + halfWidthMid) < (halfWidthLo + minSamplingPulseCnt)) ||
+	   ((dutyCnt[order->hi] - offset + halfWidthCnt[order->hi]) > FTM_PERIOD_MOD))
+	{
+		return false;
+	}
+
+	dutyCnt[order->lo]   = 0U;
+	dutyCnt[order->mid] -= offset;
+	dutyCnt[order->hi]  -= offset;
+	halfWidthCnt[order->lo] = halfWidthLo;
+
+	return true;
+}
+
+/**************************************************************************//*!
+@brief Clamp one phase for the discontinuous modulation
+
+@param	ptr,                    input/output, actuator, pwmDutyCnt and pwmCenterPulseHalfWidthCnt of the
+								continuous modulation are modified when a phase is clamped;
+		order,                  input, phases sorted by their duties;
+
+@return
+
+@details	The highest duty phase is clamped to the positive rail (100%) or the
+			lowest one to the negative rail (0%), see ACTUATE_ClampHi() and
+			ACTUATE_ClampLo(). The clamp is skipped when its window would be
+			narrower than minSamplingPulseCnt, the period pair is then modulated
+			continuously.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+static void ACTUATE_Dpwm(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order)
+{
+	tU16	*dutyCnt = ptr->pwmDutyCnt.u16Arg;
+	tU32	diffMid = dutyCnt[order->mid] - dutyCnt[order->lo];
+	tU32	diffHi  = dutyCnt[order->hi] - dutyCnt[order->mid];
+	tBool	top;
+
+	switch(ptr->pwmModulation)
+	{
+		case ACTUATE_MOD_DPWM0:
+			//positive sequence phases A B C: highest to lowest duty in cyclic order before the peak of the highest phase;
+			top = (order->lo == ((order->hi == 2U) ? 0U : (order->hi + 1U)));
+			break;
+		case ACTUATE_MOD_DPWM1:
+			//the phase with the largest voltage magnitude
+			top = (diffHi >= diffMid);
+			break;
+		default:
+			top = true;
+			break;
+	}
+
+	if(top)
+	{
+		(void)ACTUATE_ClampHi(ptr, order);
+	}
+	else
+	{
+		(void)ACTUATE_ClampLo(ptr, order);
+	}
+}
+
+#if ACTUATE_OVERMODULATION
+/**************************************************************************//*!
+@brief Linear interpolation in an overmodulation table
+
+@param	table,                  input, OVM_TABLE_SIZE points over the range;
+		x,                      input, position in the range, 0 ~ 1;
+
+@return	Interpolated value, the last point above the range
+******************************************************************************/
+static inline tFloat ACTUATE_OvmTable(const tFloat *table, tFloat x)
+{
+	tFloat	pos = MLIB_Mul(x, (tFloat)(OVM_TABLE_SIZE - 1U));
+	tU32	idx;
+
+	if(pos >= (tFloat)(OVM_TABLE_SIZE - 1U))
+	{
+		return table[OVM_TABLE_SIZE - 1U];
+	}
+
+	idx = (tU32)pos;
+	return MLIB_Add(table[idx], MLIB_Mul(MLIB_Sub(pos, (tFloat)idx), MLIB_Sub(table[idx + 1U], table[idx])));
+}
+#endif
+
+#if ACTUATE_DEADTIME_COMP
+/**************************************************************************//*!
+@brief Direction of a phase current for the dead-time compensation
+
+@param	iPh,                    input, phase current in A;
+
+@return	-1 ~ 1, linear inside ACTUATE_DTC_I_LIN or the dtcTable[] characteristic
+******************************************************************************/
+static inline tFloat ACTUATE_DtcShape(tFloat iPh)
+{
+#if ACTUATE_DEADTIME_COMP == 2
+	tFloat	pos = MLIB_Mul(MLIB_Abs(iPh), (tFloat)(ACTUATE_DTC_TABLE_SIZE - 1U) / ACTUATE_DTC_TABLE_I_MAX);
+	tFloat	shape;
+	tU32	idx;
+
+	if(pos >= (tFloat)(ACTUATE_DTC_TABLE_SIZE - 1U))
+	{
+		shape = dtcTable[ACTUATE_DTC_TABLE_SIZE - 1U];
+	}
+	else
+	{
+		idx = (tU32)pos;
+		shape = MLIB_Add(dtcTable[idx], MLIB_Mul(MLIB_Sub(pos, (tFloat)idx), MLIB_Sub(dtcTable[idx + 1U], dtcTable[idx])));
+	}
+
+	return (iPh < 0.0F) ? MLIB_Neg(shape) : shape;
+#else
+	tFloat	shape = MLIB_Mul(iPh, 1.0F / ACTUATE_DTC_I_LIN);
+
+	return (shape > 1.0F) ? 1.0F : ((shape < -1.0F) ? -1.0F : shape);
+#endif
+}
+/**************************************************************************//*!
+@brief Dead-time and switch drop compensation of one phase voltage
+
+@param	uEdge,                  input, dead time error per edge in V;
+		dutyCnt,                input, phase duty in cnt;
+		halfWidthCnt,           input, center pulse half-width in cnt;
+		iPh,                    input, phase current in A;
+
+@return	Compensation in V
+******************************************************************************/
+static inline tFloat ACTUATE_DtcPhase(tFloat uEdge, tU16 dutyCnt, tU16 halfWidthCnt, tFloat iPh)
+{
+	return MLIB_Mul(MLIB_Add(MLIB_Mul(uEdge, (tFloat)ACTUATE_PhaseEdges(dutyCnt, halfWidthCnt)), ACTUATE_DTC_SWITCH_DROP),
+					ACTUATE_DtcShape(iPh));
+}
+#endif
+
+#if ACTUATE_OVERSAMPLING
+/**************************************************************************//*!
+@brief Oversample the current samples as far as the active vector windows allow
+
+@param	ptr,                    input/output, actuator, pdbPretrigDelay[] of one conversion per pre-trigger
+								are moved for adcAvgCnt conversions;
+		order,                  input, phases sorted by their duties;
+
+@return
+
+@details	A current window lasts from the edge of one phase to the edge of the next,
+			minSamplingPulseCnt of it is taken by the settling and the single
+			conversion. n averaged conversions need (n-1) x ACTUATE_ADC_CONV_CNT more
+			in both windows, and the DC bus voltage conversion between the two current
+			samples of the 1st period and the two of the 2nd one needs n conversions
+			too. The averaged conversions end where the single one did.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+static void ACTUATE_Oversample(actuatePwm_t *ptr, const PWM_SECTOR_ORDER_TYPE *order)
+{
+	const PWM_EDGES_TYPE	*edges = ptr->pwmEdgesFoc.EdgesPhase;
+	tU16					*pdbPretrigDelay = ptr->pdbPretrigDelay;
+	tS32					slack, udcRoom, shift;
+	tU32					n, avgCnt = 1U;
+
+	slack = (tS32)(edges[order->mid].u16Edge1 - edges[order->hi].u16Edge1);		//hi window
+	if((tS32)(edges[order->lo].u16Edge1 - edges[order->mid].u16Edge1) < slack)
+	{
+		slack = (tS32)(edges[order->lo].u16Edge1 - edges[order->mid].u16Edge1);	//lo window
+	}
+	slack  -= (tS32)minSamplingPulseCnt;
+	udcRoom = (tS32)(FTM_PERIOD_MOD - edges[order->lo].u16Edge1 + edges[order->mid].u16Edge4);
+
+	for(n = 4U; n <= ACTUATE_OVERSAMPLING_MAX; n <<= 1)
+	{
+		if(((tS32)((n - 1U) * ACTUATE_ADC_CONV_CNT) > slack) || ((tS32)(2U * n * ACTUATE_ADC_CONV_CNT) > udcRoom))
+		{
+			break;
+		}
+		avgCnt = n;
+	}
+
+	ptr->adcAvgCnt = (tU16)avgCnt;
+	if(avgCnt > 1U)
+	{
+		shift = (tS32)((avgCnt - 1U) * ACTUATE_ADC_CONV_CNT);
+
+		pdbPretrigDelay[0] -= shift;
+		pdbPretrigDelay[1] -= shift;
+		pdbPretrigDelay[2]  = pdbPretrigDelay[1] + (tU16)(avgCnt * ACTUATE_ADC_CONV_CNT);	//right after the 2nd current sample
+		pdbPretrigDelay[3] -= shift;
+		pdbPretrigDelay[4] -= shift;
+	}
+}
+#endif
+
 /******************************************************************************
 | Function implementations      (scope: module-exported)
 -----------------------------------------------------------------------------*/
@@ -80,11 +489,11 @@ uint32_t                minSumPulseCnt = 200;		//80 + 120;
 /**************************************************************************//*!
 @brief Unmask PWM output and set 50% dytucyle 
 
-@param[in,out]  
+@param[in,out]  ptr		actuator
 
 @return
 ******************************************************************************/
-tBool ACTUATE_EnableOutput(void)
+tBool ACTUATE_EnableOutput(actuatePwm_t *ptr)
 {
 	SWLIBS_3Syst_FLT fltpwm;
 
@@ -95,11 +504,11 @@ tBool ACTUATE_EnableOutput(void)
 	fltpwm.fltArg2 = 0.5F;
 	fltpwm.fltArg3 = 0.5F;
 	
-	statePWM = ACTUATE_SetDutycycle(&fltpwm, 2);
-	ACTUATE_PwmUpdateBuffer();
+	statePWM = ACTUATE_SetDutycycle(ptr, &fltpwm, 2);
+	ACTUATE_PwmUpdateBuffer(ptr);
 
     // Enable PWM
-	FTM_DRV_MaskOutputChannels(INST_FLEXTIMER_PWM3, 0x0, true);
+	FTM_DRV_MaskOutputChannels(ptr->ftmInst, 0x0, true);
 
 	return(statePWM);
 }
@@ -108,11 +517,11 @@ tBool ACTUATE_EnableOutput(void)
 /**************************************************************************//*!
 @brief Mask PWM output and set 50% dytucyle 
 
-@param[in,out]  
+@param[in,out]  ptr		actuator
 
 @return
 ******************************************************************************/
-tBool ACTUATE_DisableOutput(void)
+tBool ACTUATE_DisableOutput(actuatePwm_t *ptr)
 {
 	SWLIBS_3Syst_FLT fltpwm;
 
@@ -123,336 +532,334 @@ tBool ACTUATE_DisableOutput(void)
 	fltpwm.fltArg2 = 0.5F;
 	fltpwm.fltArg3 = 0.5F;
 	
-	statePWM = ACTUATE_SetDutycycle(&fltpwm, 2);
-	ACTUATE_PwmUpdateBuffer();
+	statePWM = ACTUATE_SetDutycycle(ptr, &fltpwm, 2);
+	ACTUATE_PwmUpdateBuffer(ptr);
 
     /* Disable PWM */
-	FTM_DRV_MaskOutputChannels(INST_FLEXTIMER_PWM3, 0x3F, true);
+	FTM_DRV_MaskOutputChannels(ptr->ftmInst, 0x3F, true);
 
 	return(statePWM);
 }
 
+/**************************************************************************//*!
+@brief Edges and PDB pre-triggers of one sector
+
+@param	ptr,                    input/output, actuator, pwmDutyCnt holds the duties;
+		sector,                 input, sector 1 ~ 6, a constant;
+
+@return
+
+@details	The six sectors differ only in the order of the phase duties, the
+			order is taken from pwmSectorOrder[] and the edges are calculated
+			in one pass. The lowest duty phase gets the minimal center pulse,
+			the middle and the highest duty phases are shifted to open the
+			two current sampling windows. With ACTUATE_REDUCED_SHIFT only the
+			phases opening a too narrow window get a center pulse. A discontinuous
+			pwmModulation clamps one phase afterwards, see ACTUATE_Dpwm().
+			Inlined in every case of the sector switch of ACTUATE_SetDutycycle(),
+			the phase indices are then constants as in a hand written case.
+******************************************************************************/
+static inline __attribute__((always_inline)) void ACTUATE_SectorEdges(actuatePwm_t *ptr, tU32 sector)
+{
+	tU32    						diffMid, diffHi;
+#if !ACTUATE_REDUCED_SHIFT
+	tU32    						temp;
+#endif
+	tU16							*dutyCnt = ptr->pwmDutyCnt.u16Arg;
+	tU16							*halfWidthCnt = ptr->pwmCenterPulseHalfWidthCnt.u16Arg;
+	tU16							*pdbPretrigDelay = ptr->pdbPretrigDelay;
+	tU16							halfWidthLo, halfWidthMid, halfWidthHi;
+	tU16							dutyLo, dutyMid, dutyHi;
+	tU32							lo, mid, hi;
+	PWM_EDGES_TYPE					*edges = ptr->pwmEdgesFoc.EdgesPhase;
+	const PWM_SECTOR_ORDER_TYPE		*order;
+
+	order = &pwmSectorOrder[sector];
+	lo    = order->lo;
+	mid   = order->mid;
+	hi    = order->hi;
+
+	dutyLo  = dutyCnt[lo];
+	dutyMid = dutyCnt[mid];
+	dutyHi  = dutyCnt[hi];
+	diffMid = dutyMid - dutyLo;
+	diffHi  = dutyHi - dutyMid;
+
+#if ACTUATE_REDUCED_SHIFT
+	halfWidthLo  = 0U;
+	halfWidthMid = ACTUATE_ShiftCnt(diffMid, halfWidthLo, dutyMid);
+	halfWidthHi  = ACTUATE_ShiftCnt(diffHi, halfWidthMid, dutyHi);
+#else
+	halfWidthLo  = minZeroPulseCnt;
+	halfWidthMid = ((diffMid)<minSamplingPulseCnt)?(minSumPulseCnt - diffMid):minZeroPulseCnt;
+	temp		 = halfWidthMid + minSamplingPulseCnt;
+	halfWidthHi  = ((diffHi)<(temp - minZeroPulseCnt))?(temp - diffHi):minZeroPulseCnt;
+#endif
+
+	halfWidthCnt[lo]  = halfWidthLo;
+	halfWidthCnt[mid] = halfWidthMid;
+	halfWidthCnt[hi]  = halfWidthHi;
+
+	//a clamp shifts the duties and rewrites the centre pulse of the lowest or the highest phase;
+	if(ptr->pwmModulation != ACTUATE_MOD_SVM)
+	{
+		ACTUATE_Dpwm(ptr, order);
+		dutyLo		= dutyCnt[lo];
+		dutyMid		= dutyCnt[mid];
+		dutyHi		= dutyCnt[hi];
+		halfWidthLo	= halfWidthCnt[lo];
+		halfWidthHi	= halfWidthCnt[hi];
+	}
+#if ACTUATE_OVERMODULATION
+	//beyond the linear range move the zero sequence to the rail that keeps the highest phase inside the period;
+	if((dutyHi + halfWidthHi) > FTM_PERIOD_MOD)
+	{
+		if(!ACTUATE_ClampLo(ptr, order))
+		{
+			(void)ACTUATE_ClampHi(ptr, order);
+		}
+		dutyLo		= dutyCnt[lo];
+		dutyMid		= dutyCnt[mid];
+		dutyHi		= dutyCnt[hi];
+		halfWidthLo	= halfWidthCnt[lo];
+		halfWidthHi	= halfWidthCnt[hi];
+	}
+#endif
+	ptr->phaseShiftCnt		 = ((halfWidthHi > halfWidthMid) ? halfWidthHi : halfWidthMid) - halfWidthLo;
+
+	//Calculate Phase A B C PWM edges for consecutive two periods;
+	ACTUATE_CalcEdges(&edges[lo], halfWidthLo, dutyLo);
+	ACTUATE_CalcEdges(&edges[mid], halfWidthMid, dutyMid);
+	ACTUATE_CalcEdges(&edges[hi], halfWidthHi, dutyHi);
+
+	pdbPretrigDelay[0] = FTM_PERIOD_MOD - halfWidthMid - dutyMid - pdbTriggerOffset;		//middle phase edge 1 for highest phase current sampling
+	pdbPretrigDelay[1] = FTM_PERIOD_MOD - halfWidthLo - dutyLo - pdbTriggerOffset;			//lowest phase edge 1 for lowest phase current sampling
+	pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);							//DC bus voltage sampling
+	pdbPretrigDelay[3] = FTM_PERIOD_MOD + halfWidthMid + dutyMid - pdbTriggerOffset;		//middle phase edge 4 for lowest phase current sampling
+	pdbPretrigDelay[4] = FTM_PERIOD_MOD + halfWidthHi + dutyHi - pdbTriggerOffset;			//highest phase edge 4 for highest phase current sampling
+#if ACTUATE_OVERSAMPLING
+	ACTUATE_Oversample(ptr, order);
+#endif
+}
+
 /**************************************************************************//*!
 @brief Set PWM dytycyle, the dutycycle will by updated on next reload event
 
-@param	fltpwm,                 input, pwm duty in float format, calculated by FOC
+@param	ptr,                    input/output, actuator the outputs below belong to;
+		fltpwm,                 input, pwm duty in float format, calculated by FOC
 		sector,                 input, sector number used to sort the 3 phase duties;
-		pwmEdgesFoc, 		    output, it's a global array, contains 4 edges values of 3 phases, total 12 integer numbers;
+		pwmEdgesFoc, 		    output, contains 4 edges values of 3 phases, total 12 integer numbers;
 								This function will not update the FTM PWM registers.
 								This function just update the buffer (pwmEdgesFoc) in SRAM, and let FTM Reload ISR to write these values into FTM PWM registers;
-		pdbPretrigDelay[5],	    output, PDB pre-triggers, it's a global array, contains 5 delay timers for PDB1 pre-trigger 0 ~ 4;
+		pdbPretrigDelay[5],	    output, PDB pre-triggers, contains 5 delay timers for PDB pre-trigger 0 ~ 4;
 								This function will also update the PDB delay registers with the values in pdbPretrigDelay[];
-		pwmDutyCnt,			    output, global variable, it's the 3 phase duties in FTM cnt;
+		pwmDutyCnt,			    output, it's the 3 phase duties in FTM cnt;
 
 @return
+
+@details	The edges of a sector are calculated by ACTUATE_SectorEdges(). The
+			switching edges are counted in the slow loop, see
+			ACTUATE_SwitchLossUpdate().
 ******************************************************************************/
 __attribute__((section (".code_ram"))) 		// inserting function to the RAM section
-tBool ACTUATE_SetDutycycle(SWLIBS_3Syst_FLT *fltpwm, tU16 sector)
-{
-	tBool   state_pwm = true;
-	tU32    diffUV, diffVW, diffWU, temp;
-
-	pwmDutyCnt.u16Arg1 = MLIB_Mul(fltpwm->fltArg1, FTM_PERIOD_MOD);
-	pwmDutyCnt.u16Arg2 = MLIB_Mul(fltpwm->fltArg2, FTM_PERIOD_MOD);
-	pwmDutyCnt.u16Arg3 = MLIB_Mul(fltpwm->fltArg3, FTM_PERIOD_MOD);
-
-	switch (sector) {
-	case 1:		//duty A > duty B > duty C
-		diffUV = pwmDutyCnt.u16Arg1 - pwmDutyCnt.u16Arg2;
-		diffVW = pwmDutyCnt.u16Arg2 - pwmDutyCnt.u16Arg3;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffVW)<minSamplingPulseCnt)?(minSumPulseCnt - diffVW):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg2 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffUV)<(temp - minZeroPulseCnt))?(temp - diffUV):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhA current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhC current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhC current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhA current sampling
-
-		break;
-
-	case 2:		//duty B > duty A > duty C
-		diffUV = pwmDutyCnt.u16Arg2 - pwmDutyCnt.u16Arg1;
-		diffWU = pwmDutyCnt.u16Arg1 - pwmDutyCnt.u16Arg3;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffWU)<minSamplingPulseCnt)?(minSumPulseCnt - diffWU):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg1 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffUV)<(temp - minZeroPulseCnt))?(temp - diffUV):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhB current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhC current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhC current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhB current sampling
-
-
-		break;
-
-	case 3:		//duty B > duty C > duty A
-		diffWU = pwmDutyCnt.u16Arg3 - pwmDutyCnt.u16Arg1;
-		diffVW = pwmDutyCnt.u16Arg2 - pwmDutyCnt.u16Arg3;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffWU)<minSamplingPulseCnt)?(minSumPulseCnt - diffWU):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg3 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffVW)<(temp - minZeroPulseCnt))?(temp - diffVW):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhB current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhA current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhA current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhB current sampling
-
-		break;
-
-	case 4:		//duty C > duty B > duty A
-		diffUV = pwmDutyCnt.u16Arg2 - pwmDutyCnt.u16Arg1;
-		diffVW = pwmDutyCnt.u16Arg3 - pwmDutyCnt.u16Arg2;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = ((diffUV)<minSamplingPulseCnt)?(minSumPulseCnt - diffUV):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg2 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffVW)<(temp - minZeroPulseCnt))?(temp - diffVW):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhC current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhA current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseB.u16Edge4 - pdbTriggerOffset;		//PhB edge 4 for PhA current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhC current sampling
-
-		break;
-
-	case 5:		//duty C > duty A > duty B
-		diffUV = pwmDutyCnt.u16Arg1 - pwmDutyCnt.u16Arg2;
-		diffWU = pwmDutyCnt.u16Arg3 - pwmDutyCnt.u16Arg1;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffUV)<minSamplingPulseCnt)?(minSumPulseCnt - diffUV):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg1 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffWU)<(temp - minZeroPulseCnt))?(temp - diffWU):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseA.u16Edge1 - pdbTriggerOffset;	//PhA edge 1 for PhC current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhB current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhB current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhC current sampling
-
-		break;
-
-	case 6:		//duty A > duty C > duty B
-		diffWU = pwmDutyCnt.u16Arg1 - pwmDutyCnt.u16Arg3;
-		diffVW = pwmDutyCnt.u16Arg3 - pwmDutyCnt.u16Arg2;
-
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = minZeroPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = ((diffVW)<minSamplingPulseCnt)?(minSumPulseCnt - diffVW):minZeroPulseCnt;
-		temp         				       = pwmCenterPulseHalfWidthCnt.u16Arg3 + minSamplingPulseCnt;
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = ((diffWU)<(temp - minZeroPulseCnt))?(temp - diffWU):minZeroPulseCnt;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = pwmEdgesFoc.EdgesPhaseC.u16Edge1 - pdbTriggerOffset;	//PhC edge 1 for PhA current sampling
-		pdbPretrigDelay[1] = pwmEdgesFoc.EdgesPhaseB.u16Edge1 - pdbTriggerOffset;	//PhB edge 1 for PhB current sampling
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD - (pdbTriggerOffset>>1);		        //DC bus voltage sampling
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseC.u16Edge4 - pdbTriggerOffset;		//PhC edge 4 for PhB current sampling
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD + pwmEdgesFoc.EdgesPhaseA.u16Edge4 - pdbTriggerOffset;		//PhA edge 4 for PhA current sampling
-
-		break;
-
-	default:
-		pwmCenterPulseHalfWidthCnt.u16Arg1 = 80;
-		pwmCenterPulseHalfWidthCnt.u16Arg2 = 80;
-		pwmCenterPulseHalfWidthCnt.u16Arg3 = 80;
-
-		//Calculate Phase A B C PWM edges for consecutive two periods;
-		//PhaseA 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1 - pwmDutyCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg1;
-		//PhaseA 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg1;
-		pwmEdgesFoc.EdgesPhaseA.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg1 + pwmDutyCnt.u16Arg1;
-
-		//PhaseB 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2 - pwmDutyCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg2;
-		//PhaseB 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg2;
-		pwmEdgesFoc.EdgesPhaseB.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg2 + pwmDutyCnt.u16Arg2;
-
-		//PhaseC 1st 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge1 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3 - pwmDutyCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge2 = FTM_PERIOD_MOD - pwmCenterPulseHalfWidthCnt.u16Arg3;
-		//PhaseC 2nd 25uS PWM Edges;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge3 = pwmCenterPulseHalfWidthCnt.u16Arg3;
-		pwmEdgesFoc.EdgesPhaseC.u16Edge4 = pwmCenterPulseHalfWidthCnt.u16Arg3 + pwmDutyCnt.u16Arg3;
-
-		pdbPretrigDelay[0] = FTM_PERIOD_MOD-600;
-		pdbPretrigDelay[1] = FTM_PERIOD_MOD-400;
-		pdbPretrigDelay[2] = FTM_PERIOD_MOD;
-		pdbPretrigDelay[3] = FTM_PERIOD_MOD+400;
-		pdbPretrigDelay[4] = FTM_PERIOD_MOD+600;
-
-		break;
-}
+tBool ACTUATE_SetDutycycle(actuatePwm_t *ptr, SWLIBS_3Syst_FLT *fltpwm, tU16 sector)
+{
+	tBool   						state_pwm = true;
 
-	ACTUATE_PdbUpdatePretrigDelay();
+	ptr->pwmDutyCnt.u16Arg1 = MLIB_Mul(fltpwm->fltArg1, FTM_PERIOD_MOD);
+	ptr->pwmDutyCnt.u16Arg2 = MLIB_Mul(fltpwm->fltArg2, FTM_PERIOD_MOD);
+	ptr->pwmDutyCnt.u16Arg3 = MLIB_Mul(fltpwm->fltArg3, FTM_PERIOD_MOD);
+
+	switch (sector)
+	{
+	case 1:		ACTUATE_SectorEdges(ptr, 1U);		break;	//duty A > duty B > duty C
+	case 2:		ACTUATE_SectorEdges(ptr, 2U);		break;	//duty B > duty A > duty C
+	case 3:		ACTUATE_SectorEdges(ptr, 3U);		break;	//duty B > duty C > duty A
+	case 4:		ACTUATE_SectorEdges(ptr, 4U);		break;	//duty C > duty B > duty A
+	case 5:		ACTUATE_SectorEdges(ptr, 5U);		break;	//duty C > duty A > duty B
+	case 6:		ACTUATE_SectorEdges(ptr, 6U);		break;	//duty A > duty C > duty B
+	default:	ACTUATE_SetDefaultEdges(ptr);		break;
+	}
+
+	ACTUATE_PdbUpdatePretrigDelay(ptr);
 
 	state_pwm = false;
 
 	return(state_pwm);
 }
 
+/**************************************************************************//*!
+@brief Switching loss reduction of the last duty cycle update
+
+@param	ptr,                    input/output, actuator, pwmSwitchEdges and switchLossRedFilt are updated;
+
+@return
+
+@details	The number of edges of the period pair is stored in pwmSwitchEdges and
+			its reduction against the 12 edges of the continuous modulation is
+			filtered into switchLossRedFilt. It's a diagnostic, called in the slow
+			loop to keep it out of ACTUATE_SetDutycycle().
+******************************************************************************/
+void ACTUATE_SwitchLossUpdate(actuatePwm_t *ptr)
+{
+	ptr->pwmSwitchEdges = (tU8)(ACTUATE_PhaseEdges(ptr->pwmDutyCnt.u16Arg1, ptr->pwmCenterPulseHalfWidthCnt.u16Arg1) +
+								ACTUATE_PhaseEdges(ptr->pwmDutyCnt.u16Arg2, ptr->pwmCenterPulseHalfWidthCnt.u16Arg2) +
+								ACTUATE_PhaseEdges(ptr->pwmDutyCnt.u16Arg3, ptr->pwmCenterPulseHalfWidthCnt.u16Arg3));
+	GDFLIB_FilterMA(MLIB_Sub(1.0F, MLIB_Mul((tFloat)ptr->pwmSwitchEdges, 1.0F / (tFloat)ACTUATE_SWITCH_EDGES)),
+					&ptr->switchLossRedFilt);
+}
+
+#if ACTUATE_OVERMODULATION
+/**************************************************************************//*!
+@brief Overmodulation of the normalised voltage vector
+
+@param	ptr,                    input/output, actuator, ovmModIndex and ovmMode are updated;
+		pOut,                   output, alpha/beta voltage for GMCLIB_SvmStd_FLT;
+		pIn,                    input, alpha/beta voltage request, the inscribed circle of the voltage hexagon is 1;
+
+@return
+
+@details	The request is passed unchanged up to the inscribed circle. Above it
+			the fundamental of the output follows the request magnitude up to
+			ACTUATE_OVM_LIMIT. In mode I the reference circle radius is taken from
+			ovmRadiusTable[] and the vector is clipped by the hexagon side. In mode
+			II the vector is held at the side end once its angle from the side
+			centre exceeds ovmHoldTable[], the angle below is stretched to reach the
+			side end. Beyond ACTUATE_OVM_SIDE_ANGLE the vector is held in both modes,
+			the windows near the vertices are too narrow for the single-shunt
+			sampling. The tables are the numerically inverted fundamentals of these
+			trajectories.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+void ACTUATE_Overmodulation(actuatePwm_t *ptr, SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *pIn)
+{
+	const SWLIBS_2Syst_FLT	*normal;
+	SWLIBS_2Syst_FLT		sinCos;
+	tFloat					modIndex, radius, holdAngle, theta, sideAngle, angle, dist;
+	tU32					side;
+
+	modIndex = GFLIB_Sqrt(MLIB_Add(MLIB_Mul(pIn->fltArg1, pIn->fltArg1), MLIB_Mul(pIn->fltArg2, pIn->fltArg2)));
+	ptr->ovmModIndex = modIndex;
+
+	if(modIndex <= 1.0F)
+	{
+		ptr->ovmMode = 0U;
+		pOut->fltArg1 = pIn->fltArg1;
+		pOut->fltArg2 = pIn->fltArg2;
+		return;
+	}
+
+	if(modIndex < ACTUATE_OVM_MODE2)
+	{
+		ptr->ovmMode = 1U;
+		radius		= ACTUATE_OvmTable(ovmRadiusTable, MLIB_Mul(MLIB_Sub(modIndex, 1.0F), 1.0F / (ACTUATE_OVM_MODE2 - 1.0F)));
+		holdAngle	= ACTUATE_OVM_SIDE_ANGLE;
+	}
+	else
+	{
+		ptr->ovmMode = 2U;
+		radius		= ACTUATE_OVM_SIDE_RADIUS;
+		holdAngle	= ACTUATE_OvmTable(ovmHoldTable, MLIB_Mul(MLIB_Sub(modIndex, ACTUATE_OVM_MODE2),
+											1.0F / (ACTUATE_OVM_LIMIT - ACTUATE_OVM_MODE2)));
+	}
+
+	//angle from the centre of the nearest hexagon side, theta is shifted by pi to <0;2pi>
+	theta		= MLIB_Add(GFLIB_AtanYX(pIn->fltArg2, pIn->fltArg1), FLOAT_PI);
+	side		= (tU32)MLIB_Mul(theta, 3.0F / FLOAT_PI);
+	side		= (side > 5U) ? 5U : side;
+	sideAngle	= MLIB_Sub(theta, MLIB_Add(MLIB_Mul((tFloat)side, FLOAT_PI / 3.0F), FLOAT_PI / 6.0F));
+
+	if(MLIB_Abs(sideAngle) < holdAngle)
+	{
+		angle = MLIB_Mul(sideAngle, MLIB_Div(ACTUATE_OVM_SIDE_ANGLE, holdAngle));
+	}
+	else
+	{
+		angle = (sideAngle < 0.0F) ? MLIB_Neg(ACTUATE_OVM_SIDE_ANGLE) : ACTUATE_OVM_SIDE_ANGLE;
+	}
+
+	GFLIB_SinCos_FLT(MLIB_Sub(MLIB_Add(MLIB_Sub(theta, sideAngle), angle), FLOAT_PI), &sinCos, GFLIB_SINCOS_DEFAULT_FLT);
+	pOut->fltArg1 = MLIB_Mul(radius, sinCos.fltArg2);
+	pOut->fltArg2 = MLIB_Mul(radius, sinCos.fltArg1);
+
+	//clip by the hexagon side, its distance from the centre is 1
+	normal	= &ovmSideNormal[side];
+	dist	= MLIB_Add(MLIB_Mul(pOut->fltArg1, normal->fltArg1), MLIB_Mul(pOut->fltArg2, normal->fltArg2));
+	if(dist > 1.0F)
+	{
+		dist = MLIB_Div(1.0F, dist);
+		pOut->fltArg1 = MLIB_Mul(pOut->fltArg1, dist);
+		pOut->fltArg2 = MLIB_Mul(pOut->fltArg2, dist);
+	}
+}
+#endif
+
+#if ACTUATE_DEADTIME_COMP
+/**************************************************************************//*!
+@brief Dead-time and switch drop compensation of the voltage request
+
+@param	ptr,                    input/output, actuator, dtcUAbc is updated;
+		pOut,                   output, alpha/beta voltage request with the compensation in V;
+		pIn,                    input, alpha/beta voltage request in V;
+		pIAlBe,                 input, alpha/beta current giving the direction of the phase currents in A;
+		fltUdcb,                input, DC bus voltage in V;
+
+@return
+
+@details	Each pulse of a phase loses the dead time at one of its edges, the
+			rising one for a positive current and the falling one for a negative
+			one. The lost volt-seconds of the two PWM periods are given by the edges
+			of the phase, see ACTUATE_PhaseEdges(). The phase compensations enter
+			the alpha/beta request without their common mode.
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+void ACTUATE_DeadTimeComp(actuatePwm_t *ptr, SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *pIn,
+						  const SWLIBS_2Syst_FLT *pIAlBe, tFloat fltUdcb)
+{
+	tFloat	uEdge, iBe;
+
+	//a pulse loses the dead time at one of its two edges, error per edge averaged over the two PWM periods
+	uEdge	= MLIB_Mul(MLIB_Mul((tFloat)ptr->dtcDeadTimeCnt, 1.0F / (tFloat)(4U * FTM_PERIOD_MOD)), fltUdcb);
+	iBe		= MLIB_Mul(pIAlBe->fltArg2, 0.866025403784439F);
+
+	ptr->dtcUAbc.fltArg1 = ACTUATE_DtcPhase(uEdge, ptr->pwmDutyCnt.u16Arg1, ptr->pwmCenterPulseHalfWidthCnt.u16Arg1,
+											pIAlBe->fltArg1);
+	ptr->dtcUAbc.fltArg2 = ACTUATE_DtcPhase(uEdge, ptr->pwmDutyCnt.u16Arg2, ptr->pwmCenterPulseHalfWidthCnt.u16Arg2,
+											MLIB_Sub(iBe, MLIB_Mul(pIAlBe->fltArg1, 0.5F)));
+	ptr->dtcUAbc.fltArg3 = ACTUATE_DtcPhase(uEdge, ptr->pwmDutyCnt.u16Arg3, ptr->pwmCenterPulseHalfWidthCnt.u16Arg3,
+											MLIB_Neg(MLIB_Add(iBe, MLIB_Mul(pIAlBe->fltArg1, 0.5F))));
+
+	pOut->fltArg1 = MLIB_Add(pIn->fltArg1, MLIB_Mul(MLIB_Sub(MLIB_Mul(ptr->dtcUAbc.fltArg1, 2.0F),
+															  MLIB_Add(ptr->dtcUAbc.fltArg2, ptr->dtcUAbc.fltArg3)), 1.0F / 3.0F));
+	pOut->fltArg2 = MLIB_Add(pIn->fltArg2, MLIB_Mul(MLIB_Sub(ptr->dtcUAbc.fltArg2, ptr->dtcUAbc.fltArg3), FLOAT_DIVBY_SQRT3));
+}
+#endif
+
 /*****************************************************************************************
 *
 * @brief	Update PDB delay registers values with the array pdbPretrigDelay[];
 *
-* @param	pdbPretrigDelay[], input, these values are calculated in previous PWM edges calculation;
+* @param	ptr, input, actuator, pdbPretrigDelay[] are calculated in previous PWM edges calculation;
 * 			And LDOK register bit is written to make the update effective.
 *
 * @return  none
 *
  ****************************************************************************************/
-void ACTUATE_PdbUpdatePretrigDelay(void)
-{
-    PDB1->CH[0].DLY[0] = PDB_DLY_DLY(pdbPretrigDelay[0]);
-    PDB1->CH[0].DLY[1] = PDB_DLY_DLY(pdbPretrigDelay[1]);
-    PDB1->CH[0].DLY[2] = PDB_DLY_DLY(pdbPretrigDelay[2]);
-    PDB1->CH[0].DLY[3] = PDB_DLY_DLY(pdbPretrigDelay[3]);
-    PDB1->CH[0].DLY[4] = PDB_DLY_DLY(pdbPretrigDelay[4]);
-    REG_BIT_SET32(&(PDB1->SC), PDB_SC_LDOK_MASK);
+void ACTUATE_PdbUpdatePretrigDelay(actuatePwm_t *ptr)
+{
+	PDB_Type *pdb = ptr->pdb;
+
+    pdb->CH[0].DLY[0] = PDB_DLY_DLY(ptr->pdbPretrigDelay[0]);
+    pdb->CH[0].DLY[1] = PDB_DLY_DLY(ptr->pdbPretrigDelay[1]);
+    pdb->CH[0].DLY[2] = PDB_DLY_DLY(ptr->pdbPretrigDelay[2]);
+    pdb->CH[0].DLY[3] = PDB_DLY_DLY(ptr->pdbPretrigDelay[3]);
+    pdb->CH[0].DLY[4] = PDB_DLY_DLY(ptr->pdbPretrigDelay[4]);
+    REG_BIT_SET32(&(pdb->SC), PDB_SC_LDOK_MASK);
+#if ACTUATE_OVERSAMPLING
+    //hardware averaging of the next sequence, the ADC is idle after the last conversion of this one;
+    ptr->adc->SC3 = (ptr->adc->SC3 & ~(ADC_SC3_AVGE_MASK | ADC_SC3_AVGS_MASK)) |
+    				((ptr->adcAvgCnt > 1U) ? (ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(__builtin_ctz(ptr->adcAvgCnt) - 2U)) : 0U);
+#endif
 }
 
 /*****************************************************************************************
@@ -460,23 +867,32 @@ void ACTUATE_PdbUpdatePretrigDelay(void)
 * @brief	Copy PWM edges values from pwmEdgesFoc (buffer for save FOC calculation results)
 *                                   to pwmEdgesFtm (buffer for FTM PWM registers update);
 *
-* @param	pwmEdgesFoc, input, it's calculated PWM edge values;
+* @param	ptr, input/output, actuator;
+* 			pwmEdgesFoc, input, it's calculated PWM edge values;
 * 			pwmEdgesFtm, output, it's the data source to update FTM CnV registers;
 * 			Either of the above array contains two groups of values, one for Odd PWM cycle, the other for Even PWM cycle;
 *
 * @return  none
 *
  ****************************************************************************************/
-void ACTUATE_PwmUpdateBuffer(void)
+void ACTUATE_PwmUpdateBuffer(actuatePwm_t *ptr)
 {
 	tU32 i;
-	tU16 *src, *dst;
-	src = &pwmEdgesFoc.EdgesPhaseA.u16Edge1;
-	dst = &pwmEdgesFtm.EdgesPhaseA.u16Edge1;
-	for(i = 0; i<12; i++)
+	for(i = 0; i<3; i++)
 	{
-		*dst++ = *src++;
+		ptr->pwmEdgesFtm.EdgesPhase[i] = ptr->pwmEdgesFoc.EdgesPhase[i];
 	}
+
+#if PWM_RELOAD_DMA
+	//C(2n)V and C(2n+1)V of phase n, in the order the eDMA writes them;
+	for(i = 0; i<3; i++)
+	{
+		ptr->pwmReloadImage[PWM_RELOAD_EVEN][2*i]   = ptr->pwmEdgesFtm.EdgesPhase[i].u16Edge3;
+		ptr->pwmReloadImage[PWM_RELOAD_EVEN][2*i+1] = ptr->pwmEdgesFtm.EdgesPhase[i].u16Edge4;
+		ptr->pwmReloadImage[PWM_RELOAD_ODD][2*i]    = ptr->pwmEdgesFtm.EdgesPhase[i].u16Edge1;
+		ptr->pwmReloadImage[PWM_RELOAD_ODD][2*i+1]  = ptr->pwmEdgesFtm.EdgesPhase[i].u16Edge2;
+	}
+#endif
 }
 
 /*****************************************************************************************
@@ -484,39 +900,235 @@ void ACTUATE_PwmUpdateBuffer(void)
 * @brief	Update PWM C0V ~ C5V register values according to PWM Duty values calculated by PWM edge calculation;
 *
 *
-* @param	pwmEdgesFtm, input, it's used to update FTM PWM registers,
+* @param	ptr, input, actuator; its pwmEdgesFtm is used to update FTM PWM registers,
 * 			it's used in every FTM reload ISR, and is also used whenever need update FTM PWM registers;
 *
 * @return	none
 *
-* @details	Copy the values from variable pwmEdgesFtm to FTM registers C0V~C5V;
+* @details	Copy the values from pwmEdgesFtm to FTM registers C0V~C5V;
 * 			And write PWMLOAD register to make the update effective;
 * 			There are two sets of values, one for even PWM cycle, the other for odd PWM cycle;
 * 			Use a cycle counter pwmCycleCnt to identify currently it's in even cycle or odd cycle.
 *
  ****************************************************************************************/
-void ACTUATE_PwmUpdateRegisters(void)
+void ACTUATE_PwmUpdateRegisters(actuatePwm_t *ptr)
 {
-	if(pwmCycleCnt & 1)
+	FTM_Type *ftm = ptr->ftm;
+
+	if(ptr->pwmCycleCnt & 1)
 	{
-		FTM3->CONTROLS[0].CnV = pwmEdgesFtm.EdgesPhaseA.u16Edge1;
-		FTM3->CONTROLS[1].CnV = pwmEdgesFtm.EdgesPhaseA.u16Edge2;
-		FTM3->CONTROLS[2].CnV = pwmEdgesFtm.EdgesPhaseB.u16Edge1;
-		FTM3->CONTROLS[3].CnV = pwmEdgesFtm.EdgesPhaseB.u16Edge2;
-		FTM3->CONTROLS[4].CnV = pwmEdgesFtm.EdgesPhaseC.u16Edge1;
-		FTM3->CONTROLS[5].CnV = pwmEdgesFtm.EdgesPhaseC.u16Edge2;
+		ftm->CONTROLS[0].CnV = ptr->pwmEdgesFtm.EdgesPhaseA.u16Edge1;
+		ftm->CONTROLS[1].CnV = ptr->pwmEdgesFtm.EdgesPhaseA.u16Edge2;
+		ftm->CONTROLS[2].CnV = ptr->pwmEdgesFtm.EdgesPhaseB.u16Edge1;
+		ftm->CONTROLS[3].CnV = ptr->pwmEdgesFtm.EdgesPhaseB.u16Edge2;
+		ftm->CONTROLS[4].CnV = ptr->pwmEdgesFtm.EdgesPhaseC.u16Edge1;
+		ftm->CONTROLS[5].CnV = ptr->pwmEdgesFtm.EdgesPhaseC.u16Edge2;
 	}
 	else
 	{
-		FTM3->CONTROLS[0].CnV = pwmEdgesFtm.EdgesPhaseA.u16Edge3;
-		FTM3->CONTROLS[1].CnV = pwmEdgesFtm.EdgesPhaseA.u16Edge4;
-		FTM3->CONTROLS[2].CnV = pwmEdgesFtm.EdgesPhaseB.u16Edge3;
-		FTM3->CONTROLS[3].CnV = pwmEdgesFtm.EdgesPhaseB.u16Edge4;
-		FTM3->CONTROLS[4].CnV = pwmEdgesFtm.EdgesPhaseC.u16Edge3;
-		FTM3->CONTROLS[5].CnV = pwmEdgesFtm.EdgesPhaseC.u16Edge4;
+		ftm->CONTROLS[0].CnV = ptr->pwmEdgesFtm.EdgesPhaseA.u16Edge3;
+		ftm->CONTROLS[1].CnV = ptr->pwmEdgesFtm.EdgesPhaseA.u16Edge4;
+		ftm->CONTROLS[2].CnV = ptr->pwmEdgesFtm.EdgesPhaseB.u16Edge3;
+		ftm->CONTROLS[3].CnV = ptr->pwmEdgesFtm.EdgesPhaseB.u16Edge4;
+		ftm->CONTROLS[4].CnV = ptr->pwmEdgesFtm.EdgesPhaseC.u16Edge3;
+		ftm->CONTROLS[5].CnV = ptr->pwmEdgesFtm.EdgesPhaseC.u16Edge4;
 	}
-	FTM3->PWMLOAD |=  (1UL << FTM_PWMLOAD_LDOK_SHIFT);
+	ftm->PWMLOAD |=  (1UL << FTM_PWMLOAD_LDOK_SHIFT);
+}
+
+#if PWM_RELOAD_DMA
+/*****************************************************************************************
+*
+* @brief	Set up the eDMA chain which replaces the FTM reload ISR
+*
+* @param	ptr, input/output, actuator, its FTM, eDMA channel and TCD ring
+*
+* @return	none
+*
+* @details	The chain consists of 16 TCDs, each moves one 32-bit word from pwmReloadImage[][]
+* 			to C0V ~ C5V, EXTTRIG (INITTRIGEN cleared) or PWMLOAD (LDOK set): 8 TCDs of the
+* 			even cycle followed by 8 TCDs of the odd cycle. The TCDs of one cycle are linked
+* 			to the own channel on major loop completion, so one FTM channel 6 request writes
+* 			all 8 registers; the last TCD of a cycle has no link and the chain waits for the
+* 			next request. Scatter/gather makes a ring of the software TCDs, the 1st TCD of the
+* 			even cycle is pushed to the channel registers and repeated at the end of the ring.
+* 			McuDmaConfig() must be called before.
+*
+ ****************************************************************************************/
+void ACTUATE_PwmReloadDmaInit(actuatePwm_t *ptr)
+{
+	FTM_Type					*ftm = ptr->ftm;
+	edma_software_tcd_t			*pwmReloadTcd = ptr->pwmReloadTcd;
+	edma_scatter_gather_list_t	srcList[PWM_RELOAD_TCD_CNT + 1U];
+	edma_scatter_gather_list_t	destList[PWM_RELOAD_TCD_CNT + 1U];
+	tU32						destAddr[PWM_RELOAD_WORDS];
+	tU32						i, word;
+	tU16						link;
+
+	for(i = 0; i<6; i++)
+	{
+		destAddr[i] = (tU32)&ftm->CONTROLS[i].CnV;
+	}
+	destAddr[6] = (tU32)&ftm->EXTTRIG;
+	destAddr[7] = (tU32)&ftm->PWMLOAD;
+
+	ACTUATE_PwmUpdateBuffer(ptr);
+	for(i = 0; i<2; i++)
+	{
+		ptr->pwmReloadImage[i][6] = ftm->EXTTRIG & ~(FTM_EXTTRIG_INITTRIGEN_MASK | FTM_EXTTRIG_TRIGF_MASK);
+		ptr->pwmReloadImage[i][7] = ftm->PWMLOAD | FTM_PWMLOAD_LDOK_MASK;
+	}
+
+	for(i = 0; i<=PWM_RELOAD_TCD_CNT; i++)
+	{
+		word = i % PWM_RELOAD_WORDS;
+		srcList[i].address  = (tU32)&ptr->pwmReloadImage[(i / PWM_RELOAD_WORDS) & 1U][word];
+		srcList[i].length   = 4U;
+		srcList[i].type     = EDMA_TRANSFER_MEM2PERIPH;
+		destList[i].address = destAddr[word];
+		destList[i].length  = 4U;
+		destList[i].type    = EDMA_TRANSFER_MEM2PERIPH;
+	}
+
+	//entry 0 goes to the channel registers, entry i to pwmReloadTcd[i-1];
+	EDMA_DRV_ConfigScatterGatherTransfer(ptr->dmaChn, pwmReloadTcd, EDMA_TRANSFER_SIZE_4B, 4U,
+										 srcList, destList, (tU8)(PWM_RELOAD_TCD_CNT + 1U));
+
+	//close the ring, the repeated 1st TCD continues with the 2nd one;
+	pwmReloadTcd[PWM_RELOAD_TCD_CNT - 1U].DLAST_SGA = (int32_t)(tU32)&pwmReloadTcd[0];
+
+	//no interrupts, self link within one cycle;
+	link = DMA_TCD_CSR_MAJORELINK_MASK | DMA_TCD_CSR_MAJORLINKCH(ptr->dmaChn);
+	for(i = 0; i<PWM_RELOAD_TCD_CNT; i++)
+	{
+		pwmReloadTcd[i].CSR &= (tU16)~DMA_TCD_CSR_INTMAJOR_MASK;
+		if(((i + 1U) % PWM_RELOAD_WORDS) != (PWM_RELOAD_WORDS - 1U))
+		{
+			pwmReloadTcd[i].CSR |= link;
+		}
+	}
+	DMA->TCD[ptr->dmaChn].CSR = (DMA->TCD[ptr->dmaChn].CSR & (tU16)~DMA_TCD_CSR_INTMAJOR_MASK) | link;
+
+	EDMA_DRV_StartChannel(ptr->dmaChn);
+}
+
+/*****************************************************************************************
+*
+* @brief	Write the odd cycle PWM edges and re-align the eDMA chain with the control loop
+*
+* @param	ptr, input/output, actuator
+*
+* @return	none
+*
+* @details	Called in PDB ISR in the last PWM period of the control loop, after the
+* 			eDMA transfer of this period. Like ACTUATE_PwmUpdateRegisters() with an odd pwmCycleCnt
+* 			the latest odd cycle edges are written to the FTM registers for the 1st period of
+* 			the next control loop. The next eDMA request has to write the even cycle: if the
+* 			chain is not at the 1st even TCD (after start-up or a fault, when the FTM
+* 			initialization trigger is enabled at an arbitrary PWM period, and every control
+* 			loop of an odd number of PWM periods), it's reloaded.
+* 			The eDMA is idle at this time, so the TCD can be rewritten.
+*
+ ****************************************************************************************/
+void ACTUATE_PwmReloadSync(actuatePwm_t *ptr)
+{
+	const edma_software_tcd_t	*tcd = &ptr->pwmReloadTcd[PWM_RELOAD_TCD_CNT - 1U];
+	FTM_Type					*ftm = ptr->ftm;
+	tU8							chn = ptr->dmaChn;
+	tU32						i;
+
+	for(i = 0; i<6; i++)
+	{
+		ftm->CONTROLS[i].CnV = ptr->pwmReloadImage[PWM_RELOAD_ODD][i];
+	}
+	ftm->PWMLOAD |=  (1UL << FTM_PWMLOAD_LDOK_SHIFT);
+
+	if(DMA->TCD[chn].SADDR != tcd->SADDR)
+	{
+		DMA->CDNE = chn;
+		DMA->TCD[chn].SADDR			= tcd->SADDR;
+		DMA->TCD[chn].SOFF			= (tU16)tcd->SOFF;
+		DMA->TCD[chn].ATTR			= tcd->ATTR;
+		DMA->TCD[chn].NBYTES.MLNO	= tcd->NBYTES;
+		DMA->TCD[chn].SLAST			= (tU32)tcd->SLAST;
+		DMA->TCD[chn].DADDR			= tcd->DADDR;
+		DMA->TCD[chn].DOFF			= (tU16)tcd->DOFF;
+		DMA->TCD[chn].CITER.ELINKNO	= tcd->CITER;
+		DMA->TCD[chn].DLASTSGA		= (tU32)tcd->DLAST_SGA;
+		DMA->TCD[chn].CSR			= tcd->CSR;
+		DMA->TCD[chn].BITER.ELINKNO	= tcd->BITER;
+	}
+}
+#endif
+
+#if FAST_TRIP
+/*****************************************************************************************
+*
+* @brief	Set the CMP0 DAC to the fast-trip current
+*
+* @param	iDcbOffset, input, DC-bus current amplifier offset in the units of the
+* 			measured current, I_DCB_MAX at mid-scale
+*
+* @return	none
+*
+* @details	The amplifier output is (iDcbOffset + i)/(2 x I_DCB_MAX) of the reference,
+* 			the DAC output is (VOSEL + 1)/256 of it. Called with the nominal offset at
+* 			start-up and with the calibrated one after the calibration.
+*
+ ****************************************************************************************/
+void ACTUATE_FastTripThreshold(tFloat iDcbOffset)
+{
+	tFloat	vosel;
+
+	vosel = MLIB_Sub(MLIB_Mul(MLIB_Add(iDcbOffset, FAST_TRIP_CURRENT), 256.0F/(2.0F*I_DCB_MAX)), 1.0F);
+	vosel = (vosel < 0.0F) ? 0.0F : ((vosel > 255.0F) ? 255.0F : vosel);
+
+	CMP0->C1 = (CMP0->C1 & ~CMP_C1_VOSEL_MASK) | CMP_C1_VOSEL((tU32)vosel);
+}
+
+/*****************************************************************************************
+*
+* @brief	Check the FTM fault input driven by the fast-trip comparator
+*
+* @param	ptr, input/output, actuator; its ftmFaultStatus latches the FMS register
+*
+* @return	true if the FTM detected a fault and keeps the outputs in the safe state
+*
+* @details	With the manual fault clearing the FTM fault flag stays set until
+* 			ACTUATE_FastTripClear(), so the check can run once per control loop.
+*
+ ****************************************************************************************/
+tBool ACTUATE_FastTripCheck(actuatePwm_t *ptr)
+{
+	tU32	fms = ptr->ftm->FMS;
+
+	if(fms & FTM_FMS_FAULTF_MASK)
+	{
+		ptr->ftmFaultStatus = fms;
+		return(true);
+	}
+
+	return(false);
+}
+
+/*****************************************************************************************
+*
+* @brief	Clear the FTM fault flags after the fault is cleared by the user
+*
+* @param	ptr, input/output, actuator
+*
+* @return	none
+*
+* @details	The outputs leave the safe state at the next PWM period, unless the
+* 			comparator output is still active and sets the flags again.
+*
+ ****************************************************************************************/
+void ACTUATE_FastTripClear(actuatePwm_t *ptr)
+{
+	FTM_DRV_ClearFaultsIsr(ptr->ftm);
+	ptr->ftmFaultStatus = 0U;
 }
+#endif
 
 
 /* End of file */
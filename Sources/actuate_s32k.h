@@ -19,12 +19,201 @@
 #include "gflib.h"
 #include "gmclib.h"
 #include "gdflib.h"
+#include "PMSM_appconfig.h"
 
 /******************************************************************************
 | Defines and macros            (scope: module-local)
 -----------------------------------------------------------------------------*/
 #define FTM_PERIOD_MOD	2000
 
+/* Initial pre-trigger delays of PDB channel 0 Delay 0 ~ Delay 4, also used for an invalid sector */
+#define PDB_PRETRIG_DELAY_INIT	{FTM_PERIOD_MOD-600, FTM_PERIOD_MOD-400, FTM_PERIOD_MOD, \
+								 FTM_PERIOD_MOD+400, FTM_PERIOD_MOD+600}
+
+/*****************************************************************************
+* FTM C0V ~ C5V reload in every PWM period
+*
+* PWM_RELOAD_DMA  0		FTM reload ISR (FTM3_Ovf_Reload_IRQHandler) writes the odd or even
+* 						PWM edges to C0V ~ C5V, clears EXTTRIG[INITTRIGEN] and sets PWMLOAD[LDOK]
+* PWM_RELOAD_DMA  1		An eDMA scatter/gather chain writes the same registers, no CPU involvement;
+* 						the transfer is requested by the FTM channel 6 match shortly after the reload.
+* 						The chain alternates the odd and even edges by itself, PDB ISR re-aligns
+* 						it with the control loop.
+******************************************************************************/
+#ifndef PWM_RELOAD_DMA
+#define PWM_RELOAD_DMA			1
+#endif
+
+#define PWM_RELOAD_DMA_CHN		0U		// eDMA channel 0 of dmaController1, FTM3 axis
+#define PWM_RELOAD_FTM_CHN		6U		// FTM channel 6 compare requests the eDMA transfer
+#define PWM_RELOAD_FTM_CNT		40U		// 40cnt = 0.5uS after the reload point
+#define PWM_RELOAD_WORDS		8U		// C0V ~ C5V, EXTTRIG, PWMLOAD
+#define PWM_RELOAD_TCD_CNT		(2U * PWM_RELOAD_WORDS)		// one TCD per written register and cycle
+
+#if PWM_RELOAD_DMA
+#include "edma_driver.h"
+#endif
+
+/*****************************************************************************
+* Hardware fast-trip over-current protection, FTM3 axis
+*
+* FAST_TRIP  0		Over-currents are detected by FaultDetection() once per control loop only
+* FAST_TRIP  1		CMP0 compares the DC-bus current amplifier output with its 8-bit DAC,
+* 					TRGMUX routes the comparator output to the FTM3 fault input 0. The FTM
+* 					forces the PWM outputs to their safe state (all switches off) within
+* 					about 1us, FaultDetection() latches the trip into permFaults.motor.
+*
+* Note				FAST_TRIP_CMP_IN must be the CMP0 input the DC-bus current amplifier
+* 					output is wired to, the pin is configured in Processor Expert.
+******************************************************************************/
+#ifndef FAST_TRIP
+#define FAST_TRIP				0
+#endif
+
+#ifndef FAST_TRIP_CURRENT
+#define FAST_TRIP_CURRENT		(1.2F * I_PH_OVER)	// trip level above the software limit [A]
+#endif
+#define FAST_TRIP_CMP_IN		6U		// CMP0 analog mux input of the DC-bus current amplifier
+#define FAST_TRIP_CMP_FILTER	3U		// consecutive equal samples of the CMP0 filter
+#define FAST_TRIP_CMP_FPR		8U		// CMP0 filter sample period in bus clocks, 3 x 8 / 40MHz = 0.6us
+
+/*****************************************************************************
+* Oversampling of the single-shunt current samples
+*
+* ACTUATE_OVERSAMPLING  0	One ADC conversion per PDB pre-trigger
+* ACTUATE_OVERSAMPLING  1	ADC hardware averaging of 4 ~ ACTUATE_OVERSAMPLING_MAX conversions per
+* 							pre-trigger, chosen in every control loop by ACTUATE_SetDutycycle() from
+* 							the narrower of the two active vector windows. The current pre-triggers
+* 							move earlier so that the last conversion samples where the single one
+* 							did; the DC bus voltage is converted right after the 2nd current sample.
+******************************************************************************/
+#ifndef ACTUATE_OVERSAMPLING
+#define ACTUATE_OVERSAMPLING	0
+#endif
+
+#define ACTUATE_OVERSAMPLING_MAX	8U		// 4, 8, 16 or 32 conversions
+#define ACTUATE_ADC_CONV_CNT		80U		// 80cnt = 1uS, ADC sampling and 12-bit conversion at 40MHz ADCK
+
+/*****************************************************************************
+* Centre pulses of the single-shunt PWM pattern
+*
+* ACTUATE_REDUCED_SHIFT  0	Every phase gets a centre pulse of minZeroPulseCnt half-width at least,
+* 							the middle and the highest duty phases are shifted further when an
+* 							active vector window is narrower than minSamplingPulseCnt.
+* ACTUATE_REDUCED_SHIFT  1	A phase gets a centre pulse only when the window it opens is narrower
+* 							than minSamplingPulseCnt, the half-width is the missing width but at
+* 							least minZeroPulseCnt. A pulse without the centre pulse continues over
+* 							the reload point (Edge2 = FTM_PERIOD_MOD is never matched), the phase
+* 							switches twice in the two PWM periods instead of four times. The
+* 							half-width is limited so that both pulses stay inside their periods
+* 							and the volt-seconds of the odd and the even period remain exact.
+* 							Build it with ACTUATE_DEADTIME_COMP 1 or 2, see below.
+******************************************************************************/
+#ifndef ACTUATE_REDUCED_SHIFT
+#define ACTUATE_REDUCED_SHIFT	0
+#endif
+
+/*****************************************************************************
+* Modulation, actuatePwm_t pwmModulation, selectable in FreeMASTER
+*
+* ACTUATE_MOD_SVM		Continuous space vector modulation of GMCLIB_SvmStd_FLT
+* ACTUATE_MOD_DPWM0		One phase clamped per 60 degrees: the highest duty phase to the positive
+* 						rail in the 60 degrees before its voltage peak, the lowest one to the
+* 						negative rail in the 60 degrees before its negative peak
+* ACTUATE_MOD_DPWM1		One phase clamped per 60 degrees, centred on the voltage peak of the phase
+* ACTUATE_MOD_DPWMMAX	The highest duty phase is always clamped to the positive rail
+*
+* The clamp is a common offset of the three duties, the line voltages do not change.
+* ACTUATE_SetDutycycle() clamps only when both single-shunt windows stay open, a
+* clamped phase does not switch in the two PWM periods.
+******************************************************************************/
+#define ACTUATE_MOD_SVM			0U
+#define ACTUATE_MOD_DPWM0		1U
+#define ACTUATE_MOD_DPWM1		2U
+#define ACTUATE_MOD_DPWMMAX		3U
+
+#ifndef ACTUATE_MODULATION
+#define ACTUATE_MODULATION		ACTUATE_MOD_SVM		// modulation after reset
+#endif
+
+#define ACTUATE_SWITCH_EDGES	12U		// phase edges in two PWM periods with the continuous modulation
+
+/*****************************************************************************
+* Overmodulation, ACTUATE_Overmodulation() between the DC bus normalisation and GMCLIB_SvmStd_FLT
+*
+* ACTUATE_OVERMODULATION  0	The voltage vector is limited to CLOOP_LIMIT of the inscribed circle of
+* 							the voltage hexagon
+* ACTUATE_OVERMODULATION  1	Linear up to the inscribed circle, above it the two overmodulation modes
+* 							of Holtz up to ACTUATE_OVM_LIMIT of the inscribed circle:
+* 							mode I	the reference circle is enlarged and clipped by the hexagon sides,
+* 							mode II	the vector is held at the ends of the hexagon sides for a growing
+* 									part of the sector, the rest of the side is passed faster.
+* 							The side ends are ACTUATE_OVM_SIDE_ANGLE from the side centre, the middle
+* 							duty stays 10.5% (210 cnt) from the rails there and both single-shunt
+* 							windows keep minZeroPulseCnt + minSamplingPulseCnt with 10 cnt of margin.
+* 							The six-step vertex has one window only, the limit is 1.072 instead of
+* 							1.103 of the six-step operation.
+* 							ACTUATE_SetDutycycle() moves the zero sequence of the duties to the rail
+* 							that keeps the centre pulses inside the period.
+******************************************************************************/
+#ifndef ACTUATE_OVERMODULATION
+#define ACTUATE_OVERMODULATION	0
+#endif
+
+#define ACTUATE_OVM_LIMIT		1.0716F		// largest fundamental, ratio to the inscribed circle
+#define ACTUATE_OVM_MODE2		1.0440F		// fundamental of the clipped sides without the hold, mode I to mode II
+#define ACTUATE_OVM_SIDE_ANGLE	0.42792F	// side end, atan(0.79/sqrt(3)) from the side centre
+#define ACTUATE_OVM_SIDE_RADIUS	1.09911F	// side end distance, 1/cos(ACTUATE_OVM_SIDE_ANGLE)
+
+/*****************************************************************************
+* Dead-time compensation, ACTUATE_DeadTimeComp() between GMCLIB_ParkInv_FLT and the DC bus normalisation
+*
+* ACTUATE_DEADTIME_COMP  0	The phase voltages lack the dead time volt-seconds, the back-EMF observer
+* 							sees the difference between the request and the output as a distortion
+* 							growing towards the low speeds
+* ACTUATE_DEADTIME_COMP  1	Every phase voltage is moved in the direction of its current by the dead
+* 							time error, dtcDeadTimeCnt per edge pair over the PWM period times the DC
+* 							bus voltage, plus ACTUATE_DTC_SWITCH_DROP. The current direction is linear
+* 							inside +-ACTUATE_DTC_I_LIN, the compensation does not chatter at the
+* 							current zero crossing.
+* ACTUATE_DEADTIME_COMP  2	As 1, the part of the error over the phase current magnitude is taken from
+* 							dtcTable[] up to ACTUATE_DTC_TABLE_I_MAX, e.g. measured in the voltage
+* 							control at standstill as (uDReq - Rs*iD)/error over iD.
+*
+* A phase with the pulse continuing over the reload point has 2 edges in the two PWM
+* periods and half the error, a clamped phase none, see ACTUATE_PhaseEdges(). The edges
+* are those of the last ACTUATE_SetDutycycle(). The back-EMF observer keeps the
+* uncompensated request, with the compensation it is the voltage of the motor.
+*
+* The two switches are independent, but ACTUATE_REDUCED_SHIFT 1 needs the compensation:
+* the phases without the centre pulse lose half the error of the others and the
+* difference follows the voltage sector, not the current. The back-EMF observer of the
+* open loop handover does not converge on it, with the 500ns (40 cnt) of the GD3000 the
+* reduced shift without the compensation ends in FOCError after the handover.
+******************************************************************************/
+#ifndef ACTUATE_DEADTIME_COMP
+#define ACTUATE_DEADTIME_COMP	0
+#endif
+
+#define ACTUATE_DTC_CNT_PER_NS	0.08F		// FTM3 counts per ns at 80MHz
+#define ACTUATE_DTC_SWITCH_DROP	0.0F		// forward voltage of the conducting switch or diode [V]
+#define ACTUATE_DTC_I_LIN		0.01F		// current of the full compensation, ACTUATE_DEADTIME_COMP 1 [A]
+#define ACTUATE_DTC_TABLE_SIZE	9U			// points of dtcTable[], equidistant from 0A
+#define ACTUATE_DTC_TABLE_I_MAX	0.08F		// current of the last dtcTable[] point [A]
+
+/* Peripheral bindings and initial pre-trigger delays of an actuatePwm_t */
+#define ACTUATE_PWM_BINDING(ftmBase, ftmInstance, pdbBase, adcBase, dmaChannel)		\
+	{																		\
+		.ftm				= (ftmBase),									\
+		.pdb				= (pdbBase),									\
+		.adc				= (adcBase),									\
+		.ftmInst			= (ftmInstance),								\
+		.dmaChn				= (dmaChannel),									\
+		.adcAvgCnt			= 1U,											\
+		.pwmModulation		= ACTUATE_MODULATION,							\
+		.pdbPretrigDelay	= PDB_PRETRIG_DELAY_INIT						\
+	}
+
 /******************************************************************************
 | Typedefs and structures       (scope: module-local)
 -----------------------------------------------------------------------------*/
@@ -36,36 +225,103 @@ typedef struct
 	tU16	u16Edge4;
 }PWM_EDGES_TYPE;
 
-typedef struct
+/* The phases are also indexed by the sector order, EdgesPhase[] and u16Arg[]
+ * alias the named members */
+typedef union
 {
-	PWM_EDGES_TYPE EdgesPhaseA;
-	PWM_EDGES_TYPE EdgesPhaseB;
-	PWM_EDGES_TYPE EdgesPhaseC;
+	PWM_EDGES_TYPE EdgesPhase[3];
+	struct
+	{
+		PWM_EDGES_TYPE EdgesPhaseA;
+		PWM_EDGES_TYPE EdgesPhaseB;
+		PWM_EDGES_TYPE EdgesPhaseC;
+	};
 }PWM_3PHASE_EDGES_TYPE;
 
-typedef struct
+typedef union
 {
-	tU16	u16Arg1;
-	tU16	u16Arg2;
-	tU16	u16Arg3;
+	tU16	u16Arg[3];
+	struct
+	{
+		tU16	u16Arg1;
+		tU16	u16Arg2;
+		tU16	u16Arg3;
+	};
 }SWLIBS_3Syst_U16;
 
+/*------------------------------------------------------------------------*//*!
+@brief  PWM actuator of one inverter
+
+@details	The FTM generating the six PWM signals, the PDB started by its
+			initialization trigger, the ADC converting the pre-triggers and
+			the eDMA channel reloading its CnV registers are bound by
+			ACTUATE_PWM_BINDING, the rest is the PWM edge and pre-trigger
+			state of the inverter.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+#if PWM_RELOAD_DMA
+	//eDMA software TCD ring; a TCD is loaded by scatter/gather from a 32 bytes aligned address;
+	edma_software_tcd_t		pwmReloadTcd[PWM_RELOAD_TCD_CNT] __attribute__((aligned(32)));
+	tU32					pwmReloadImage[2][PWM_RELOAD_WORDS];	//eDMA source: C0V~C5V, EXTTRIG and PWMLOAD values of the even and odd cycle;
+#endif
+	FTM_Type				*ftm;							//FTM of the PWM outputs, channels 0 ~ 5 in combined mode;
+	PDB_Type				*pdb;							//PDB started by the FTM initialization trigger, channel 0 pre-triggers the ADC;
+	ADC_Type				*adc;							//ADC converting the PDB channel 0 pre-triggers;
+	tU32					ftmInst;						//SDK instance of the FTM;
+	tU8						dmaChn;							//eDMA channel of dmaController1 reloading the FTM CnV registers;
+	PWM_3PHASE_EDGES_TYPE	pwmEdgesFoc;					//PWM A B C edges in cnt, calculated by FOC generated PWM duties;
+	PWM_3PHASE_EDGES_TYPE	pwmEdgesFtm;					//PWM A B C edges in cnt, same value as pwmEdgesFoc, used to update to FTM CnV registers;
+	SWLIBS_3Syst_U16		pwmDutyCnt;						//PWM A B C duties in cnt;
+	SWLIBS_3Syst_U16		pwmCenterPulseHalfWidthCnt;		//PWM center pulse half-width in cnt;
+	tU16					pdbPretrigDelay[5];				//pretrigger delays for PDB channel 0 Delay 0 ~ Delay 4 registers
+	tU32					pwmCycleCnt;					//it's incremented in each PWM cycle. Different PWM edge values are loaded depending on this value is even or odd
+	tU32					ftmFaultStatus;					//FTM FMS register latched by the last detected fault, see FAST_TRIP;
+	tU16					adcAvgCnt;						//ADC conversions averaged per pre-trigger, see ACTUATE_OVERSAMPLING;
+	tU16					phaseShiftCnt;					//largest centre pulse half-width beyond the one of the lowest duty phase, see ACTUATE_REDUCED_SHIFT;
+	tU8						pwmModulation;					//ACTUATE_MOD_SVM, ACTUATE_MOD_DPWM0, ACTUATE_MOD_DPWM1 or ACTUATE_MOD_DPWMMAX;
+	tU8						pwmSwitchEdges;					//phase edges in the two PWM periods, ACTUATE_SWITCH_EDGES without a clamp and a centre pulse reduction;
+	GDFLIB_FILTER_MA_T_FLT	switchLossRedFilt;				//switching loss reduction against ACTUATE_SWITCH_EDGES, 0 ~ 1, filtered in the slow loop;
+	tFloat					ovmModIndex;					//voltage request, ratio to the inscribed circle of the voltage hexagon, see ACTUATE_OVERMODULATION;
+	tU8						ovmMode;						//0 linear, 1 overmodulation mode I, 2 overmodulation mode II;
+	tU16					dtcDeadTimeCnt;					//dead time in cnt, see ACTUATE_DEADTIME_COMP;
+	SWLIBS_3Syst_FLT		dtcUAbc;						//dead-time compensation of the phase voltages in V;
+}actuatePwm_t;
+
 /******************************************************************************
 | Exported Variables
 -----------------------------------------------------------------------------*/
-extern tU16 pdbPretrigDelay[5];	//pretrigger delay initial values for PDB1 channel 0 Delay 0 ~ Delay 4 registers
 extern tU16 pdbTriggerOffset;	//this offset duration is the ADC sampling time (not including the conversion time) for one channel;
-extern tU32 pwmCycleCnt;		//it's incremented in each PWM cycle. Different PWM edge values are loaded depending on this value is even or odd
+#if ACTUATE_DEADTIME_COMP == 2
+extern tFloat dtcTable[ACTUATE_DTC_TABLE_SIZE];	//part of the dead time error over the phase current magnitude;
+#endif
 
 /******************************************************************************
 | Exported function prototypes
 -----------------------------------------------------------------------------*/
-extern tBool 	ACTUATE_EnableOutput(void);
-extern tBool 	ACTUATE_DisableOutput(void);
-extern tBool 	ACTUATE_SetDutycycle(SWLIBS_3Syst_FLT *fltpwm, tU16 sector);
-extern void 	ACTUATE_PwmUpdateRegisters(void);
-extern void 	ACTUATE_PdbUpdatePretrigDelay(void);
-extern void 	ACTUATE_PwmUpdateBuffer(void);
+extern tBool 	ACTUATE_EnableOutput(actuatePwm_t *ptr);
+extern tBool 	ACTUATE_DisableOutput(actuatePwm_t *ptr);
+extern tBool 	ACTUATE_SetDutycycle(actuatePwm_t *ptr, SWLIBS_3Syst_FLT *fltpwm, tU16 sector);
+extern void 	ACTUATE_SwitchLossUpdate(actuatePwm_t *ptr);
+extern void 	ACTUATE_PwmUpdateRegisters(actuatePwm_t *ptr);
+extern void 	ACTUATE_PdbUpdatePretrigDelay(actuatePwm_t *ptr);
+extern void 	ACTUATE_PwmUpdateBuffer(actuatePwm_t *ptr);
+#if PWM_RELOAD_DMA
+extern void 	ACTUATE_PwmReloadDmaInit(actuatePwm_t *ptr);
+extern void 	ACTUATE_PwmReloadSync(actuatePwm_t *ptr);
+#endif
+#if ACTUATE_OVERMODULATION
+extern void 	ACTUATE_Overmodulation(actuatePwm_t *ptr, SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *pIn);
+#endif
+#if ACTUATE_DEADTIME_COMP
+extern void 	ACTUATE_DeadTimeComp(actuatePwm_t *ptr, SWLIBS_2Syst_FLT *pOut, const SWLIBS_2Syst_FLT *pIn,
+									 const SWLIBS_2Syst_FLT *pIAlBe, tFloat fltUdcb);
+#endif
+#if FAST_TRIP
+extern void 	ACTUATE_FastTripThreshold(tFloat iDcbOffset);
+extern tBool 	ACTUATE_FastTripCheck(actuatePwm_t *ptr);
+extern void 	ACTUATE_FastTripClear(actuatePwm_t *ptr);
+#endif
 
 /******************************************************************************
 | Inline functions
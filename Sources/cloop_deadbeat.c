@@ -0,0 +1,178 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     cloop_deadbeat.c
+*
+* @date     April-20-2017
+*
+* @brief    Deadbeat current controller
+*
+* @details	The voltage written by a control loop is applied from the start of
+*			the next one, the current until the next sample still follows the
+*			voltage of the last loop but for the CLOOP_DB_SAMPLE share. The
+*			controller predicts the current at the next sample from both and
+*			sets the voltage that takes the prediction to the reference at
+*			the sample after it: with the gain 1 a step of the reference is
+*			reached after two loops when the voltage suffices, a smaller gain
+*			takes that share of the error per loop.
+*			The prediction error of the last loop feeds an integral
+*			disturbance observer, the only controller state.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "cloop_deadbeat.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Clears the prediction and the disturbance
+
+@param[in,out]	ptr		Controller structure, model and gains are kept
+
+@details		The first update after it does not correct the disturbance,
+				there is no prediction of its current.
+******************************************************************************/
+void CLOOP_DeadbeatInit(cloopDeadbeat_t *ptr)
+{
+	ptr->iPred.fltArg1	= 0.0F;
+	ptr->iPred.fltArg2	= 0.0F;
+	ptr->uDist.fltArg1	= 0.0F;
+	ptr->uDist.fltArg2	= 0.0F;
+	ptr->predValid		= FALSE;
+}
+
+/**************************************************************************//*!
+@brief			Model coefficients from the motor parameters
+
+@param[out]		ptr		Controller structure
+@param[in]		pParam	Motor parameters, positive
+@param[in]		fltTs	Control loop period [s]
+
+@details		The decay is the trapezoidal one of the back-EMF observer, the
+				voltage gain keeps the DC gain 1/R, CLOOP_DB_SAMPLE of it is
+				the share of the voltage of this loop before the next sample.
+				To be called from the control loop between two of its passes.
+******************************************************************************/
+void CLOOP_DeadbeatSetModel(cloopDeadbeat_t *ptr, const motorParam_t *pParam, tFloat fltTs)
+{
+	tFloat	rTs;
+
+	rTs			= MLIB_Mul(pParam->rs, fltTs);
+
+	ptr->aD		= MLIB_Div(MLIB_Sub(MLIB_Mul(2.0F, pParam->ld), rTs), MLIB_Add(MLIB_Mul(2.0F, pParam->ld), rTs));
+	ptr->bD		= MLIB_Div(MLIB_Sub(1.0F, ptr->aD), pParam->rs);
+	ptr->bDInv	= MLIB_Div(1.0F, ptr->bD);
+	ptr->bDNew	= MLIB_Mul(ptr->bD, CLOOP_DB_SAMPLE);
+	ptr->kD		= MLIB_Div(1.0F, MLIB_Add(MLIB_Mul(ptr->aD, ptr->bDNew), MLIB_Sub(ptr->bD, ptr->bDNew)));
+	ptr->aQ		= MLIB_Div(MLIB_Sub(MLIB_Mul(2.0F, pParam->lq), rTs), MLIB_Add(MLIB_Mul(2.0F, pParam->lq), rTs));
+	ptr->bQ		= MLIB_Div(MLIB_Sub(1.0F, ptr->aQ), pParam->rs);
+	ptr->bQInv	= MLIB_Div(1.0F, ptr->bQ);
+	ptr->bQNew	= MLIB_Mul(ptr->bQ, CLOOP_DB_SAMPLE);
+	ptr->kQ		= MLIB_Div(1.0F, MLIB_Add(MLIB_Mul(ptr->aQ, ptr->bQNew), MLIB_Sub(ptr->bQ, ptr->bQNew)));
+	ptr->rs		= pParam->rs;
+	ptr->ld		= pParam->ld;
+	ptr->lq		= pParam->lq;
+	ptr->ke		= pParam->ke;
+}
+
+/**************************************************************************//*!
+@brief			dq voltage of the next control loop
+
+@param[in,out]	ptr			Controller structure
+@param[in]		fltUDcBus	DC bus voltage [V]
+@param[in,out]	pUDQReq		Voltage applied during this control loop in,
+							voltage of the next one out [V]
+@param[in,out]	pCtrl		Current loop, references, feedback and limits
+@param[in]		fltWRotEl	Electrical speed [rad/s]
+
+@details		The voltage of this loop is the one that reaches the target
+				at the sample after the next one with the steady state
+				voltage R*target held from the next loop on, the current
+				until the next sample includes its CLOOP_DB_SAMPLE share.
+				The limits are the ones of AMCLIB_CurrentLoop_FLT: the d-axis
+				voltage within pPIrAWD.fltUpperLimit*Udcb/sqrt(3), the q-axis
+				within the rest of the circle, written to the pPIrAWQ limits
+				in volts for the field weakening controller. The next update
+				predicts with the limited voltage, a saturated loop does not
+				wind up the disturbance.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+void CLOOP_DeadbeatUpdate(cloopDeadbeat_t *ptr, tFloat fltUDcBus, SWLIBS_2Syst_FLT *pUDQReq,
+						  AMCLIB_CURRENT_LOOP_T_FLT *pCtrl, tFloat fltWRotEl)
+{
+	tFloat	iD, iQ, uOldD, uOldQ, predD, predQ, targetD, targetQ, uD, uQ, uMax, uQMax;
+
+	iD = pCtrl->pIDQFbck->fltArg1;
+	iQ = pCtrl->pIDQFbck->fltArg2;
+
+	// Disturbance from the prediction error of the last control loop
+	if (ptr->predValid)
+	{
+		ptr->uDist.fltArg1 = MLIB_Add(ptr->uDist.fltArg1,
+									  MLIB_Mul(MLIB_Mul(ptr->obsGain, ptr->bDInv), MLIB_Sub(iD, ptr->iPred.fltArg1)));
+		ptr->uDist.fltArg2 = MLIB_Add(ptr->uDist.fltArg2,
+									  MLIB_Mul(MLIB_Mul(ptr->obsGain, ptr->bQInv), MLIB_Sub(iQ, ptr->iPred.fltArg2)));
+	}
+
+	// Voltage of the last loop with the speed voltages and the disturbance
+	uOldD = MLIB_Add(MLIB_Add(pUDQReq->fltArg1, ptr->uDist.fltArg1), MLIB_Mul(MLIB_Mul(fltWRotEl, ptr->lq), iQ));
+	uOldQ = MLIB_Sub(MLIB_Add(pUDQReq->fltArg2, ptr->uDist.fltArg2), MLIB_Mul(fltWRotEl, MLIB_Add(MLIB_Mul(ptr->ld, iD), ptr->ke)));
+
+	// Current at the next sample with the voltage of the last loop held
+	predD = MLIB_Add(MLIB_Mul(ptr->aD, iD), MLIB_Mul(ptr->bD, uOldD));
+	predQ = MLIB_Add(MLIB_Mul(ptr->aQ, iQ), MLIB_Mul(ptr->bQ, uOldQ));
+
+	// Target of the sample after the next one, the gain share of the error to the reference
+	targetD = MLIB_Add(predD, MLIB_Mul(ptr->gain, MLIB_Sub(pCtrl->pIDQReq->fltArg1, predD)));
+	targetQ = MLIB_Add(predQ, MLIB_Mul(ptr->gain, MLIB_Sub(pCtrl->pIDQReq->fltArg2, predQ)));
+
+	// Voltage reaching the target, the last one applied until this loop ends, R*target from the next loop
+	uD = MLIB_Sub(MLIB_Sub(MLIB_Mul(ptr->kD,
+									MLIB_Sub(MLIB_Sub(targetD, MLIB_Mul(ptr->aD, MLIB_Sub(predD, MLIB_Mul(ptr->bDNew, uOldD)))),
+											 MLIB_Mul(MLIB_Mul(ptr->bDNew, ptr->rs), targetD))),
+						   MLIB_Mul(MLIB_Mul(fltWRotEl, ptr->lq), predQ)),
+				  ptr->uDist.fltArg1);
+	uQ = MLIB_Sub(MLIB_Add(MLIB_Mul(ptr->kQ,
+									MLIB_Sub(MLIB_Sub(targetQ, MLIB_Mul(ptr->aQ, MLIB_Sub(predQ, MLIB_Mul(ptr->bQNew, uOldQ)))),
+											 MLIB_Mul(MLIB_Mul(ptr->bQNew, ptr->rs), targetQ))),
+						   MLIB_Mul(fltWRotEl, MLIB_Add(MLIB_Mul(ptr->ld, predD), ptr->ke))),
+				  ptr->uDist.fltArg2);
+
+	// Limits of AMCLIB_CurrentLoop_FLT
+	uMax = MLIB_Mul(MLIB_Mul(pCtrl->pPIrAWD.fltUpperLimit, fltUDcBus), FLOAT_DIVBY_SQRT3);
+	if (uD > uMax)
+	{
+		uD = uMax;
+	}
+	else if (uD < MLIB_Neg(uMax))
+	{
+		uD = MLIB_Neg(uMax);
+	}
+
+	uQMax = GFLIB_Sqrt(MLIB_Sub(MLIB_Mul(uMax, uMax), MLIB_Mul(uD, uD)));
+	pCtrl->pPIrAWQ.fltUpperLimit = uQMax;
+	pCtrl->pPIrAWQ.fltLowerLimit = MLIB_Neg(uQMax);
+	if (uQ > uQMax)
+	{
+		uQ = uQMax;
+	}
+	else if (uQ < MLIB_Neg(uQMax))
+	{
+		uQ = MLIB_Neg(uQMax);
+	}
+
+	// The share of the new voltage until the next sample
+	ptr->iPred.fltArg1	= MLIB_Add(predD, MLIB_Mul(ptr->bDNew, MLIB_Sub(uD, pUDQReq->fltArg1)));
+	ptr->iPred.fltArg2	= MLIB_Add(predQ, MLIB_Mul(ptr->bQNew, MLIB_Sub(uQ, pUDQReq->fltArg2)));
+	pUDQReq->fltArg1	= uD;
+	pUDQReq->fltArg2	= uQ;
+	ptr->predValid		= TRUE;
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     cloop_deadbeat.h
+*
+* @date     April-20-2017
+*
+* @brief    Header file for the deadbeat current controller
+*
+*******************************************************************************/
+#ifndef CLOOP_DEADBEAT_H_
+#define CLOOP_DEADBEAT_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "amclib.h"
+#include "PMSM_apprate.h"
+#include "motor_tune.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* CLOOP_DEADBEAT	dq current controller of FocFastLoop
+ *		0	AMCLIB_CurrentLoop_FLT, two PI controllers at the bandwidth of
+ *			motor_tune.h
+ *		1	deadbeat controller on the motor model of motorTune.param. The
+ *			voltage written by a control loop is applied from the start of
+ *			the next one, the current samples lie CLOOP_DB_SAMPLE after the
+ *			start: the voltage of the last loop is applied until the next
+ *			sample but for that share. The model predicts the current at the
+ *			next sample and sets the voltage that reaches the reference at
+ *			the sample after it.
+ *			A disturbance observer removes the steady state error of the
+ *			model. The current settles in two control loops with the gain 1
+ *			of CLOOP_DB_GAIN, the limits and the q-axis voltage limit left
+ *			for the field weakening are the ones of AMCLIB_CurrentLoop_FLT.
+ * Only in the sensorless and encoder position modes, the model holds in the
+ * rotor frame only and the injection filters the fundamental current; the
+ * open loop start-up, the tracking and the injection keep the PI controllers,
+ * preset to the deadbeat output whenever it runs.
+ *
+ * CLOOP_DB_GAIN	share of the predicted error removed per control loop
+ *		1	deadbeat, a step settles in 2 control loops without overshoot
+ *			with the exact model; a motor inductance 10% below Ld, Lq of
+ *			motorTune.param overshoots by 9%, 30% below by 33%
+ *		0.5	default, 90% of a step in 4 control loops; a motor inductance
+ *			from 30% below to 30% above the model overshoots by 5% at most
+ * Rs and Ke errors only load the disturbance observer, they do not
+ * overshoot. */
+#ifndef CLOOP_DEADBEAT
+#define CLOOP_DEADBEAT			0
+#endif
+
+#ifndef CLOOP_DB_GAIN
+#define CLOOP_DB_GAIN			(0.5F)		// share of the predicted error removed per control loop, 1 deadbeat
+#endif
+#define CLOOP_DB_OBS_GAIN		(0.25F)		// share of the prediction error the disturbance takes per control loop
+#define CLOOP_DB_TS				((tFloat)FOC_PERIOD_US*1.0e-6F)
+
+/* Current sample after the start of the control loop, share of the loop. The
+ * mean of the samples in the first and the second PWM period is the current
+ * at the end of the first one. */
+#define CLOOP_DB_SAMPLE			(1.0F/(tFloat)FOC_PWM_PERIODS)
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Deadbeat current controller
+
+@details	Model from one current sample to the next, the voltage u(k-1)
+			written by the last loop is held until the next loop starts,
+			u(k) of this loop for the rest
+				i(k+1) = a*i(k) + b*(1 - s)*(u(k-1) + coupling + d)
+								+ b*s*(u(k) + coupling + d)
+				a = (2L - R*Ts)/(2L + R*Ts), b = (1 - a)/R, s = CLOOP_DB_SAMPLE
+			the speed voltages
+				d-axis	 w*Lq*iq
+				q-axis	-w*Ld*id - w*Ke
+			are taken constant over the loop. d is the disturbance voltage,
+			the dead time and the model error. With u(k+1) at the steady
+			state voltage of the reference i(k+2) reaches it, u(k+1)
+			computed by the next loop is that voltage then.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							aD;				// d-axis current decay per control loop
+	tFloat							bD;				// d-axis current per voltage [A/V]
+	tFloat							bDInv;			// d-axis voltage per current [V/A]
+	tFloat							bDNew;			// d-axis current per voltage of this loop until the next sample [A/V]
+	tFloat							kD;				// d-axis voltage of this loop per current two samples ahead [V/A]
+	tFloat							aQ;				// q-axis current decay per control loop
+	tFloat							bQ;				// q-axis current per voltage [A/V]
+	tFloat							bQInv;			// q-axis voltage per current [V/A]
+	tFloat							bQNew;			// q-axis current per voltage of this loop until the next sample [A/V]
+	tFloat							kQ;				// q-axis voltage of this loop per current two samples ahead [V/A]
+	tFloat							rs;				// stator resistance [Ohm]
+	tFloat							ld;				// d-axis inductance [H]
+	tFloat							lq;				// q-axis inductance [H]
+	tFloat							ke;				// flux linkage [Vs/rad]
+	tFloat							gain;			// share of the predicted error removed per control loop
+	tFloat							obsGain;		// share of the prediction error the disturbance takes
+	SWLIBS_2Syst_FLT				iPred;			// current predicted for the next sample [A]
+	tBool							predValid;		// iPred made by the last control loop
+	SWLIBS_2Syst_FLT				uDist;			// disturbance voltage [V]
+}cloopDeadbeat_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void CLOOP_DeadbeatInit(cloopDeadbeat_t *ptr);
+extern void CLOOP_DeadbeatSetModel(cloopDeadbeat_t *ptr, const motorParam_t *pParam, tFloat fltTs);
+extern void CLOOP_DeadbeatUpdate(cloopDeadbeat_t *ptr, tFloat fltUDcBus, SWLIBS_2Syst_FLT *pUDQReq,
+								 AMCLIB_CURRENT_LOOP_T_FLT *pCtrl, tFloat fltWRotEl);
+
+#endif /* CLOOP_DEADBEAT_H_ */
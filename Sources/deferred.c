@@ -0,0 +1,108 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     deferred.c
+*
+* @date     March-28-2017
+*
+* @brief    Deferred work of the fast control loop
+*
+* @details	ADC1_IRQHandler posts one message per control loop and pends the
+*			software interrupt, SWI_IRQHandler runs the non real-time work
+*			(board buttons, RGB LED, FreeMASTER recorder) at the lowest
+*			priority once the fast loop has finished.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "deferred.h"
+#include "interrupt_manager.h"
+
+/******************************************************************************
+| Global variable definitions   (scope: module-exported)
+-----------------------------------------------------------------------------*/
+deferMbox_t deferMbox;
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Clears the mailbox and enables the software interrupt
+******************************************************************************/
+void DEFER_Init(void)
+{
+	deferMbox.head		= 0U;
+	deferMbox.tail		= 0U;
+	deferMbox.posted	= 0U;
+	deferMbox.dropped	= 0U;
+
+	INT_SYS_ClearPending(DEFER_IRQ);
+	INT_SYS_SetPriority(DEFER_IRQ, DEFER_IRQ_PRIORITY);
+	INT_SYS_EnableIRQ(DEFER_IRQ);
+}
+
+/**************************************************************************//*!
+@brief			Posts a message and pends the software interrupt
+
+@param[in]		msg		Deferred work of the control loop
+
+@return			false when the mailbox is full and the message is dropped
+
+@details		Producer side, called from ADC1_IRQHandler only. The message is
+				complete before head is advanced, the consumer never sees a
+				partly written entry.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+tBool DEFER_Post(const deferMsg_t *msg)
+{
+	tU32 head = deferMbox.head;
+
+	if ((head - deferMbox.tail) >= DEFER_MBOX_SIZE)
+	{
+		deferMbox.dropped++;
+		INT_SYS_SetPending(DEFER_IRQ);
+		return (false);
+	}
+
+	deferMbox.msg[head & (DEFER_MBOX_SIZE - 1U)] = *msg;
+	__asm volatile ("" ::: "memory");
+	deferMbox.head = head + 1U;
+	deferMbox.posted++;
+
+	INT_SYS_SetPending(DEFER_IRQ);
+
+	return (true);
+}
+
+/**************************************************************************//*!
+@brief			Takes the oldest message
+
+@param[out]		msg		Deferred work of the control loop
+
+@return			false when the mailbox is empty
+
+@details		Consumer side, called from SWI_IRQHandler only.
+******************************************************************************/
+tBool DEFER_Get(deferMsg_t *msg)
+{
+	tU32 tail = deferMbox.tail;
+
+	if (tail == deferMbox.head)
+	{
+		return (false);
+	}
+
+	*msg = deferMbox.msg[tail & (DEFER_MBOX_SIZE - 1U)];
+	__asm volatile ("" ::: "memory");
+	deferMbox.tail = tail + 1U;
+
+	return (true);
+}
+
+/* End of file */
@@ -0,0 +1,67 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     deferred.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the deferred work of the fast control loop
+*
+*******************************************************************************/
+#ifndef _DEFERRED_H_
+#define _DEFERRED_H_
+
+#include "gflib.h"
+#include "S32K144.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+#define DEFER_IRQ				SWI_IRQn	// software interrupt, pended by DEFER_Post()
+#define DEFER_IRQ_PRIORITY		15U			// lowest, below all peripheral interrupts
+#define DEFER_MBOX_SIZE			8U			// mailbox entries, power of two
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  One control loop worth of deferred work
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tU16	state;					// application state at the end of the control loop
+}deferMsg_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Single producer, single consumer mailbox
+
+@details	ADC1_IRQHandler is the only producer and writes head only,
+			SWI_IRQHandler is the only consumer and writes tail only, so no
+			locking is needed. A full mailbox drops the new message.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	deferMsg_t		msg[DEFER_MBOX_SIZE];
+	volatile tU32	head;			// next entry to write, producer
+	volatile tU32	tail;			// next entry to read, consumer
+	tU32			posted;			// messages posted
+	tU32			dropped;		// messages dropped on a full mailbox
+}deferMbox_t;
+
+/******************************************************************************
+| Exported Variables
+-----------------------------------------------------------------------------*/
+extern deferMbox_t deferMbox;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void  DEFER_Init(void);
+extern tBool DEFER_Post(const deferMsg_t *msg);
+extern tBool DEFER_Get(deferMsg_t *msg);
+
+#endif /* _DEFERRED_H_ */
@@ -45,16 +45,25 @@ volatile int exit_code = 0;
 #include "gd3000_init.h"
 #include "freemaster.h"
 #include "PMSM_appconfig.h"
+#include "PMSM_apprate.h"
 #include "actuate_s32k.h"
 #include "meas_s32k.h"
 #include "motor_structure.h"
 #include "state_machine.h"
 #include "pospe_sensor.h"
+#include "pospe_ipd.h"
+#include "pospe_hfi.h"
+#include "motor_ident.h"
+#include "motor_tune.h"
+#include "motor_mtpa.h"
+#include "cloop_deadbeat.h"
 #include "amclib.h"
 #include "aml/common_aml.h"
 #include "aml/gpio_aml.h"
 #include "tpp/tpp.h"
 #include "PMSM_appfreemaster_TSA.h"
+#include "profiler.h"
+#include "deferred.h"
 
 /*******************************************************************************
 * Global variables
@@ -64,35 +73,44 @@ volatile int exit_code = 0;
 /*******************************************************************************
 * Local variables
 *******************************************************************************/
-pmsmDrive_t         drvFOC;         // Field Oriented Control Variables
-driveStates_t 	    cntrState;	    // Responsible for stateMachine state propagation
-appFaultStatus_t    tempfaults;		// Temporary faults to be indicated inhere
-appFaultStatus_t    permFaults;		// Permanent faults to be indicated inhere
 fm_scale_t          fmScale;		// Scales for freeMASTER interface
-measModule_t        meas;			// Variables measured by ADC modules
-tPos_mode           pos_mode;		// Variable defining position mode
 gd3000Status_t      gd3000Status;	// GD3000 status variables
 tpp_drv_config_t    tppDrvConfig;	// GD3000 configuration structure
-tBool               statePWM;		// Status of the PWM update
-pdbStatus_t         pdbStatus;		// PDB0 and PDB1 status tracking
-tBool               fieldWeakOnOff; // Enable/Disable Field Weakening
-encoderPospe_t      encoderPospe;	// Encoder position and speed
-switchSensor_t      switchSensor;	// Position sensor selector
 
-static void MCAT_Init();
+// Drive contexts of the axes with the peripheral bindings of their inverters
+pmsmAxis_t          pmsmAxis[PMSM_AXIS_CNT] =
+{
+	[PMSM_AXIS_FTM3] =
+	{
+		.pwm		= ACTUATE_PWM_BINDING(FTM3, INST_FLEXTIMER_PWM3, PDB1, ADC1, PWM_RELOAD_DMA_CHN),
+		.adc		= ADC1,
+		.adcInst	= INST_ADCONV1,
+		.adcIrq		= ADC1_IRQn,
+		.adcDmaChn	= MEAS_ADC_DMA_CHN,
+		.pdbInst	= INST_PDB1,
+		.gd3000		= &tppDrvConfig,
+	},
+};
+
+static void MCAT_Init(pmsmAxis_t *axis);
+
+static void AxisPdbIsr(pmsmAxis_t *axis);
+static void AxisControlLoop(pmsmAxis_t *axis);
+static void AxisTuneLoad(pmsmAxis_t *axis);
+#if !PWM_RELOAD_DMA
+static void AxisPwmReload(pmsmAxis_t *axis);
+#endif
 
-static tBool FocFastLoop(void);
-static tBool FocSlowLoop(void);
-static tBool FaultDetection();
+static tBool FocFastLoop(pmsmAxis_t *axis);
+static tBool FocSlowLoop(pmsmAxis_t *axis);
+#if FOC_FLYING_START
+static tBool FocCatch(pmsmAxis_t *axis);
+#endif
+static tBool FaultDetection(pmsmAxis_t *axis);
 
-tBool AutomaticMode(void);
+tBool AutomaticMode(pmsmAxis_t *axis);
 static tBool CalcOpenLoop(openLoopPospe_t *openLoop, tFloat speedReqRamp);
 
-// Open Loop and Closed loop speed ramp variants
-volatile tFloat     OL_SpeedRampInc = 0.0F, CL_SpeedRampInc = 0.0F, CL_SpeedRampDec = 0.0F;
-volatile tFloat     FW_PropGainControl = 0.0F, FW_IntegGainControl = 0.0F;
-volatile tFloat     UDQVectorSum = 0.0F;
-
 /*****************************************************************************
 * Define Motor with or without Encoder sensor
 *
@@ -115,6 +133,8 @@ volatile tFloat     UDQVectorSum = 0.0F;
 int main(void)
 {
 	/* Write your local variable definition here */
+	pmsmAxis_t *axis;
+	tU32 i;
 
 	// MCU peripherals initialization
  	McuClockConfig();
@@ -126,7 +146,27 @@ int main(void)
  	McuLpuartConfig();
  	McuAdcConfig();
  	McuPdbConfig();
+#if FAST_TRIP
+	McuCmpConfig();
+#endif
 	McuFtmConfig();
+#if PWM_RELOAD_DMA || MEAS_ADC_DMA
+	McuDmaConfig();
+#endif
+#if PWM_RELOAD_DMA
+	// FTM PWM registers reloaded by eDMA
+	for(i = 0; i < PMSM_AXIS_CNT; i++)
+	{
+		ACTUATE_PwmReloadDmaInit(&pmsmAxis[i].pwm);
+	}
+#endif
+#if MEAS_ADC_DMA
+	// ADC results captured by eDMA
+	for(i = 0; i < PMSM_AXIS_CNT; i++)
+	{
+		MEAS_AdcDmaInit(&pmsmAxis[i].meas, pmsmAxis[i].adc, pmsmAxis[i].adcDmaChn);
+	}
+#endif
 
     // FreeMASTER initialization
 	FMSTR_Init();
@@ -134,21 +174,36 @@ int main(void)
     // MC34GD3000 initialization
     GD3000_Init();
 
-    // MCAT variables initialization
-    MCAT_Init();
+    // Execution time profiler initialization
+    PROF_Init();
+
+    // Deferred work of the ADC ISR in the software interrupt
+    DEFER_Init();
+
+    for(i = 0; i < PMSM_AXIS_CNT; i++)
+    {
+    	axis = &pmsmAxis[i];
+
+    	// MCAT variables initialization
+    	MCAT_Init(axis);
 
-    // Clear measured variables
-    MEAS_Clear(&meas);
+    	// Clear measured variables
+    	MEAS_Clear(&axis->meas);
 
-    // Application starts from init state
-    cntrState.state   	= init;
-    cntrState.event 	= e_init;
+    	// Application starts from init state
+    	SM_Init(&axis->smEventQueue);
+    	axis->cntrState.state   	= init;
+    	axis->cntrState.event 	= e_init;
 
-    // Default setting of a FOC Control Mode
-    cntrState.usrControl.FOCcontrolMode		= speedControl;
+    	// Default setting of a FOC Control Mode
+    	axis->cntrState.usrControl.FOCcontrolMode		= speedControl;
+    }
 
-    // Application starts by FTM3 initialization trigger
-    FTM_RMW_EXTTRIG_REG(FTM3, 0x00, 0x40);
+    // Application starts by FTM initialization trigger
+    for(i = 0; i < PMSM_AXIS_CNT; i++)
+    {
+    	FTM_RMW_EXTTRIG_REG(pmsmAxis[i].pwm.ftm, 0x00, 0x40);
+    }
 
     /*** Processor Expert internal initialization. DON'T REMOVE THIS CODE!!! ***/
     #ifdef PEX_RTOS_INIT
@@ -174,20 +229,37 @@ int main(void)
     	if(gd3000Status.B.gd3000ClearErr)
     	{
     		gd3000Status.B.gd3000ClearErr = false;
-    		permFaults.gd3000 = false;
+    		pmsmAxis[PMSM_AXIS_FTM3].permFaults.gd3000 = false;
     		tppDrvConfig.deviceConfig.statusRegister[0U] = 0U;
     		TPP_ClearInterrupts(&tppDrvConfig, TPP_CLINT0_MASK, TPP_CLINT1_MASK);
     	}
 
-    	// Enter fault state, if there are PDBs sequence errors
-    	if(permFaults.mcu.B.PDB0_Error || permFaults.mcu.B.PDB1_Error)
+    	for(i = 0; i < PMSM_AXIS_CNT; i++)
     	{
-    		FTM_RMW_EXTTRIG_REG(FTM3, 0x40, 0x00);
+    		axis = &pmsmAxis[i];
+
+    		// Requested control gain synthesis, loaded by the control loop
+    		TUNE_Background(&axis->drvFOC.motorTune);
+#if MOTOR_MTPA
+    		// Requested current reference table, used by the speed loop once valid
+    		MTPA_Background(&axis->drvFOC.motorMtpa, &axis->drvFOC.motorTune.param);
+#endif
 
-    		// Enter fault state
-    		cntrState.event = e_fault;
-    		StateTable[cntrState.event][cntrState.state]();
-    		StateLED[cntrState.state]();
+    		// Enter fault state, if there are PDBs sequence errors
+    		if(axis->permFaults.mcu.B.PDB0_Error || axis->permFaults.mcu.B.PDB1_Error)
+    		{
+    			FTM_RMW_EXTTRIG_REG(axis->pwm.ftm, 0x40, 0x00);
+
+    			// Enter fault state, the control loop is stopped, the state machine runs from here
+    			(void)SM_PostEvent(&axis->smEventQueue, e_fault);
+    			INT_SYS_DisableIRQ(axis->adcIrq);
+    			SM_Dispatch(axis);
+    			INT_SYS_EnableIRQ(axis->adcIrq);
+    			if(i == PMSM_AXIS_BOARD)
+    			{
+    				StateLED[axis->cntrState.state](axis);
+    			}
+    		}
     	}
     }
 
@@ -258,111 +330,233 @@ void PORTE_IRQHandler(void)
 *
 * Function: 	PDB1_IRQHandler(void)
 *
-* Description:  PDB1 Interrupt Service Routine
+* Description:  PDB1 Interrupt Service Routine, FTM3 axis
 *
 *******************************************************************************/
 void PDB1_IRQHandler(void)
 {
-	// PDB1 Sequence error interrupt
-	if(PDB_DRV_GetAdcPreTriggerSeqErrFlags(INST_PDB1, 0, 0xFF))
+	AxisPdbIsr(&pmsmAxis[PMSM_AXIS_FTM3]);
+}
+
+/*******************************************************************************
+*
+* Function: 	ADC1_IRQHandler()
+*
+* Description:  ADC1 interrupt service routine, FTM3 axis control loop
+*
+*******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+void ADC1_IRQHandler()
+{
+	AxisControlLoop(&pmsmAxis[PMSM_AXIS_FTM3]);
+}
+
+/*******************************************************************************
+*
+* Function: 	AxisPdbIsr(pmsmAxis_t *axis)
+*
+* Description:  PDB Interrupt Service Routine of an axis
+*
+*******************************************************************************/
+static void AxisPdbIsr(pmsmAxis_t *axis)
+{
+	// PDB Sequence error interrupt
+	if(PDB_DRV_GetAdcPreTriggerSeqErrFlags(axis->pdbInst, 0, 0xFF))
 	{
-		// Indicates PDB1 Sequence error
-		permFaults.mcu.B.PDB1_Error = true;
-		// Get PDB1 Sequence error flags
-		pdbStatus.PDB1_SeqErrFlags = PDB_DRV_GetAdcPreTriggerSeqErrFlags(INST_PDB1, 0, 0xFF);
+		// Indicates PDB Sequence error and gets PDB Sequence error flags
+		if(axis->pdbInst == 0U)
+		{
+			axis->permFaults.mcu.B.PDB0_Error = true;
+			axis->pdbStatus.PDB0_SeqErrFlags = PDB_DRV_GetAdcPreTriggerSeqErrFlags(axis->pdbInst, 0, 0xFF);
+		}
+		else
+		{
+			axis->permFaults.mcu.B.PDB1_Error = true;
+			axis->pdbStatus.PDB1_SeqErrFlags = PDB_DRV_GetAdcPreTriggerSeqErrFlags(axis->pdbInst, 0, 0xFF);
+		}
 
-		// Disable PDB1
-		PDB_DRV_Disable(INST_PDB1);
+		// Disable PDB
+		PDB_DRV_Disable(axis->pdbInst);
 
-		// Clear PDB1 sequence errors
-		PDB_DRV_ClearAdcPreTriggerSeqErrFlags(INST_PDB1, 0, 0xFF);
+		// Clear PDB sequence errors
+		PDB_DRV_ClearAdcPreTriggerSeqErrFlags(axis->pdbInst, 0, 0xFF);
 
-		// Enable PDB1
-		PDB_DRV_Enable(INST_PDB1);
+		// Enable PDB
+		PDB_DRV_Enable(axis->pdbInst);
 	}
 
-	// PDB1 timer overflow interrupt
-	if (PDB_DRV_GetTimerIntFlag(INST_PDB1))
+	// PDB timer overflow interrupt
+	if (PDB_DRV_GetTimerIntFlag(axis->pdbInst))
 	{
 		// Enable FTM initialization trigger to trigger ADC modules
-		// every control loop (150uS). Ignore if there are PDBs sequence errors
-		if(!(permFaults.mcu.B.PDB0_Error || permFaults.mcu.B.PDB1_Error))
+		// every control loop (FOC_PWM_PERIODS x 25uS). Ignore if there are PDBs sequence errors
+		if(!(axis->permFaults.mcu.B.PDB0_Error || axis->permFaults.mcu.B.PDB1_Error))
 		{
-			FTM_RMW_EXTTRIG_REG(FTM3, 0x00, 0x40);		//enable FMT3_INIT_TRIG output
-			ACTUATE_PwmUpdateBuffer();		//Update PWM edge values from buffer of FOC calculated results to buffer used for FTM registers update
-			ACTUATE_PwmUpdateRegisters();				//Update FTM PWM edge registers values with global variables;
-			//we update FTM registers here because it's just close to the end of 150uS control loop,
-			//and we want to use same set of FTM PWM edges values in each 150uS control loop;
-			//at 125uS, the FTM PWM registers were already updated in FTM reload ISR;
+			FTM_RMW_EXTTRIG_REG(axis->pwm.ftm, 0x00, 0x40);		//enable FTM INIT_TRIG output
+			ACTUATE_PwmUpdateBuffer(&axis->pwm);		//Update PWM edge values from buffer of FOC calculated results to buffer used for FTM registers update
+#if PWM_RELOAD_DMA
+			ACTUATE_PwmReloadSync(&axis->pwm);			//Update FTM PWM edge registers with odd cycle values, re-align the eDMA chain;
+#else
+			axis->pwm.pwmCycleCnt |= 1U;				//1st period of the next control loop uses odd cycle values, also with odd FOC_PWM_PERIODS;
+			ACTUATE_PwmUpdateRegisters(&axis->pwm);		//Update FTM PWM edge registers values with global variables;
+#endif
+#if MEAS_ADC_DMA
+			MEAS_AdcDmaSync(&axis->meas, axis->drvFOC.svmSector);	//Arm the tag of the next ADC frame, re-align the eDMA ring;
+#endif
+			//we update FTM registers here because it's just close to the end of the control loop,
+			//and we want to use same set of FTM PWM edges values in each control loop;
+			//at the start of the last PWM period, the FTM PWM registers were already updated in FTM reload ISR;
 			//here we update the FTM PWM registers again but with latest FOC calculated values.
 		}
 
-		PDB_DRV_ClearTimerIntFlag(INST_PDB1);
+		PDB_DRV_ClearTimerIntFlag(axis->pdbInst);
 	}
 }
 
 /*******************************************************************************
 *
-* Function: 	ADC1_IRQHandler()
+* Function: 	AxisControlLoop(pmsmAxis_t *axis)
 *
-* Description:  ADC1 interrupt service routine
+* Description:  Control loop of an axis, runs in its ADC interrupt service routine
 *
 *******************************************************************************/
 __attribute__((section (".code_ram"))) 		// inserting function to the RAM section
-void ADC1_IRQHandler()
+static void AxisControlLoop(pmsmAxis_t *axis)
 {
-	static tBool getFcnStatus;
+	tBool getFcnStatus;
+	tU32 profIsrStamp, profStamp;
+	deferMsg_t deferMsg;
 
-	// Board buttons to control the application from board
-	cntrState.usrControl.btSpeedUp = ((PINS_DRV_ReadPins(PTC)  >> 12) & 1);
-	cntrState.usrControl.btSpeedDown = ((PINS_DRV_ReadPins(PTC)  >> 13) & 1);
-
-	// Board buttons control logic
-	BoardButtons();
+	PROF_BEGIN(profIsrStamp);
 
 	// User accessible switch for stopping the application.
-	if (cntrState.usrControl.switchAppOnOff ^ cntrState.usrControl.switchAppOnOffState)
+	if (axis->cntrState.usrControl.switchAppOnOff ^ axis->cntrState.usrControl.switchAppOnOffState)
 	{
-		cntrState.usrControl.switchAppOnOffState  = cntrState.usrControl.switchAppOnOff;
-		cntrState.event   = (cntrState.usrControl.switchAppOnOff) ? e_app_on: e_app_off;
+		axis->cntrState.usrControl.switchAppOnOffState  = axis->cntrState.usrControl.switchAppOnOff;
+		(void)SM_PostEvent(&axis->smEventQueue, (axis->cntrState.usrControl.switchAppOnOff) ? e_app_on: e_app_off);
 	}
 
 	getFcnStatus    =    true;
 
+	// Synthesized gains, swapped in before any controller of this control loop runs
+	if (axis->drvFOC.motorTune.pending)
+	{
+		AxisTuneLoad(axis);
+		axis->drvFOC.motorTune.loaded	= true;
+		axis->drvFOC.motorTune.pending	= false;
+	}
+
 	// Set pin to measure TOTAL execution time
     //PTD->PSOR |= 1<<2;
 
-	//save ADC1 results to buffer adcRawResultArray[], and clear ADC conversion complete flag;
-	MEAS_SaveAdcRawResult();
+	//save ADC results to buffer adcRawResultArray[], and clear ADC conversion complete flag;
+	PROF_BEGIN(profStamp);
+	MEAS_SaveAdcRawResult(&axis->meas, axis->adc, axis->drvFOC.svmSector);
+	PROF_END(PROF_MEAS_SAVE, profStamp);
 
 	// DCB voltage, DCB current and phase currents measurement
-	getFcnStatus &= MEAS_Get3PhCurrent(&meas, &drvFOC.iAbcFbck, drvFOC.svmSector);
-	getFcnStatus &= MEAS_GetIdcCurrent(&meas);
-	getFcnStatus  = MEAS_GetUdcVoltage(&meas, &drvFOC.uDcbFilter);
-
-	drvFOC.fltUdcb = meas.measured.fltUdcb.filt;
-	drvFOC.fltIdcb = meas.measured.fltIdcb.filt;
+	PROF_BEGIN(profStamp);
+	getFcnStatus &= MEAS_Get3PhCurrent(&axis->meas, &axis->drvFOC.iAbcFbck, axis->drvFOC.svmSector);
+	getFcnStatus &= MEAS_GetIdcCurrent(&axis->meas);
+	getFcnStatus  = MEAS_GetUdcVoltage(&axis->meas, &axis->drvFOC.uDcbFilter);
+	PROF_END(PROF_MEAS_GET, profStamp);
+
+	axis->drvFOC.fltUdcb = axis->meas.measured.fltUdcb.filt;
+	axis->drvFOC.fltIdcb = axis->meas.measured.fltIdcb.filt;
 	
 #if ENCODER
     // Get rotor position and speed from Encoder sensor
-	POSPE_GetPospeElEnc(&encoderPospe);
+	POSPE_GetPospeElEnc(&axis->encoderPospe);
 #endif
 
 	// Fault detection routine, must be executed prior application state machine
-	getFcnStatus &= FaultDetection();
+	PROF_BEGIN(profStamp);
+	getFcnStatus &= FaultDetection(axis);
+	PROF_END(PROF_FAULT_DETECTION, profStamp);
 
-	if (getFcnStatus)    cntrState.event = e_fault;
+	if (getFcnStatus)    (void)SM_PostEvent(&axis->smEventQueue, e_fault);
 
-	// Execute State table with newly measured data
-	StateTable[cntrState.event][cntrState.state]();
+	// Execute State table with newly measured data and the posted events
+	PROF_BEGIN(profStamp);
+	SM_Dispatch(axis);
+	PROF_END(PROF_STATE_TABLE, profStamp);
 
 	// Clear pin to measure TOTAL execution time
 	//PTD->PCOR |= 1<<2;
 
-	StateLED[cntrState.state]();
-	FMSTR_Recorder();
+	// Board buttons, LED and recorder run in SWI_IRQHandler after the ISR of the board axis
+	if (axis == &pmsmAxis[PMSM_AXIS_BOARD])
+	{
+		deferMsg.state = axis->cntrState.state;
+		(void)DEFER_Post(&deferMsg);
+	}
+
+	PROF_END(PROF_ISR_TOTAL, profIsrStamp);
+	PROF_CheckReset();
+}
+
+/*******************************************************************************
+*
+* Function: 	AxisTuneLoad(pmsmAxis_t *axis)
+*
+* Description:  Loads the synthesized gains of an axis, the field weakening
+* 				controller takes them from FW_PropGainControl and
+* 				FW_IntegGainControl every speed loop
+*
+*******************************************************************************/
+static void AxisTuneLoad(pmsmAxis_t *axis)
+{
+	TUNE_Load(&axis->drvFOC.motorTune.gains, &axis->drvFOC.CurrentLoop, &axis->drvFOC.pospeSensorless.bEMFObs,
+			  &axis->drvFOC.pospeSensorless.TrackObsrv, &axis->drvFOC.FwSpeedLoop);
+	axis->FW_PropGainControl	= axis->drvFOC.motorTune.gains.speedPropGain;
+	axis->FW_IntegGainControl	= axis->drvFOC.motorTune.gains.speedIntegGain;
+#if CLOOP_DEADBEAT
+	CLOOP_DeadbeatSetModel(&axis->drvFOC.cloopDeadbeat, &axis->drvFOC.motorTune.param, CLOOP_DB_TS);
+#endif
+}
+
+/*******************************************************************************
+*
+* Function: 	SWI_IRQHandler()
+*
+* Description:  Software interrupt service routine, deferred work of ADC1 ISR
+*
+* 				Pended by ADC1 ISR every control loop, runs at the lowest
+* 				priority. One pass per posted control loop keeps the button
+* 				and LED counters and the recorder time base in control loops.
+*
+*******************************************************************************/
+void SWI_IRQHandler()
+{
+	pmsmAxis_t *axis = &pmsmAxis[PMSM_AXIS_BOARD];
+	deferMsg_t deferMsg;
+	tU32 profSwiStamp, profStamp;
+
+	PROF_BEGIN(profSwiStamp);
+
+	while(DEFER_Get(&deferMsg))
+	{
+		// Board buttons to control the application from board
+		axis->cntrState.usrControl.btSpeedUp = ((PINS_DRV_ReadPins(PTC)  >> 12) & 1);
+		axis->cntrState.usrControl.btSpeedDown = ((PINS_DRV_ReadPins(PTC)  >> 13) & 1);
+
+		// Board buttons control logic
+		BoardButtons(axis);
+
+		PROF_BEGIN(profStamp);
+		StateLED[deferMsg.state](axis);
+		PROF_END(PROF_STATE_LED, profStamp);
+
+		PROF_BEGIN(profStamp);
+		FMSTR_Recorder();
+		PROF_END(PROF_RECORDER, profStamp);
+	}
+
+	PROF_END(PROF_DEFERRED, profSwiStamp);
+	PROF_CheckResetDeferred();
 }
 
+#if !PWM_RELOAD_DMA
 /***************************************************************************//*!
 *
 * @brief	FTM3 counter overflow ISR
@@ -371,30 +565,47 @@ void ADC1_IRQHandler()
 *
 * @return	none
 *
-* @details	It update the FTM3 CnV registers - even cycle and odd cycle use different values
-*           And if the FTM_EXT_TRIG is enabled, this ISR will disable it for next 5x25us period;
-*           The FTM_EXT_TRIG will be re-enabled in PDB1_ISR; FTM_EXT_TRIG is enabled every 150uS;
-*
 ******************************************************************************/
 __attribute__((section (".code_ram"))) 		// inserting function to the RAM section
 void FTM3_Ovf_Reload_IRQHandler(void)
 {
-	if(FTM3->EXTTRIG & FTM_EXTTRIG_INITTRIGEN_MASK)
+	AxisPwmReload(&pmsmAxis[PMSM_AXIS_FTM3]);
+}
+
+/***************************************************************************//*!
+*
+* @brief	FTM counter overflow of an axis
+*
+* @param	axis	drive context
+*
+* @return	none
+*
+* @details	It update the FTM CnV registers - even cycle and odd cycle use different values
+*           And if the FTM_EXT_TRIG is enabled, this ISR will disable it for next (FOC_PWM_PERIODS-1)x25us;
+*           The FTM_EXT_TRIG will be re-enabled in PDB ISR; FTM_EXT_TRIG is enabled every control loop;
+*           Not used with PWM_RELOAD_DMA, the eDMA writes the same registers.
+*
+******************************************************************************/
+__attribute__((section (".code_ram"))) 		// inserting function to the RAM section
+static void AxisPwmReload(pmsmAxis_t *axis)
+{
+	if(axis->pwm.ftm->EXTTRIG & FTM_EXTTRIG_INITTRIGEN_MASK)
 	{
-		FTM_RMW_EXTTRIG_REG(FTM3, 0x40, 0x00);	//disable FTM3 INIT trigger output
-		pwmCycleCnt = 1;
+		FTM_RMW_EXTTRIG_REG(axis->pwm.ftm, 0x40, 0x00);	//disable FTM INIT trigger output
+		axis->pwm.pwmCycleCnt = 1;
 	}
 
 	//increment cycle counter, it's used to update FTM registers with odd cycle values or even cycle values;
 	//this increment must be done before calling function ACTUATE_PwmUpdateRegisters() not after calling it;
-	pwmCycleCnt ++;
+	axis->pwm.pwmCycleCnt ++;
 
-	//This function updates FTM PWM edge registers with global variables pwmEdgesFtm
-	ACTUATE_PwmUpdateRegisters();
-	FTM_DRV_ClearStatusFlags(INST_FLEXTIMER_PWM3, FTM_TIME_OVER_FLOW_FLAG);
+	//This function updates FTM PWM edge registers with pwmEdgesFtm
+	ACTUATE_PwmUpdateRegisters(&axis->pwm);
+	FTM_DRV_ClearStatusFlags(axis->pwm.ftmInst, FTM_TIME_OVER_FLOW_FLAG);
 
 	return;
 }
+#endif
 
 /***************************************************************************//*!
 *
@@ -405,7 +616,7 @@ void FTM3_Ovf_Reload_IRQHandler(void)
 * @return  none
 *
 ******************************************************************************/
-void MCAT_Init()
+static void MCAT_Init(pmsmAxis_t *axis)
 {
 	/*------------------------------------
 	 * Freemaster variables
@@ -413,193 +624,246 @@ void MCAT_Init()
 	fmScale.speed_n_m						= FM_SPEED_RPM_MEC_SCALE;
 	fmScale.position						= FM_POSITION_DEG_SCALE;
 
-    drvFOC.alignCntr						= ALIGN_DURATION;
-	drvFOC.alignVoltage						= ALIGN_VOLTAGE;
+    axis->drvFOC.alignCntr						= FOC_RATE_CNT(ALIGN_DURATION);
+	axis->drvFOC.alignVoltage						= ALIGN_VOLTAGE;
+#if FOC_FLYING_START
+	axis->drvFOC.catchCntr						= 0U;			// armed by StateInit()
+#endif
+#if POSPE_IPD
+	axis->drvFOC.pospeIpd.pulseVoltage			= POSPE_IPD_VOLTAGE;
+	axis->drvFOC.pospeIpd.pulseCnt				= FOC_RATE_CNT(POSPE_IPD_PULSE_CNT);
+	axis->drvFOC.pospeIpd.polPulseCnt				= FOC_RATE_CNT(POSPE_IPD_POL_PULSE_CNT);
+	axis->drvFOC.pospeIpd.polRestCnt				= FOC_RATE_CNT(POSPE_IPD_POL_REST_CNT);
+	POSPE_IpdInit(&axis->drvFOC.pospeIpd);
+#endif
+#if MOTOR_IDENT
+	axis->drvFOC.motorIdent.current				= IDENT_CURRENT;
+	axis->drvFOC.motorIdent.pulseVoltage			= IDENT_PULSE_VOLTAGE;
+	axis->drvFOC.motorIdent.spinSpeed				= IDENT_SPIN_SPEED;
+	axis->drvFOC.motorIdent.spinAccel				= IDENT_SPIN_ACCEL;
+	axis->drvFOC.motorIdent.request				= false;
+	axis->drvFOC.motorIdent.adopt					= false;
+	IDENT_Init(&axis->drvFOC.motorIdent);
+#endif
+	TUNE_Init(&axis->drvFOC.motorTune);
+#if MOTOR_MTPA
+	MTPA_Init(&axis->drvFOC.motorMtpa, SPEED_LOOP_HIGH_LIMIT, FOC_CLOOP_LIMIT*MTPA_UDCB_NOM*FLOAT_DIVBY_SQRT3);
+#endif
+#if CLOOP_DEADBEAT
+	axis->drvFOC.cloopDeadbeat.gain				= CLOOP_DB_GAIN;
+	axis->drvFOC.cloopDeadbeat.obsGain				= CLOOP_DB_OBS_GAIN;
+	CLOOP_DeadbeatSetModel(&axis->drvFOC.cloopDeadbeat, &axis->drvFOC.motorTune.param, CLOOP_DB_TS);
+#endif
 
     /*------------------------------------
      * Currents
      * ----------------------------------*/
-    drvFOC.iAbcFbck.fltArg1					= 0.0F;
-    drvFOC.iAbcFbck.fltArg2                	= 0.0F;
-    drvFOC.iAbcFbck.fltArg3                	= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg1					= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg2                	= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg3                	= 0.0F;
 
-    drvFOC.iAlBeFbck.fltArg1               	= 0.0F;
-    drvFOC.iAlBeFbck.fltArg2               	= 0.0F;
+    axis->drvFOC.iAlBeFbck.fltArg1               	= 0.0F;
+    axis->drvFOC.iAlBeFbck.fltArg2               	= 0.0F;
 
-    drvFOC.iDQReqInLoop.fltArg1             = 0.0F;
-    drvFOC.iDQReqInLoop.fltArg2             = 0.0F;
+    axis->drvFOC.iDQReqInLoop.fltArg1             = 0.0F;
+    axis->drvFOC.iDQReqInLoop.fltArg2             = 0.0F;
 
-    drvFOC.iDQReqOutLoop.fltArg1            = 0.0F;
-    drvFOC.iDQReqOutLoop.fltArg2            = 0.0F;
+    axis->drvFOC.iDQReqOutLoop.fltArg1            = 0.0F;
+    axis->drvFOC.iDQReqOutLoop.fltArg2            = 0.0F;
 
-    drvFOC.iDQFbck.fltArg1                 	= 0.0F;
-    drvFOC.iDQFbck.fltArg2                	= 0.0F;
+    axis->drvFOC.iDQFbck.fltArg1                 	= 0.0F;
+    axis->drvFOC.iDQFbck.fltArg2                	= 0.0F;
 
     /*------------------------------------
      * Voltages
      * ----------------------------------*/
-    drvFOC.uAlBeReq.fltArg1                 = 0.0F;
-    drvFOC.uAlBeReq.fltArg2                	= 0.0F;
+    axis->drvFOC.uAlBeReq.fltArg1                 = 0.0F;
+    axis->drvFOC.uAlBeReq.fltArg2                	= 0.0F;
 
-    drvFOC.uAlBeReqDCB.fltArg1             	= 0.0F;
-    drvFOC.uAlBeReqDCB.fltArg2             	= 0.0F;
+    axis->drvFOC.uAlBeReqDCB.fltArg1             	= 0.0F;
+    axis->drvFOC.uAlBeReqDCB.fltArg2             	= 0.0F;
 
-    drvFOC.uDQReq.fltArg1                 	= 0.0F;
-    drvFOC.uDQReq.fltArg2                  	= 0.0F;
+    axis->drvFOC.uDQReq.fltArg1                 	= 0.0F;
+    axis->drvFOC.uDQReq.fltArg2                  	= 0.0F;
 
     /*------------------------------------
      * Speed/Position
      * ----------------------------------*/
-    drvFOC.thTransform.fltArg1             	= 0.0F;
-    drvFOC.thTransform.fltArg2             	= 0.0F;
+    axis->drvFOC.thTransform.fltArg1             	= 0.0F;
+    axis->drvFOC.thTransform.fltArg2             	= 0.0F;
 
     /*------------------------------------
      * SVC-PWM variables
      * ----------------------------------*/
-    drvFOC.svmSector                       	= 1;
+    axis->drvFOC.svmSector                       	= 1;
 
-    drvFOC.pwmflt.fltArg1                   = 0.0F;
-    drvFOC.pwmflt.fltArg2                   = 0.0F;
-    drvFOC.pwmflt.fltArg3                   = 0.0F;
+    axis->drvFOC.pwmflt.fltArg1                   = 0.0F;
+    axis->drvFOC.pwmflt.fltArg2                   = 0.0F;
+    axis->drvFOC.pwmflt.fltArg3                   = 0.0F;
 
 	/*------------------------------------
      * FOC variables
      * ----------------------------------*/
 
     // D-axis PI controller
-    drvFOC.CurrentLoop.pPIrAWD.fltCC1sc             = D_CC1SC;
-    drvFOC.CurrentLoop.pPIrAWD.fltCC2sc             = D_CC2SC;
-    drvFOC.CurrentLoop.pPIrAWD.fltLowerLimit        = MLIB_Neg(CLOOP_LIMIT);
-    drvFOC.CurrentLoop.pPIrAWD.fltUpperLimit        = CLOOP_LIMIT;
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltCC1sc             = FOC_RATE_CC1(D_CC1SC, D_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltCC2sc             = FOC_RATE_CC2(D_CC1SC, D_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltLowerLimit        = MLIB_Neg(FOC_CLOOP_LIMIT);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltUpperLimit        = FOC_CLOOP_LIMIT;
 
     // Q-axis PI controller
-    drvFOC.CurrentLoop.pPIrAWQ.fltCC1sc             = Q_CC1SC;
-    drvFOC.CurrentLoop.pPIrAWQ.fltCC2sc             = Q_CC2SC;
-    drvFOC.CurrentLoop.pPIrAWQ.fltLowerLimit        = MLIB_Neg(CLOOP_LIMIT);
-    drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit        = CLOOP_LIMIT;
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltCC1sc             = FOC_RATE_CC1(Q_CC1SC, Q_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltCC2sc             = FOC_RATE_CC2(Q_CC1SC, Q_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltLowerLimit        = MLIB_Neg(FOC_CLOOP_LIMIT);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit        = FOC_CLOOP_LIMIT;
 
-    drvFOC.CurrentLoop.pIDQReq  					= &drvFOC.iDQReqInLoop;
-    drvFOC.CurrentLoop.pIDQFbck 					= &drvFOC.iDQFbck;
+    axis->drvFOC.CurrentLoop.pIDQReq  					= &axis->drvFOC.iDQReqInLoop;
+    axis->drvFOC.CurrentLoop.pIDQFbck 					= &axis->drvFOC.iDQFbck;
 
     // Clear AMCLIB_CurrentLoop state variables
-	AMCLIB_CurrentLoopInit_FLT(&drvFOC.CurrentLoop);
+	AMCLIB_CurrentLoopInit_FLT(&axis->drvFOC.CurrentLoop);
+#if CLOOP_DEADBEAT
+	CLOOP_DeadbeatInit(&axis->drvFOC.cloopDeadbeat);
+#endif
+
+    // DCBus 1st order filter; lambda 1/8 at the MCAT control loop rate
+    axis->drvFOC.uDcbFilter.fltLambda 					= FOC_RATE_GAIN(0.125F);
+    GDFLIB_FilterMAInit_FLT(&axis->drvFOC.uDcbFilter);
+    axis->drvFOC.uDcbFilter.fltAcc 						= 12.0F;
+
+    // Switching loss reduction 1st order filter; lambda 1/64 at the MCAT control loop rate, updated in the slow loop
+    axis->pwm.switchLossRedFilt.fltLambda 				= 0.015625F * SPEED_LOOP_CNTR;
+    GDFLIB_FilterMAInit_FLT(&axis->pwm.switchLossRedFilt);
 
-    // DCBus 1st order filter; Fcut = 100Hz, Ts = 100e-6
-    drvFOC.uDcbFilter.fltLambda 					= MLIB_Div(1.0F, 8.0F);
-    GDFLIB_FilterMAInit_FLT(&drvFOC.uDcbFilter);
-    drvFOC.uDcbFilter.fltAcc 						= 12.0F;
+    // Dead-time compensation, GD3000 dead time
+    axis->pwm.dtcDeadTimeCnt							= (tU16)(INIT_DEADTIME * ACTUATE_DTC_CNT_PER_NS);
 
-    drvFOC.elimDcbRip.fltModIndex          			= 0.866025403784439F;
-    drvFOC.elimDcbRip.fltArgDcBusMsr       			= 0.0F;
+    axis->drvFOC.elimDcbRip.fltModIndex          			= 0.866025403784439F;
+    axis->drvFOC.elimDcbRip.fltArgDcBusMsr       			= 0.0F;
 
-    OL_SpeedRampInc = OL_START_RAMP_INC;
-    CL_SpeedRampInc = SPEED_RAMP_UP;
-    CL_SpeedRampDec = SPEED_RAMP_DOWN;
+    axis->OL_SpeedRampInc = OL_START_RAMP_INC;
+    axis->CL_SpeedRampInc = SPEED_RAMP_UP;
+    axis->CL_SpeedRampDec = SPEED_RAMP_DOWN;
 
-	drvFOC.FwSpeedLoop.pRamp.fltRampUp				= OL_SpeedRampInc;
-	drvFOC.FwSpeedLoop.pRamp.fltRampDown			= OL_SpeedRampInc;
+	axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp				= axis->OL_SpeedRampInc;
+	axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown			= axis->OL_SpeedRampInc;
 
-	drvFOC.FwSpeedLoop.pPIpAWQ.fltPropGain			= SPEED_PI_PROP_GAIN;
-	drvFOC.FwSpeedLoop.pPIpAWQ.fltIntegGain			= SPEED_PI_INTEG_GAIN;
-	drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit		= SPEED_LOOP_HIGH_LIMIT;
-	drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit		= SPEED_LOOP_LOW_LIMIT;
-	drvFOC.FwSpeedLoop.pFilterW.fltLambda			= POSPE_SPEED_FILTER_MA_LAMBDA;
+	axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltPropGain			= SPEED_PI_PROP_GAIN;
+	axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltIntegGain			= SPEED_PI_INTEG_GAIN;
+	axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit		= SPEED_LOOP_HIGH_LIMIT;
+	axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit		= SPEED_LOOP_LOW_LIMIT;
+	axis->drvFOC.FwSpeedLoop.pFilterW.fltLambda			= POSPE_SPEED_FILTER_MA_LAMBDA;
 
 	/* Field weakening FilterMA */
-	drvFOC.FwSpeedLoop.pFilterFW.fltLambda			= 1.0F;
+	axis->drvFOC.FwSpeedLoop.pFilterFW.fltLambda			= 1.0F;
 	/* Field weakening PI controller */
-	drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= SPEED_PI_PROP_GAIN;
-	drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= SPEED_PI_INTEG_GAIN;
-	FW_PropGainControl								= SPEED_PI_PROP_GAIN;
-	FW_IntegGainControl								= SPEED_PI_INTEG_GAIN;
-	drvFOC.FwSpeedLoop.pPIpAWFW.fltUpperLimit		= 0.0F;
-	drvFOC.FwSpeedLoop.pPIpAWFW.fltLowerLimit		= MLIB_Neg(FLOAT_PI_DIVBY_2);
+	axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= SPEED_PI_PROP_GAIN;
+	axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= SPEED_PI_INTEG_GAIN;
+	axis->FW_PropGainControl								= SPEED_PI_PROP_GAIN;
+	axis->FW_IntegGainControl								= SPEED_PI_INTEG_GAIN;
+	axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltUpperLimit		= 0.0F;
+	axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltLowerLimit		= MLIB_Neg(FLOAT_PI_DIVBY_2);
 	/* Input/output pointers */
-	drvFOC.FwSpeedLoop.pIQFbck						= &(drvFOC.iDQFbck.fltArg2);
-	drvFOC.FwSpeedLoop.pUQLim						= &(drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit);
-	drvFOC.FwSpeedLoop.pUQReq						= &(drvFOC.uDQReq.fltArg2);
+	axis->drvFOC.FwSpeedLoop.pIQFbck						= &(axis->drvFOC.iDQFbck.fltArg2);
+	axis->drvFOC.FwSpeedLoop.pUQLim						= &(axis->drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit);
+	axis->drvFOC.FwSpeedLoop.pUQReq						= &(axis->drvFOC.uDQReq.fltArg2);
 	/* Field weakening PI controller */
-	drvFOC.FwSpeedLoop.fltUmaxDivImax				= MLIB_Div(U_DCB_MAX, I_MAX);
+	axis->drvFOC.FwSpeedLoop.fltUmaxDivImax				= MLIB_Div(U_DCB_MAX, I_MAX);
 
 	// Clear AMCLIB_SpeedLoop state variables
-  	AMCLIB_FWSpeedLoopInit_FLT(&drvFOC.FwSpeedLoop);
+  	AMCLIB_FWSpeedLoopInit_FLT(&axis->drvFOC.FwSpeedLoop);
 
     // Position observer
-    drvFOC.pospeSensorless.wRotEl   	   						= 0.0F;
-    drvFOC.pospeSensorless.thRotEl		   						= 0.0F;
-    drvFOC.pospeSensorless.DQtoGaDeError   						= 0.0F;
+    axis->drvFOC.pospeSensorless.wRotEl   	   						= 0.0F;
+    axis->drvFOC.pospeSensorless.thRotEl		   						= 0.0F;
+    axis->drvFOC.pospeSensorless.DQtoGaDeError   						= 0.0F;
 
     // back-EMF observer parameters - D-axis
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC1sc 			= BEMF_DQ_CC1_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC2sc 			= BEMF_DQ_CC2_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltUpperLimit 		= FLOAT_MAX;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltLowerLimit 		= FLOAT_MIN;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC1sc 			= FOC_RATE_CC1(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC2sc 			= FOC_RATE_CC2(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltUpperLimit 		= FLOAT_MAX;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltLowerLimit 		= FLOAT_MIN;
     // back-EMF observer parameters - Q-axis
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC1sc 			= BEMF_DQ_CC1_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC2sc 			= BEMF_DQ_CC2_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltUpperLimit 		= FLOAT_MAX;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltLowerLimit 		= FLOAT_MIN;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC1sc 			= FOC_RATE_CC1(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC2sc 			= FOC_RATE_CC2(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltUpperLimit 		= FLOAT_MAX;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltLowerLimit 		= FLOAT_MIN;
     // back-EMF observer parameters - Scale constants
-    drvFOC.pospeSensorless.bEMFObs.fltIGain 					= I_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltUGain 					= U_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltEGain 					= E_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltWIGain			 		= WI_Gain;
+    axis->drvFOC.pospeSensorless.bEMFObs.fltIGain 					= FOC_RATE_BEMF_I(I_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltUGain 					= FOC_RATE_BEMF(U_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltEGain 					= FOC_RATE_BEMF(E_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltWIGain			 		= FOC_RATE_BEMF(WI_Gain);
 
     /* Clear back-EMF observer state variables */
-    AMCLIB_BemfObsrvDQInit_FLT(&drvFOC.pospeSensorless.bEMFObs);
+    AMCLIB_BemfObsrvDQInit_FLT(&axis->drvFOC.pospeSensorless.bEMFObs);
 
     // ATO observer - Controller parameters
-    drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltCC1sc 		= TO_CC1SC;
-    drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltCC2sc 		= TO_CC2SC;
-    drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltUpperLimit 	= FLOAT_MAX;
-    drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltLowerLimit 	= FLOAT_MIN;
+    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltCC1sc 		= FOC_RATE_CC1(TO_CC1SC, TO_CC2SC);
+    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltCC2sc 		= FOC_RATE_CC2(TO_CC1SC, TO_CC2SC);
+    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltUpperLimit 	= FLOAT_MAX;
+    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltLowerLimit 	= FLOAT_MIN;
     // ATO observer - Integrator parameters
-    drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltC1 		= TO_THETA_GAIN;
+    axis->drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltC1 		= FOC_RATE_GAIN(TO_THETA_GAIN);
 
     /* Clear ATO observer state variables */
-    AMCLIB_TrackObsrvInit_FLT(&drvFOC.pospeSensorless.TrackObsrv);
+    AMCLIB_TrackObsrvInit_FLT(&axis->drvFOC.pospeSensorless.TrackObsrv);
 
     // Encoder ATO observer - Controller parameters
-    encoderPospe.TrackObsrv.pParamPI.fltCC1sc					= POSPE_ENC_TO_CC1;
-    encoderPospe.TrackObsrv.pParamPI.fltCC2sc					= POSPE_ENC_TO_CC2;
-    encoderPospe.TrackObsrv.pParamPI.fltUpperLimit				= FLOAT_MAX;
-    encoderPospe.TrackObsrv.pParamPI.fltLowerLimit				= FLOAT_MIN;
+    axis->encoderPospe.TrackObsrv.pParamPI.fltCC1sc					= FOC_RATE_CC1(POSPE_ENC_TO_CC1, POSPE_ENC_TO_CC2);
+    axis->encoderPospe.TrackObsrv.pParamPI.fltCC2sc					= FOC_RATE_CC2(POSPE_ENC_TO_CC1, POSPE_ENC_TO_CC2);
+    axis->encoderPospe.TrackObsrv.pParamPI.fltUpperLimit				= FLOAT_MAX;
+    axis->encoderPospe.TrackObsrv.pParamPI.fltLowerLimit				= FLOAT_MIN;
     // Encoder observer - Integrator parameters
-    encoderPospe.TrackObsrv.pParamInteg.fltC1					= POSPE_ENC_TO_INTEG_GAIN;
+    axis->encoderPospe.TrackObsrv.pParamInteg.fltC1					= FOC_RATE_GAIN(POSPE_ENC_TO_INTEG_GAIN);
 
     /* Clear ATO observer state variables */
-    AMCLIB_TrackObsrvInit_FLT(&encoderPospe.TrackObsrv);
+    AMCLIB_TrackObsrvInit_FLT(&axis->encoderPospe.TrackObsrv);
+
+#if POSPE_HFI
+    // Injection ATO observer - Controller and integrator parameters, designed for the control loop period
+    axis->drvFOC.pospeHfi.voltage									= POSPE_HFI_VOLTAGE;
+    axis->drvFOC.pospeHfi.TrackObsrv.pParamPI.fltCC1sc				= POSPE_HFI_TO_CC1;
+    axis->drvFOC.pospeHfi.TrackObsrv.pParamPI.fltCC2sc				= POSPE_HFI_TO_CC2;
+    axis->drvFOC.pospeHfi.TrackObsrv.pParamPI.fltUpperLimit			= FLOAT_MAX;
+    axis->drvFOC.pospeHfi.TrackObsrv.pParamPI.fltLowerLimit			= FLOAT_MIN;
+    axis->drvFOC.pospeHfi.TrackObsrv.pParamInteg.fltC1				= POSPE_HFI_TO_INTEG_GAIN;
+    axis->drvFOC.pospeHfi.SpeedFilter.fltLambda						= POSPE_HFI_SPEED_FILT_LAMBDA;
+    POSPE_HfiInit(&axis->drvFOC.pospeHfi, 0.0F, 0.0F);
+#endif
 
-    drvFOC.pospeSensorless.wRotEl			= 0.0F;
-    drvFOC.pospeSensorless.thRotEl			= 0.0F;
+    axis->drvFOC.pospeSensorless.wRotEl			= 0.0F;
+    axis->drvFOC.pospeSensorless.thRotEl			= 0.0F;
     
-    drvFOC.pospeSensorless.wRotElMatch_1	= MLIB_Div(MLIB_Mul(MERG_SPEED_1_TRH, MLIB_Mul(FLOAT_2_PI, MOTOR_PP)), 60.0F);
-    drvFOC.pospeSensorless.wRotElMatch_2	= MLIB_Div(MLIB_Mul(MERG_SPEED_2_TRH, MLIB_Mul(FLOAT_2_PI, MOTOR_PP)), 60.0F);
+    axis->drvFOC.pospeSensorless.wRotElMatch_1	= MLIB_Div(MLIB_Mul(FOC_MERG_SPEED_1, MLIB_Mul(FLOAT_2_PI, MOTOR_PP)), 60.0F);
+    axis->drvFOC.pospeSensorless.wRotElMatch_2	= MLIB_Div(MLIB_Mul(FOC_MERG_SPEED_2, MLIB_Mul(FLOAT_2_PI, MOTOR_PP)), 60.0F);
 
-    drvFOC.pospeSensorless.iQUpperLimit		= SPEED_LOOP_HIGH_LIMIT;
-    drvFOC.pospeSensorless.iQLowerLimit		= SPEED_LOOP_LOW_LIMIT;
+    axis->drvFOC.pospeSensorless.iQUpperLimit		= SPEED_LOOP_HIGH_LIMIT;
+    axis->drvFOC.pospeSensorless.iQLowerLimit		= SPEED_LOOP_LOW_LIMIT;
 
-    drvFOC.pospeOpenLoop.integ.f32InK1 		= 0;
-    drvFOC.pospeOpenLoop.integ.f32State 	= 0;
-    drvFOC.pospeOpenLoop.integ.f32C1 		= SCALAR_INTEG_GAIN;
-    drvFOC.pospeOpenLoop.integ.u16NShift	= SCALAR_INTEG_SHIFT;
+    axis->drvFOC.pospeOpenLoop.integ.f32InK1 		= 0;
+    axis->drvFOC.pospeOpenLoop.integ.f32State 	= 0;
+    axis->drvFOC.pospeOpenLoop.integ.f32C1 		= FOC_RATE_FRAC32(SCALAR_INTEG_GAIN);
+    axis->drvFOC.pospeOpenLoop.integ.u16NShift	= SCALAR_INTEG_SHIFT;
 
-    drvFOC.pospeOpenLoop.thRotEl			= 0.0F;
-    drvFOC.pospeOpenLoop.wRotEl				= 0.0F;
+    axis->drvFOC.pospeOpenLoop.thRotEl			= 0.0F;
+    axis->drvFOC.pospeOpenLoop.wRotEl				= 0.0F;
+#if FOC_ANGLE_MERGE
+    axis->drvFOC.pospeOpenLoop.thDifMerge			= 0.0F;
+#endif
 
-    drvFOC.pospeOpenLoop.iQUpperLimit		= OL_START_I;
-    drvFOC.pospeOpenLoop.iQLowerLimit		= MLIB_Neg(drvFOC.pospeOpenLoop.iQUpperLimit);
+    axis->drvFOC.pospeOpenLoop.iQUpperLimit		= OL_START_I;
+    axis->drvFOC.pospeOpenLoop.iQLowerLimit		= MLIB_Neg(axis->drvFOC.pospeOpenLoop.iQUpperLimit);
 
     // Default state set according to the selected sensor
-    if(switchSensor==encoder)
+    if(axis->switchSensor==encoder)
     {
-        cntrState.usrControl.controlMode		= automatic;
-        pos_mode								= encoder1;
+        axis->cntrState.usrControl.controlMode		= automatic;
+        axis->pos_mode								= encoder1;
     }
     else
     {
-        cntrState.usrControl.controlMode		= automatic;
-        pos_mode								= force;
+        axis->cntrState.usrControl.controlMode		= automatic;
+        axis->pos_mode								= force;
     }
 
 }
@@ -613,51 +877,59 @@ void MCAT_Init()
 * @return  none
 *
 ******************************************************************************/
-void StateFault()
+void StateFault(pmsmAxis_t *axis)
 {
+#if !MEAS_ADC_DMA
 	uint16_t adc_r;
+#endif
     /*-----------------------------------------------------
     Application State Machine - state identification
     ----------------------------------------------------- */
     // Entering state fault
-	cntrState.state   = fault;
-	cntrState.event   = e_fault;
+	axis->cntrState.state   = fault;
+	axis->cntrState.event   = e_fault;
 
 	// Turn off PWM
-	statePWM = ACTUATE_DisableOutput();
+	axis->statePWM = ACTUATE_DisableOutput(&axis->pwm);
 
 	// Indicate State Machine fault state invoked by irrelevant event call
-	if((permFaults.mcu.R == 0)&&(permFaults.motor.R == 0)&&(permFaults.stateMachine.R == 0)&&(permFaults.gd3000 == 0))
-		permFaults.stateMachine.B.FOCError = 1;
+	if((axis->permFaults.mcu.R == 0)&&(axis->permFaults.motor.R == 0)&&(axis->permFaults.stateMachine.R == 0)&&(axis->permFaults.gd3000 == 0))
+		axis->permFaults.stateMachine.B.FOCError = 1;
 
     // Disable user application switch
-    cntrState.usrControl.switchAppOnOff      = false;
-    cntrState.usrControl.switchAppOnOffState = false;
+    axis->cntrState.usrControl.switchAppOnOff      = false;
+    axis->cntrState.usrControl.switchAppOnOffState = false;
 
-    if (cntrState.usrControl.switchFaultClear)
+    if (axis->cntrState.usrControl.switchFaultClear)
     {
 		// Clear permanent and temporary SW faults
-		permFaults.mcu.R          		= 0;    		// Clear mcu faults
-		permFaults.motor.R		  		= 0;	  		// Clear motor faults
-		permFaults.stateMachine.R 		= 0;	  		// Clear state machine faults
-		gd3000Status.B.gd3000ClearErr	= true;			// Clear GD3000 faults
-		pdbStatus.PDB0_SeqErrFlags 		= 0;			// Clear PDB0 sequence error flags
-		pdbStatus.PDB1_SeqErrFlags 		= 0;			// Clear PDB1 sequence error flags
+		axis->permFaults.mcu.R          		= 0;    		// Clear mcu faults
+		axis->permFaults.motor.R		  		= 0;	  		// Clear motor faults
+		axis->permFaults.stateMachine.R 		= 0;	  		// Clear state machine faults
+		if (axis->gd3000 != NULL)
+			gd3000Status.B.gd3000ClearErr	= true;		// Clear GD3000 faults
+#if FAST_TRIP
+		ACTUATE_FastTripClear(&axis->pwm);					// Clear FTM fault flags
+#endif
+		axis->pdbStatus.PDB0_SeqErrFlags 		= 0;			// Clear PDB0 sequence error flags
+		axis->pdbStatus.PDB1_SeqErrFlags 		= 0;			// Clear PDB1 sequence error flags
 
 		// When all Faults cleared prepare for transition to next state.
-		cntrState.usrControl.readFault             = true;
-		cntrState.usrControl.switchFaultClear      = false;
-		cntrState.event                            = e_fault_clear;
+		axis->cntrState.usrControl.readFault             = true;
+		axis->cntrState.usrControl.switchFaultClear      = false;
+		axis->cntrState.event                            = e_fault_clear;
 
+#if !MEAS_ADC_DMA
 		// Read ADCs Results registers to unlock PDB pre-triggers lock states
-		ADC_DRV_GetChanResult(INST_ADCONV1, 0, &adc_r);
-		ADC_DRV_GetChanResult(INST_ADCONV1, 1, &adc_r);
-		ADC_DRV_GetChanResult(INST_ADCONV1, 2, &adc_r);
-		ADC_DRV_GetChanResult(INST_ADCONV1, 3, &adc_r);
-		ADC_DRV_GetChanResult(INST_ADCONV1, 4, &adc_r);
+		ADC_DRV_GetChanResult(axis->adcInst, 0, &adc_r);
+		ADC_DRV_GetChanResult(axis->adcInst, 1, &adc_r);
+		ADC_DRV_GetChanResult(axis->adcInst, 2, &adc_r);
+		ADC_DRV_GetChanResult(axis->adcInst, 3, &adc_r);
+		ADC_DRV_GetChanResult(axis->adcInst, 4, &adc_r);
+#endif
 
 		// Enable FTM INIT trigger after clearing faults and errors
-		FTM_RMW_EXTTRIG_REG(FTM3, 0x00, 0x40);
+		FTM_RMW_EXTTRIG_REG(axis->pwm.ftm, 0x00, 0x40);
     }
 }
 /***************************************************************************//*!
@@ -669,17 +941,29 @@ void StateFault()
 * @return  none
 *
 ******************************************************************************/
-void StateInit()
+void StateInit(pmsmAxis_t *axis)
 {
     /*-----------------------------------------------------
     Application State Machine - state identification
     ----------------------------------------------------- */
     tBool InitFcnStatus;
-    cntrState.state                             	= init;
-    cntrState.event								 	= e_init;
+
+#if FOC_FLYING_START
+    // Armed on the entry by a stop of the run state above the observer merging speed or by a fault clear, a start from standstill aligns at once
+    if (axis->cntrState.state != init)
+    {
+    	axis->drvFOC.catchCntr = ((axis->cntrState.state == fault)
+    							  || ((axis->cntrState.state == run)
+    								  && (MLIB_Abs(axis->drvFOC.pospeSensorless.wRotEl) > axis->drvFOC.pospeSensorless.wRotElMatch_1)))
+    							 ? FOC_RATE_CNT(FOC_CATCH_DURATION) : 0U;
+    }
+#endif
+
+    axis->cntrState.state                             	= init;
+    axis->cntrState.event								 	= e_init;
 
     // Turn off PWM output
-    statePWM = ACTUATE_DisableOutput();
+    axis->statePWM = ACTUATE_DisableOutput(&axis->pwm);
 
     /*------------------------------------
      * General use variables
@@ -690,170 +974,191 @@ void StateInit()
      * Application state machine variables
      * ----------------------------------*/
     // Reset state of all user control variables
-    cntrState.usrControl.switchAppOnOff           	= false;
-    cntrState.usrControl.switchAppOnOffState      	= false;
-    cntrState.usrControl.switchFaultClear          	= false;
-    cntrState.usrControl.switchAppReset            	= false;
+    axis->cntrState.usrControl.switchAppOnOff           	= false;
+    axis->cntrState.usrControl.switchAppOnOffState      	= false;
+    axis->cntrState.usrControl.switchFaultClear          	= false;
+    axis->cntrState.usrControl.switchAppReset            	= false;
 
-    cntrState.usrControl.ledCounter					= 0;
-    cntrState.usrControl.ledFlashing				= 1250;
+    axis->cntrState.usrControl.ledCounter					= 0;
+    axis->cntrState.usrControl.ledFlashing				= FOC_RATE_CNT(1250);
 
 
-    drvFOC.pospeControl.speedLoopCntr               = 0;
+    axis->drvFOC.pospeControl.speedLoopCntr               = 0;
 
-    drvFOC.alignCntr								= ALIGN_DURATION;
-
-    InitFcnStatus = MEAS_Clear(&meas);
+    axis->drvFOC.alignCntr								= FOC_RATE_CNT(ALIGN_DURATION);
+#if POSPE_IPD
+    POSPE_IpdInit(&axis->drvFOC.pospeIpd);
+#endif
+#if FOC_FLYING_START
+    // A restart keeps the offsets, the calibration would leave a coasting motor 2.5s to slow down
+    InitFcnStatus = true;
+    if (!axis->meas.flag.B.calibDone)
+#endif
+    {
+    	InitFcnStatus = MEAS_Clear(&axis->meas);
 
-    meas.param.u16CalibSamples                     	= 10.0F;    // number of samples = 2^u16CalibSamples
-    meas.offset.fltPhA.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(meas.param.u16CalibSamples));
-	meas.offset.fltPhB.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(meas.param.u16CalibSamples));
-	meas.offset.fltPhC.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(meas.param.u16CalibSamples));
-	meas.offset.fltIdcb.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(meas.param.u16CalibSamples));
+    	axis->meas.param.u16CalibSamples                     	= 10.0F;    // number of samples = 2^u16CalibSamples
+    	axis->meas.offset.fltPhA.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(axis->meas.param.u16CalibSamples));
+    	axis->meas.offset.fltPhB.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(axis->meas.param.u16CalibSamples));
+    	axis->meas.offset.fltPhC.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(axis->meas.param.u16CalibSamples));
+    	axis->meas.offset.fltIdcb.filtParam.fltLambda		   	= MLIB_Div(1.0F,(tFloat)(axis->meas.param.u16CalibSamples));
+    }
 
     /*------------------------------------
      * Currents
      * ----------------------------------*/
-    drvFOC.iAbcFbck.fltArg1               	= 0.0F;
-    drvFOC.iAbcFbck.fltArg2               	= 0.0F;
-    drvFOC.iAbcFbck.fltArg3                	= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg1               	= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg2               	= 0.0F;
+    axis->drvFOC.iAbcFbck.fltArg3                	= 0.0F;
 
-    drvFOC.iAlBeFbck.fltArg1              	= 0.0F;
-    drvFOC.iAlBeFbck.fltArg2               	= 0.0F;
+    axis->drvFOC.iAlBeFbck.fltArg1              	= 0.0F;
+    axis->drvFOC.iAlBeFbck.fltArg2               	= 0.0F;
     
-    drvFOC.iDQReqInLoop.fltArg1             = 0.0F;
-    drvFOC.iDQReqInLoop.fltArg2             = 0.0F;
+    axis->drvFOC.iDQReqInLoop.fltArg1             = 0.0F;
+    axis->drvFOC.iDQReqInLoop.fltArg2             = 0.0F;
 
-    drvFOC.iDQReqOutLoop.fltArg1            = 0.0F;
-    drvFOC.iDQReqOutLoop.fltArg2            = 0.0F;
+    axis->drvFOC.iDQReqOutLoop.fltArg1            = 0.0F;
+    axis->drvFOC.iDQReqOutLoop.fltArg2            = 0.0F;
     
 
-    drvFOC.iDQFbck.fltArg1                  = 0.0F;
-    drvFOC.iDQFbck.fltArg2                  = 0.0F;
+    axis->drvFOC.iDQFbck.fltArg1                  = 0.0F;
+    axis->drvFOC.iDQFbck.fltArg2                  = 0.0F;
 
     /*------------------------------------
      * Voltages
      * ----------------------------------*/
-    drvFOC.uAlBeReq.fltArg1                	= 0.0F;
-    drvFOC.uAlBeReq.fltArg2                	= 0.0F;
+    axis->drvFOC.uAlBeReq.fltArg1                	= 0.0F;
+    axis->drvFOC.uAlBeReq.fltArg2                	= 0.0F;
 
-    drvFOC.uAlBeReqDCB.fltArg1             	= 0.0F;
-    drvFOC.uAlBeReqDCB.fltArg2             	= 0.0F;
+    axis->drvFOC.uAlBeReqDCB.fltArg1             	= 0.0F;
+    axis->drvFOC.uAlBeReqDCB.fltArg2             	= 0.0F;
 
-    drvFOC.uDQReq.fltArg1                  	= 0.0F;
-    drvFOC.uDQReq.fltArg2                  	= 0.0F;
+    axis->drvFOC.uDQReq.fltArg1                  	= 0.0F;
+    axis->drvFOC.uDQReq.fltArg2                  	= 0.0F;
 
     /*------------------------------------
      * Speed/Position
      * ----------------------------------*/
-    drvFOC.thTransform.fltArg1             	= 0.0F;
-    drvFOC.thTransform.fltArg2             	= 0.0F;
+    axis->drvFOC.thTransform.fltArg1             	= 0.0F;
+    axis->drvFOC.thTransform.fltArg2             	= 0.0F;
 
     /*------------------------------------
      * SVC-PWM variables
      * ----------------------------------*/
-    drvFOC.svmSector                       	= 1;
+    axis->drvFOC.svmSector                       	= 1;
 
-    drvFOC.pwmflt.fltArg1                 	= 0.0F;
-    drvFOC.pwmflt.fltArg2                 	= 0.0F;
-    drvFOC.pwmflt.fltArg3                 	= 0.0F;
+    axis->drvFOC.pwmflt.fltArg1                 	= 0.0F;
+    axis->drvFOC.pwmflt.fltArg2                 	= 0.0F;
+    axis->drvFOC.pwmflt.fltArg3                 	= 0.0F;
 
     /*------------------------------------
      * FOC variables re-init
      * ----------------------------------*/
 
     // D-axis PI controller
-    drvFOC.CurrentLoop.pPIrAWD.fltCC1sc             = D_CC1SC;
-    drvFOC.CurrentLoop.pPIrAWD.fltCC2sc             = D_CC2SC;
-    drvFOC.CurrentLoop.pPIrAWD.fltLowerLimit        = MLIB_Neg(CLOOP_LIMIT);
-    drvFOC.CurrentLoop.pPIrAWD.fltUpperLimit        = CLOOP_LIMIT;
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltCC1sc             = FOC_RATE_CC1(D_CC1SC, D_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltCC2sc             = FOC_RATE_CC2(D_CC1SC, D_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltLowerLimit        = MLIB_Neg(FOC_CLOOP_LIMIT);
+    axis->drvFOC.CurrentLoop.pPIrAWD.fltUpperLimit        = FOC_CLOOP_LIMIT;
 
     // Q-axis PI controller
-    drvFOC.CurrentLoop.pPIrAWQ.fltCC1sc             = Q_CC1SC;
-    drvFOC.CurrentLoop.pPIrAWQ.fltCC2sc             = Q_CC2SC;
-    drvFOC.CurrentLoop.pPIrAWQ.fltLowerLimit        = MLIB_Neg(CLOOP_LIMIT);
-    drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit        = CLOOP_LIMIT;
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltCC1sc             = FOC_RATE_CC1(Q_CC1SC, Q_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltCC2sc             = FOC_RATE_CC2(Q_CC1SC, Q_CC2SC);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltLowerLimit        = MLIB_Neg(FOC_CLOOP_LIMIT);
+    axis->drvFOC.CurrentLoop.pPIrAWQ.fltUpperLimit        = FOC_CLOOP_LIMIT;
 
-    drvFOC.CurrentLoop.pIDQReq  					= &drvFOC.iDQReqInLoop;
-    drvFOC.CurrentLoop.pIDQFbck 					= &drvFOC.iDQFbck;
+    axis->drvFOC.CurrentLoop.pIDQReq  					= &axis->drvFOC.iDQReqInLoop;
+    axis->drvFOC.CurrentLoop.pIDQFbck 					= &axis->drvFOC.iDQFbck;
 
     // Clear AMCLIB_CurrentLoop state variables
-	AMCLIB_CurrentLoopInit_FLT(&drvFOC.CurrentLoop);
+	AMCLIB_CurrentLoopInit_FLT(&axis->drvFOC.CurrentLoop);
+#if CLOOP_DEADBEAT
+	CLOOP_DeadbeatInit(&axis->drvFOC.cloopDeadbeat);
+#endif
 
-    // DCBus 1st order filter; Fcut = 100Hz, Ts = 100e-6
-    drvFOC.uDcbFilter.fltLambda                     = MLIB_Div(1.0F, 8.0F);
-    GDFLIB_FilterMAInit_FLT(&drvFOC.uDcbFilter);
-    drvFOC.uDcbFilter.fltAcc                        = 12.0F;
+    // DCBus 1st order filter; lambda 1/8 at the MCAT control loop rate
+    axis->drvFOC.uDcbFilter.fltLambda                     = FOC_RATE_GAIN(0.125F);
+    GDFLIB_FilterMAInit_FLT(&axis->drvFOC.uDcbFilter);
+    axis->drvFOC.uDcbFilter.fltAcc                        = 12.0F;
 
-    drvFOC.elimDcbRip.fltModIndex          			= 0.866025403784439F;
-    drvFOC.elimDcbRip.fltArgDcBusMsr       			= 0.0F;
+    axis->drvFOC.elimDcbRip.fltModIndex          			= 0.866025403784439F;
+    axis->drvFOC.elimDcbRip.fltArgDcBusMsr       			= 0.0F;
 
-    drvFOC.FwSpeedLoop.pRamp.fltRampUp	   			= OL_SpeedRampInc;
-    drvFOC.FwSpeedLoop.pRamp.fltRampDown	   		= OL_SpeedRampInc;
-    drvFOC.FwSpeedLoop.pFilterW.fltLambda	   		= POSPE_SPEED_FILTER_MA_LAMBDA;
-    fieldWeakOnOff = true;
+    axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp	   			= axis->OL_SpeedRampInc;
+    axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown	   		= axis->OL_SpeedRampInc;
+    axis->drvFOC.FwSpeedLoop.pFilterW.fltLambda	   		= POSPE_SPEED_FILTER_MA_LAMBDA;
+    axis->fieldWeakOnOff = true;
 
-    AMCLIB_FWSpeedLoopInit_FLT(&drvFOC.FwSpeedLoop);
+    AMCLIB_FWSpeedLoopInit_FLT(&axis->drvFOC.FwSpeedLoop);
 
-    drvFOC.pospeControl.wRotEl			   			= 0.0F;
+    axis->drvFOC.pospeControl.wRotEl			   			= 0.0F;
 
     // Position observer
-    drvFOC.pospeSensorless.wRotEl   	   			= 0.0F;
-    drvFOC.pospeSensorless.thRotEl		  			= 0.0F;
-    drvFOC.pospeSensorless.DQtoGaDeError   			= 0.0F;
+    axis->drvFOC.pospeSensorless.wRotEl   	   			= 0.0F;
+    axis->drvFOC.pospeSensorless.thRotEl		  			= 0.0F;
+    axis->drvFOC.pospeSensorless.DQtoGaDeError   			= 0.0F;
 
     // back-EMF observer parameters - D-axis
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC1sc 		= BEMF_DQ_CC1_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC2sc 		= BEMF_DQ_CC2_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltUpperLimit 	= FLOAT_MAX;
-    drvFOC.pospeSensorless.bEMFObs.pParamD.fltLowerLimit 	= FLOAT_MIN;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC1sc 		= FOC_RATE_CC1(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltCC2sc 		= FOC_RATE_CC2(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltUpperLimit 	= FLOAT_MAX;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamD.fltLowerLimit 	= FLOAT_MIN;
     // back-EMF observer parameters - Q-axis
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC1sc 		= BEMF_DQ_CC1_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC2sc 		= BEMF_DQ_CC2_GAIN;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltUpperLimit 	= FLOAT_MAX;
-    drvFOC.pospeSensorless.bEMFObs.pParamQ.fltLowerLimit 	= FLOAT_MIN;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC1sc 		= FOC_RATE_CC1(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltCC2sc 		= FOC_RATE_CC2(BEMF_DQ_CC1_GAIN, BEMF_DQ_CC2_GAIN);
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltUpperLimit 	= FLOAT_MAX;
+    axis->drvFOC.pospeSensorless.bEMFObs.pParamQ.fltLowerLimit 	= FLOAT_MIN;
     // back-EMF observer parameters - Scale constants
-    drvFOC.pospeSensorless.bEMFObs.fltIGain 				= I_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltUGain 				= U_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltEGain 				= E_Gain;
-    drvFOC.pospeSensorless.bEMFObs.fltWIGain 				= WI_Gain;
+    axis->drvFOC.pospeSensorless.bEMFObs.fltIGain 				= FOC_RATE_BEMF_I(I_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltUGain 				= FOC_RATE_BEMF(U_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltEGain 				= FOC_RATE_BEMF(E_Gain);
+    axis->drvFOC.pospeSensorless.bEMFObs.fltWIGain 				= FOC_RATE_BEMF(WI_Gain);
 
     /* Clear back-EMF observer state variables */
-    AMCLIB_BemfObsrvDQInit_FLT(&drvFOC.pospeSensorless.bEMFObs);
+    AMCLIB_BemfObsrvDQInit_FLT(&axis->drvFOC.pospeSensorless.bEMFObs);
+
+    // Synthesized gains replace the PMSM_appconfig.h ones once loaded
+    if (axis->drvFOC.motorTune.loaded)
+    {
+    	AxisTuneLoad(axis);
+    }
 
     /* Clear ATO observer state variables */
-    AMCLIB_TrackObsrvInit_FLT(&drvFOC.pospeSensorless.TrackObsrv);
+    AMCLIB_TrackObsrvInit_FLT(&axis->drvFOC.pospeSensorless.TrackObsrv);
 
     /* Clear ATO observer state variables */
-    AMCLIB_TrackObsrvInit_FLT(&encoderPospe.TrackObsrv);
+    AMCLIB_TrackObsrvInit_FLT(&axis->encoderPospe.TrackObsrv);
 
-    drvFOC.pospeSensorless.wRotEl			= 0.0F;
-    drvFOC.pospeSensorless.thRotEl			= 0.0F;
+    axis->drvFOC.pospeSensorless.wRotEl			= 0.0F;
+    axis->drvFOC.pospeSensorless.thRotEl			= 0.0F;
 
-    drvFOC.pospeOpenLoop.integ.f32InK1 		= 0.0F;
-    drvFOC.pospeOpenLoop.integ.f32State 	= 0.0F;
+    axis->drvFOC.pospeOpenLoop.integ.f32InK1 		= 0.0F;
+    axis->drvFOC.pospeOpenLoop.integ.f32State 	= 0.0F;
 
-    drvFOC.pospeOpenLoop.thRotEl			= 0.0F;
-    drvFOC.pospeOpenLoop.wRotEl				= 0.0F;
+    axis->drvFOC.pospeOpenLoop.thRotEl			= 0.0F;
+    axis->drvFOC.pospeOpenLoop.wRotEl				= 0.0F;
+#if FOC_ANGLE_MERGE
+    axis->drvFOC.pospeOpenLoop.thDifMerge			= 0.0F;
+#endif
 
-    drvFOC.pospeOpenLoop.iQLowerLimit		= MLIB_Neg(drvFOC.pospeOpenLoop.iQUpperLimit);
+    axis->drvFOC.pospeOpenLoop.iQLowerLimit		= MLIB_Neg(axis->drvFOC.pospeOpenLoop.iQUpperLimit);
 
     // Default mode of operation
-    cntrState.usrControl.controlMode		= automatic;
-    pos_mode								= force;
+    axis->cntrState.usrControl.controlMode		= automatic;
+    axis->pos_mode								= force;
 
-    switchSensor							= sensorless;
+    axis->switchSensor							= sensorless;
 
     if (!InitFcnStatus)
     {
     	// Fault in initialization state
-        tempfaults.stateMachine.B.InitError = 1;		    // Mark the initialization fault
-        cntrState.event                     = e_fault;	    // prepare for transition to fault state.
+        axis->tempfaults.stateMachine.B.InitError = 1;		    // Mark the initialization fault
+        axis->cntrState.event                     = e_fault;	    // prepare for transition to fault state.
     }
     else
     {
     	// Initialization phase successfully done
-    	cntrState.event                     = e_init_done;  // prepare for transition to next state.
+    	axis->cntrState.event                     = e_init_done;  // prepare for transition to next state.
     }
 }
 
@@ -866,23 +1171,35 @@ void StateInit()
 * @return  none
 *
 ******************************************************************************/
-void StateReady()
+void StateReady(pmsmAxis_t *axis)
 {
     /*-----------------------------------------------------
     Application State Machine - state identification
     ----------------------------------------------------- */
 
 	// Turn off PWM output
-	statePWM = ACTUATE_DisableOutput();
+	axis->statePWM = ACTUATE_DisableOutput(&axis->pwm);
 
-	if(cntrState.loadDefSetting)
+	if(axis->cntrState.loadDefSetting)
 	{
-		cntrState.loadDefSetting = false;
-		MCAT_Init();
+		axis->cntrState.loadDefSetting = false;
+		MCAT_Init(axis);
 	}
+#if MOTOR_IDENT
+	if(axis->drvFOC.motorIdent.adopt)
+	{
+		// Gains synthesized from the identified or entered motor parameters
+		axis->drvFOC.motorIdent.adopt = false;
+		axis->drvFOC.motorTune.param	= axis->drvFOC.motorIdent.param;
+		axis->drvFOC.motorTune.request	= true;
+#if MOTOR_MTPA
+		axis->drvFOC.motorMtpa.request	= true;
+#endif
+	}
+#endif
 
-	cntrState.state   = ready;
-    cntrState.event   = e_ready;
+	axis->cntrState.state   = ready;
+    axis->cntrState.event   = e_ready;
 
 }
 
@@ -895,37 +1212,101 @@ void StateReady()
 * @return  none
 *
 ******************************************************************************/
-void StateCalib()
+void StateCalib(pmsmAxis_t *axis)
 {
     /*-----------------------------------------------------
       Application State Machine - state identification
     ----------------------------------------------------- */
     tBool           CalibStatus;
 
-    cntrState.state    = calib;
-    cntrState.event    = e_calib;
+    axis->cntrState.state    = calib;
+    axis->cntrState.event    = e_calib;
     CalibStatus        = false;
 
     // Turn on actuator output
-    statePWM = ACTUATE_EnableOutput();
+    axis->statePWM = ACTUATE_EnableOutput(&axis->pwm);
 
-    CalibStatus = MEAS_CalibCurrentSense(&meas);
+    CalibStatus = MEAS_CalibCurrentSense(&axis->meas);
 
     // Apply 0.5 duty cycle
-    drvFOC.pwmflt.fltArg1 = 0.5F;
-    drvFOC.pwmflt.fltArg2 = 0.5F;
-    drvFOC.pwmflt.fltArg3 = 0.5F;
+    axis->drvFOC.pwmflt.fltArg1 = 0.5F;
+    axis->drvFOC.pwmflt.fltArg2 = 0.5F;
+    axis->drvFOC.pwmflt.fltArg3 = 0.5F;
 
-    statePWM = ACTUATE_SetDutycycle(&drvFOC.pwmflt, 2);
+    axis->statePWM = ACTUATE_SetDutycycle(&axis->pwm, &axis->drvFOC.pwmflt, 2);
 
     // Exit the calibration state when DC calibration is done for all sectors
     if (CalibStatus)
     {
     	// Calibration sequence has successfully finished
-		cntrState.event               = e_calib_done;
+		axis->cntrState.event               = e_calib_done;
+#if MOTOR_IDENT
+		if (axis->drvFOC.motorIdent.request)
+		{
+			// The identification runs once per request, before the alignment
+			axis->drvFOC.motorIdent.request	= false;
+			IDENT_Init(&axis->drvFOC.motorIdent);
+			axis->cntrState.event			= e_ident;
+		}
+#endif
+#if FAST_TRIP
+		// Fast-trip threshold relative to the calibrated DC-bus current offset
+		if (axis->pwm.ftm == FTM3)
+			ACTUATE_FastTripThreshold(axis->meas.offset.fltIdcb.fltOffset);
+#endif
     }
 }
 
+/***************************************************************************//*!
+*
+* @brief   IDENTIFICATION state - motor parameter identification
+*
+* @param
+*
+* @return  none
+*
+******************************************************************************/
+void StateIdent(pmsmAxis_t *axis)
+{
+    /*-----------------------------------------------------
+    Application State Machine - state identification
+    ----------------------------------------------------- */
+    axis->cntrState.state   = ident;
+    axis->cntrState.event   = e_ident;
+
+#if MOTOR_IDENT
+    GMCLIB_Clark_FLT(&axis->drvFOC.iAlBeFbck,&axis->drvFOC.iAbcFbck);
+
+    // The alignment follows, also after a failed identification, status tells
+    if (IDENT_Update(&axis->drvFOC.motorIdent, &axis->drvFOC.uAlBeReq, &axis->drvFOC.iAlBeFbck,
+    				 axis->drvFOC.fltUdcb) != identBusy)
+    {
+    	axis->cntrState.event = e_ident_done;
+#if FOC_FLYING_START
+    	// The spin ends at standstill, the observers hold its state and would catch a phantom rotor
+    	axis->drvFOC.catchCntr = 0U;
+#endif
+    }
+#else
+    axis->drvFOC.uAlBeReq.fltArg1 = 0.0F;
+    axis->drvFOC.uAlBeReq.fltArg2 = 0.0F;
+    axis->cntrState.event   = e_ident_done;
+#endif
+
+    axis->drvFOC.elimDcbRip.fltArgDcBusMsr  = axis->meas.measured.fltUdcb.raw;
+#if ACTUATE_DEADTIME_COMP
+    // The edges of a phase change with the DC level in the reduced shift, the compensation keeps the error of both levels equal
+    ACTUATE_DeadTimeComp(&axis->pwm, &axis->drvFOC.uAlBeReqDTC, &axis->drvFOC.uAlBeReq, &axis->drvFOC.iAlBeFbck, axis->meas.measured.fltUdcb.raw);
+    GMCLIB_ElimDcBusRip_FLT(&axis->drvFOC.uAlBeReqDCB,&axis->drvFOC.uAlBeReqDTC,&axis->drvFOC.elimDcbRip);
+#else
+    GMCLIB_ElimDcBusRip_FLT(&axis->drvFOC.uAlBeReqDCB,&axis->drvFOC.uAlBeReq,&axis->drvFOC.elimDcbRip);
+#endif
+
+    axis->drvFOC.svmSector   = GMCLIB_SvmStd_FLT(&(axis->drvFOC.pwmflt),&axis->drvFOC.uAlBeReqDCB);
+
+    axis->statePWM = ACTUATE_SetDutycycle(&axis->pwm, &axis->drvFOC.pwmflt, axis->drvFOC.svmSector);
+}
+
 /***************************************************************************//*!
 *
 * @brief   ALIGNMENT state - motor control d-axes alignment
@@ -935,48 +1316,96 @@ void StateCalib()
 * @return  none
 *
 ******************************************************************************/
-void StateAlign( )
+void StateAlign(pmsmAxis_t *axis)
 {
     /*-----------------------------------------------------
     Application State Machine - state identification
     ----------------------------------------------------- */
     tBool           AlignStatus;
+    tBool           AlignDone;
 
-    cntrState.state   = align;
-    cntrState.event   = e_align;
+    axis->cntrState.state   = align;
+    axis->cntrState.event   = e_align;
 
     // Align sequence is at the beginning
     AlignStatus     = true;
 
-    drvFOC.uDQReq.fltArg1      = drvFOC.alignVoltage;
-    drvFOC.uDQReq.fltArg2      = 0.0F;
+#if FOC_FLYING_START
+    // A coasting rotor is caught before the alignment
+    if ((axis->drvFOC.catchCntr > 0U) && (axis->cntrState.usrControl.FOCcontrolMode == speedControl)
+    	&& (axis->cntrState.usrControl.controlMode == automatic) && (axis->switchSensor == sensorless))
+    {
+    	if (FocCatch(axis))
+    	{
+    		axis->cntrState.event = e_align_done;
+    	}
+
+    	axis->statePWM = ACTUATE_SetDutycycle(&axis->pwm, &axis->drvFOC.pwmflt, axis->drvFOC.svmSector);
+    	return;
+    }
+#endif
+
+#if POSPE_IPD
+    // Initial position detection, the alignment takes over when it fails
+    if (axis->drvFOC.pospeIpd.status != ipdFailed)
+    {
+    	GMCLIB_Clark_FLT(&axis->drvFOC.iAlBeFbck,&axis->drvFOC.iAbcFbck);
+
+    	AlignDone = (POSPE_IpdUpdate(&axis->drvFOC.pospeIpd, &axis->drvFOC.uAlBeReq, &axis->drvFOC.iAlBeFbck) == ipdDone);
 
-	GFLIB_SinCos_FLT(0.0F, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+    	if (AlignDone)
+    	{
+    		// Open loop and tracking observer start from the detected position
+    		axis->drvFOC.pospeOpenLoop.thRotEl							= axis->drvFOC.pospeIpd.thRotEl;
+    		axis->drvFOC.pospeOpenLoop.integ.f32InK1 					= 0;
+    		axis->drvFOC.pospeOpenLoop.integ.f32State 				= MLIB_ConvertPU_F32FLT(MLIB_Div(axis->drvFOC.pospeIpd.thRotEl, FLOAT_PI));
+    		axis->drvFOC.pospeSensorless.thRotEl						= axis->drvFOC.pospeIpd.thRotEl;
+    		axis->drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltState	= axis->drvFOC.pospeIpd.thRotEl;
+    		axis->drvFOC.pospeControl.thRotEl							= axis->drvFOC.pospeIpd.thRotEl;
+    	}
+    }
+    else
+#endif
+    {
+    	axis->drvFOC.uDQReq.fltArg1      = axis->drvFOC.alignVoltage;
+    	axis->drvFOC.uDQReq.fltArg2      = 0.0F;
+
+    	GFLIB_SinCos_FLT(0.0F, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 
-    GMCLIB_ParkInv_FLT(&(drvFOC.uAlBeReq),&(drvFOC.thTransform),&(drvFOC.uDQReq));
+    	GMCLIB_ParkInv_FLT(&(axis->drvFOC.uAlBeReq),&(axis->drvFOC.thTransform),&(axis->drvFOC.uDQReq));
+
+    	AlignDone = (--(axis->drvFOC.alignCntr)<=0);
+    }
 
-    if (--(drvFOC.alignCntr)<=0)
+    if (AlignDone)
     {
-    	drvFOC.CurrentLoop.pIDQReq->fltArg1 	= 0.0F;
-        drvFOC.CurrentLoop.pIDQReq->fltArg2 	= 0.0F;
+#if POSPE_HFI
+    	// The injection starts from the aligned or detected position, the polarity is known
+    	POSPE_HfiInit(&axis->drvFOC.pospeHfi, axis->drvFOC.pospeOpenLoop.thRotEl, 0.0F);
+#endif
+    	axis->drvFOC.CurrentLoop.pIDQReq->fltArg1 	= 0.0F;
+        axis->drvFOC.CurrentLoop.pIDQReq->fltArg2 	= 0.0F;
 
-        AMCLIB_CurrentLoopInit_FLT(&drvFOC.CurrentLoop);
+        AMCLIB_CurrentLoopInit_FLT(&axis->drvFOC.CurrentLoop);
+#if CLOOP_DEADBEAT
+        CLOOP_DeadbeatInit(&axis->drvFOC.cloopDeadbeat);
+#endif
 
-        drvFOC.uDQReq.fltArg1 					= 0.0F;
-        drvFOC.uDQReq.fltArg2 					= 0.0F;
+        axis->drvFOC.uDQReq.fltArg1 					= 0.0F;
+        axis->drvFOC.uDQReq.fltArg2 					= 0.0F;
 
-        drvFOC.CurrentLoop.pPIrAWD.fltInErrK1  	= 0.0F;
-        drvFOC.CurrentLoop.pPIrAWD.fltAcc      	= 0.0F;
+        axis->drvFOC.CurrentLoop.pPIrAWD.fltInErrK1  	= 0.0F;
+        axis->drvFOC.CurrentLoop.pPIrAWD.fltAcc      	= 0.0F;
 
-        drvFOC.CurrentLoop.pPIrAWQ.fltInErrK1  	= 0.0F;
-        drvFOC.CurrentLoop.pPIrAWQ.fltAcc      	= 0.0F;
+        axis->drvFOC.CurrentLoop.pPIrAWQ.fltInErrK1  	= 0.0F;
+        axis->drvFOC.CurrentLoop.pPIrAWQ.fltAcc      	= 0.0F;
 
-        drvFOC.pwmflt.fltArg1 					= 0.5F;
-        drvFOC.pwmflt.fltArg2 					= 0.5F;
-        drvFOC.pwmflt.fltArg3 					= 0.5F;
+        axis->drvFOC.pwmflt.fltArg1 					= 0.5F;
+        axis->drvFOC.pwmflt.fltArg2 					= 0.5F;
+        axis->drvFOC.pwmflt.fltArg3 					= 0.5F;
 
         // Clear Encoder position and speed variables
-		POSPE_ClearPospeElEnc(&encoderPospe);
+		POSPE_ClearPospeElEnc(&axis->encoderPospe);
 		// FTM2 starts to count in Quadrature decoder mode
 		FTM_DRV_QuadDecodeStart(INST_FLEXTIMER_QD2, &flexTimer_qd2_QuadDecoderConfig);
 		// Set initial value of the FTM2 counter to -2048 to wrap encoder position into the range <-pi,pi>
@@ -984,20 +1413,20 @@ void StateAlign( )
 
         if (!AlignStatus)
         {
-        	tempfaults.stateMachine.B.AlignError = 1;
+        	axis->tempfaults.stateMachine.B.AlignError = 1;
         }
         else
         {
-        	cntrState.event           = e_align_done;
+        	axis->cntrState.event           = e_align_done;
         }
     }
 
-    drvFOC.elimDcbRip.fltArgDcBusMsr  = meas.measured.fltUdcb.raw;
-    GMCLIB_ElimDcBusRip_FLT(&drvFOC.uAlBeReqDCB,&drvFOC.uAlBeReq,&drvFOC.elimDcbRip);
+    axis->drvFOC.elimDcbRip.fltArgDcBusMsr  = axis->meas.measured.fltUdcb.raw;
+    GMCLIB_ElimDcBusRip_FLT(&axis->drvFOC.uAlBeReqDCB,&axis->drvFOC.uAlBeReq,&axis->drvFOC.elimDcbRip);
 
-    drvFOC.svmSector   = GMCLIB_SvmStd_FLT(&(drvFOC.pwmflt),&drvFOC.uAlBeReqDCB);
+    axis->drvFOC.svmSector   = GMCLIB_SvmStd_FLT(&(axis->drvFOC.pwmflt),&axis->drvFOC.uAlBeReqDCB);
 
-    statePWM = ACTUATE_SetDutycycle(&drvFOC.pwmflt, drvFOC.svmSector);
+    axis->statePWM = ACTUATE_SetDutycycle(&axis->pwm, &axis->drvFOC.pwmflt, axis->drvFOC.svmSector);
 }
 
 /***************************************************************************//*!
@@ -1010,41 +1439,45 @@ void StateAlign( )
 *
 ******************************************************************************/
 __attribute__((section (".code_ram"))) 		// inserting function to the RAM section
-void StateRun( )
+void StateRun(pmsmAxis_t *axis)
 {
-	static tBool stateRunStatus;
+	tBool stateRunStatus;
+	tU32 profStamp;
 
     stateRunStatus = false;
 
     /*-----------------------------------------------------
     Application State Machine - state identification
     ----------------------------------------------------- */
-    cntrState.state   = run;
-    cntrState.event   = e_run;
+    axis->cntrState.state   = run;
+    axis->cntrState.event   = e_run;
 
     /*-----------------------------------------------------
         Calculate positions
      ----------------------------------------------------- */
-	CalcOpenLoop(&drvFOC.pospeOpenLoop,drvFOC.FwSpeedLoop.pRamp.fltState);
+	CalcOpenLoop(&axis->drvFOC.pospeOpenLoop,axis->drvFOC.FwSpeedLoop.pRamp.fltState);
+
+	PROF_BEGIN(profStamp);
 
 	// Start calculation of the Bemf Observer in tracking mode
-	if(pos_mode!=force)
+	if(axis->pos_mode!=force)
 	// SENSORLESS CALCULATION - BACK-EMF OBSERVER
 	// INPUT	- Stator currents and voltages
 	// 		  	- Electrical angular velocity
 	// 		  	- Estimated rotor flux angle
 	// OUTPUT 	- Phase error between synchronous and quasi-synchronous reference frame
-    drvFOC.pospeSensorless.DQtoGaDeError = AMCLIB_BemfObsrvDQ_FLT(&drvFOC.iAlBeFbck, &drvFOC.uAlBeReq,
-															       drvFOC.pospeSensorless.wRotEl,
-															       drvFOC.pospeSensorless.thRotEl,
-															      &drvFOC.pospeSensorless.bEMFObs);
+    axis->drvFOC.pospeSensorless.DQtoGaDeError = AMCLIB_BemfObsrvDQ_FLT(&axis->drvFOC.iAlBeFbck, &axis->drvFOC.uAlBeReq,
+															       axis->drvFOC.pospeSensorless.wRotEl,
+															       axis->drvFOC.pospeSensorless.thRotEl,
+															      &axis->drvFOC.pospeSensorless.bEMFObs);
 
 	// SENSORLESS CALCULATION - ANGLE TRACKING OBSERVER
 	// INPUT	- Phase error between synchronous and quasi-synchronous reference frame
 	// OUTPUT 	- Estimated rotor position and velocity
-	AMCLIB_TrackObsrv_FLT(drvFOC.pospeSensorless.DQtoGaDeError, &drvFOC.pospeSensorless.thRotEl, &drvFOC.pospeSensorless.wRotEl, &drvFOC.pospeSensorless.TrackObsrv);
+	AMCLIB_TrackObsrv_FLT(axis->drvFOC.pospeSensorless.DQtoGaDeError, &axis->drvFOC.pospeSensorless.thRotEl, &axis->drvFOC.pospeSensorless.wRotEl, &axis->drvFOC.pospeSensorless.TrackObsrv);
+	PROF_END(PROF_OBSERVERS, profStamp);
 
-	drvFOC.pospeOpenLoop.thDifOpenLEstim = MLIB_Sub(drvFOC.pospeSensorless.thRotEl, drvFOC.pospeOpenLoop.thRotEl);
+	axis->drvFOC.pospeOpenLoop.thDifOpenLEstim = MLIB_Sub(axis->drvFOC.pospeSensorless.thRotEl, axis->drvFOC.pospeOpenLoop.thRotEl);
 
 	/*-----------------------------------------------------
 	Get positions according to selected mode
@@ -1054,115 +1487,162 @@ void StateRun( )
 	// Selecting 1 will enable the "USER mode"
 	// where user decide whether to switch to force mode, tracking mode, sensorless mode
 #if ENCODER
-	if(switchSensor == encoder && cntrState.usrControl.FOCcontrolMode != scalarControl)
+	if(axis->switchSensor == encoder && axis->cntrState.usrControl.FOCcontrolMode != scalarControl)
 	{
-		pos_mode = encoder1;
+		axis->pos_mode = encoder1;
 	}
 
-	else if(cntrState.usrControl.controlMode == automatic)
+	else if(axis->cntrState.usrControl.controlMode == automatic)
 	{
-		AutomaticMode();
+		AutomaticMode(axis);
 	}
 #else
-	if(cntrState.usrControl.controlMode == automatic)
+	if(axis->cntrState.usrControl.controlMode == automatic)
 	{
-		AutomaticMode();
+		AutomaticMode(axis);
 	}
 #endif
 
 
 	// user decide whether to switch to force mode, tracking mode, sensorless mode
-	switch (pos_mode)
+	switch (axis->pos_mode)
 	{
 		case force:
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= drvFOC.pospeOpenLoop.iQUpperLimit;
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= MLIB_Neg(drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit);
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= axis->drvFOC.pospeOpenLoop.iQUpperLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= MLIB_Neg(axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit);
 
-			drvFOC.pospeControl.thRotEl 			    = drvFOC.pospeOpenLoop.thRotEl;
-			drvFOC.pospeControl.wRotEl				    = 0;
+			axis->drvFOC.pospeControl.thRotEl 			    = axis->drvFOC.pospeOpenLoop.thRotEl;
+			axis->drvFOC.pospeControl.wRotEl				    = 0;
 
-			drvFOC.FwSpeedLoop.pRamp.fltRampDown		= OL_SpeedRampInc;
-			drvFOC.FwSpeedLoop.pRamp.fltRampUp          = OL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown		= axis->OL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp          = axis->OL_SpeedRampInc;
 
-		    drvFOC.pospeSensorless.wRotEl			    = 0;
-		    drvFOC.pospeSensorless.thRotEl			    = 0;
+		    axis->drvFOC.pospeSensorless.wRotEl			    = 0;
+		    axis->drvFOC.pospeSensorless.thRotEl			    = 0;
 
 		    /* Clear back-EMF observer state variables */
-		    AMCLIB_BemfObsrvDQInit_FLT(&drvFOC.pospeSensorless.bEMFObs);
+		    AMCLIB_BemfObsrvDQInit_FLT(&axis->drvFOC.pospeSensorless.bEMFObs);
 
 		    /* Load back-EMF observer state variables from tracking mode */
-		    drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltAcc 		= drvFOC.pospeOpenLoop.wRotEl;
-		    drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltState 	= drvFOC.pospeOpenLoop.thRotEl;
+		    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltAcc 		= axis->drvFOC.pospeOpenLoop.wRotEl;
+		    axis->drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltState 	= axis->drvFOC.pospeOpenLoop.thRotEl;
 
 		break;
 		case tracking:
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= drvFOC.pospeOpenLoop.iQUpperLimit;
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= MLIB_Neg(drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit);
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= axis->drvFOC.pospeOpenLoop.iQUpperLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= MLIB_Neg(axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit);
 
-			drvFOC.pospeControl.thRotEl 			    = drvFOC.pospeOpenLoop.thRotEl;
-			drvFOC.pospeControl.wRotEl				    = 0;
+			axis->drvFOC.pospeControl.thRotEl 			    = axis->drvFOC.pospeOpenLoop.thRotEl;
+			axis->drvFOC.pospeControl.wRotEl				    = 0;
 
-			drvFOC.FwSpeedLoop.pRamp.fltRampDown		= OL_SpeedRampInc;
-			drvFOC.FwSpeedLoop.pRamp.fltRampUp          = OL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown		= axis->OL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp          = axis->OL_SpeedRampInc;
 
 		break;
 		case sensorless1:
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= drvFOC.pospeSensorless.iQUpperLimit;
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= drvFOC.pospeSensorless.iQLowerLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= axis->drvFOC.pospeSensorless.iQUpperLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= axis->drvFOC.pospeSensorless.iQLowerLimit;
+
+#if FOC_ANGLE_MERGE
+			// The angle difference left by the open loop decays into the estimated angle
+			axis->drvFOC.pospeOpenLoop.thDifMerge			= MLIB_Mul(axis->drvFOC.pospeOpenLoop.thDifMerge, FOC_MERGE_DECAY);
+			axis->drvFOC.pospeControl.thRotEl 			    = MLIB_Add(axis->drvFOC.pospeSensorless.thRotEl, axis->drvFOC.pospeOpenLoop.thDifMerge);
+			if (axis->drvFOC.pospeControl.thRotEl >= FLOAT_PI)			axis->drvFOC.pospeControl.thRotEl -= FLOAT_2_PI;
+			else if (axis->drvFOC.pospeControl.thRotEl < -FLOAT_PI)	axis->drvFOC.pospeControl.thRotEl += FLOAT_2_PI;
+#else
+			axis->drvFOC.pospeControl.thRotEl 			    = axis->drvFOC.pospeSensorless.thRotEl;
+#endif
+			axis->drvFOC.pospeControl.wRotEl				    = axis->drvFOC.pospeSensorless.wRotEl;
+
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown		= axis->CL_SpeedRampDec;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp          = axis->CL_SpeedRampInc;
+
+		    axis->drvFOC.pospeOpenLoop.integ.f32State 	    = MLIB_ConvertPU_F32FLT(MLIB_Div(axis->drvFOC.pospeSensorless.thRotEl, FLOAT_PI));
+		break;
+#if POSPE_HFI
+		case hfi:
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= axis->drvFOC.pospeSensorless.iQUpperLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= axis->drvFOC.pospeSensorless.iQLowerLimit;
 
-			drvFOC.pospeControl.thRotEl 			    = drvFOC.pospeSensorless.thRotEl;
-			drvFOC.pospeControl.wRotEl				    = drvFOC.pospeSensorless.wRotEl;
+			axis->drvFOC.pospeControl.thRotEl 			    = axis->drvFOC.pospeHfi.thRotEl;
+			axis->drvFOC.pospeControl.wRotEl				    = axis->drvFOC.pospeHfi.wRotEl;
 
-			drvFOC.FwSpeedLoop.pRamp.fltRampDown		= CL_SpeedRampDec;
-			drvFOC.FwSpeedLoop.pRamp.fltRampUp          = CL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown		= axis->CL_SpeedRampDec;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp          = axis->CL_SpeedRampInc;
 
-		    drvFOC.pospeOpenLoop.integ.f32State 	    = MLIB_ConvertPU_F32FLT(MLIB_Div(drvFOC.pospeSensorless.thRotEl, FLOAT_PI));
+		    axis->drvFOC.pospeSensorless.wRotEl			    = axis->drvFOC.pospeHfi.wRotElFilt;
+		    axis->drvFOC.pospeSensorless.thRotEl			    = axis->drvFOC.pospeHfi.thRotEl;
+
+		    /* Clear back-EMF observer state variables, the injection voltage disturbs the observer */
+		    AMCLIB_BemfObsrvDQInit_FLT(&axis->drvFOC.pospeSensorless.bEMFObs);
+
+		    /* Load back-EMF observer state variables from the injection */
+		    axis->drvFOC.pospeSensorless.TrackObsrv.pParamPI.fltAcc 		= axis->drvFOC.pospeHfi.wRotElFilt;
+		    axis->drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltState 	= axis->drvFOC.pospeHfi.thRotEl;
+
+		    axis->drvFOC.pospeOpenLoop.integ.f32State 	    = MLIB_ConvertPU_F32FLT(MLIB_Div(axis->drvFOC.pospeHfi.thRotEl, FLOAT_PI));
 		break;
+#endif
 #if ENCODER
 		case encoder1:
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= drvFOC.pospeSensorless.iQUpperLimit;
-			drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= drvFOC.pospeSensorless.iQLowerLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltUpperLimit 	= axis->drvFOC.pospeSensorless.iQUpperLimit;
+			axis->drvFOC.FwSpeedLoop.pPIpAWQ.fltLowerLimit 	= axis->drvFOC.pospeSensorless.iQLowerLimit;
 
 			// Quadrature decoder mode
-			drvFOC.pospeControl.thRotEl                 = encoderPospe.thRotEl.filt;
-			drvFOC.pospeControl.wRotEl	                = encoderPospe.wRotEl.raw;
+			axis->drvFOC.pospeControl.thRotEl                 = axis->encoderPospe.thRotEl.filt;
+			axis->drvFOC.pospeControl.wRotEl	                = axis->encoderPospe.wRotEl.raw;
 
-			drvFOC.FwSpeedLoop.pRamp.fltRampDown		= CL_SpeedRampDec;
-			drvFOC.FwSpeedLoop.pRamp.fltRampUp          = CL_SpeedRampInc;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampDown		= axis->CL_SpeedRampDec;
+			axis->drvFOC.FwSpeedLoop.pRamp.fltRampUp          = axis->CL_SpeedRampInc;
 
-		    drvFOC.pospeOpenLoop.integ.f32State         = MLIB_ConvertPU_F32FLT(MLIB_Div(encoderPospe.thRotEl.filt, FLOAT_PI));
+		    axis->drvFOC.pospeOpenLoop.integ.f32State         = MLIB_ConvertPU_F32FLT(MLIB_Div(axis->encoderPospe.thRotEl.filt, FLOAT_PI));
 		break;
 #endif
 		default:
-			pos_mode = sensorless1;
+			axis->pos_mode = sensorless1;
 	}
 
+#if POSPE_HFI
+	// The injection is selected in the manual control mode only, it starts from the control angle of the mode before
+	if (axis->pos_mode != hfi)
+	{
+		POSPE_HfiInit(&axis->drvFOC.pospeHfi, axis->drvFOC.pospeControl.thRotEl, axis->drvFOC.pospeControl.wRotEl);
+	}
+#endif
+
 	/*-----------------------------------------------------
 	    Calculate Field Oriented Control FOC
 	----------------------------------------------------- */
-    if (++drvFOC.pospeControl.speedLoopCntr>=SPEED_LOOP_CNTR)
+    if (++axis->drvFOC.pospeControl.speedLoopCntr>=FOC_RATE_CNT(SPEED_LOOP_CNTR))
     {
-        drvFOC.pospeControl.speedLoopCntr    	= 0;
-        stateRunStatus  = FocSlowLoop();
+        axis->drvFOC.pospeControl.speedLoopCntr    	= 0;
+        PROF_BEGIN(profStamp);
+        stateRunStatus  = FocSlowLoop(axis);
+        ACTUATE_SwitchLossUpdate(&axis->pwm);
+        PROF_END(PROF_FOC_SLOW, profStamp);
 
         if (!stateRunStatus)
         {
-        	tempfaults.stateMachine.B.RunError 	= 1;
+        	axis->tempfaults.stateMachine.B.RunError 	= 1;
         }
     }
 
-    stateRunStatus = FocFastLoop();
+    PROF_BEGIN(profStamp);
+    stateRunStatus = FocFastLoop(axis);
+    PROF_END(PROF_FOC_FAST, profStamp);
 
     if (!stateRunStatus)
     {
-    	tempfaults.stateMachine.B.RunError 		= 1;
+    	axis->tempfaults.stateMachine.B.RunError 		= 1;
     }
 
     /* Voltage vector sum calculation to check if DC bus voltage is used appropriately */
-    UDQVectorSum = GFLIB_Sqrt(MLIB_Add(MLIB_Mul(drvFOC.uDQReq.fltArg1,drvFOC.uDQReq.fltArg1),MLIB_Mul(drvFOC.uDQReq.fltArg2,drvFOC.uDQReq.fltArg2)));
-
-    statePWM = ACTUATE_SetDutycycle(&drvFOC.pwmflt, drvFOC.svmSector);
+    axis->UDQVectorSum = GFLIB_Sqrt(MLIB_Add(MLIB_Mul(axis->drvFOC.uDQReq.fltArg1,axis->drvFOC.uDQReq.fltArg1),MLIB_Mul(axis->drvFOC.uDQReq.fltArg2,axis->drvFOC.uDQReq.fltArg2)));
 
+    PROF_BEGIN(profStamp);
+    axis->statePWM = ACTUATE_SetDutycycle(&axis->pwm, &axis->drvFOC.pwmflt, axis->drvFOC.svmSector);
+    PROF_END(PROF_SET_DUTYCYCLE, profStamp);
+    PROF_VALUE(PROF_PWM_SHIFT, axis->pwm.phaseShiftCnt);
 }
 
 /***************************************************************************//*!
@@ -1174,44 +1654,54 @@ void StateRun( )
 * @return  none
 *
 ******************************************************************************/
-static tBool FocSlowLoop()
+static tBool FocSlowLoop(pmsmAxis_t *axis)
 {
-	if(cntrState.usrControl.FOCcontrolMode != speedControl)
+	if(axis->cntrState.usrControl.FOCcontrolMode != speedControl)
 	{
 		// required speed for open loop start-up in sensorless mode = MERG_SPEED_1_TRH*1,5
         // wRotElReq = MERG_SPEED_1_TRH * 9.55 * 1.5 / pp = MERG_SPEED_1_TRH * 4.775 = ((MERG_SPEED_1_TRH*Frac16(0.596875)) << 3;
-		if (cntrState.usrControl.FOCcontrolMode == voltageControl && drvFOC.uDQReq.fltArg2==0)
-			drvFOC.pospeControl.wRotElReq = 0;
-		else if (cntrState.usrControl.FOCcontrolMode == currentControl && drvFOC.CurrentLoop.pIDQReq->fltArg2==0)
-			drvFOC.pospeControl.wRotElReq = 0;
-		else if (cntrState.usrControl.FOCcontrolMode != scalarControl)
-			drvFOC.pospeControl.wRotElReq = MLIB_Mul(0.75,MERG_SPEED_1_TRH);
+		if (axis->cntrState.usrControl.FOCcontrolMode == voltageControl && axis->drvFOC.uDQReq.fltArg2==0)
+			axis->drvFOC.pospeControl.wRotElReq = 0;
+		else if (axis->cntrState.usrControl.FOCcontrolMode == currentControl && axis->drvFOC.CurrentLoop.pIDQReq->fltArg2==0)
+			axis->drvFOC.pospeControl.wRotElReq = 0;
+		else if (axis->cntrState.usrControl.FOCcontrolMode != scalarControl)
+			axis->drvFOC.pospeControl.wRotElReq = MLIB_Mul(0.75,MERG_SPEED_1_TRH);
 	}
 
     // Required speed limit due to reduced DC bus voltage
-	if(drvFOC.pospeControl.wRotElReq > SPEED_LIM_RAD)	drvFOC.pospeControl.wRotElReq = SPEED_LIM_RAD;
-	if(drvFOC.pospeControl.wRotElReq < -SPEED_LIM_RAD)	drvFOC.pospeControl.wRotElReq = -SPEED_LIM_RAD;
+	if(axis->drvFOC.pospeControl.wRotElReq > SPEED_LIM_RAD)	axis->drvFOC.pospeControl.wRotElReq = SPEED_LIM_RAD;
+	if(axis->drvFOC.pospeControl.wRotElReq < -SPEED_LIM_RAD)	axis->drvFOC.pospeControl.wRotElReq = -SPEED_LIM_RAD;
 
-	if(fieldWeakOnOff)
+	if(axis->fieldWeakOnOff)
 	{
-		drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= FW_PropGainControl;
-		drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= FW_IntegGainControl;
+		axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= axis->FW_PropGainControl;
+		axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= axis->FW_IntegGainControl;
 
 	}else
 	{
-		drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= 0.0F;
-		drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= 0.0F;
-		drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegPartK_1 	= 0.0F;
+		axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltPropGain			= 0.0F;
+		axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegGain		= 0.0F;
+		axis->drvFOC.FwSpeedLoop.pPIpAWFW.fltIntegPartK_1 	= 0.0F;
 	}
 
-   	AMCLIB_FWSpeedLoop_FLT(drvFOC.pospeControl.wRotElReq, drvFOC.pospeControl.wRotEl, &drvFOC.iDQReqOutLoop, &drvFOC.FwSpeedLoop);
+   	AMCLIB_FWSpeedLoop_FLT(axis->drvFOC.pospeControl.wRotElReq, axis->drvFOC.pospeControl.wRotEl, &axis->drvFOC.iDQReqOutLoop, &axis->drvFOC.FwSpeedLoop);
+
+#if MOTOR_MTPA
+	// Table dq currents of the requested magnitude, the field weakening controller output turns them as a trim
+	if (axis->drvFOC.motorMtpa.valid && (axis->pos_mode != force) && (axis->pos_mode != tracking))
+	{
+		MTPA_Update(&axis->drvFOC.motorMtpa, &axis->drvFOC.iDQReqOutLoop, axis->drvFOC.pospeControl.wRotEl,
+					MLIB_Mul(MLIB_Mul(axis->drvFOC.CurrentLoop.pPIrAWD.fltUpperLimit, axis->drvFOC.fltUdcb), FLOAT_DIVBY_SQRT3),
+					axis->fieldWeakOnOff);
+	}
+#endif
 
     // Speed FO control mode
-    if(cntrState.usrControl.FOCcontrolMode == speedControl)
+    if(axis->cntrState.usrControl.FOCcontrolMode == speedControl)
     {
     	// In Speed control mode, FOC Outer Loop (Speed Loop & Field Weakening) output is interconnected with FOC Inner Loop (Current Loop) input
-    	drvFOC.iDQReqInLoop.fltArg1 = drvFOC.iDQReqOutLoop.fltArg1;
-    	drvFOC.iDQReqInLoop.fltArg2 = drvFOC.iDQReqOutLoop.fltArg2;
+    	axis->drvFOC.iDQReqInLoop.fltArg1 = axis->drvFOC.iDQReqOutLoop.fltArg1;
+    	axis->drvFOC.iDQReqInLoop.fltArg2 = axis->drvFOC.iDQReqOutLoop.fltArg2;
     }
     return true;
 }
@@ -1225,84 +1715,263 @@ static tBool FocSlowLoop()
 * @return  none
 *
 ******************************************************************************/
-static tBool FocFastLoop()
+static tBool FocFastLoop(pmsmAxis_t *axis)
 {
-	GMCLIB_Clark_FLT(&drvFOC.iAlBeFbck,&drvFOC.iAbcFbck);
+	SWLIBS_2Syst_FLT	*pUAlBeReq = &axis->drvFOC.uAlBeReq;
+	SWLIBS_2Syst_FLT	*pThTransformAct = &axis->drvFOC.thTransform;
+#if ACTUATE_DEADTIME_COMP
+	SWLIBS_2Syst_FLT	iAlBeDtc;
+#endif
+#if FOC_ANGLE_ADVANCE
+	SWLIBS_2Syst_FLT	thAdvance, thTransformAct;
+#endif
+#if ACTUATE_OVERMODULATION
+	tFloat				fltUdcbGain;
+#endif
+#if POSPE_HFI
+	SWLIBS_2Syst_FLT	uDQInj;
+	tFloat				uDInj = 0.0F;
+#endif
+
+	GMCLIB_Clark_FLT(&axis->drvFOC.iAlBeFbck,&axis->drvFOC.iAbcFbck);
 
 	// Scalar control mode
-	if(cntrState.usrControl.FOCcontrolMode == scalarControl)
+	if(axis->cntrState.usrControl.FOCcontrolMode == scalarControl)
 	{
 		// generated electrical position for scalar control purpose
 
 		// Required voltage = VHzRatio * Required Frequency
-		drvFOC.scalarControl.UmReq	  	= MLIB_Mul(drvFOC.scalarControl.VHzRatioReq, drvFOC.pospeControl.wRotElReq);
+		axis->drvFOC.scalarControl.UmReq	  	= MLIB_Mul(axis->drvFOC.scalarControl.VHzRatioReq, axis->drvFOC.pospeControl.wRotElReq);
 
 		// thRotEl is calculated in CalcOpenLoop executed in focSlowLoop
-		GFLIB_SinCos_FLT(drvFOC.pospeControl.thRotEl, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+		GFLIB_SinCos_FLT(axis->drvFOC.pospeControl.thRotEl, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 
-		drvFOC.uDQReq.fltArg1           = 0.0F;
-		drvFOC.uDQReq.fltArg2           = drvFOC.scalarControl.UmReq;
+		axis->drvFOC.uDQReq.fltArg1           = 0.0F;
+		axis->drvFOC.uDQReq.fltArg2           = axis->drvFOC.scalarControl.UmReq;
 
 		// enable Bemf observer
-		cntrState.usrControl.controlMode = manual;
-		pos_mode = tracking;
+		axis->cntrState.usrControl.controlMode = manual;
+		axis->pos_mode = tracking;
 	}
 
 	// DQ Voltage FO control mode
-	if(cntrState.usrControl.FOCcontrolMode == voltageControl)
+	if(axis->cntrState.usrControl.FOCcontrolMode == voltageControl)
 	{
-		if(drvFOC.uDQReq.fltArg2!=0)
+		if(axis->drvFOC.uDQReq.fltArg2!=0)
 		{
-			GFLIB_SinCos_FLT(drvFOC.pospeControl.thRotEl, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+			GFLIB_SinCos_FLT(axis->drvFOC.pospeControl.thRotEl, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 		}
 		else
 		{
-			GFLIB_SinCos_FLT(0.0F, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+			GFLIB_SinCos_FLT(0.0F, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 		}
 
-		GMCLIB_Park_FLT(&drvFOC.iDQFbck,&drvFOC.thTransform,&drvFOC.iAlBeFbck);
+		GMCLIB_Park_FLT(&axis->drvFOC.iDQFbck,&axis->drvFOC.thTransform,&axis->drvFOC.iAlBeFbck);
 	}
 
 	// DQ Current and Speed FO control mode
-	if(cntrState.usrControl.FOCcontrolMode == currentControl || cntrState.usrControl.FOCcontrolMode == speedControl)
+	if(axis->cntrState.usrControl.FOCcontrolMode == currentControl || axis->cntrState.usrControl.FOCcontrolMode == speedControl)
 	{
-		if(cntrState.usrControl.FOCcontrolMode == speedControl)
+		if(axis->cntrState.usrControl.FOCcontrolMode == speedControl)
 		{
-			GFLIB_SinCos_FLT(drvFOC.pospeControl.thRotEl, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+			GFLIB_SinCos_FLT(axis->drvFOC.pospeControl.thRotEl, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 		}
 		else
 		{
-			if(drvFOC.iDQReqOutLoop.fltArg2!=0)
+			if(axis->drvFOC.iDQReqOutLoop.fltArg2!=0)
 			{
-				GFLIB_SinCos_FLT(drvFOC.pospeControl.thRotEl, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+				GFLIB_SinCos_FLT(axis->drvFOC.pospeControl.thRotEl, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 			}
 			else
 			{
-				GFLIB_SinCos_FLT(0.0F, &drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
+				GFLIB_SinCos_FLT(0.0F, &axis->drvFOC.thTransform, GFLIB_SINCOS_DEFAULT_FLT);
 			}
 		}
 
-		GMCLIB_Park_FLT(&drvFOC.iDQFbck,&drvFOC.thTransform,&drvFOC.iAlBeFbck);
+		GMCLIB_Park_FLT(&axis->drvFOC.iDQFbck,&axis->drvFOC.thTransform,&axis->drvFOC.iAlBeFbck);
+
+#if POSPE_HFI
+		// The current controllers get the fundamental current, the injection estimates the position of the next loop
+		if (axis->pos_mode == hfi)
+		{
+			uDInj = POSPE_HfiUpdate(&axis->drvFOC.pospeHfi, &axis->drvFOC.iDQFbck, &axis->drvFOC.iAlBeFbck, &axis->drvFOC.thTransform);
+		}
+#endif
 
 		// 85% of available DCbus recalculated to phase voltage = 0.90*uDCB/sqrt(3)
-		AMCLIB_CurrentLoop_FLT(drvFOC.fltUdcb, &drvFOC.uDQReq, &drvFOC.CurrentLoop);
+#if CLOOP_DEADBEAT
+		// The model needs the rotor frame and the instantaneous current, the open loop frame and the
+		// filtered fundamental of the injection keep the PI controllers
+		if ((axis->pos_mode == sensorless1) || (axis->pos_mode == encoder1))
+		{
+			CLOOP_DeadbeatUpdate(&axis->drvFOC.cloopDeadbeat, axis->drvFOC.fltUdcb, &axis->drvFOC.uDQReq,
+								 &axis->drvFOC.CurrentLoop, axis->drvFOC.pospeControl.wRotEl);
+			// The PI controllers follow, another position mode continues without a step
+			AMCLIB_CurrentLoopSetState(axis->drvFOC.uDQReq.fltArg1, axis->drvFOC.uDQReq.fltArg2, &axis->drvFOC.CurrentLoop);
+		}
+		else
+		{
+			AMCLIB_CurrentLoop_FLT(axis->drvFOC.fltUdcb, &axis->drvFOC.uDQReq, &axis->drvFOC.CurrentLoop);
+			CLOOP_DeadbeatInit(&axis->drvFOC.cloopDeadbeat);
+		}
+#else
+		AMCLIB_CurrentLoop_FLT(axis->drvFOC.fltUdcb, &axis->drvFOC.uDQReq, &axis->drvFOC.CurrentLoop);
+#endif
 
+#if FOC_ANGLE_ADVANCE
+		// The rotor turns on until the voltage is applied, the actuation angle leads the feedback one
+		if ((axis->cntrState.usrControl.FOCcontrolMode == speedControl) || (axis->drvFOC.iDQReqOutLoop.fltArg2 != 0))
+		{
+			GFLIB_SinCos_FLT(MLIB_Mul(axis->drvFOC.pospeControl.wRotEl, FOC_ADVANCE_TS), &thAdvance, GFLIB_SINCOS_DEFAULT_FLT);
+			thTransformAct.fltArg1	= MLIB_Add(MLIB_Mul(axis->drvFOC.thTransform.fltArg1, thAdvance.fltArg2),
+											   MLIB_Mul(axis->drvFOC.thTransform.fltArg2, thAdvance.fltArg1));
+			thTransformAct.fltArg2	= MLIB_Sub(MLIB_Mul(axis->drvFOC.thTransform.fltArg2, thAdvance.fltArg2),
+											   MLIB_Mul(axis->drvFOC.thTransform.fltArg1, thAdvance.fltArg1));
+			pThTransformAct			= &thTransformAct;
+		}
+#endif
 	}
 
-    GMCLIB_ParkInv_FLT(&drvFOC.uAlBeReq,&drvFOC.thTransform,&drvFOC.uDQReq);
+#if POSPE_HFI
+    // Injection on the estimated d-axis, the controller output uDQReq stays fundamental
+#if FOC_ANGLE_ADVANCE
+    if (pThTransformAct != &axis->drvFOC.thTransform)
+    {
+    	// Only the fundamental is advanced, the injection is demodulated in the feedback frame
+    	GMCLIB_ParkInv_FLT(&axis->drvFOC.uAlBeReq,pThTransformAct,&axis->drvFOC.uDQReq);
+    	axis->drvFOC.uAlBeReq.fltArg1 = MLIB_Add(axis->drvFOC.uAlBeReq.fltArg1, MLIB_Mul(uDInj, axis->drvFOC.thTransform.fltArg2));
+    	axis->drvFOC.uAlBeReq.fltArg2 = MLIB_Add(axis->drvFOC.uAlBeReq.fltArg2, MLIB_Mul(uDInj, axis->drvFOC.thTransform.fltArg1));
+    }
+    else
+#endif
+    {
+    	uDQInj.fltArg1 = MLIB_Add(axis->drvFOC.uDQReq.fltArg1, uDInj);
+    	uDQInj.fltArg2 = axis->drvFOC.uDQReq.fltArg2;
+    	GMCLIB_ParkInv_FLT(&axis->drvFOC.uAlBeReq,pThTransformAct,&uDQInj);
+    }
+#else
+    GMCLIB_ParkInv_FLT(&axis->drvFOC.uAlBeReq,pThTransformAct,&axis->drvFOC.uDQReq);
+#endif
+
+#if ACTUATE_DEADTIME_COMP
+    // Dead-time compensation, the current direction is taken from the required currents when they are controlled
+    if(axis->cntrState.usrControl.FOCcontrolMode == currentControl || axis->cntrState.usrControl.FOCcontrolMode == speedControl)
+    {
+    	GMCLIB_ParkInv_FLT(&iAlBeDtc,pThTransformAct,&axis->drvFOC.iDQReqInLoop);
+    }
+    else
+    {
+    	iAlBeDtc = axis->drvFOC.iAlBeFbck;
+    }
+    ACTUATE_DeadTimeComp(&axis->pwm, &axis->drvFOC.uAlBeReqDTC, &axis->drvFOC.uAlBeReq, &iAlBeDtc, axis->meas.measured.fltUdcb.raw);
+    pUAlBeReq = &axis->drvFOC.uAlBeReqDTC;
+#endif
 
-    drvFOC.elimDcbRip.fltArgDcBusMsr  = meas.measured.fltUdcb.raw;
-    GMCLIB_ElimDcBusRip_FLT(&drvFOC.uAlBeReqDCB,&drvFOC.uAlBeReq,&drvFOC.elimDcbRip);
+#if ACTUATE_OVERMODULATION
+    // DC bus ripple elimination without the component limit of GMCLIB_ElimDcBusRip_FLT, the inscribed circle of the voltage hexagon is 1
+    fltUdcbGain = (axis->meas.measured.fltUdcb.raw > 0.0F) ? MLIB_Div(1.0F, MLIB_Mul(axis->meas.measured.fltUdcb.raw, FLOAT_DIVBY_SQRT3)) : 0.0F;
+    axis->drvFOC.uAlBeReqDCB.fltArg1 = MLIB_Mul(pUAlBeReq->fltArg1, fltUdcbGain);
+    axis->drvFOC.uAlBeReqDCB.fltArg2 = MLIB_Mul(pUAlBeReq->fltArg2, fltUdcbGain);
 
-    drvFOC.AlBeReqDCBLim.fltLimit = 0.9;
-    GFLIB_VectorLimit_FLT (&drvFOC.uAlBeReqDCBLim,&drvFOC.uAlBeReqDCB,&drvFOC.AlBeReqDCBLim);
+    ACTUATE_Overmodulation(&axis->pwm, &axis->drvFOC.uAlBeReqDCBLim, &axis->drvFOC.uAlBeReqDCB);
+#else
+    axis->drvFOC.elimDcbRip.fltArgDcBusMsr  = axis->meas.measured.fltUdcb.raw;
+    GMCLIB_ElimDcBusRip_FLT(&axis->drvFOC.uAlBeReqDCB,pUAlBeReq,&axis->drvFOC.elimDcbRip);
+
+    axis->drvFOC.AlBeReqDCBLim.fltLimit = 0.9;
+    GFLIB_VectorLimit_FLT (&axis->drvFOC.uAlBeReqDCBLim,&axis->drvFOC.uAlBeReqDCB,&axis->drvFOC.AlBeReqDCBLim);
+#endif
 
-    drvFOC.svmSector = GMCLIB_SvmStd_FLT(&(drvFOC.pwmflt),&drvFOC.uAlBeReqDCBLim);
+    axis->drvFOC.svmSector = GMCLIB_SvmStd_FLT(&(axis->drvFOC.pwmflt),&axis->drvFOC.uAlBeReqDCBLim);
 
     return (true);
 }
 
 
+#if FOC_FLYING_START
+/***************************************************************************//*!
+*
+* @brief   Flying start - zero current control with the sensorless observers
+*
+* @param   pointer to the axis
+*
+* @return  true when the rotor is caught, the run state takes over
+*
+******************************************************************************/
+static tBool FocCatch(pmsmAxis_t *axis)
+{
+	AMCLIB_BEMF_OBSRV_DQ_T_FLT	*pBemfObs = &axis->drvFOC.pospeSensorless.bEMFObs;
+
+	// Back-EMF and tracking observers as in the run state
+	axis->drvFOC.pospeSensorless.DQtoGaDeError = AMCLIB_BemfObsrvDQ_FLT(&axis->drvFOC.iAlBeFbck, &axis->drvFOC.uAlBeReq,
+																	   axis->drvFOC.pospeSensorless.wRotEl,
+																	   axis->drvFOC.pospeSensorless.thRotEl,
+																	   pBemfObs);
+	AMCLIB_TrackObsrv_FLT(axis->drvFOC.pospeSensorless.DQtoGaDeError, &axis->drvFOC.pospeSensorless.thRotEl, &axis->drvFOC.pospeSensorless.wRotEl, &axis->drvFOC.pospeSensorless.TrackObsrv);
+
+	// The phase error vanishes in the reversed frame too, there the back-EMF is against the speed
+	if ((MLIB_Abs(axis->drvFOC.pospeSensorless.wRotEl) > axis->drvFOC.pospeSensorless.wRotElMatch_1)
+		&& ((pBemfObs->pEObsrv.fltArg2 < 0.0F) != (axis->drvFOC.pospeSensorless.wRotEl < 0.0F)))
+	{
+		axis->drvFOC.pospeSensorless.thRotEl 			= MLIB_Add(axis->drvFOC.pospeSensorless.thRotEl,
+																	  (axis->drvFOC.pospeSensorless.thRotEl < 0.0F) ? FLOAT_PI : -FLOAT_PI);
+		axis->drvFOC.pospeSensorless.TrackObsrv.pParamInteg.fltState = axis->drvFOC.pospeSensorless.thRotEl;
+
+		// The observer and current controller states turn with the frame
+		pBemfObs->pEObsrv.fltArg1		= MLIB_Neg(pBemfObs->pEObsrv.fltArg1);
+		pBemfObs->pEObsrv.fltArg2		= MLIB_Neg(pBemfObs->pEObsrv.fltArg2);
+		pBemfObs->pIObsrv.fltArg1		= MLIB_Neg(pBemfObs->pIObsrv.fltArg1);
+		pBemfObs->pIObsrv.fltArg2		= MLIB_Neg(pBemfObs->pIObsrv.fltArg2);
+		pBemfObs->pIObsrvIn_1.fltArg1	= MLIB_Neg(pBemfObs->pIObsrvIn_1.fltArg1);
+		pBemfObs->pIObsrvIn_1.fltArg2	= MLIB_Neg(pBemfObs->pIObsrvIn_1.fltArg2);
+		pBemfObs->pParamD.fltAcc		= MLIB_Neg(pBemfObs->pParamD.fltAcc);
+		pBemfObs->pParamD.fltInErrK1	= MLIB_Neg(pBemfObs->pParamD.fltInErrK1);
+		pBemfObs->pParamQ.fltAcc		= MLIB_Neg(pBemfObs->pParamQ.fltAcc);
+		pBemfObs->pParamQ.fltInErrK1	= MLIB_Neg(pBemfObs->pParamQ.fltInErrK1);
+		AMCLIB_CurrentLoopSetState(MLIB_Neg(axis->drvFOC.uDQReq.fltArg1), MLIB_Neg(axis->drvFOC.uDQReq.fltArg2), &axis->drvFOC.CurrentLoop);
+	}
+
+	// Zero current in the estimated frame, the current controllers take over the back-EMF
+	axis->drvFOC.pospeControl.thRotEl 			= axis->drvFOC.pospeSensorless.thRotEl;
+	axis->drvFOC.pospeControl.wRotEl				= axis->drvFOC.pospeSensorless.wRotEl;
+	axis->drvFOC.iDQReqInLoop.fltArg1 			= 0.0F;
+	axis->drvFOC.iDQReqInLoop.fltArg2 			= 0.0F;
+
+	FocFastLoop(axis);
+
+	if (--(axis->drvFOC.catchCntr) > 0U)
+	{
+		return (false);
+	}
+
+	if ((MLIB_Abs(axis->drvFOC.pospeSensorless.wRotEl) > axis->drvFOC.pospeSensorless.wRotElMatch_2)
+		&& ((pBemfObs->pEObsrv.fltArg2 < 0.0F) == (axis->drvFOC.pospeSensorless.wRotEl < 0.0F)))
+	{
+		// Speed ramp and open loop continue from the estimate, no torque is required yet
+		AMCLIB_CurrentLoopSetState(axis->drvFOC.uDQReq.fltArg1, axis->drvFOC.uDQReq.fltArg2, &axis->drvFOC.CurrentLoop);
+		AMCLIB_FWSpeedLoopSetState(axis->drvFOC.pospeSensorless.wRotEl, 0.0F, 0.0F, 0.0F, axis->drvFOC.pospeSensorless.wRotEl, &axis->drvFOC.FwSpeedLoop);
+
+		axis->drvFOC.pospeOpenLoop.wRotEl				= axis->drvFOC.pospeSensorless.wRotEl;
+		axis->drvFOC.pospeOpenLoop.thRotEl			= axis->drvFOC.pospeSensorless.thRotEl;
+		axis->drvFOC.pospeOpenLoop.integ.f32State 	= MLIB_ConvertPU_F32FLT(MLIB_Div(axis->drvFOC.pospeSensorless.thRotEl, FLOAT_PI));
+		axis->drvFOC.pospeControl.speedLoopCntr		= 0;
+
+		axis->pos_mode								= sensorless1;
+		axis->trackingToSensorless					= false;
+
+		return (true);
+	}
+
+	// Too slow for the back-EMF observer, the alignment follows with the observers cleared
+	AMCLIB_BemfObsrvDQInit_FLT(pBemfObs);
+	AMCLIB_TrackObsrvInit_FLT(&axis->drvFOC.pospeSensorless.TrackObsrv);
+	axis->drvFOC.pospeSensorless.wRotEl			= 0.0F;
+	axis->drvFOC.pospeSensorless.thRotEl			= 0.0F;
+
+	return (false);
+}
+#endif
+
 /***************************************************************************//*!
 *
 * @brief   Fault Detection function
@@ -1312,7 +1981,7 @@ static tBool FocFastLoop()
 * @return  none
 *
 ******************************************************************************/
-static tBool FaultDetection()
+static tBool FaultDetection(pmsmAxis_t *axis)
 {
     tBool faultDetectiontEvent;
 
@@ -1322,26 +1991,26 @@ static tBool FaultDetection()
     // Actual Faults
     //-----------------------------
     // TRIP:   Phase A over-current detected
-	tempfaults.motor.B.OverPhaseACurrent = (drvFOC.iAbcFbck.fltArg1 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
+	axis->tempfaults.motor.B.OverPhaseACurrent = (axis->drvFOC.iAbcFbck.fltArg1 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
 
 	// TRIP:   Phase B over-current detected
-	tempfaults.motor.B.OverPhaseBCurrent = (drvFOC.iAbcFbck.fltArg2 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
+	axis->tempfaults.motor.B.OverPhaseBCurrent = (axis->drvFOC.iAbcFbck.fltArg2 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
 
 	// TRIP:   Phase C over-current detected
-	tempfaults.motor.B.OverPhaseCCurrent = (drvFOC.iAbcFbck.fltArg3 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
+	axis->tempfaults.motor.B.OverPhaseCCurrent = (axis->drvFOC.iAbcFbck.fltArg3 > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
 
 	// TRIP:   DC-bus over-voltage
-	tempfaults.motor.B.OverDCBusVoltage  = (meas.measured.fltUdcb.raw > U_DCB_TRIP) ? true : false;
+	axis->tempfaults.motor.B.OverDCBusVoltage  = (axis->meas.measured.fltUdcb.raw > U_DCB_TRIP) ? true : false;
 
 	// TRIP:   DC-bus under-voltage
-	tempfaults.motor.B.UnderDCBusVoltage = (meas.measured.fltUdcb.raw < MLIB_Div(U_DCB_UNDER,0.91F)) ? true : false;
+	axis->tempfaults.motor.B.UnderDCBusVoltage = (axis->meas.measured.fltUdcb.raw < MLIB_Div(U_DCB_UNDER,0.91F)) ? true : false;
 
 	// TRIP:   DC-bus over-current
-	tempfaults.motor.B.OverDCBusCurrent  = (meas.measured.fltIdcb.filt > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
+	axis->tempfaults.motor.B.OverDCBusCurrent  = (axis->meas.measured.fltIdcb.filt > MLIB_Mul(I_PH_OVER, 0.9F)) ? true : false;
 
 	// Activate braking resistor, if there is DC-bus over-voltage
 	/*
-	if(tempfaults.motor.B.OverDCBusVoltage)
+	if(axis->tempfaults.motor.B.OverDCBusVoltage)
 	{
 		// Activate braking resistor
 		GPIO_HAL_SetPins(PTD, 1<<14);
@@ -1357,55 +2026,61 @@ static tBool FaultDetection()
 	// Pending Faults
 	//-----------------------------
 
-	if (cntrState.state != fault)
+	if (axis->cntrState.state != fault)
 	{
 		// Fault:   Phase A over-current detected
-		permFaults.motor.B.OverPhaseACurrent    = (drvFOC.iAbcFbck.fltArg1 > I_PH_OVER) ? true : permFaults.motor.B.OverPhaseACurrent;
+		axis->permFaults.motor.B.OverPhaseACurrent    = (axis->drvFOC.iAbcFbck.fltArg1 > I_PH_OVER) ? true : axis->permFaults.motor.B.OverPhaseACurrent;
 
 		// Fault:   Phase B over-current detected
-		permFaults.motor.B.OverPhaseBCurrent    = (drvFOC.iAbcFbck.fltArg2 > I_PH_OVER) ? true : permFaults.motor.B.OverPhaseBCurrent;
+		axis->permFaults.motor.B.OverPhaseBCurrent    = (axis->drvFOC.iAbcFbck.fltArg2 > I_PH_OVER) ? true : axis->permFaults.motor.B.OverPhaseBCurrent;
 
 		// Fault:   Phase C over-current detected
-		permFaults.motor.B.OverPhaseCCurrent    = (drvFOC.iAbcFbck.fltArg3 > I_PH_OVER) ? true : permFaults.motor.B.OverPhaseCCurrent;
+		axis->permFaults.motor.B.OverPhaseCCurrent    = (axis->drvFOC.iAbcFbck.fltArg3 > I_PH_OVER) ? true : axis->permFaults.motor.B.OverPhaseCCurrent;
 
 		// Fault:   DC-bus over-voltage
-		permFaults.motor.B.OverDCBusVoltage     = (meas.measured.fltUdcb.raw > U_DCB_OVER) ? true : permFaults.motor.B.OverDCBusVoltage;
+		axis->permFaults.motor.B.OverDCBusVoltage     = (axis->meas.measured.fltUdcb.raw > U_DCB_OVER) ? true : axis->permFaults.motor.B.OverDCBusVoltage;
 
 		// Fault:   DC-bus under-voltage
-		permFaults.motor.B.UnderDCBusVoltage    = (meas.measured.fltUdcb.raw < U_DCB_UNDER) ? true : permFaults.motor.B.UnderDCBusVoltage;
+		axis->permFaults.motor.B.UnderDCBusVoltage    = (axis->meas.measured.fltUdcb.raw < U_DCB_UNDER) ? true : axis->permFaults.motor.B.UnderDCBusVoltage;
 
 		// Fault:   DC-bus over-current
-		permFaults.motor.B.OverDCBusCurrent   	= (meas.measured.fltIdcb.filt > I_PH_OVER) ? true : permFaults.motor.B.OverDCBusCurrent;
+		axis->permFaults.motor.B.OverDCBusCurrent   	= (axis->meas.measured.fltIdcb.filt > I_PH_OVER) ? true : axis->permFaults.motor.B.OverDCBusCurrent;
 	}
 
+#if FAST_TRIP
+	// Fault:   Hardware fast-trip, the FTM keeps the outputs off until the fault is cleared
+	if (ACTUATE_FastTripCheck(&axis->pwm))
+		axis->permFaults.motor.B.FastTripOverCurrent = true;
+#endif
+
 	// Check, whether back-EMF observer estimates rotor position properly
-	if((pos_mode == sensorless1) && (cntrState.usrControl.FOCcontrolMode == speedControl) && (cntrState.state != fault)
-		&& (MLIB_Abs(drvFOC.pospeOpenLoop.thDifOpenLEstim)>MAX_TH_DIF_OPEN_ESTIM))
+	if((axis->pos_mode == sensorless1) && (axis->cntrState.usrControl.FOCcontrolMode == speedControl) && (axis->cntrState.state != fault)
+		&& (MLIB_Abs(axis->drvFOC.pospeOpenLoop.thDifOpenLEstim)>MAX_TH_DIF_OPEN_ESTIM))
 	{
-		drvFOC.pospeSensorless.sensorlessCnt++;
-		if(drvFOC.pospeSensorless.sensorlessCnt > 10000)
+		axis->drvFOC.pospeSensorless.sensorlessCnt++;
+		if(axis->drvFOC.pospeSensorless.sensorlessCnt > 10000)
 		{
-			drvFOC.pospeSensorless.sensorlessCnt 	= 0;
-			permFaults.stateMachine.B.FOCError 		= 1;
+			axis->drvFOC.pospeSensorless.sensorlessCnt 	= 0;
+			axis->permFaults.stateMachine.B.FOCError 		= 1;
 		}
 	}
 	else
 	{
-		drvFOC.pospeSensorless.sensorlessCnt 		= 0;
+		axis->drvFOC.pospeSensorless.sensorlessCnt 		= 0;
 	}
 
 	// Check the status of the GD3000 MOSFET pre-driver
-    if (tppDrvConfig.deviceConfig.statusRegister[0U])
+    if ((axis->gd3000 != NULL) && axis->gd3000->deviceConfig.statusRegister[0U])
     {
-    	permFaults.gd3000 = true;
+    	axis->permFaults.gd3000 = true;
     	faultDetectiontEvent = true;
     }
 
-    if ((permFaults.motor.R != 0x0))
+    if ((axis->permFaults.motor.R != 0x0))
     	faultDetectiontEvent = true;
-    if ((permFaults.mcu.R != 0x0))
+    if ((axis->permFaults.mcu.R != 0x0))
         faultDetectiontEvent = true;
-    if ((permFaults.stateMachine.R != 0x0))
+    if ((axis->permFaults.stateMachine.R != 0x0))
         faultDetectiontEvent = true;
 
     return faultDetectiontEvent;
@@ -1439,31 +2114,38 @@ static tBool CalcOpenLoop(openLoopPospe_t *openLoop, tFloat speedReqRamp)
 * @return  bool
 *
 ******************************************************************************/
-tBool AutomaticMode()
+tBool AutomaticMode(pmsmAxis_t *axis)
 {
-	static tBool trackingToSensorless 	= false;
-
-	if ((MLIB_Abs(drvFOC.pospeOpenLoop.wRotEl) > drvFOC.pospeSensorless.wRotElMatch_2))
+	if ((MLIB_Abs(axis->drvFOC.pospeOpenLoop.wRotEl) > axis->drvFOC.pospeSensorless.wRotElMatch_2))
 	{
 		// Just once the sensorless is entered, the speed PI controller needs to be reset to avoid step current changes
-		if(trackingToSensorless)
+		if(axis->trackingToSensorless)
 		{
-			AMCLIB_CurrentLoopSetState(drvFOC.uDQReq.fltArg1, drvFOC.uDQReq.fltArg2, &drvFOC.CurrentLoop);
-			AMCLIB_FWSpeedLoopSetState(drvFOC.pospeOpenLoop.wRotEl, 0.0F,drvFOC.iDQReqInLoop.fltArg2, 0.0F, drvFOC.pospeOpenLoop.wRotEl, &drvFOC.FwSpeedLoop);
-			trackingToSensorless		= false;
+			AMCLIB_CurrentLoopSetState(axis->drvFOC.uDQReq.fltArg1, axis->drvFOC.uDQReq.fltArg2, &axis->drvFOC.CurrentLoop);
+			AMCLIB_FWSpeedLoopSetState(axis->drvFOC.pospeOpenLoop.wRotEl, 0.0F,axis->drvFOC.iDQReqInLoop.fltArg2, 0.0F, axis->drvFOC.pospeOpenLoop.wRotEl, &axis->drvFOC.FwSpeedLoop);
+#if FOC_ANGLE_MERGE
+			// The control angle starts from the open loop angle
+			axis->drvFOC.pospeOpenLoop.thDifMerge	= MLIB_Neg(axis->drvFOC.pospeOpenLoop.thDifOpenLEstim);
+			if (axis->drvFOC.pospeOpenLoop.thDifMerge >= FLOAT_PI)			axis->drvFOC.pospeOpenLoop.thDifMerge -= FLOAT_2_PI;
+			else if (axis->drvFOC.pospeOpenLoop.thDifMerge < -FLOAT_PI)	axis->drvFOC.pospeOpenLoop.thDifMerge += FLOAT_2_PI;
+			// A rotor far behind the open loop takes the rest of the difference at once
+			if (axis->drvFOC.pospeOpenLoop.thDifMerge > FOC_MERGE_MAX)		axis->drvFOC.pospeOpenLoop.thDifMerge = FOC_MERGE_MAX;
+			else if (axis->drvFOC.pospeOpenLoop.thDifMerge < -FOC_MERGE_MAX)	axis->drvFOC.pospeOpenLoop.thDifMerge = -FOC_MERGE_MAX;
+#endif
+			axis->trackingToSensorless		= false;
 		}
 
-		pos_mode = sensorless1;
+		axis->pos_mode = sensorless1;
 	}
-	else if ((MLIB_Abs(drvFOC.pospeOpenLoop.wRotEl) >= drvFOC.pospeSensorless.wRotElMatch_1 &&
-			 MLIB_Abs(drvFOC.pospeOpenLoop.wRotEl) < drvFOC.pospeSensorless.wRotElMatch_2))
+	else if ((MLIB_Abs(axis->drvFOC.pospeOpenLoop.wRotEl) >= axis->drvFOC.pospeSensorless.wRotElMatch_1 &&
+			 MLIB_Abs(axis->drvFOC.pospeOpenLoop.wRotEl) < axis->drvFOC.pospeSensorless.wRotElMatch_2))
 	{
-		pos_mode = tracking;
-		trackingToSensorless			= true;
+		axis->pos_mode = tracking;
+		axis->trackingToSensorless			= true;
 	}
 	else
 	{
-		pos_mode 						= force;
+		axis->pos_mode 						= force;
 	}
 
 	return(true);
@@ -1478,65 +2160,65 @@ tBool AutomaticMode()
 * @return  none
 *
 ******************************************************************************/
-void BoardButtons()
+void BoardButtons(pmsmAxis_t *axis)
 {
 	/* Turn the application on and increase the rotor velocity */
-    if (cntrState.usrControl.btSpeedUp && (!cntrState.usrControl.btSpeedDown))
+    if (axis->cntrState.usrControl.btSpeedUp && (!axis->cntrState.usrControl.btSpeedDown))
     {
-    	if(cntrState.usrControl.cntSpeedUp>SPEED_UP_CNT)
+    	if(axis->cntrState.usrControl.cntSpeedUp>FOC_RATE_CNT(SPEED_UP_CNT))
     	{
-    		cntrState.usrControl.cntSpeedUp = 0;
-    		cntrState.usrControl.switchAppOnOff = true;
-    		drvFOC.pospeControl.wRotElReq = MLIB_Add(drvFOC.pospeControl.wRotElReq, SPEED_RAD_INC);
+    		axis->cntrState.usrControl.cntSpeedUp = 0;
+    		axis->cntrState.usrControl.switchAppOnOff = true;
+    		axis->drvFOC.pospeControl.wRotElReq = MLIB_Add(axis->drvFOC.pospeControl.wRotElReq, SPEED_RAD_INC);
     	}
     	else
     	{
-    		cntrState.usrControl.cntSpeedUp++;
-    		cntrState.usrControl.cntSpeedDown=0;
-    		cntrState.usrControl.cntAppOff=0;
+    		axis->cntrState.usrControl.cntSpeedUp++;
+    		axis->cntrState.usrControl.cntSpeedDown=0;
+    		axis->cntrState.usrControl.cntAppOff=0;
     	}
     }
 
     /* Turn the application ON and decrease the rotor velocity */
-    if ((!cntrState.usrControl.btSpeedUp) && cntrState.usrControl.btSpeedDown)
+    if ((!axis->cntrState.usrControl.btSpeedUp) && axis->cntrState.usrControl.btSpeedDown)
     {
-    	if(cntrState.usrControl.cntSpeedDown>SPEED_DOWN_CNT)
+    	if(axis->cntrState.usrControl.cntSpeedDown>FOC_RATE_CNT(SPEED_DOWN_CNT))
     	{
-    		cntrState.usrControl.cntSpeedDown=0;
-    		cntrState.usrControl.switchAppOnOff = true;
-    		drvFOC.pospeControl.wRotElReq = MLIB_Sub(drvFOC.pospeControl.wRotElReq, SPEED_RAD_DEC);
+    		axis->cntrState.usrControl.cntSpeedDown=0;
+    		axis->cntrState.usrControl.switchAppOnOff = true;
+    		axis->drvFOC.pospeControl.wRotElReq = MLIB_Sub(axis->drvFOC.pospeControl.wRotElReq, SPEED_RAD_DEC);
     	}
     	else
        	{
-    		cntrState.usrControl.cntSpeedDown++;
-    		cntrState.usrControl.cntSpeedUp=0;
-    		cntrState.usrControl.cntAppOff=0;
+    		axis->cntrState.usrControl.cntSpeedDown++;
+    		axis->cntrState.usrControl.cntSpeedUp=0;
+    		axis->cntrState.usrControl.cntAppOff=0;
       	}
     }
 
     /* Turn the application off and clear application faults */
-    if(cntrState.usrControl.btSpeedUp && cntrState.usrControl.btSpeedDown)
+    if(axis->cntrState.usrControl.btSpeedUp && axis->cntrState.usrControl.btSpeedDown)
     {
     	/* Turn the application off */
-    	if(cntrState.usrControl.cntAppOff>APP_OFF_CNT && cntrState.state != fault)
+    	if(axis->cntrState.usrControl.cntAppOff>FOC_RATE_CNT(APP_OFF_CNT) && axis->cntrState.state != fault)
     	{
-    		cntrState.usrControl.cntAppOff=0;
-    		cntrState.usrControl.switchAppOnOff = false;
-    		drvFOC.pospeControl.wRotElReq=0;
+    		axis->cntrState.usrControl.cntAppOff=0;
+    		axis->cntrState.usrControl.switchAppOnOff = false;
+    		axis->drvFOC.pospeControl.wRotElReq=0;
     	}
 
     	/* Clear application faults */
-    	else if(cntrState.usrControl.cntAppOff>APP_OFF_CNT && cntrState.state == fault)
+    	else if(axis->cntrState.usrControl.cntAppOff>FOC_RATE_CNT(APP_OFF_CNT) && axis->cntrState.state == fault)
     	{
-    		cntrState.usrControl.cntAppOff=0;
-    		cntrState.usrControl.switchFaultClear = true;
-    		drvFOC.pospeControl.wRotElReq=0;
+    		axis->cntrState.usrControl.cntAppOff=0;
+    		axis->cntrState.usrControl.switchFaultClear = true;
+    		axis->drvFOC.pospeControl.wRotElReq=0;
     	}
     	else
     	{
-    		cntrState.usrControl.cntAppOff++;
-    		cntrState.usrControl.cntSpeedUp=0;
-    		cntrState.usrControl.cntSpeedDown=0;
+    		axis->cntrState.usrControl.cntAppOff++;
+    		axis->cntrState.usrControl.cntSpeedUp=0;
+    		axis->cntrState.usrControl.cntSpeedDown=0;
     	}
     }
 }
@@ -1545,12 +2227,12 @@ void BoardButtons()
 *
 * @brief   RGB LED OFF state
 *
-* @param
+* @param   axis, board axis
 *
 * @return  none
 *
 ******************************************************************************/
-void StateRGBLedOFF()
+void StateRGBLedOFF(pmsmAxis_t *axis)
 {
 	PINS_DRV_SetPins(PTD, 1<<0);		// RGB Blue  Led OFF
 	PINS_DRV_SetPins(PTD, 1<<15);		// RGB Red 	 Led OFF
@@ -1561,12 +2243,12 @@ void StateRGBLedOFF()
 *
 * @brief   Blue RGB LED ON state
 *
-* @param
+* @param   axis, board axis
 *
 * @return  none
 *
 ******************************************************************************/
-void StateRGBLedBlueON()
+void StateRGBLedBlueON(pmsmAxis_t *axis)
 {
 	PINS_DRV_ClearPins(PTD, 1<<0);		// RGB Blue  Led ON
 	PINS_DRV_SetPins(PTD, 1<<15);		// RGB Red 	 Led OFF
@@ -1577,12 +2259,12 @@ void StateRGBLedBlueON()
 *
 * @brief   Red RGB LED ON state
 *
-* @param
+* @param   axis, board axis
 *
 * @return  none
 *
 ******************************************************************************/
-void StateRGBLedRedON()
+void StateRGBLedRedON(pmsmAxis_t *axis)
 {
 	PINS_DRV_SetPins(PTD, 1<<0);		// RGB Blue  Led OFF
 	PINS_DRV_ClearPins(PTD, 1<<15);		// RGB Red 	 Led ON
@@ -1593,12 +2275,12 @@ void StateRGBLedRedON()
 *
 * @brief   Green RGB LED ON state
 *
-* @param
+* @param   axis, board axis
 *
 * @return  none
 *
 ******************************************************************************/
-void StateRGBLedGreenON()
+void StateRGBLedGreenON(pmsmAxis_t *axis)
 {
 	PINS_DRV_ClearPins(PTD, 1<<16);		// RGB Green Led ON
 	PINS_DRV_SetPins(PTD, 1<<0);		// RGB Blue  Led OFF
@@ -1609,20 +2291,20 @@ void StateRGBLedGreenON()
 *
 * @brief   Green RGB LED FLASHING state
 *
-* @param
+* @param   axis, board axis, its LED counters are used
 *
 * @return  none
 *
 ******************************************************************************/
-void StateRGBLedGreenFlashing()
+void StateRGBLedGreenFlashing(pmsmAxis_t *axis)
 {
-	cntrState.usrControl.ledCounter += 1;
+	axis->cntrState.usrControl.ledCounter += 1;
 
 	/* RGB Green Led FLASHING */
-	if((cntrState.usrControl.ledCounter)>((cntrState.usrControl.ledFlashing)<<1))
+	if((axis->cntrState.usrControl.ledCounter)>((axis->cntrState.usrControl.ledFlashing)<<1))
 	{
 		PINS_DRV_TogglePins(PTD, 1<<16);
-		cntrState.usrControl.ledCounter = 0;
+		axis->cntrState.usrControl.ledCounter = 0;
 	}
 	PINS_DRV_SetPins(PTD, 1<<0);		// RGB Blue  Led OFF
 	PINS_DRV_SetPins(PTD, 1<<15);		// RGB Red 	 Led OFF
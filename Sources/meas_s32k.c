@@ -32,7 +32,6 @@
 /******************************************************************************
 | Global variable definitions   (scope: module-exported)
 -----------------------------------------------------------------------------*/
-tU16 adcRawResultArray[5] = {0x7FF, 0x7FF, 0, 0x7FF, 0x7FF};
 
 /******************************************************************************
 | Global variable definitions   (scope: module-local)
@@ -133,7 +132,7 @@ tBool MEAS_CalibCurrentSense(measModule_t *ptr)
     if (!(ptr->flag.B.calibDone))
     {
     	//
-    	MEAS_GetPhaseABCurrent(ptr, adcRawResultArray);
+    	MEAS_GetPhaseABCurrent(ptr, ptr->adcRawResultArray);
     	/* --------------------------------------------------------------
          * Phase A - DC offset data filtering using MA recursive filter
          * ------------------------------------------------------------ */
@@ -183,7 +182,7 @@ tBool MEAS_CalibCurrentSense(measModule_t *ptr)
 ******************************************************************************/
 tBool MEAS_Get3PhCurrent(measModule_t *ptr, SWLIBS_3Syst_FLT *i, tU16 svmSector)
 {
-	MEAS_GetPhaseABCurrent(ptr, adcRawResultArray);	//Convert ADC raw integer results into float values "ptr->measured.fltPhA.raw" and "ptr->measured.fltPhB.raw"
+	MEAS_GetPhaseABCurrent(ptr, ptr->adcRawResultArray);	//Convert ADC raw integer results into float values "ptr->measured.fltPhA.raw" and "ptr->measured.fltPhB.raw"
 
 	switch (svmSector){
 		case 1:
@@ -253,7 +252,7 @@ tBool MEAS_GetUdcVoltage(measModule_t *ptr, GDFLIB_FILTER_MA_T *uDcbFilter)
 	uint16_t DCBus_Voltage;
 
     //DC Bus Voltage raw ADC data is already stored into adcRawResultArray[2] in function MEAS_SaveAdcRawResult();
-	DCBus_Voltage = adcRawResultArray[2];
+	DCBus_Voltage = ptr->adcRawResultArray[2];
 	ptr->measured.fltUdcb.raw	= MLIB_Mul((tFloat)(DCBus_Voltage & 0x00000FFF), MLIB_Div(U_DCB_MAX,4095.0F));
 	ptr->measured.fltUdcb.filt	= GDFLIB_FilterMA(ptr->measured.fltUdcb.raw, uDcbFilter);
 
@@ -286,22 +285,172 @@ tBool MEAS_GetIdcCurrent(measModule_t *ptr)
 /**************************************************************************//*!
 @brief      	Read ADC results registers and clear ADC flags;
 
-@param[in,out]  adcRawResultArray[], output, save ADC result registers values into the array adcRawResultArray[].
+@param[in,out]  *ptr    	output, save ADC result registers values into the array ptr->adcRawResultArray[].
+@param[in]      *adc    	ADC module triggered by the PDB of the drive
+@param[in]      svmSector	SVM sector the results are reconstructed for, MEAS_ADC_DMA only
 
 @return     	none
 
+@details		With MEAS_ADC_DMA the results are taken from the complete eDMA frame
+				of svmSector, the registers are read only when the frame is not
+				complete or was sampled for another sector.
+
 @note
 
 @warning
 ******************************************************************************/
-void MEAS_SaveAdcRawResult(void)
+void MEAS_SaveAdcRawResult(measModule_t *ptr, const ADC_Type *adc, tU16 svmSector)
 {
-	 adcRawResultArray[0] = ((ADC1->R[0]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
-	 adcRawResultArray[1] = ((ADC1->R[1]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
-	 adcRawResultArray[2] = ((ADC1->R[2]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
-	 adcRawResultArray[3] = ((ADC1->R[3]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
-	 adcRawResultArray[4] = ((ADC1->R[4]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+#if MEAS_ADC_DMA
+	measAdcDma_t			*dma = &ptr->adcDma;
+	const measAdcFrame_t	*frame = &dma->frame[dma->frameIdx];
+
+	if((frame->tag.seq == dma->stamp.seq) && (frame->tag.sector == svmSector))
+	{
+		ptr->adcRawResultArray[0] = frame->result[0] & ADC_R_D_MASK;
+		ptr->adcRawResultArray[1] = frame->result[1] & ADC_R_D_MASK;
+		ptr->adcRawResultArray[2] = frame->result[2] & ADC_R_D_MASK;
+		ptr->adcRawResultArray[3] = frame->result[3] & ADC_R_D_MASK;
+		ptr->adcRawResultArray[4] = frame->result[4] & ADC_R_D_MASK;
+		dma->frameIdx ^= 1U;
+		dma->taken++;
+		return;
+	}
+
+	//frame incomplete or of another sector, a conversion was missed or the ring is not aligned yet;
+	dma->missed++;
+#else
+	(void)svmSector;
+#endif
+	 ptr->adcRawResultArray[0] = ((adc->R[0]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+	 ptr->adcRawResultArray[1] = ((adc->R[1]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+	 ptr->adcRawResultArray[2] = ((adc->R[2]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+	 ptr->adcRawResultArray[3] = ((adc->R[3]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+	 ptr->adcRawResultArray[4] = ((adc->R[4]) & ADC_R_D_MASK) >> ADC_R_D_SHIFT;
+}
+
+#if MEAS_ADC_DMA
+/**************************************************************************//*!
+@brief      	Load a TCD of the ring to the eDMA channel registers
+
+@param[in]      chn    		eDMA channel
+@param[in]      *tcd    	software TCD
+
+@return     	none
+******************************************************************************/
+static void MEAS_AdcDmaLoad(tU8 chn, const edma_software_tcd_t *tcd)
+{
+	DMA->CDNE = chn;
+	DMA->TCD[chn].SADDR			= tcd->SADDR;
+	DMA->TCD[chn].SOFF			= (tU16)tcd->SOFF;
+	DMA->TCD[chn].ATTR			= tcd->ATTR;
+	DMA->TCD[chn].NBYTES.MLNO	= tcd->NBYTES;
+	DMA->TCD[chn].SLAST			= (tU32)tcd->SLAST;
+	DMA->TCD[chn].DADDR			= tcd->DADDR;
+	DMA->TCD[chn].DOFF			= (tU16)tcd->DOFF;
+	DMA->TCD[chn].CITER.ELINKNO	= tcd->CITER;
+	DMA->TCD[chn].DLASTSGA		= (tU32)tcd->DLAST_SGA;
+	DMA->TCD[chn].CSR			= tcd->CSR;
+	DMA->TCD[chn].BITER.ELINKNO	= tcd->BITER;
+}
+
+/**************************************************************************//*!
+@brief      	Set up the eDMA capture of the ADC results
+
+@param[in,out]  *ptr    	measurement module, its adcDma ring and frames
+@param[in]      *adc    	ADC module triggered by the PDB of the drive
+@param[in]      chn    		eDMA channel, initialized by McuDmaConfig() for the ADC request
+
+@return     	none
+
+@details		The results TCD reads R[0] ~ R[4] one per request (16-bit, source
+				offset 4) and is linked to the own channel on major loop completion,
+				so the tag TCD follows within the 5th request. Both TCDs of a frame
+				load the next one by scatter/gather; the ring waits for the next
+				request at the results TCD of the other frame.
+******************************************************************************/
+void MEAS_AdcDmaInit(measModule_t *ptr, ADC_Type *adc, tU8 chn)
+{
+	measAdcDma_t	*dma = &ptr->adcDma;
+	tU32			i;
+
+	for(i = 0; i<2; i++)
+	{
+		edma_software_tcd_t *res = &dma->tcd[2U * i];
+		edma_software_tcd_t *tag = &dma->tcd[2U * i + 1U];
+
+		res->SADDR		= (tU32)&adc->R[0];
+		res->SOFF		= 4;
+		res->ATTR		= (tU16)(DMA_TCD_ATTR_SSIZE(EDMA_TRANSFER_SIZE_2B) | DMA_TCD_ATTR_DSIZE(EDMA_TRANSFER_SIZE_2B));
+		res->NBYTES		= 2U;
+		res->SLAST		= -(tS32)(4U * MEAS_ADC_RESULTS);
+		res->DADDR		= (tU32)&dma->frame[i].result[0];
+		res->DOFF		= 2;
+		res->CITER		= MEAS_ADC_RESULTS;
+		res->BITER		= MEAS_ADC_RESULTS;
+		res->DLAST_SGA	= (tS32)(tU32)tag;
+		res->CSR		= (tU16)(DMA_TCD_CSR_ESG_MASK | DMA_TCD_CSR_MAJORELINK_MASK | DMA_TCD_CSR_MAJORLINKCH(chn));
+
+		tag->SADDR		= (tU32)&dma->stamp;
+		tag->SOFF		= 2;
+		tag->ATTR		= res->ATTR;
+		tag->NBYTES		= sizeof(measAdcTag_t);
+		tag->SLAST		= 0;
+		tag->DADDR		= (tU32)&dma->frame[i].tag;
+		tag->DOFF		= 2;
+		tag->CITER		= 1U;
+		tag->BITER		= 1U;
+		tag->DLAST_SGA	= (tS32)(tU32)&dma->tcd[(2U * i + 2U) % MEAS_ADC_TCD_CNT];
+		tag->CSR		= (tU16)DMA_TCD_CSR_ESG_MASK;
+
+		dma->frame[i].tag.seq = 0U;
+	}
+
+	dma->stamp.sector	= 0U;
+	dma->stamp.seq		= 1U;
+	dma->frameIdx		= 0U;
+	dma->taken			= 0U;
+	dma->missed			= 0U;
+	dma->resync			= 0U;
+	dma->chn			= chn;
+
+	MEAS_AdcDmaLoad(chn, &dma->tcd[0]);
+
+	//conversion complete requests the eDMA;
+	adc->SC2 |= ADC_SC2_DMAEN_MASK;
+
+	EDMA_DRV_StartChannel(chn);
+}
+
+/**************************************************************************//*!
+@brief      	Arm the tag of the next frame and re-align the ring with the control loop
+
+@param[in,out]  *ptr    	measurement module
+@param[in]      svmSector	SVM sector the PDB pre-trigger delays of the next frame are set for
+
+@return     	none
+
+@details		Called in PDB ISR in the last PWM period of the control loop, all
+				conversions of the loop are done and the eDMA is idle. The ring has
+				to wait at the results TCD of frameIdx, if it does not (a conversion
+				was missed, the ADC ISR did not take the frame), it is reloaded.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+void MEAS_AdcDmaSync(measModule_t *ptr, tU16 svmSector)
+{
+	measAdcDma_t				*dma = &ptr->adcDma;
+	const edma_software_tcd_t	*tcd = &dma->tcd[2U * dma->frameIdx];
+
+	if((DMA->TCD[dma->chn].DADDR != tcd->DADDR) || (DMA->TCD[dma->chn].CITER.ELINKNO != tcd->CITER))
+	{
+		MEAS_AdcDmaLoad(dma->chn, tcd);
+		dma->resync++;
+	}
+
+	dma->stamp.sector = svmSector;
+	dma->stamp.seq++;
 }
+#endif
 
 /***************************************************************************//*!
 @brief Read raw values from adc and remove offset obtained in calibration function
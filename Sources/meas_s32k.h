@@ -27,6 +27,25 @@
 -----------------------------------------------------------------------------*/
 #define I_DCB_MAX		25.0F
 
+/*****************************************************************************
+* ADC result capture
+*
+* MEAS_ADC_DMA  0		MEAS_SaveAdcRawResult() reads the ADC R[0] ~ R[4] registers in the ADC ISR
+* MEAS_ADC_DMA  1		Every ADC conversion complete requests an eDMA transfer of its result into
+* 						a ping-pong frame buffer (measAdcFrame_t); the 5th transfer of a frame is
+* 						followed by its tag, the sequence number and SVM sector armed in PDB ISR.
+* 						MEAS_SaveAdcRawResult() takes the complete frame of the active sector
+* 						from RAM, the ADC
+* 						conversion complete flags are cleared by the eDMA reads.
+******************************************************************************/
+#ifndef MEAS_ADC_DMA
+#define MEAS_ADC_DMA			0
+#endif
+
+#define MEAS_ADC_RESULTS		5U		// ADC R[0] ~ R[4], PDB pre-triggers 0 ~ 4 of the control loop
+#define MEAS_ADC_DMA_CHN		2U		// eDMA channel 2 of dmaController1, ADC1 of the FTM3 axis
+#define MEAS_ADC_TCD_CNT		4U		// results and tag TCD of both frames
+
 /******************************************************************************
 | Typedefs and structures       (scope: module-local)
 -----------------------------------------------------------------------------*/
@@ -93,16 +112,61 @@ typedef union
     } B;
 }calibFlags_t;
 
+/*------------------------------------------------------------------------*//*!
+@brief  Tag of an ADC result frame
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tU16	sector;		// SVM sector the PDB pre-trigger delays of the frame were set for
+	tU16	seq;		// control loop sequence number, written after the last result
+}measAdcTag_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  ADC results of one control loop, written by the eDMA
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tU16			result[MEAS_ADC_RESULTS];	// ADC R[0] ~ R[4]
+	measAdcTag_t	tag;
+}measAdcFrame_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  eDMA capture of the ADC results into ping-pong frames
+
+@details	The channel runs a scatter/gather ring of 4 TCDs: the results of
+			frame 0 (one per conversion complete request), the tag of frame 0
+			(linked to the last result), the same for frame 1. A frame is
+			complete when its tag sequence number equals stamp.seq, it is
+			taken when its tag sector is also the one the currents are
+			reconstructed for.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	//eDMA software TCD ring; a TCD is loaded by scatter/gather from a 32 bytes aligned address;
+	edma_software_tcd_t	tcd[MEAS_ADC_TCD_CNT] __attribute__((aligned(32)));
+	measAdcFrame_t		frame[2];
+	measAdcTag_t		stamp;			// tag of the frame in progress, eDMA source
+	tU32				frameIdx;		// frame in progress, taken next by the ADC ISR
+	tU32				taken;			// complete frames taken
+	tU32				missed;			// incomplete frames or frames of another sector, the ADC registers were read instead
+	tU32				resync;			// ring re-aligned with the control loop
+	tU8					chn;			// eDMA channel of dmaController1
+}measAdcDma_t;
+
 /*------------------------------------------------------------------------*//*!
 @brief  Module structure containing measurement related variables.
 *//*-------------------------------------------------------------------------*/
 typedef struct
 {
+#if MEAS_ADC_DMA
+	measAdcDma_t		adcDma;
+#endif
     measResult_t  		measured;
     offset_t     		offset;
     calibParam_t      	param;
     calibFlags_t      	flag;
 	tU16 				calibCntr;
+	tU16				adcRawResultArray[5];	// ADC result registers of the control loop
 }measModule_t;
 
 typedef struct ADC_RAW_DATA_T
@@ -112,11 +176,6 @@ typedef struct ADC_RAW_DATA_T
     tFrac16				dcOffset;
 }ADC_RAW_DATA_T;
 
-/******************************************************************************
-| Exported Variables
------------------------------------------------------------------------------*/
-extern tU16 adcRawResultArray[5];
-
 /******************************************************************************
 | Exported function prototypes
 -----------------------------------------------------------------------------*/
@@ -126,7 +185,11 @@ extern tBool MEAS_Get3PhCurrent(measModule_t *ptr, SWLIBS_3Syst_FLT *i, tU16 svm
 extern tBool MEAS_GetUdcVoltage(measModule_t *ptr, GDFLIB_FILTER_MA_T *uDcbFilter);
 extern tBool MEAS_GetIdcCurrent(measModule_t *ptr);
 extern void MEAS_GetPhaseABCurrent(measModule_t *ptr, tU16 *pRawBuf);
-extern void MEAS_SaveAdcRawResult(void);
+extern void MEAS_SaveAdcRawResult(measModule_t *ptr, const ADC_Type *adc, tU16 svmSector);
+#if MEAS_ADC_DMA
+extern void MEAS_AdcDmaInit(measModule_t *ptr, ADC_Type *adc, tU8 chn);
+extern void MEAS_AdcDmaSync(measModule_t *ptr, tU16 svmSector);
+#endif
 
 /******************************************************************************
 | Inline functions
@@ -0,0 +1,540 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_ident.c
+*
+* @date     April-11-2017
+*
+* @brief    Motor parameter identification
+*
+* @details	Rs, Ld, Lq, the flux linkage and the inertia measured through the
+*			single-shunt current sampling, in the order each measurement
+*			needs the results of the ones before. The voltage requested in a
+*			control loop is applied in the next one, the current is sampled
+*			IDENT_SAMPLE_DELAY after its start.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "motor_ident.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+/* Phases of the sequence */
+#define IDENT_PH_RS1			0U		// first DC level, aligns the rotor
+#define IDENT_PH_RS2			1U		// second DC level
+#define IDENT_PH_LD				2U		// pulses along alpha
+#define IDENT_PH_LQ				3U		// pulses along beta
+#define IDENT_PH_SPIN_UP		4U		// forced frame ramped up
+#define IDENT_PH_SPIN_HOLD		5U		// forced frame at the spin speed
+#define IDENT_PH_SPIN_DOWN		6U		// forced frame ramped down
+#define IDENT_PH_STOP			7U		// forced frame at standstill
+
+#define IDENT_FLUX_ITER			3U		// rotor angle iterations of the flux linkage
+#define IDENT_LAG_SPEED			(0.2F)	// least part of the spin speed with a valid rotor lag
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Recurrent PI controller coefficients from Kp and Ki
+
+@param[out]		pPI		Controller, limits and state are kept
+@param[in]		kp		Proportional gain [V/A]
+@param[in]		ki		Integral gain [V/As]
+******************************************************************************/
+static void IDENT_PiGains(GFLIB_CONTROLLER_PIAW_R_T_FLT *pPI, tFloat kp, tFloat ki)
+{
+	pPI->fltCC1sc = MLIB_Add(kp, MLIB_Mul(ki, 0.5F * IDENT_TS));
+	pPI->fltCC2sc = MLIB_Add(MLIB_Neg(kp), MLIB_Mul(ki, 0.5F * IDENT_TS));
+}
+
+/**************************************************************************//*!
+@brief			Current controller critically damped at IDENT_CLOOP_BW, the
+				MCAT design
+
+@param[out]		pPI		Controller, limits and state are kept
+@param[in]		r		Resistance [Ohm]
+@param[in]		l		Inductance of the controlled axis [H]
+******************************************************************************/
+static void IDENT_PiDesign(GFLIB_CONTROLLER_PIAW_R_T_FLT *pPI, tFloat r, tFloat l)
+{
+	// Kp = 2*xi*w0*L - R, Ki = w0^2*L
+	IDENT_PiGains(pPI, MLIB_Sub(MLIB_Mul(2.0F * IDENT_CLOOP_BW, l), r),
+				  MLIB_Mul(IDENT_CLOOP_BW * IDENT_CLOOP_BW, l));
+}
+
+/**************************************************************************//*!
+@brief			Clears the averaging window
+******************************************************************************/
+static void IDENT_ClearSums(identMotor_t *ptr)
+{
+	ptr->sumU.fltArg1	= 0.0F;
+	ptr->sumU.fltArg2	= 0.0F;
+	ptr->sumI.fltArg1	= 0.0F;
+	ptr->sumI.fltArg2	= 0.0F;
+	ptr->sumP			= 0.0F;
+	ptr->sumE			= 0.0F;
+	ptr->sumW			= 0.0F;
+}
+
+/**************************************************************************//*!
+@brief			Air gap energy since the start of the ramp less the losses of
+				the hold after it, averaged over the second half of the hold
+
+@param[in]		cnt		Duration of the hold [control loops]
+
+@details		At step k of the hold the energy holds k + 1 control loops of
+				the loss power, the mean of the second half of the hold is
+				taken as the loss power.
+******************************************************************************/
+static tFloat IDENT_RampEnergy(const identMotor_t *ptr, tU16 cnt)
+{
+	tFloat	n, kMean;
+
+	n		= (tFloat)(cnt - (cnt / 2U));
+	kMean	= 0.5F * (tFloat)((cnt / 2U) + cnt + 1U);
+
+	return (MLIB_Sub(MLIB_Div(ptr->sumE, n), MLIB_Mul(MLIB_Div(ptr->sumP, n), MLIB_Mul(kMean, IDENT_TS))));
+}
+
+/**************************************************************************//*!
+@brief			Flux linkage from the back-EMF at the spin speed
+
+@param[in]		pEDQ	Mean back-EMF in the forced frame [V]
+@param[in]		pIDQ	Mean current in the forced frame [A]
+
+@details		The stator flux jw*psiS = e is the magnet flux along the rotor
+				d-axis at phi plus the inductance flux, with the saliency
+					L(phi) = Lavg + Ldif*[cos(2phi) sin(2phi); sin(2phi) -cos(2phi)]
+				phi is found by iteration from the aligned guess, it changes
+				the inductance flux only.
+******************************************************************************/
+static void IDENT_Flux(identMotor_t *ptr, const SWLIBS_2Syst_FLT *pEDQ, const SWLIBS_2Syst_FLT *pIDQ)
+{
+	SWLIBS_2Syst_FLT	psiS, psiM, sinCos2;
+	tFloat				lAvg, lDif, phi;
+	tU16				i;
+
+	psiS.fltArg1	= MLIB_Div(pEDQ->fltArg2, ptr->spinSpeed);
+	psiS.fltArg2	= MLIB_Neg(MLIB_Div(pEDQ->fltArg1, ptr->spinSpeed));
+	lAvg			= MLIB_Mul(MLIB_Add(ptr->param.ld, ptr->param.lq), 0.5F);
+	lDif			= MLIB_Mul(MLIB_Sub(ptr->param.ld, ptr->param.lq), 0.5F);
+	phi				= 0.0F;
+
+	for (i = 0U; i < IDENT_FLUX_ITER; i++)
+	{
+		GFLIB_SinCos_FLT(MLIB_Mul(2.0F, phi), &sinCos2, GFLIB_SINCOS_DEFAULT_FLT);
+		psiM.fltArg1 = MLIB_Sub(psiS.fltArg1, MLIB_Add(MLIB_Mul(MLIB_Add(lAvg, MLIB_Mul(lDif, sinCos2.fltArg2)), pIDQ->fltArg1),
+													   MLIB_Mul(MLIB_Mul(lDif, sinCos2.fltArg1), pIDQ->fltArg2)));
+		psiM.fltArg2 = MLIB_Sub(psiS.fltArg2, MLIB_Add(MLIB_Mul(MLIB_Mul(lDif, sinCos2.fltArg1), pIDQ->fltArg1),
+													   MLIB_Mul(MLIB_Sub(lAvg, MLIB_Mul(lDif, sinCos2.fltArg2)), pIDQ->fltArg2)));
+		phi = GFLIB_AtanYX(psiM.fltArg2, psiM.fltArg1);
+	}
+
+	ptr->param.ke = GFLIB_Sqrt(MLIB_Add(MLIB_Mul(psiM.fltArg1, psiM.fltArg1), MLIB_Mul(psiM.fltArg2, psiM.fltArg2)));
+}
+
+/**************************************************************************//*!
+@brief			DC current level along alpha
+
+@details		Averaged over the second half of the level, the first one lets
+				the rotor settle in the aligned position.
+******************************************************************************/
+static void IDENT_DcLevel(identMotor_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe)
+{
+	tU16	cnt = FOC_RATE_CNT(IDENT_RS_CNT);
+	tFloat	iReq, n, u, i;
+
+	iReq = (ptr->phase == IDENT_PH_RS1) ? MLIB_Mul(ptr->current, 0.5F) : ptr->current;
+
+	pUAlBe->fltArg1 = GFLIB_ControllerPIrAW_FLT(MLIB_Sub(iReq, pIAlBe->fltArg1), &ptr->PiD);
+	pUAlBe->fltArg2 = GFLIB_ControllerPIrAW_FLT(MLIB_Neg(pIAlBe->fltArg2), &ptr->PiQ);
+
+	if (ptr->step >= (cnt / 2U))
+	{
+		ptr->sumU.fltArg1 = MLIB_Add(ptr->sumU.fltArg1, pUAlBe->fltArg1);
+		ptr->sumU.fltArg2 = MLIB_Add(ptr->sumU.fltArg2, pUAlBe->fltArg2);
+		ptr->sumI.fltArg1 = MLIB_Add(ptr->sumI.fltArg1, pIAlBe->fltArg1);
+	}
+
+	if (++ptr->step < cnt)
+	{
+		return;
+	}
+
+	n = (tFloat)(cnt - (cnt / 2U));
+	u = MLIB_Div(ptr->sumU.fltArg1, n);
+	i = MLIB_Div(ptr->sumI.fltArg1, n);
+
+	if (ptr->phase == IDENT_PH_RS1)
+	{
+		ptr->uLevel1	= u;
+		ptr->iLevel1	= i;
+	}
+	else
+	{
+		// The dead time and switch drops are the same at both levels
+		i = MLIB_Sub(i, ptr->iLevel1);
+		if (i < IDENT_I_MIN)
+		{
+			ptr->status = identFailed;
+			return;
+		}
+		ptr->param.rs		= MLIB_Div(MLIB_Sub(u, ptr->uLevel1), i);
+		ptr->uOffset		= MLIB_Sub(u, MLIB_Mul(ptr->param.rs, MLIB_Add(i, ptr->iLevel1)));
+		ptr->uBias.fltArg1	= u;
+		ptr->uBias.fltArg2	= MLIB_Div(ptr->sumU.fltArg2, n);
+
+		if (ptr->param.rs <= 0.0F)
+		{
+			ptr->status = identFailed;
+			return;
+		}
+	}
+
+	IDENT_ClearSums(ptr);
+	ptr->step = 0U;
+	ptr->phase++;
+}
+
+/**************************************************************************//*!
+@brief			Inductance pulses along alpha or beta
+
+@details		A pulse of two control loops on top of the bias voltage, then
+				the bias voltage for the rest. The current is sampled in both
+				pulse loops, one control loop apart with the same voltage, so
+				the sampling delay and the PWM ripple drop out of the rise
+					L*(i2 - i1) = (U - R*((i1 + i2)/2 - i0))*Ts
+				with i0 the current before the pulse.
+******************************************************************************/
+static void IDENT_Pulse(identMotor_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe)
+{
+	tFloat	iDir, uDir, l;
+
+	iDir = (ptr->phase == IDENT_PH_LQ) ? pIAlBe->fltArg2 : pIAlBe->fltArg1;
+	uDir = ((ptr->pulse & 1U) != 0U) ? MLIB_Neg(ptr->pulseVoltage) : ptr->pulseVoltage;
+	if (uDir < 0.0F)
+	{
+		iDir = MLIB_Neg(iDir);
+	}
+
+	*pUAlBe = ptr->uBias;
+
+	if (ptr->step == 0U)
+	{
+		ptr->iPre = iDir;
+	}
+	else if (ptr->step == 1U)
+	{
+		ptr->iResp	= MLIB_Sub(ptr->iResp, iDir);
+		ptr->iMean	= MLIB_Add(ptr->iMean, MLIB_Sub(MLIB_Mul(0.5F, iDir), ptr->iPre));
+	}
+	else if (ptr->step == 2U)
+	{
+		ptr->iResp	= MLIB_Add(ptr->iResp, iDir);
+		ptr->iMean	= MLIB_Add(ptr->iMean, MLIB_Mul(0.5F, iDir));
+	}
+
+	if (ptr->step < 2U)
+	{
+		if (ptr->phase == IDENT_PH_LQ)
+		{
+			pUAlBe->fltArg2 = MLIB_Add(pUAlBe->fltArg2, uDir);
+		}
+		else
+		{
+			pUAlBe->fltArg1 = MLIB_Add(pUAlBe->fltArg1, uDir);
+		}
+	}
+
+	if (++ptr->step < FOC_RATE_CNT(IDENT_PULSE_REST_CNT))
+	{
+		return;
+	}
+	ptr->step = 0U;
+
+	if (++ptr->pulse < IDENT_PULSES)
+	{
+		return;
+	}
+
+	if (ptr->iResp < (IDENT_I_MIN * (tFloat)IDENT_PULSES))
+	{
+		ptr->status = identFailed;
+		return;
+	}
+	l = MLIB_Div(MLIB_Mul(MLIB_Sub(MLIB_Mul(ptr->pulseVoltage, (tFloat)IDENT_PULSES), MLIB_Mul(ptr->param.rs, ptr->iMean)),
+						  IDENT_TS), ptr->iResp);
+
+	ptr->pulse	= 0U;
+	ptr->iResp	= 0.0F;
+	ptr->iMean	= 0.0F;
+
+	if (ptr->phase == IDENT_PH_LQ)
+	{
+		ptr->param.lq = l;
+
+		// The spin controllers take over the bias voltage in the forced frame at zero
+		IDENT_PiDesign(&ptr->PiD, ptr->param.rs, ptr->param.ld);
+		IDENT_PiDesign(&ptr->PiQ, ptr->param.rs, ptr->param.lq);
+		ptr->PiD.fltAcc			= ptr->uBias.fltArg1;
+		ptr->PiD.fltInErrK1		= 0.0F;
+		ptr->PiQ.fltAcc			= ptr->uBias.fltArg2;
+		ptr->PiQ.fltInErrK1		= 0.0F;
+		ptr->uDQ				= ptr->uBias;
+		ptr->energy				= 0.0F;
+	}
+	else
+	{
+		ptr->param.ld = l;
+	}
+
+	ptr->phase++;
+}
+
+/**************************************************************************//*!
+@brief			Current control in the forced frame, ramps and evaluation
+
+@details		The voltage applied in this control loop was requested in the
+				last one, in the frame one control loop back. Seen from the
+				frame of the current sample it lags by wEl*(1.5*Ts - delay).
+				The offset of the DC levels is the dead time voltage with the
+				current along a phase, turning with the current it is 3/pi of
+				it along the current on average.
+******************************************************************************/
+static void IDENT_Spin(identMotor_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe)
+{
+	SWLIBS_2Syst_FLT	sinCosLag, eDQ, iDQ;
+	tU16				cnt = FOC_RATE_CNT(IDENT_HOLD_CNT);
+	tFloat				p, n, lAvg, lag;
+
+	GMCLIB_Park_FLT(&ptr->iDQ, &ptr->sinCos, pIAlBe);
+
+	// Back-EMF and air gap power of this control loop
+	GFLIB_SinCos_FLT(MLIB_Mul(ptr->wEl, IDENT_SAMPLE_DELAY - 1.5F * IDENT_TS), &sinCosLag, GFLIB_SINCOS_DEFAULT_FLT);
+	eDQ.fltArg1	= MLIB_Sub(MLIB_Sub(MLIB_Mul(ptr->uDQ.fltArg1, sinCosLag.fltArg2), MLIB_Mul(ptr->uDQ.fltArg2, sinCosLag.fltArg1)),
+						   MLIB_Add(MLIB_Mul(ptr->param.rs, ptr->iDQ.fltArg1), MLIB_Mul(ptr->uOffset, 3.0F / FLOAT_PI)));
+	eDQ.fltArg2	= MLIB_Sub(MLIB_Add(MLIB_Mul(ptr->uDQ.fltArg1, sinCosLag.fltArg1), MLIB_Mul(ptr->uDQ.fltArg2, sinCosLag.fltArg2)),
+						   MLIB_Mul(ptr->param.rs, ptr->iDQ.fltArg2));
+	p			= MLIB_Mul(1.5F, MLIB_Add(MLIB_Mul(eDQ.fltArg1, ptr->iDQ.fltArg1), MLIB_Mul(eDQ.fltArg2, ptr->iDQ.fltArg2)));
+	ptr->energy	= MLIB_Add(ptr->energy, MLIB_Mul(p, IDENT_TS));
+
+	// Rotor lag behind the forced frame from the magnet flux, w*psiM = e - j*w*Lavg*i
+	if (ptr->wEl >= MLIB_Mul(ptr->spinSpeed, IDENT_LAG_SPEED))
+	{
+		lAvg	= MLIB_Mul(MLIB_Mul(MLIB_Add(ptr->param.ld, ptr->param.lq), 0.5F), ptr->wEl);
+		lag		= MLIB_Neg(GFLIB_AtanYX(MLIB_Neg(MLIB_Add(eDQ.fltArg1, MLIB_Mul(lAvg, ptr->iDQ.fltArg2))),
+										MLIB_Sub(eDQ.fltArg2, MLIB_Mul(lAvg, ptr->iDQ.fltArg1))));
+		if (lag > (0.5F * FLOAT_PI))
+		{
+			// Out of step, the current no longer turns the rotor
+			ptr->status = identFailed;
+			return;
+		}
+		if (ptr->lagValid)
+		{
+			ptr->lagWork = MLIB_Add(ptr->lagWork, MLIB_Mul(ptr->wEl, MLIB_Sub(lag, ptr->lag)));
+		}
+		ptr->lag		= lag;
+		ptr->lagValid	= TRUE;
+	}
+	else
+	{
+		ptr->lagValid	= FALSE;
+	}
+
+	// Averaged over the second half of the constant speed and the standstill
+	if (((ptr->phase == IDENT_PH_SPIN_HOLD) || (ptr->phase == IDENT_PH_STOP)) && (ptr->step >= (cnt / 2U)))
+	{
+		ptr->sumU.fltArg1	= MLIB_Add(ptr->sumU.fltArg1, eDQ.fltArg1);
+		ptr->sumU.fltArg2	= MLIB_Add(ptr->sumU.fltArg2, eDQ.fltArg2);
+		ptr->sumI.fltArg1	= MLIB_Add(ptr->sumI.fltArg1, ptr->iDQ.fltArg1);
+		ptr->sumI.fltArg2	= MLIB_Add(ptr->sumI.fltArg2, ptr->iDQ.fltArg2);
+		ptr->sumP			= MLIB_Add(ptr->sumP, p);
+		ptr->sumE			= MLIB_Add(ptr->sumE, ptr->energy);
+		ptr->sumW			= MLIB_Add(ptr->sumW, ptr->lagWork);
+	}
+
+	ptr->uDQ.fltArg1 = GFLIB_ControllerPIrAW_FLT(MLIB_Sub(ptr->current, ptr->iDQ.fltArg1), &ptr->PiD);
+	ptr->uDQ.fltArg2 = GFLIB_ControllerPIrAW_FLT(MLIB_Neg(ptr->iDQ.fltArg2), &ptr->PiQ);
+	GMCLIB_ParkInv_FLT(pUAlBe, &ptr->sinCos, &ptr->uDQ);
+
+	n = (tFloat)(cnt - (cnt / 2U));
+
+	switch (ptr->phase)
+	{
+	case IDENT_PH_SPIN_UP:
+		ptr->wEl = MLIB_Add(ptr->wEl, MLIB_Mul(ptr->spinAccel, IDENT_TS));
+		if (ptr->wEl >= ptr->spinSpeed)
+		{
+			ptr->wEl	= ptr->spinSpeed;
+			ptr->step	= 0U;
+			ptr->phase	= IDENT_PH_SPIN_HOLD;
+		}
+		break;
+
+	case IDENT_PH_SPIN_HOLD:
+		if (++ptr->step >= cnt)
+		{
+			ptr->energyUp	= IDENT_RampEnergy(ptr, cnt);
+			ptr->lagWorkUp	= MLIB_Div(ptr->sumW, n);
+			ptr->lossPower	= MLIB_Div(ptr->sumP, n);
+
+			eDQ.fltArg1 = MLIB_Div(ptr->sumU.fltArg1, n);
+			eDQ.fltArg2 = MLIB_Div(ptr->sumU.fltArg2, n);
+			iDQ.fltArg1 = MLIB_Div(ptr->sumI.fltArg1, n);
+			iDQ.fltArg2 = MLIB_Div(ptr->sumI.fltArg2, n);
+			IDENT_Flux(ptr, &eDQ, &iDQ);
+
+			IDENT_ClearSums(ptr);
+			ptr->energy	= 0.0F;
+			ptr->lagWork	= 0.0F;
+			ptr->step	= 0U;
+			ptr->phase	= IDENT_PH_SPIN_DOWN;
+		}
+		break;
+
+	case IDENT_PH_SPIN_DOWN:
+		ptr->wEl = MLIB_Sub(ptr->wEl, MLIB_Mul(ptr->spinAccel, IDENT_TS));
+		if (ptr->wEl <= 0.0F)
+		{
+			ptr->wEl	= 0.0F;
+			ptr->phase	= IDENT_PH_STOP;
+		}
+		break;
+
+	default:
+		if (++ptr->step >= cnt)
+		{
+			// Up less down is twice the kinetic energy at the spin speed, J*(wEl/pp)^2, with the friction
+			// work of the rotor lag: the viscous friction torque P/wMech^2*w/pp over the lag travel lag/pp
+			p = MLIB_Sub(ptr->energyUp, IDENT_RampEnergy(ptr, cnt));
+			p = MLIB_Add(p, MLIB_Div(MLIB_Mul(ptr->lossPower, MLIB_Sub(ptr->lagWorkUp, MLIB_Div(ptr->sumW, n))),
+									 MLIB_Mul(ptr->spinSpeed, ptr->spinSpeed)));
+			ptr->param.j = MLIB_Div(MLIB_Mul(p, MOTOR_PP * MOTOR_PP), MLIB_Mul(ptr->spinSpeed, ptr->spinSpeed));
+
+			ptr->status = ((ptr->param.ke > 0.0F) && (ptr->param.j > 0.0F)) ? identDone : identFailed;
+		}
+		break;
+	}
+
+	// Frame of the next control loop
+	ptr->thEl = MLIB_Add(ptr->thEl, MLIB_Mul(ptr->wEl, IDENT_TS));
+	if (ptr->thEl > FLOAT_PI)		ptr->thEl = MLIB_Sub(ptr->thEl, 2.0F * FLOAT_PI);
+	GFLIB_SinCos_FLT(ptr->thEl, &ptr->sinCos, GFLIB_SINCOS_DEFAULT_FLT);
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Restarts the identification, the settings and the last
+				result are kept
+
+@param[out]		ptr		Identification structure
+******************************************************************************/
+void IDENT_Init(identMotor_t *ptr)
+{
+	ptr->phase				= IDENT_PH_RS1;
+	ptr->step				= 0U;
+	ptr->pulse				= 0U;
+	ptr->thEl				= 0.0F;
+	ptr->wEl				= 0.0F;
+	ptr->sinCos.fltArg1		= 0.0F;
+	ptr->sinCos.fltArg2		= 1.0F;
+	ptr->iDQ.fltArg1		= 0.0F;
+	ptr->iDQ.fltArg2		= 0.0F;
+	ptr->uDQ.fltArg1		= 0.0F;
+	ptr->uDQ.fltArg2		= 0.0F;
+	ptr->uBias.fltArg1		= 0.0F;
+	ptr->uBias.fltArg2		= 0.0F;
+	ptr->iPre				= 0.0F;
+	ptr->iResp				= 0.0F;
+	ptr->iMean				= 0.0F;
+	ptr->uLevel1			= 0.0F;
+	ptr->iLevel1			= 0.0F;
+	ptr->uOffset			= 0.0F;
+	ptr->energy				= 0.0F;
+	ptr->energyUp			= 0.0F;
+	ptr->lag				= 0.0F;
+	ptr->lagValid			= FALSE;
+	ptr->lagWork			= 0.0F;
+	ptr->lagWorkUp			= 0.0F;
+	ptr->lossPower			= 0.0F;
+	IDENT_ClearSums(ptr);
+
+	IDENT_PiGains(&ptr->PiD, IDENT_RS_KP, IDENT_RS_KI);
+	IDENT_PiGains(&ptr->PiQ, IDENT_RS_KP, IDENT_RS_KI);
+	ptr->PiD.fltAcc			= 0.0F;
+	ptr->PiD.fltInErrK1		= 0.0F;
+	ptr->PiQ.fltAcc			= 0.0F;
+	ptr->PiQ.fltInErrK1		= 0.0F;
+
+	ptr->status				= identBusy;
+}
+
+/**************************************************************************//*!
+@brief			One control loop of the identification
+
+@param[in,out]	ptr		Identification structure
+@param[out]		pUAlBe	Alpha/beta voltage request for the next control loop [V]
+@param[in]		pIAlBe	Alpha/beta current of this control loop [A]
+@param[in]		fltUdcb	DC bus voltage [V]
+
+@return			identBusy during the sequence, identDone with param valid or
+				identFailed, the voltage request is zero then
+******************************************************************************/
+identStatus_t IDENT_Update(identMotor_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe,
+						   tFloat fltUdcb)
+{
+	tFloat	uMax;
+
+	pUAlBe->fltArg1 = 0.0F;
+	pUAlBe->fltArg2 = 0.0F;
+
+	if (ptr->status != identBusy)
+	{
+		return (ptr->status);
+	}
+
+	// The current loop limit, CLOOP_LIMIT of the phase voltage
+	uMax = MLIB_Mul(fltUdcb, CLOOP_LIMIT * FLOAT_DIVBY_SQRT3);
+	ptr->PiD.fltUpperLimit	= uMax;
+	ptr->PiD.fltLowerLimit	= MLIB_Neg(uMax);
+	ptr->PiQ.fltUpperLimit	= uMax;
+	ptr->PiQ.fltLowerLimit	= MLIB_Neg(uMax);
+
+	switch (ptr->phase)
+	{
+	case IDENT_PH_RS1:
+	case IDENT_PH_RS2:
+		IDENT_DcLevel(ptr, pUAlBe, pIAlBe);
+		break;
+
+	case IDENT_PH_LD:
+	case IDENT_PH_LQ:
+		IDENT_Pulse(ptr, pUAlBe, pIAlBe);
+		break;
+
+	default:
+		IDENT_Spin(ptr, pUAlBe, pIAlBe);
+		break;
+	}
+
+	if (ptr->status != identBusy)
+	{
+		pUAlBe->fltArg1 = 0.0F;
+		pUAlBe->fltArg2 = 0.0F;
+	}
+
+	return (ptr->status);
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_ident.h
+*
+* @date     April-11-2017
+*
+* @brief    Header file for the motor parameter identification
+*
+*******************************************************************************/
+#ifndef MOTOR_IDENT_H_
+#define MOTOR_IDENT_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "gmclib.h"
+#include "amclib.h"
+#include "PMSM_apprate.h"
+#include "motor_tune.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* MOTOR_IDENT	motor parameter identification
+ *		0	the control constants come from PMSM_appconfig.h only
+ *		1	with request set, the next start runs the identification state
+ *			between the calibration and the alignment (about 5s): Rs by DC
+ *			current, Ld and Lq by voltage pulses, the flux linkage and the
+ *			inertia by an open loop spin. Setting adopt in the ready state
+ *			hands the result to the gain synthesis of motor_tune.h
+ * The rotor has to be free to turn, the spin takes it to IDENT_SPIN_SPEED. */
+#ifndef MOTOR_IDENT
+#define MOTOR_IDENT				0
+#endif
+
+#define IDENT_CURRENT			(2.0F)		// DC, pulse bias and spin current [A]
+#define IDENT_PULSE_VOLTAGE		(1.5F)		// inductance pulse voltage [V]
+#define IDENT_SPIN_SPEED		(300.0F)	// electrical speed of the spin [rad/s]
+#define IDENT_SPIN_ACCEL		(2000.0F)	// electrical acceleration of the spin [rad/s^2]
+#define IDENT_RS_CNT			(6667)		// duration of each DC current level [MCAT control loops]
+#define IDENT_PULSES			8U			// inductance pulses per axis, alternating sign
+#define IDENT_PULSE_REST_CNT	(30)		// bias voltage after each pulse [MCAT control loops]
+#define IDENT_HOLD_CNT			(6667)		// spin at constant speed and standstill after it [MCAT control loops]
+#define IDENT_I_MIN				(0.1F)		// least current difference and pulse response [A]
+
+/* Current controllers of the DC levels, slow enough for any motor */
+#define IDENT_RS_KP				(0.2F)		// [V/A]
+#define IDENT_RS_KI				(100.0F)	// [V/As]
+
+/* Spin current controllers, critically damped at the MCAT current loop bandwidth */
+#define IDENT_CLOOP_BW			(2.0F*FLOAT_PI*150.0F)	// [rad/s]
+
+/* The current is sampled about one PWM period after the start of the control
+ * loop, the mean of the two single-shunt sampling periods. Only the voltage
+ * angle of the spin depends on it. */
+#define IDENT_TS				((tFloat)FOC_PERIOD_US*1.0e-6F)
+#define IDENT_SAMPLE_DELAY		(25.0e-6F)	// [s]
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+typedef enum
+{
+	identBusy		= 0,
+	identDone		= 1,
+	identFailed		= 2
+}identStatus_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Motor parameter identification
+
+@details	The sequence runs in the alpha/beta frame up to the spin:
+			- two DC current levels along alpha align the rotor, the voltage
+			  difference over the current difference is Rs, the dead time
+			  and the switch drops cancel
+			- the voltage of the second level holds the bias current, voltage
+			  pulses of two control loops along alpha (d) and beta (q) give
+			  the inductances from the current rise; the bias keeps the phase
+			  current signs and with them the dead time constant
+			- the current is controlled in a frame forced along at the spin
+			  speed, ramped up, held and ramped down to standstill. At the
+			  constant speed the voltage gives the flux linkage. The air gap
+			  energy of the ramp up less the one of the ramp down is twice
+			  the kinetic energy, the losses of both ramps cancel. Both are
+			  averaged over the end of the following hold, the rotor swings
+			  about the forced speed without any damping but friction
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							current;		// DC, pulse bias and spin current [A]
+	tFloat							pulseVoltage;	// inductance pulse voltage [V]
+	tFloat							spinSpeed;		// electrical speed of the spin [rad/s]
+	tFloat							spinAccel;		// electrical acceleration of the spin [rad/s^2]
+	tBool							request;		// identification at the next start
+	tBool							adopt;			// hand param to the gain synthesis in the ready state
+	tU16							phase;			// running phase, DC levels, pulses, spin
+	tU16							step;			// control loop within the phase
+	tU16							pulse;			// running inductance pulse
+	tFloat							thEl;			// forced electrical position [rad]
+	tFloat							wEl;			// forced electrical speed [rad/s]
+	SWLIBS_2Syst_FLT				sinCos;			// sine and cosine of thEl
+	SWLIBS_2Syst_FLT				iDQ;			// current in the forced frame [A]
+	SWLIBS_2Syst_FLT				uDQ;			// voltage request of the last control loop [V]
+	SWLIBS_2Syst_FLT				uBias;			// voltage holding the bias current [V]
+	tFloat							iPre;			// current before the pulse [A]
+	tFloat							iResp;			// sum of the pulse current rises over one control loop [A]
+	tFloat							iMean;			// sum of the pulse currents over the rise [A]
+	SWLIBS_2Syst_FLT				sumU;			// voltage sum of the averaging window [V]
+	SWLIBS_2Syst_FLT				sumI;			// current sum of the averaging window [A]
+	tFloat							sumP;			// air gap power sum of the averaging window [W]
+	tFloat							sumE;			// air gap energy sum of the averaging window [J]
+	tFloat							sumW;			// lag work sum of the averaging window [rad^2/s]
+	tFloat							uLevel1;		// voltage of the first DC level [V]
+	tFloat							iLevel1;		// current of the first DC level [A]
+	tFloat							uOffset;		// voltage of the second DC level beyond Rs, dead time and switch thresholds [V]
+	tFloat							energy;			// air gap energy since the start of the running ramp [J]
+	tFloat							energyUp;		// air gap energy of the ramp up less the losses after it [J]
+	tFloat							lag;			// rotor lag behind the forced frame [rad]
+	tBool							lagValid;		// lag of the last control loop valid
+	tFloat							lagWork;		// forced speed times the lag change since the start of the running ramp [rad^2/s]
+	tFloat							lagWorkUp;		// lag work of the ramp up [rad^2/s]
+	tFloat							lossPower;		// loss power at the spin speed [W]
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	PiD;			// alpha or d-axis current controller
+	GFLIB_CONTROLLER_PIAW_R_T_FLT	PiQ;			// beta or q-axis current controller
+	motorParam_t					param;			// identified parameters
+	identStatus_t					status;
+}identMotor_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void IDENT_Init(identMotor_t *ptr);
+extern identStatus_t IDENT_Update(identMotor_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe,
+								  tFloat fltUdcb);
+
+#endif /* MOTOR_IDENT_H_ */
@@ -0,0 +1,470 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_mtpa.c
+*
+* @date     April-18-2017
+*
+* @brief    MTPA and field weakening current reference table
+*
+* @details	The table points are the torque maxima of the linear dq model
+*				psi_d = Ld*id + Ke, psi_q = Lq*iq
+*				T ~ iq*(Ke + (Ld - Lq)*id)
+*			within the current circle of the requested magnitude and the
+*			steady state voltage limit
+*				|Rs*i + j*w*psi| <= U
+*			at the speed the flux of the column gives at the nominal voltage.
+*			The speed loop interpolates them bilinearly.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "motor_mtpa.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Steady state stator voltage of a dq current
+
+@param[in]		pParam	Motor parameters
+@param[in]		fltId	d-axis current [A]
+@param[in]		fltIq	q-axis current [A]
+@param[in]		fltW	Electrical speed [rad/s]
+
+@return			Voltage magnitude [V]
+******************************************************************************/
+static tFloat MTPA_Volt(const motorParam_t *pParam, tFloat fltId, tFloat fltIq, tFloat fltW)
+{
+	tFloat	uD, uQ;
+
+	uD = MLIB_Sub(MLIB_Mul(pParam->rs, fltId), MLIB_Mul(MLIB_Mul(fltW, pParam->lq), fltIq));
+	uQ = MLIB_Add(MLIB_Mul(pParam->rs, fltIq), MLIB_Mul(fltW, MLIB_Add(MLIB_Mul(pParam->ld, fltId), pParam->ke)));
+
+	return (GFLIB_Sqrt(MLIB_Add(MLIB_Mul(uD, uD), MLIB_Mul(uQ, uQ))));
+}
+
+/**************************************************************************//*!
+@brief			q-axis current on the current circle
+
+@param[in]		fltI	Current magnitude [A]
+@param[in]		fltId	d-axis current [A]
+
+@return			Non-negative q-axis current [A]
+******************************************************************************/
+static tFloat MTPA_CircleIq(tFloat fltI, tFloat fltId)
+{
+	tFloat	iq2;
+
+	iq2 = MLIB_Sub(MLIB_Mul(fltI, fltI), MLIB_Mul(fltId, fltId));
+
+	return ((iq2 > 0.0F) ? GFLIB_Sqrt(iq2) : 0.0F);
+}
+
+/**************************************************************************//*!
+@brief			d-axis current of the least flux on the current circle
+
+@param[in]		pParam	Motor parameters
+@param[in]		fltI	Current magnitude [A]
+
+@return			-fltI, or the flux minimum inside the circle when Ld > Lq
+******************************************************************************/
+static tFloat MTPA_CircleIdMin(const motorParam_t *pParam, tFloat fltI)
+{
+	tFloat	idMin;
+
+	if (pParam->ld > pParam->lq)
+	{
+		idMin = MLIB_Neg(MLIB_Div(MLIB_Mul(pParam->ld, pParam->ke),
+								  MLIB_Sub(MLIB_Mul(pParam->ld, pParam->ld), MLIB_Mul(pParam->lq, pParam->lq))));
+		if (idMin > MLIB_Neg(fltI))
+		{
+			return (idMin);
+		}
+	}
+
+	return (MLIB_Neg(fltI));
+}
+
+/**************************************************************************//*!
+@brief			MTPA d-axis current
+
+@param[in]		pParam	Motor parameters
+@param[in]		fltI	Current magnitude [A]
+
+@return			id = -2*(Lq - Ld)*i^2/(Ke + sqrt(Ke^2 + 8*(Lq - Ld)^2*i^2)), the
+				form free of the division by the saliency
+******************************************************************************/
+static tFloat MTPA_Id(const motorParam_t *pParam, tFloat fltI)
+{
+	tFloat	lDifI2;
+
+	lDifI2 = MLIB_Mul(MLIB_Sub(pParam->lq, pParam->ld), MLIB_Mul(fltI, fltI));
+
+	return (MLIB_Neg(MLIB_Div(MLIB_Mul(2.0F, lDifI2),
+							  MLIB_Add(pParam->ke, GFLIB_Sqrt(MLIB_Add(MLIB_Mul(pParam->ke, pParam->ke),
+																	   MLIB_Mul(MLIB_Mul(8.0F, lDifI2), MLIB_Sub(pParam->lq, pParam->ld))))))));
+}
+
+/**************************************************************************//*!
+@brief			Current of the most torque on a current circle
+
+@param[out]		pIDQ	dq current [A]
+@param[in]		pParam	Motor parameters
+@param[in]		fltI	Current magnitude [A]
+@param[in]		fltW	Electrical speed [rad/s]
+@param[in]		fltU	Voltage limit [V]
+
+@return			Torque over 1.5*pp [Nm/pp], less than zero the voltage the
+				least flux point lacks, pIDQ is then that point
+
+@details		MTPA when its voltage fits, else the point of the voltage limit
+				next to it by bisection; the voltage falls along the circle
+				from MTPA towards the least flux point.
+******************************************************************************/
+static tFloat MTPA_Circle(SWLIBS_2Syst_FLT *pIDQ, const motorParam_t *pParam, tFloat fltI, tFloat fltW, tFloat fltU)
+{
+	tFloat	u, idHigh, idLow, idMid;
+	tU16	cnt;
+
+	idHigh	= MTPA_Id(pParam, fltI);
+	idLow	= MTPA_CircleIdMin(pParam, fltI);
+	u		= MTPA_Volt(pParam, idLow, MTPA_CircleIq(fltI, idLow), fltW);
+
+	if (MTPA_Volt(pParam, idHigh, MTPA_CircleIq(fltI, idHigh), fltW) <= fltU)
+	{
+		idLow = idHigh;
+	}
+	else if (u > fltU)
+	{
+		pIDQ->fltArg1 = idLow;
+		pIDQ->fltArg2 = MTPA_CircleIq(fltI, idLow);
+		return (MLIB_Sub(fltU, u));
+	}
+	else
+	{
+		for (cnt = 0U; cnt < MTPA_BISECT_CNT; cnt++)
+		{
+			idMid = MLIB_Mul(MLIB_Add(idLow, idHigh), 0.5F);
+			if (MTPA_Volt(pParam, idMid, MTPA_CircleIq(fltI, idMid), fltW) <= fltU)
+			{
+				idLow = idMid;
+			}
+			else
+			{
+				idHigh = idMid;
+			}
+		}
+	}
+
+	pIDQ->fltArg1 = idLow;
+	pIDQ->fltArg2 = MTPA_CircleIq(fltI, idLow);
+
+	return (MLIB_Mul(pIDQ->fltArg2, MLIB_Add(pParam->ke, MLIB_Mul(MLIB_Sub(pParam->ld, pParam->lq), pIDQ->fltArg1))));
+}
+
+/**************************************************************************//*!
+@brief			Current of the most torque for a magnitude and a flux
+
+@param[out]		pIDQ	dq current, q-axis current of positive torque [A]
+@param[in]		pParam	Motor parameters
+@param[in]		fltI	Current magnitude [A]
+@param[in]		fltPsi	Flux the voltage allows [Vs/rad]
+@param[in]		fltU	Voltage the flux is exact for [V]
+
+@details		The speed of the flux at fltU counts the resistive drop in. The
+				best point of the circle fltI, MTPA or field weakening, is the
+				answer unless a smaller circle gives more torque at the voltage
+				limit (MTPV); the torque of the circles is searched by golden
+				section.
+******************************************************************************/
+static void MTPA_Point(SWLIBS_2Syst_FLT *pIDQ, const motorParam_t *pParam, tFloat fltI, tFloat fltPsi, tFloat fltU)
+{
+	SWLIBS_2Syst_FLT	iDQ;
+	tFloat				w, t, tBest, rLow, rHigh, r1, r2, t1, t2;
+	tU16				cnt;
+
+	if ((fltI <= 0.0F) || (fltPsi <= 0.0F))
+	{
+		pIDQ->fltArg1 = (fltI <= 0.0F) ? 0.0F : MLIB_Neg(MLIB_Div(pParam->ke, pParam->ld));
+		if (pIDQ->fltArg1 < MLIB_Neg(fltI))
+		{
+			pIDQ->fltArg1 = MLIB_Neg(fltI);
+		}
+		pIDQ->fltArg2 = 0.0F;
+		return;
+	}
+
+	// MTPA when it fits, the most torque of all circles up to fltI
+	w				= MLIB_Div(fltU, fltPsi);
+	pIDQ->fltArg1	= MTPA_Id(pParam, fltI);
+	pIDQ->fltArg2	= MTPA_CircleIq(fltI, pIDQ->fltArg1);
+	if (MTPA_Volt(pParam, pIDQ->fltArg1, pIDQ->fltArg2, w) <= fltU)
+	{
+		return;
+	}
+	tBest = MTPA_Circle(pIDQ, pParam, fltI, w, fltU);
+
+	rLow	= 0.0F;
+	rHigh	= fltI;
+	r1		= MLIB_Sub(rHigh, MLIB_Mul(MTPA_GOLDEN, rHigh));
+	r2		= MLIB_Mul(MTPA_GOLDEN, rHigh);
+	t1		= MTPA_Circle(&iDQ, pParam, r1, w, fltU);
+	t2		= MTPA_Circle(&iDQ, pParam, r2, w, fltU);
+	for (cnt = 0U; cnt < MTPA_GOLDEN_CNT; cnt++)
+	{
+		if (t1 < t2)
+		{
+			rLow	= r1;
+			r1		= r2;
+			t1		= t2;
+			r2		= MLIB_Add(rLow, MLIB_Mul(MTPA_GOLDEN, MLIB_Sub(rHigh, rLow)));
+			t2		= MTPA_Circle(&iDQ, pParam, r2, w, fltU);
+		}
+		else
+		{
+			rHigh	= r2;
+			r2		= r1;
+			t2		= t1;
+			r1		= MLIB_Sub(rHigh, MLIB_Mul(MTPA_GOLDEN, MLIB_Sub(rHigh, rLow)));
+			t1		= MTPA_Circle(&iDQ, pParam, r1, w, fltU);
+		}
+	}
+
+	t = MTPA_Circle(&iDQ, pParam, MLIB_Mul(MLIB_Add(rLow, rHigh), 0.5F), w, fltU);
+	if (t > tBest)
+	{
+		*pIDQ = iDQ;
+	}
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			No table yet, the build is requested
+
+@param[out]		ptr			Table structure
+@param[in]		fltIMax		Current magnitude range, the speed controller limit [A]
+@param[in]		fltUmaxNom	Current loop voltage limit the resistive drop is exact for [V]
+******************************************************************************/
+void MTPA_Init(mtpaMotor_t *ptr, tFloat fltIMax, tFloat fltUmaxNom)
+{
+	ptr->iMax		= fltIMax;
+	ptr->uMaxNom	= fltUmaxNom;
+	ptr->request	= TRUE;
+	ptr->valid		= FALSE;
+	ptr->error		= FALSE;
+}
+
+/**************************************************************************//*!
+@brief			Builds the table from the motor parameters
+
+@param[in,out]	ptr		Table structure, iMax and uMaxNom in
+@param[in]		pParam	Motor parameters
+
+@return			FALSE when a parameter, iMax or uMaxNom is not positive or the
+				resistive drop of iMax takes the whole voltage, the table is
+				then not usable
+
+@details		The flux range ends where the MTPA point of iMax reaches the
+				voltage limit and starts where its least flux point does, or at
+				zero when iMax reaches the centre of the voltage ellipse. With
+				the point's flux a and drop b per speed
+					|R*i + w*a| = U
+				gives w from a quadratic.
+******************************************************************************/
+tBool MTPA_Build(mtpaMotor_t *ptr, const motorParam_t *pParam)
+{
+	SWLIBS_2Syst_FLT	iDQ, psiDQ;
+	tFloat				u, a, b, c, psi, i;
+	tU16				k, n, cnt;
+
+	if ((pParam->rs <= 0.0F) || (pParam->ld <= 0.0F) || (pParam->lq <= 0.0F) ||
+		(pParam->ke <= 0.0F) || (ptr->iMax <= 0.0F) || (ptr->uMaxNom <= 0.0F))
+	{
+		return (FALSE);
+	}
+
+	u	= MLIB_Mul(MTPA_U_MARGIN, ptr->uMaxNom);
+	c	= MLIB_Sub(MLIB_Mul(MLIB_Mul(pParam->rs, ptr->iMax), MLIB_Mul(pParam->rs, ptr->iMax)), MLIB_Mul(u, u));
+	if (c >= 0.0F)
+	{
+		return (FALSE);
+	}
+
+	for (cnt = 0U; cnt < 2U; cnt++)
+	{
+		iDQ.fltArg1		= (cnt == 0U) ? MTPA_Id(pParam, ptr->iMax) : MTPA_CircleIdMin(pParam, ptr->iMax);
+		iDQ.fltArg2		= MTPA_CircleIq(ptr->iMax, iDQ.fltArg1);
+		psiDQ.fltArg1	= MLIB_Add(MLIB_Mul(pParam->ld, iDQ.fltArg1), pParam->ke);
+		psiDQ.fltArg2	= MLIB_Mul(pParam->lq, iDQ.fltArg2);
+
+		// a*w^2 + 2*b*w + c = 0
+		a	= MLIB_Add(MLIB_Mul(psiDQ.fltArg1, psiDQ.fltArg1), MLIB_Mul(psiDQ.fltArg2, psiDQ.fltArg2));
+		b	= MLIB_Mul(pParam->rs, MLIB_Sub(MLIB_Mul(iDQ.fltArg2, psiDQ.fltArg1), MLIB_Mul(iDQ.fltArg1, psiDQ.fltArg2)));
+		psi	= 0.0F;
+		if (a > 0.0F)
+		{
+			psi = MLIB_Div(MLIB_Mul(u, a), MLIB_Sub(GFLIB_Sqrt(MLIB_Sub(MLIB_Mul(b, b), MLIB_Mul(a, c))), b));
+		}
+
+		if (cnt == 0U)
+		{
+			ptr->psiHigh	= psi;
+		}
+		else
+		{
+			ptr->psiLow		= (MLIB_Mul(pParam->ld, ptr->iMax) < pParam->ke) ? psi : 0.0F;
+		}
+	}
+	if (ptr->psiHigh <= ptr->psiLow)
+	{
+		return (FALSE);
+	}
+
+	ptr->iStepInv	= MLIB_Div((tFloat)(MTPA_I_PTS - 1U), ptr->iMax);
+	ptr->psiStepInv	= MLIB_Div((tFloat)(MTPA_PSI_PTS - 1U), MLIB_Sub(ptr->psiHigh, ptr->psiLow));
+
+	for (k = 0U; k < MTPA_PSI_PTS; k++)
+	{
+		psi = MLIB_Add(ptr->psiLow, MLIB_Div((tFloat)k, ptr->psiStepInv));
+		for (n = 0U; n < MTPA_I_PTS; n++)
+		{
+			i = MLIB_Div((tFloat)n, ptr->iStepInv);
+			MTPA_Point(&iDQ, pParam, i, psi, u);
+			ptr->id[k][n] = iDQ.fltArg1;
+			ptr->iq[k][n] = iDQ.fltArg2;
+		}
+	}
+
+	return (TRUE);
+}
+
+/**************************************************************************//*!
+@brief			Background loop part, builds a requested table
+
+@param[in,out]	ptr		Table structure
+@param[in]		pParam	Motor parameters
+
+@details		valid is cleared for the build, the speed loop interrupting it
+				keeps to the plain field weakening loop meanwhile.
+******************************************************************************/
+void MTPA_Background(mtpaMotor_t *ptr, const motorParam_t *pParam)
+{
+	if (ptr->request)
+	{
+		ptr->request	= FALSE;
+		ptr->valid		= FALSE;
+		ptr->error		= !MTPA_Build(ptr, pParam);
+		ptr->valid		= !ptr->error;
+	}
+}
+
+/**************************************************************************//*!
+@brief			Bilinear table interpolation
+
+@param[out]		pIDQ		dq current, q-axis current of positive torque [A]
+@param[in]		ptr			Table structure, valid
+@param[in]		fltI		Current magnitude [A]
+@param[in]		fltUAvail	Voltage for the back-EMF [V]
+@param[in]		fltW		Absolute electrical speed [rad/s]
+@param[in]		bFieldWeak	FALSE takes the MTPA column only
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+static void MTPA_Interp(SWLIBS_2Syst_FLT *pIDQ, const mtpaMotor_t *ptr, tFloat fltI, tFloat fltUAvail, tFloat fltW,
+						tBool bFieldWeak)
+{
+	tFloat	xI, xPsi, id0, id1, iq0, iq1;
+	tU16	n, k;
+
+	// Row, the magnitude beyond iMax takes the last one
+	xI = MLIB_Mul(fltI, ptr->iStepInv);
+	if (xI >= (tFloat)(MTPA_I_PTS - 1U))
+	{
+		n	= MTPA_I_PTS - 2U;
+		xI	= 1.0F;
+	}
+	else
+	{
+		n	= (tU16)xI;
+		xI	= MLIB_Sub(xI, (tFloat)n);
+	}
+
+	// Column, compared in voltage to keep the division away from standstill
+	if (!bFieldWeak || (fltUAvail >= MLIB_Mul(ptr->psiHigh, fltW)))
+	{
+		k		= MTPA_PSI_PTS - 2U;
+		xPsi	= 1.0F;
+	}
+	else if (fltUAvail <= MLIB_Mul(ptr->psiLow, fltW))
+	{
+		k		= 0U;
+		xPsi	= 0.0F;
+	}
+	else
+	{
+		xPsi	= MLIB_Mul(MLIB_Sub(MLIB_Div(fltUAvail, fltW), ptr->psiLow), ptr->psiStepInv);
+		k		= (tU16)xPsi;
+		if (k > (MTPA_PSI_PTS - 2U))
+		{
+			k	= MTPA_PSI_PTS - 2U;
+		}
+		xPsi	= MLIB_Sub(xPsi, (tFloat)k);
+	}
+
+	id0				= MLIB_Add(ptr->id[k][n], MLIB_Mul(xI, MLIB_Sub(ptr->id[k][n + 1U], ptr->id[k][n])));
+	id1				= MLIB_Add(ptr->id[k + 1U][n], MLIB_Mul(xI, MLIB_Sub(ptr->id[k + 1U][n + 1U], ptr->id[k + 1U][n])));
+	iq0				= MLIB_Add(ptr->iq[k][n], MLIB_Mul(xI, MLIB_Sub(ptr->iq[k][n + 1U], ptr->iq[k][n])));
+	iq1				= MLIB_Add(ptr->iq[k + 1U][n], MLIB_Mul(xI, MLIB_Sub(ptr->iq[k + 1U][n + 1U], ptr->iq[k + 1U][n])));
+	pIDQ->fltArg1	= MLIB_Add(id0, MLIB_Mul(xPsi, MLIB_Sub(id1, id0)));
+	pIDQ->fltArg2	= MLIB_Add(iq0, MLIB_Mul(xPsi, MLIB_Sub(iq1, iq0)));
+}
+
+/**************************************************************************//*!
+@brief			dq current references from the speed and field weakening loop
+
+@param[in]		ptr			Table structure, valid
+@param[in,out]	pIDQReq		Output of AMCLIB_FWSpeedLoop_FLT in, references out
+@param[in]		fltWRotEl	Electrical speed [rad/s]
+@param[in]		fltUmax		Voltage limit of the current loop [V]
+@param[in]		bFieldWeak	FALSE takes the MTPA column only
+
+@details		The magnitude of pIDQReq is the speed controller output, its
+				angle from the q-axis the field weakening controller trim; the
+				table vector of that magnitude and the speed's flux is turned
+				by the trim.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+void MTPA_Update(const mtpaMotor_t *ptr, SWLIBS_2Syst_FLT *pIDQReq, tFloat fltWRotEl, tFloat fltUmax,
+				 tBool bFieldWeak)
+{
+	SWLIBS_2Syst_FLT	iDQ;
+	tFloat				i, trimCos, trimSin, iq;
+
+	i = GFLIB_Sqrt(MLIB_Add(MLIB_Mul(pIDQReq->fltArg1, pIDQReq->fltArg1), MLIB_Mul(pIDQReq->fltArg2, pIDQReq->fltArg2)));
+	if (i <= 0.0F)
+	{
+		return;
+	}
+	trimCos = MLIB_Div(MLIB_Abs(pIDQReq->fltArg2), i);
+	trimSin = MLIB_Div(pIDQReq->fltArg1, i);
+
+	MTPA_Interp(&iDQ, ptr, i, MLIB_Mul(MTPA_U_MARGIN, fltUmax), MLIB_Abs(fltWRotEl), bFieldWeak);
+
+	// Trim turns the table vector towards the negative d-axis, not beyond it
+	iq = MLIB_Sub(MLIB_Mul(iDQ.fltArg2, trimCos), MLIB_Mul(iDQ.fltArg1, trimSin));
+	if (iq < 0.0F)
+	{
+		iq = 0.0F;
+	}
+	pIDQReq->fltArg1 = MLIB_Add(MLIB_Mul(iDQ.fltArg1, trimCos), MLIB_Mul(iDQ.fltArg2, trimSin));
+	pIDQReq->fltArg2 = (pIDQReq->fltArg2 < 0.0F) ? MLIB_Neg(iq) : iq;
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_mtpa.h
+*
+* @date     April-18-2017
+*
+* @brief    Header file for the MTPA and field weakening current reference table
+*
+*******************************************************************************/
+#ifndef MOTOR_MTPA_H_
+#define MOTOR_MTPA_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "motor_tune.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* MOTOR_MTPA	dq current references of the speed loop
+ *		0	the speed controller output is the q-axis current, the field
+ *			weakening controller turns it towards the negative d-axis when the
+ *			q-axis voltage runs out
+ *		1	the speed controller output is the current magnitude, a table over
+ *			the magnitude and the flux the voltage allows at the speed gives
+ *			the dq currents of the most torque: MTPA, field weakening along the
+ *			current limit and MTPV. The field weakening controller only turns
+ *			the table vector further, it covers the model error and the
+ *			voltage margin MTPA_U_MARGIN. The table is built from
+ *			motorTune.param in the background loop whenever request is set.
+ * Only in the closed loop position modes, the open loop start-up and tracking
+ * keep the plain speed loop. */
+#ifndef MOTOR_MTPA
+#define MOTOR_MTPA				0
+#endif
+
+#define MTPA_I_PTS				9U			// table points over the current magnitude
+#define MTPA_PSI_PTS			17U			// table points over the flux
+#define MTPA_U_MARGIN			(0.95F)		// share of the current loop voltage limit the table plans with
+#define MTPA_UDCB_NOM			(12.0F)		// DC bus voltage the resistive drop of the table is exact for [V]
+#define MTPA_BISECT_CNT			24U			// bisection steps of the field weakening points
+#define MTPA_GOLDEN_CNT			20U			// golden section steps of the MTPV points
+#define MTPA_GOLDEN				(0.618034F)	// golden section ratio
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  MTPA and field weakening current reference table
+
+@details	Rows are current magnitudes from 0 to iMax, columns the flux the
+			voltage allows from psiLow, the flux of iMax along the negative
+			d-axis, to psiHigh, the flux of the MTPA point at iMax; above it
+			every row is MTPA. The flux of a speed is
+				psi = MTPA_U_MARGIN*Umax/|wEl|
+			the resistive drop is counted in at uMaxNom, at another DC bus
+			voltage the field weakening controller covers its difference.
+			The tables hold the q-axis current of positive torque, the
+			negative torque is the mirror image.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							iMax;			// current magnitude range of the table [A]
+	tFloat							uMaxNom;		// current loop voltage limit at MTPA_UDCB_NOM [V]
+	tBool							request;		// build the table
+	tBool							valid;			// table built, used by the speed loop
+	tBool							error;			// last build rejected
+	tFloat							iStepInv;		// rows per ampere [1/A]
+	tFloat							psiLow;			// flux of the first column [Vs/rad]
+	tFloat							psiHigh;		// flux of the last column [Vs/rad]
+	tFloat							psiStepInv;		// columns per flux [rad/Vs]
+	tFloat							id[MTPA_PSI_PTS][MTPA_I_PTS];	// d-axis current [A]
+	tFloat							iq[MTPA_PSI_PTS][MTPA_I_PTS];	// q-axis current [A]
+}mtpaMotor_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void MTPA_Init(mtpaMotor_t *ptr, tFloat fltIMax, tFloat fltUmaxNom);
+extern tBool MTPA_Build(mtpaMotor_t *ptr, const motorParam_t *pParam);
+extern void MTPA_Background(mtpaMotor_t *ptr, const motorParam_t *pParam);
+extern void MTPA_Update(const mtpaMotor_t *ptr, SWLIBS_2Syst_FLT *pIDQReq, tFloat fltWRotEl, tFloat fltUmax,
+						tBool bFieldWeak);
+
+#endif /* MOTOR_MTPA_H_ */
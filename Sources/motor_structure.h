@@ -24,6 +24,15 @@
 #include "state_machine.h"
 #include "amclib.h"
 #include "actuate_s32k.h"
+#include "meas_s32k.h"
+#include "pospe_sensor.h"
+#include "pospe_ipd.h"
+#include "pospe_hfi.h"
+#include "motor_ident.h"
+#include "motor_tune.h"
+#include "motor_mtpa.h"
+#include "cloop_deadbeat.h"
+#include "tpp/tpp.h"
 
 /******************************************************************************
 | Defines and macros            (scope: module-local)
@@ -47,8 +56,106 @@
 #define FW_FACTOR				1.04
 // Required speed limit can be increased by field weakening factor FW_FACTOR
 #define SPEED_FW_RAD			(float)(SPEED_NOM_RAD*FW_FACTOR)
+// Current controller output limit, ratio to the inscribed circle of the voltage hexagon
+#if ACTUATE_OVERMODULATION
+#define FOC_CLOOP_LIMIT			ACTUATE_OVM_LIMIT
+#else
+#define FOC_CLOOP_LIMIT			CLOOP_LIMIT
+#endif
 // Required speed limit is reduced to half due to reduced DC bus voltage from 24V to 12V
+#if ACTUATE_OVERMODULATION
+// and increased by the voltage gained by the overmodulation
+#define SPEED_LIM_RAD			(float)(SPEED_FW_RAD/2.0F*(FOC_CLOOP_LIMIT/CLOOP_LIMIT))
+#else
 #define SPEED_LIM_RAD			(float)(SPEED_FW_RAD/2.0F)
+#endif
+
+// Open loop speeds where the back-EMF observer starts tracking and the sensorless control takes over [rpm]
+#if ACTUATE_DEADTIME_COMP
+// lowered by a third, the dead-time compensation keeps the estimated back-EMF accurate at lower speeds
+#define FOC_MERG_SPEED_1		(MERG_SPEED_1_TRH*(2.0F/3.0F))
+#define FOC_MERG_SPEED_2		(MERG_SPEED_2_TRH*(2.0F/3.0F))
+#else
+#define FOC_MERG_SPEED_1		MERG_SPEED_1_TRH
+#define FOC_MERG_SPEED_2		MERG_SPEED_2_TRH
+#endif
+
+/* FOC_ANGLE_MERGE	open loop to sensorless transition at FOC_MERG_SPEED_2
+ *		0	the control angle jumps from the open loop angle to the estimated one
+ *		1	the control angle keeps the open loop angle at the transition and
+ *			merges into the estimated one, the difference decays with the time
+ *			constant FOC_MERGE_TAU; the speed loop takes over the open loop
+ *			current in the same frame, so neither the angle nor the current
+ *			reference steps. A difference above FOC_MERGE_MAX is taken at once
+ *			down to FOC_MERGE_MAX, the open loop frame is no use for the torque
+ *			when the rotor has fallen far behind it */
+#ifndef FOC_ANGLE_MERGE
+#define FOC_ANGLE_MERGE			0
+#endif
+
+#ifndef FOC_MERGE_TAU
+#define FOC_MERGE_TAU			(5.0F)		// time constant of the angle merge [ms]
+#endif
+#ifndef FOC_MERGE_MAX
+#define FOC_MERGE_MAX			(0.5F)		// largest angle difference merged [rad]
+#endif
+#define FOC_MERGE_DECAY			(1.0F - (tFloat)FOC_PERIOD_US/(1000.0F*FOC_MERGE_TAU))	// per control loop
+
+/* FOC_FLYING_START	start of a coasting motor
+ *		0	every start aligns the rotor and ramps the open loop up from standstill
+ *		1	a restart keeps the current offsets of the first calibration; after a
+ *			stop of the run state above FOC_MERG_SPEED_1 or a fault clear the
+ *			alignment state controls zero current for FOC_CATCH_DURATION first,
+ *			the back-EMF and tracking observers estimate the rotor meanwhile;
+ *			above FOC_MERG_SPEED_2 the run state takes over in sensorless mode
+ *			with the speed loop loaded from the estimate, else the start
+ *			continues with the alignment
+ * The catch runs in the automatic speed control mode with the sensorless
+ * position only. */
+#ifndef FOC_FLYING_START
+#define FOC_FLYING_START		0
+#endif
+
+#define FOC_CATCH_DURATION		(200)	// zero current control before the decision [MCAT control loops]
+
+/* FOC_ANGLE_ADVANCE	angle of the inverse Park transformation
+ *		0	the voltage is transformed with the angle of the current feedback
+ *		1	the angle is advanced by wRotEl*FOC_ADVANCE_DELAY control loops:
+ *			the current is sampled at the end of the first PWM period of the
+ *			loop, the voltage is written at the next PDB1 overflow and held
+ *			over the following control loop, its mean is applied 1.5 loops
+ *			less one PWM period after the sample, 1.33 loops at 6 PWM periods
+ *			per loop. Without it the applied dq voltage lags the requested
+ *			one by that angle, at high speed the current controllers and the
+ *			field weakening work against the rotation.
+ *			The dead-time compensation takes the current direction at the
+ *			advanced angle too, the POSPE_HFI injection stays at the
+ *			feedback angle it is demodulated with
+ * Only in the current and speed control modes with the rotor angle. */
+#ifndef FOC_ANGLE_ADVANCE
+#define FOC_ANGLE_ADVANCE		0
+#endif
+
+#ifndef FOC_ADVANCE_DELAY
+#define FOC_ADVANCE_DELAY		(1.5F - 1.0F/(tFloat)FOC_PWM_PERIODS)	// current sample to the mean voltage application [control loops]
+#endif
+#define FOC_ADVANCE_TS			(FOC_ADVANCE_DELAY*(tFloat)FOC_PERIOD_US*1.0e-6F)	// [s]
+
+/* PMSM_AXIS_CNT	Number of PMSM axes, every axis has its own pmsmAxis_t drive context
+ *		1	FTM3 + PDB1 + ADC1, the MTRDEVKSPNK144 inverter with the MC34GD3000
+ * Only the drive context is per axis; a further axis needs its inverter, pins,
+ * FTM/PDB/ADC/eDMA configuration in Generated_Code and peripherals_config.c,
+ * its pmsmAxis initializer and its PDB, ADC and reload ISRs. */
+#ifndef PMSM_AXIS_CNT
+#define PMSM_AXIS_CNT			1
+#endif
+
+#if PMSM_AXIS_CNT != 1
+#error "PMSM_AXIS_CNT: only the FTM3, PDB1 and ADC1 axis is configured"
+#endif
+
+#define PMSM_AXIS_FTM3			0		// index of the FTM3 + PDB1 + ADC1 axis
+#define PMSM_AXIS_BOARD			PMSM_AXIS_FTM3	// axis of the board buttons, RGB LED and FreeMASTER names
 
 /******************************************************************************
 | Typedefs and structures       (scope: module-local)
@@ -80,6 +187,9 @@ typedef struct
 	tFloat							iQUpperLimit;
 	tFloat							iQLowerLimit;
 	tFloat							thDifOpenLEstim;
+#if FOC_ANGLE_MERGE
+	tFloat							thDifMerge;		// open loop to estimated angle, decays after the transition
+#endif
 }openLoopPospe_t;
 
 typedef struct
@@ -107,6 +217,9 @@ typedef struct
 typedef struct{
 	tU16        		            alignCntr;		// Alignment duration
 	tFloat        		            alignVoltage;	// Alignment voltage
+#if FOC_FLYING_START
+	tU16							catchCntr;		// Zero current control of the flying start
+#endif
     tU16		                    svmSector;      // Space Vector Modulation sector
     SWLIBS_2Syst_FLT                iDQFbck;        // dq - axis current feedback
     SWLIBS_2Syst_FLT                iAlBeFbck;      // Alpha/Beta - axis current feedback
@@ -114,6 +227,7 @@ typedef struct{
     SWLIBS_2Syst_FLT                iDQReqOutLoop;  // dq - axis required currents, FOC Outer Loop (Speed Loop & Field Weakening) output
 	SWLIBS_2Syst_FLT                uDQReq;         // dq - axis required voltages given by current PIs
     SWLIBS_2Syst_FLT                uAlBeReq;       // Alpha/Beta required voltages
+    SWLIBS_2Syst_FLT                uAlBeReqDTC;    // Alpha/Beta required voltages with the dead-time compensation
     SWLIBS_2Syst_FLT                uAlBeReqDCB;    // Alpha/Beta required voltages after DC Bus ripple elimination
     SWLIBS_2Syst_FLT                uAlBeReqDCBLim; // Alpha/Beta required voltages after DC Bus ripple elimination with limits
     SWLIBS_2Syst_FLT				uAlBEReqDCBTest;
@@ -127,9 +241,25 @@ typedef struct{
     tFloat							fltIdcb;		// DC bus voltage
     openLoopPospe_t					pospeOpenLoop;	// Open Loop Position generator
     sensorLessPospe_t				pospeSensorless;// Sensorless position and speed including open loop matching
+#if POSPE_IPD
+    ipdPospe_t						pospeIpd;		// Initial position detection
+#endif
+#if POSPE_HFI
+    hfiPospe_t						pospeHfi;		// High frequency injection position estimator
+#endif
+#if MOTOR_IDENT
+    identMotor_t					motorIdent;		// Motor parameter identification
+#endif
+    tuneMotor_t						motorTune;		// Control gain synthesis
+#if MOTOR_MTPA
+    mtpaMotor_t						motorMtpa;		// MTPA and field weakening current references
+#endif
     pospeControl_t                  pospeControl;   // Position/Speed variables needed for control
     scalarControl_t					scalarControl;  // Scalar Control variables for MCAT purpose
     AMCLIB_CURRENT_LOOP_T_FLT 		CurrentLoop;	// Current loop function
+#if CLOOP_DEADBEAT
+    cloopDeadbeat_t					cloopDeadbeat;	// Deadbeat current controller replacing the CurrentLoop PI controllers
+#endif
     AMCLIB_FW_SPEED_LOOP_T_FLT		FwSpeedLoop;	// Speed loop plus field weakining function
     GFLIB_VECTORLIMIT_T_FLT 		AlBeReqDCBLim;	// limits for uAlBeReqDCB
 }pmsmDrive_t;
@@ -139,7 +269,8 @@ typedef enum
 	force	 		= 0,
 	tracking 		= 1,
 	sensorless1 	= 2,
-	encoder1     	= 3
+	encoder1     	= 3,
+	hfi				= 4
 }tPos_mode;
 
 typedef enum
@@ -255,7 +386,8 @@ typedef union
     	tU16 OverDCBusCurrent       : 1;   /* OverCurrent fault flag */
     	tU16 UnderDCBusVoltage      : 1;   /* Undervoltage fault flag */
     	tU16 OverDCBusVoltage       : 1;   /* Overvoltage fault flag */
-    	tU16 : 6;                          /* RESERVED */
+    	tU16 FastTripOverCurrent    : 1;   /* Hardware fast-trip over-current, FTM fault input */
+    	tU16 : 5;                          /* RESERVED */
     }B;
 }motorFaultStatus_t;
 
@@ -276,6 +408,50 @@ typedef struct
 	motorFaultStatus_t 		motor;
 }appFaultStatus_t;    /* Application fault status user type*/
 
+/*------------------------------------------------------------------------*//*!
+@brief  Drive context of one PMSM axis
+
+@details	Everything the control loop of an axis touches: the peripheral
+			bindings of its inverter (FTM, PDB and eDMA channel in pwm, the
+			ADC and its eDMA channel, the pre-driver) and the drive state.
+			The state functions, the fast and slow loops and the ISRs work on
+			the context passed to them only.
+*//*-------------------------------------------------------------------------*/
+typedef struct pmsmAxis_s
+{
+	actuatePwm_t		pwm;					// PWM actuator, FTM, PDB and eDMA channel bindings
+	ADC_Type			*adc;					// ADC triggered by the PDB pre-triggers
+	tU32				adcInst;				// SDK instance of the ADC
+	IRQn_Type			adcIrq;					// ADC conversion complete interrupt, runs the control loop
+	tU8					adcDmaChn;				// eDMA channel capturing the ADC results, see MEAS_ADC_DMA
+	tU32				pdbInst;				// SDK instance of the PDB
+	tpp_drv_config_t	*gd3000;				// MC34GD3000 pre-driver of the inverter, NULL if there is none
+
+	pmsmDrive_t			drvFOC;					// Field Oriented Control Variables
+	driveStates_t		cntrState;				// Responsible for stateMachine state propagation
+	smEventQueue_t		smEventQueue;			// Events posted to the state machine
+	appFaultStatus_t	tempfaults;				// Temporary faults to be indicated inhere
+	appFaultStatus_t	permFaults;				// Permanent faults to be indicated inhere
+	measModule_t		meas;					// Variables measured by ADC modules
+	tPos_mode			pos_mode;				// Variable defining position mode
+	switchSensor_t		switchSensor;			// Position sensor selector
+	encoderPospe_t		encoderPospe;			// Encoder position and speed
+	pdbStatus_t			pdbStatus;				// PDB sequence error tracking
+	tBool				statePWM;				// Status of the PWM update
+	tBool				fieldWeakOnOff;			// Enable/Disable Field Weakening
+	tBool				trackingToSensorless;	// Tracking mode entered, reset the loops once sensorless
+
+	// Open Loop and Closed loop speed ramp variants
+	volatile tFloat		OL_SpeedRampInc, CL_SpeedRampInc, CL_SpeedRampDec;
+	volatile tFloat		FW_PropGainControl, FW_IntegGainControl;
+	volatile tFloat		UDQVectorSum;
+}pmsmAxis_t;
+
+/******************************************************************************
+| Exported Variables
+-----------------------------------------------------------------------------*/
+extern pmsmAxis_t pmsmAxis[PMSM_AXIS_CNT];
+
 
 
 #endif /* _MOTOR_STRUCTURE */
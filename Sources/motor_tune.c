@@ -0,0 +1,223 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_tune.c
+*
+* @date     April-13-2017
+*
+* @brief    Control gain synthesis from the motor parameters
+*
+* @details	The MCAT design formulas evaluated on the target. The current
+*			and back-EMF observer controllers cancel the R/L plant to a
+*			second order loop, the tracking observer is a double integrator
+*			loop and the speed loop drives the inertia through the torque
+*			constant. The recurrent controllers use the trapezoidal
+*			integration of MCAT.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "motor_tune.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Recurrent PI controller coefficients of an R/L plant
+
+@param[out]		pCC1	CC1 = Kp + Ki*Ts/2
+@param[out]		pCC2	CC2 = -Kp + Ki*Ts/2
+@param[in]		r		Resistance [Ohm]
+@param[in]		l		Inductance [H]
+@param[in]		bw		Bandwidth [rad/s]
+@param[in]		xi		Damping
+@param[in]		ts		Period [s]
+******************************************************************************/
+static void TUNE_RlPi(tFloat *pCC1, tFloat *pCC2, tFloat r, tFloat l, tFloat bw, tFloat xi, tFloat ts)
+{
+	tFloat	kp, kiTs;
+
+	// Kp = 2*xi*w0*L - R, Ki = w0^2*L
+	kp		= MLIB_Sub(MLIB_Mul(MLIB_Mul(2.0F, xi), MLIB_Mul(bw, l)), r);
+	kiTs	= MLIB_Mul(MLIB_Mul(MLIB_Mul(bw, bw), l), MLIB_Mul(ts, 0.5F));
+
+	*pCC1	= MLIB_Add(kp, kiTs);
+	*pCC2	= MLIB_Sub(kiTs, kp);
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Motor and loop design of PMSM_appconfig.h, no design pending
+
+@param[out]		ptr		Synthesis structure
+******************************************************************************/
+void TUNE_Init(tuneMotor_t *ptr)
+{
+	ptr->param.rs		= TUNE_MOTOR_RS;
+	ptr->param.ld		= TUNE_MOTOR_LD;
+	ptr->param.lq		= TUNE_MOTOR_LQ;
+	ptr->param.ke		= TUNE_MOTOR_KE;
+	ptr->param.j		= TUNE_MOTOR_J;
+
+	ptr->spec.ts		= TUNE_TS;
+	ptr->spec.speedTs	= TUNE_SPEED_TS;
+	ptr->spec.cloopBw	= TUNE_CLOOP_BW;
+	ptr->spec.cloopXi	= TUNE_CLOOP_XI;
+	ptr->spec.bemfBw	= TUNE_BEMF_BW;
+	ptr->spec.bemfXi	= TUNE_BEMF_XI;
+	ptr->spec.toBw		= TUNE_TO_BW;
+	ptr->spec.toXi		= TUNE_TO_XI;
+	ptr->spec.speedBw	= TUNE_SPEED_BW;
+	ptr->spec.speedXi	= TUNE_SPEED_XI;
+
+	ptr->request		= FALSE;
+	ptr->pending		= FALSE;
+	ptr->loaded			= FALSE;
+	ptr->error			= FALSE;
+}
+
+/**************************************************************************//*!
+@brief			Gains of all loops from the motor parameters
+
+@param[out]		pGains	Synthesized coefficients, written only when valid
+@param[in]		pParam	Motor parameters
+@param[in]		pSpec	Loop dynamics
+
+@return			TRUE with pGains written, FALSE when a parameter is not
+				positive, a loop is too fast for its period or a current
+				controller would get a negative proportional gain
+
+@details		Current controllers, Kp = 2*xi*w0*L - R, Ki = w0^2*L
+				Back-EMF observer, the d-axis controller on both axes and
+					I_Gain = (2Ld - Ts*R)/(2Ld + Ts*R)
+					U_Gain = E_Gain = Ts/(2Ld + Ts*R), WI_Gain = Lq*U_Gain
+				Tracking observer, Kp = 2*xi*w0, Ki = w0^2, integrator Ts/2
+				Speed loop from the electrical speed error to the q-axis
+				current, with K = 1.5*pp^2*Ke/J
+					Kp = 2*xi*w0/K, Ki = w0^2/K, integral gain Ki*Ts/2
+				the field weakening controller takes the speed gains, the
+				MCAT choice.
+******************************************************************************/
+tBool TUNE_Design(tuneGains_t *pGains, const motorParam_t *pParam, const tuneSpec_t *pSpec)
+{
+	tuneGains_t	gains;
+	tFloat		den, kInv;
+
+	if ((pParam->rs <= 0.0F) || (pParam->ld <= 0.0F) || (pParam->lq <= 0.0F) ||
+		(pParam->ke <= 0.0F) || (pParam->j <= 0.0F) || (pSpec->ts <= 0.0F) || (pSpec->speedTs <= 0.0F) ||
+		(pSpec->cloopXi <= 0.0F) || (pSpec->bemfXi <= 0.0F) || (pSpec->toXi <= 0.0F) || (pSpec->speedXi <= 0.0F))
+	{
+		return (FALSE);
+	}
+
+	if ((pSpec->cloopBw <= 0.0F) || (MLIB_Mul(pSpec->cloopBw, pSpec->ts) > TUNE_BW_TS_MAX) ||
+		(pSpec->bemfBw <= 0.0F) || (MLIB_Mul(pSpec->bemfBw, pSpec->ts) > TUNE_BW_TS_MAX) ||
+		(pSpec->toBw <= 0.0F) || (MLIB_Mul(pSpec->toBw, pSpec->ts) > TUNE_BW_TS_MAX) ||
+		(pSpec->speedBw <= 0.0F) || (MLIB_Mul(pSpec->speedBw, pSpec->speedTs) > TUNE_BW_TS_MAX))
+	{
+		return (FALSE);
+	}
+
+	// Current loop
+	TUNE_RlPi(&gains.dCC1sc, &gains.dCC2sc, pParam->rs, pParam->ld, pSpec->cloopBw, pSpec->cloopXi, pSpec->ts);
+	TUNE_RlPi(&gains.qCC1sc, &gains.qCC2sc, pParam->rs, pParam->lq, pSpec->cloopBw, pSpec->cloopXi, pSpec->ts);
+
+	// Back-EMF observer
+	TUNE_RlPi(&gains.bemfCC1sc, &gains.bemfCC2sc, pParam->rs, pParam->ld, pSpec->bemfBw, pSpec->bemfXi, pSpec->ts);
+	den					= MLIB_Add(MLIB_Mul(2.0F, pParam->ld), MLIB_Mul(pSpec->ts, pParam->rs));
+	gains.bemfIGain		= MLIB_Div(MLIB_Sub(MLIB_Mul(2.0F, pParam->ld), MLIB_Mul(pSpec->ts, pParam->rs)), den);
+	gains.bemfUGain		= MLIB_Div(pSpec->ts, den);
+	gains.bemfEGain		= gains.bemfUGain;
+	gains.bemfWIGain	= MLIB_Mul(pParam->lq, gains.bemfUGain);
+
+	// A current loop slower than the R/L plant itself cannot be made by this controller
+	if ((MLIB_Sub(gains.dCC1sc, gains.dCC2sc) <= 0.0F) || (MLIB_Sub(gains.qCC1sc, gains.qCC2sc) <= 0.0F) ||
+		(MLIB_Sub(gains.bemfCC1sc, gains.bemfCC2sc) <= 0.0F))
+	{
+		return (FALSE);
+	}
+
+	// Tracking observer
+	gains.toCC1sc		= MLIB_Add(MLIB_Mul(MLIB_Mul(2.0F, pSpec->toXi), pSpec->toBw),
+								   MLIB_Mul(MLIB_Mul(pSpec->toBw, pSpec->toBw), MLIB_Mul(pSpec->ts, 0.5F)));
+	gains.toCC2sc		= MLIB_Sub(MLIB_Mul(MLIB_Mul(pSpec->toBw, pSpec->toBw), MLIB_Mul(pSpec->ts, 0.5F)),
+								   MLIB_Mul(MLIB_Mul(2.0F, pSpec->toXi), pSpec->toBw));
+	gains.toThetaGain	= MLIB_Mul(pSpec->ts, 0.5F);
+
+	// Speed loop
+	kInv					= MLIB_Div(pParam->j, MLIB_Mul(1.5F * MOTOR_PP * MOTOR_PP, pParam->ke));
+	gains.speedPropGain		= MLIB_Mul(MLIB_Mul(MLIB_Mul(2.0F, pSpec->speedXi), pSpec->speedBw), kInv);
+	gains.speedIntegGain	= MLIB_Mul(MLIB_Mul(MLIB_Mul(pSpec->speedBw, pSpec->speedBw), kInv),
+									   MLIB_Mul(pSpec->speedTs, 0.5F));
+
+	*pGains = gains;
+
+	return (TRUE);
+}
+
+/**************************************************************************//*!
+@brief			Loads synthesized gains into the control structures
+
+@param[in]		pGains			Synthesized coefficients
+@param[out]		pCurrentLoop	Current loop
+@param[out]		pBemfObsrv		DQ back-EMF observer
+@param[out]		pTrackObsrv		Tracking observer
+@param[out]		pFwSpeedLoop	Speed and field weakening loop
+
+@details		Only coefficients are written, limits and states are kept. To
+				be called from the control loop between two of its passes.
+******************************************************************************/
+void TUNE_Load(const tuneGains_t *pGains, AMCLIB_CURRENT_LOOP_T_FLT *pCurrentLoop,
+			   AMCLIB_BEMF_OBSRV_DQ_T_FLT *pBemfObsrv, AMCLIB_TRACK_OBSRV_T_FLT *pTrackObsrv,
+			   AMCLIB_FW_SPEED_LOOP_T_FLT *pFwSpeedLoop)
+{
+	pCurrentLoop->pPIrAWD.fltCC1sc			= pGains->dCC1sc;
+	pCurrentLoop->pPIrAWD.fltCC2sc			= pGains->dCC2sc;
+	pCurrentLoop->pPIrAWQ.fltCC1sc			= pGains->qCC1sc;
+	pCurrentLoop->pPIrAWQ.fltCC2sc			= pGains->qCC2sc;
+
+	pBemfObsrv->pParamD.fltCC1sc			= pGains->bemfCC1sc;
+	pBemfObsrv->pParamD.fltCC2sc			= pGains->bemfCC2sc;
+	pBemfObsrv->pParamQ.fltCC1sc			= pGains->bemfCC1sc;
+	pBemfObsrv->pParamQ.fltCC2sc			= pGains->bemfCC2sc;
+	pBemfObsrv->fltIGain					= pGains->bemfIGain;
+	pBemfObsrv->fltUGain					= pGains->bemfUGain;
+	pBemfObsrv->fltEGain					= pGains->bemfEGain;
+	pBemfObsrv->fltWIGain					= pGains->bemfWIGain;
+
+	pTrackObsrv->pParamPI.fltCC1sc			= pGains->toCC1sc;
+	pTrackObsrv->pParamPI.fltCC2sc			= pGains->toCC2sc;
+	pTrackObsrv->pParamInteg.fltC1			= pGains->toThetaGain;
+
+	pFwSpeedLoop->pPIpAWQ.fltPropGain		= pGains->speedPropGain;
+	pFwSpeedLoop->pPIpAWQ.fltIntegGain		= pGains->speedIntegGain;
+	pFwSpeedLoop->pPIpAWFW.fltPropGain		= pGains->speedPropGain;
+	pFwSpeedLoop->pPIpAWFW.fltIntegGain		= pGains->speedIntegGain;
+}
+
+/**************************************************************************//*!
+@brief			Background loop part, designs a requested set
+
+@param[in,out]	ptr		Synthesis structure
+
+@details		gains is written only with pending clear, the control loop
+				reads it only with pending set.
+******************************************************************************/
+void TUNE_Background(tuneMotor_t *ptr)
+{
+	if (ptr->request && !ptr->pending)
+	{
+		ptr->request	= FALSE;
+		ptr->error		= !TUNE_Design(&ptr->gains, &ptr->param, &ptr->spec);
+		ptr->pending	= !ptr->error;
+	}
+}
@@ -0,0 +1,146 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     motor_tune.h
+*
+* @date     April-13-2017
+*
+* @brief    Header file for the control gain synthesis from the motor parameters
+*
+*******************************************************************************/
+#ifndef MOTOR_TUNE_H_
+#define MOTOR_TUNE_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "amclib.h"
+#include "PMSM_apprate.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* Motor parameters of PMSM_appconfig.h, MCAT lists them as comments only */
+#define TUNE_MOTOR_RS			(0.56F)		// [Ohm]
+#define TUNE_MOTOR_LD			(0.000375F)	// [H]
+#define TUNE_MOTOR_LQ			(0.000435F)	// [H]
+#define TUNE_MOTOR_KE			(0.0135281F)	// [Vs/rad]
+#define TUNE_MOTOR_J			(0.12e-4F)	// [kgm2]
+
+/* Loop design of PMSM_appconfig.h, bandwidth [rad/s] and damping. The speed
+ * loop here drives J through the torque constant 1.5*pp*Ke, the MCAT 1Hz
+ * design assumes a 7.6 times lower torque gain: its gains are this design at
+ * 17.4rad/s and damping 2.77. The open loop start-up needs their current
+ * rise, a much slower speed loop loses the rotor before the merge. */
+#define TUNE_CLOOP_BW			(2.0F*FLOAT_PI*150.0F)
+#define TUNE_CLOOP_XI			(1.0F)
+#define TUNE_BEMF_BW			(2.0F*FLOAT_PI*150.0F)
+#define TUNE_BEMF_XI			(1.0F)
+#define TUNE_TO_BW				(2.0F*FLOAT_PI*25.0F)
+#define TUNE_TO_XI				(1.0F)
+#define TUNE_SPEED_BW			(17.375F)
+#define TUNE_SPEED_XI			(2.765F)
+
+/* Control loop and speed loop periods */
+#define TUNE_TS					((tFloat)FOC_PERIOD_US*1.0e-6F)
+#define TUNE_SPEED_TS			((tFloat)(FOC_RATE_CNT(SPEED_LOOP_CNTR)*FOC_PERIOD_US)*1.0e-6F)
+
+/* Largest bandwidth times period of a discrete loop design */
+#define TUNE_BW_TS_MAX			(0.5F)
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Physical motor parameters
+
+@details	ke is the permanent magnet flux linkage, the back-EMF amplitude
+			per electrical speed. j is the inertia of the rotor and what is
+			coupled to it.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							rs;				// stator resistance [Ohm]
+	tFloat							ld;				// d-axis inductance [H]
+	tFloat							lq;				// q-axis inductance [H]
+	tFloat							ke;				// flux linkage [Vs/rad]
+	tFloat							j;				// inertia [kgm2]
+}motorParam_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Requested loop dynamics, bandwidths [rad/s] and dampings
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							ts;				// control loop period [s]
+	tFloat							speedTs;		// speed loop period [s]
+	tFloat							cloopBw;		// current loop
+	tFloat							cloopXi;
+	tFloat							bemfBw;			// back-EMF observer
+	tFloat							bemfXi;
+	tFloat							toBw;			// tracking observer
+	tFloat							toXi;
+	tFloat							speedBw;		// speed and field weakening loop
+	tFloat							speedXi;
+}tuneSpec_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Synthesized coefficients, the form the AMCLIB structures take them
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							dCC1sc;			// d-axis current controller
+	tFloat							dCC2sc;
+	tFloat							qCC1sc;			// q-axis current controller
+	tFloat							qCC2sc;
+	tFloat							bemfCC1sc;		// back-EMF observer controllers
+	tFloat							bemfCC2sc;
+	tFloat							bemfIGain;		// back-EMF observer plant
+	tFloat							bemfUGain;
+	tFloat							bemfEGain;
+	tFloat							bemfWIGain;
+	tFloat							toCC1sc;		// tracking observer controller
+	tFloat							toCC2sc;
+	tFloat							toThetaGain;	// tracking observer integrator
+	tFloat							speedPropGain;	// speed and field weakening controllers
+	tFloat							speedIntegGain;
+}tuneGains_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Control gain synthesis
+
+@details	Setting request designs gains from param and spec in the
+			background loop. A valid design sets pending, the control loop
+			loads it at its start and clears pending; the controllers never
+			run with a half loaded set. request is ignored while pending, the
+			background loop owns gains only with pending clear. A rejected
+			design sets error and loads nothing. loaded keeps the set over
+			the initialization state.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	motorParam_t					param;			// motor of the design
+	tuneSpec_t						spec;			// loop dynamics of the design
+	tuneGains_t						gains;			// last valid design
+	tBool							request;		// design and load
+	tBool							pending;		// gains waiting for the control loop
+	tBool							loaded;			// gains loaded at least once
+	tBool							error;			// last design rejected
+}tuneMotor_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void TUNE_Init(tuneMotor_t *ptr);
+extern tBool TUNE_Design(tuneGains_t *pGains, const motorParam_t *pParam, const tuneSpec_t *pSpec);
+extern void TUNE_Load(const tuneGains_t *pGains, AMCLIB_CURRENT_LOOP_T_FLT *pCurrentLoop,
+					  AMCLIB_BEMF_OBSRV_DQ_T_FLT *pBemfObsrv, AMCLIB_TRACK_OBSRV_T_FLT *pTrackObsrv,
+					  AMCLIB_FW_SPEED_LOOP_T_FLT *pFwSpeedLoop);
+extern void TUNE_Background(tuneMotor_t *ptr);
+
+#endif /* MOTOR_TUNE_H_ */
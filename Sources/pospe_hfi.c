@@ -0,0 +1,131 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pospe_hfi.c
+*
+* @date     April-04-2017
+*
+* @brief    High frequency injection position estimator
+*
+* @details	Pulsating square wave injection on the estimated d-axis at half
+*			the control loop frequency. The voltage requested in a control
+*			loop is applied in the next one, the current difference of two
+*			control loops answers the injection of the one before, which has
+*			the sign of the current request. A single-shunt current sample
+*			is needed every control loop only, the injection does not change
+*			the sampling.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "pospe_hfi.h"
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Restarts the injection and the tracking from a known position
+
+@param[out]		ptr		Estimator structure, voltage, the tracking observer and
+						the speed filter parameters are kept
+@param[in]		thRotEl	Electrical position [rad]
+@param[in]		wRotEl	Electrical speed [rad/s]
+******************************************************************************/
+void POSPE_HfiInit(hfiPospe_t *ptr, tFloat thRotEl, tFloat wRotEl)
+{
+	ptr->injSign		= -1.0F;
+	ptr->settleCnt		= POSPE_HFI_SETTLE_CNT;
+	ptr->iAlBe_1.fltArg1	= 0.0F;
+	ptr->iAlBe_1.fltArg2	= 0.0F;
+	ptr->dIDQ_1.fltArg1	= 0.0F;
+	ptr->dIDQ_1.fltArg2	= 0.0F;
+	ptr->dIDQ.fltArg1	= 0.0F;
+	ptr->dIDQ.fltArg2	= 0.0F;
+	GFLIB_SinCos_FLT(thRotEl, &ptr->sinCos_1, GFLIB_SINCOS_DEFAULT_FLT);
+	ptr->sinCos_2		= ptr->sinCos_1;
+	ptr->phaseErr		= 0.0F;
+	ptr->thRotEl		= thRotEl;
+	ptr->wRotEl			= wRotEl;
+	ptr->wRotElFilt		= wRotEl;
+
+	AMCLIB_TrackObsrvInit_FLT(&ptr->TrackObsrv);
+	ptr->TrackObsrv.pParamPI.fltAcc			= wRotEl;
+	ptr->TrackObsrv.pParamInteg.fltState	= thRotEl;
+	ptr->SpeedFilter.fltAcc					= wRotEl;
+}
+
+/**************************************************************************//*!
+@brief			One control loop of the estimator
+
+@param[in,out]	ptr			Estimator structure
+@param[out]		pIDQFund	Fundamental current in the estimated frame [A]
+@param[in]		pIAlBe		Alpha/beta current of this control loop [A]
+@param[in]		pSinCos		Sine and cosine of the estimated position of this
+							control loop
+
+@return			d-axis voltage to add to the request of this control loop [V]
+
+@details		thRotEl, wRotEl and wRotElFilt are updated for the next control
+				loop.
+******************************************************************************/
+tFloat POSPE_HfiUpdate(hfiPospe_t *ptr, SWLIBS_2Syst_FLT *pIDQFund, const SWLIBS_2Syst_FLT *pIAlBe,
+					   const SWLIBS_2Syst_FLT *pSinCos)
+{
+	SWLIBS_2Syst_FLT	iAlBe, dIDQ;
+
+	// Sign of this request, the same as two control loops before
+	ptr->injSign = MLIB_Neg(ptr->injSign);
+
+	if (ptr->settleCnt == POSPE_HFI_SETTLE_CNT)
+	{
+		// No current of the last control loop after the start
+		ptr->iAlBe_1 = *pIAlBe;
+	}
+
+	// Fundamental current, mean of two control loops
+	iAlBe.fltArg1 = MLIB_Mul(MLIB_Add(pIAlBe->fltArg1, ptr->iAlBe_1.fltArg1), 0.5F);
+	iAlBe.fltArg2 = MLIB_Mul(MLIB_Add(pIAlBe->fltArg2, ptr->iAlBe_1.fltArg2), 0.5F);
+	GMCLIB_Park_FLT(pIDQFund, pSinCos, &iAlBe);
+
+	// Response to one injection step in the frame it was requested in, the difference is rotated, not the currents
+	iAlBe.fltArg1 = MLIB_Sub(pIAlBe->fltArg1, ptr->iAlBe_1.fltArg1);
+	iAlBe.fltArg2 = MLIB_Sub(pIAlBe->fltArg2, ptr->iAlBe_1.fltArg2);
+	GMCLIB_Park_FLT(&dIDQ, &ptr->sinCos_2, &iAlBe);
+	dIDQ.fltArg1 = MLIB_Mul(dIDQ.fltArg1, ptr->injSign);
+	dIDQ.fltArg2 = MLIB_Mul(dIDQ.fltArg2, ptr->injSign);
+
+	// Demodulation, the mean of two responses cancels the fundamental current slope
+	ptr->dIDQ.fltArg1 = MLIB_Mul(MLIB_Add(dIDQ.fltArg1, ptr->dIDQ_1.fltArg1), 0.5F);
+	ptr->dIDQ.fltArg2 = MLIB_Mul(MLIB_Add(dIDQ.fltArg2, ptr->dIDQ_1.fltArg2), 0.5F);
+
+	ptr->iAlBe_1	= *pIAlBe;
+	ptr->dIDQ_1		= dIDQ;
+	ptr->sinCos_2	= ptr->sinCos_1;
+	ptr->sinCos_1	= *pSinCos;
+
+	if (ptr->settleCnt > 0U)
+	{
+		// The first injection is answered two control loops after its request
+		ptr->settleCnt--;
+		ptr->phaseErr		= 0.0F;
+	}
+	else if (ptr->dIDQ.fltArg1 > POSPE_HFI_I_MIN)
+	{
+		ptr->phaseErr = MLIB_Div(ptr->dIDQ.fltArg2, MLIB_Mul(ptr->dIDQ.fltArg1, 2.0F * POSPE_HFI_SALIENCY));
+	}
+	else
+	{
+		ptr->phaseErr = 0.0F;
+	}
+
+	AMCLIB_TrackObsrv_FLT(ptr->phaseErr, &ptr->thRotEl, &ptr->wRotEl, &ptr->TrackObsrv);
+	ptr->wRotElFilt = GDFLIB_FilterMA_FLT(ptr->wRotEl, &ptr->SpeedFilter);
+
+	return (MLIB_Mul(ptr->voltage, ptr->injSign));
+}
@@ -0,0 +1,111 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pospe_hfi.h
+*
+* @date     April-04-2017
+*
+* @brief    Header file for the high frequency injection position estimator
+*
+*******************************************************************************/
+#ifndef POSPE_HFI_H_
+#define POSPE_HFI_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "gdflib.h"
+#include "gmclib.h"
+#include "amclib.h"
+#include "PMSM_apprate.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* POSPE_HFI	sensorless position below the back-EMF observer speeds
+ *		0	no injection, the position modes force, tracking and sensorless
+ *		1	position mode hfi of the manual control mode: a square wave
+ *			voltage alternating every control loop on the estimated d-axis
+ *			gives the angle from the inductive saliency, the speed loop is
+ *			closed from standstill. AutomaticMode() keeps the open loop
+ *			start-up, the injection is not selected in the automatic mode.
+ * The estimate is modulo pi, the magnet polarity comes from the alignment or
+ * POSPE_IPD and is kept by the tracking. The motor needs Ld < Lq. The current
+ * samples carry the PWM ripple of the sampling periods, it changes with the
+ * injection sign and adds to the small saliency response; a larger voltage or
+ * a low saliency motor loses the polarity. With the switching instants
+ * simulated the angle is lost at standstill and low speed, the estimate is
+ * not good enough for the unattended start. */
+#ifndef POSPE_HFI
+#define POSPE_HFI				0
+#endif
+
+#define POSPE_HFI_VOLTAGE		(1.5F)		// injected voltage [V]
+#define POSPE_HFI_SALIENCY		(0.074F)	// (Lq - Ld)/(Lq + Ld) of PMSM_appconfig.h
+#define POSPE_HFI_I_MIN			(0.1F)		// least d-axis response for a valid angle error [A]
+#define POSPE_HFI_SETTLE_CNT	3U			// control loops from the start to a valid response
+
+/* Tracking observer, critically damped at POSPE_HFI_TO_BW, the angle error
+ * is averaged over two control loops */
+#ifndef POSPE_HFI_TO_BW
+#define POSPE_HFI_TO_BW			(100.0F)	// [rad/s]
+#endif
+#define POSPE_HFI_TS			((tFloat)FOC_PERIOD_US*1.0e-6F)
+#define POSPE_HFI_TO_CC1		(2.0F*POSPE_HFI_TO_BW + 0.5F*POSPE_HFI_TO_BW*POSPE_HFI_TO_BW*POSPE_HFI_TS)
+#define POSPE_HFI_TO_CC2		(-2.0F*POSPE_HFI_TO_BW + 0.5F*POSPE_HFI_TO_BW*POSPE_HFI_TO_BW*POSPE_HFI_TS)
+#define POSPE_HFI_TO_INTEG_GAIN	(0.5F*POSPE_HFI_TS)
+
+/* Filtered speed for the hand-over to the back-EMF observer, the tracking
+ * observer speed carries the angle error noise times its proportional gain */
+#define POSPE_HFI_SPEED_FILT_TAU	(5.0e-3F)	// [s]
+#define POSPE_HFI_SPEED_FILT_LAMBDA	(POSPE_HFI_TS/POSPE_HFI_SPEED_FILT_TAU)
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  High frequency injection position estimator
+
+@details	The injected voltage changes its sign every control loop, the
+			current difference of two control loops is the response to one
+			injection step. Rotated into the estimated frame and multiplied
+			by the injection sign it gives
+				dD ~ 1 - s*cos(2*(thRotEl - thEst)), dQ ~ s*sin(2*(thRotEl - thEst))
+			with s the saliency. The mean of two control loops cancels the
+			slope of the fundamental current, it is the demodulation filter
+			with its zero at the injection frequency; dQ/(2*s*dD) is the angle
+			error in radians. The mean of two current samples is the
+			fundamental current for the current controllers, they do not
+			see the injection.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							voltage;		// injected voltage [V]
+	tFloat							injSign;		// sign of the injection request
+	tU16							settleCnt;		// control loops to a valid response
+	SWLIBS_2Syst_FLT				iAlBe_1;		// current of the last control loop [A]
+	SWLIBS_2Syst_FLT				sinCos_1;		// sine and cosine of the estimate one control loop before
+	SWLIBS_2Syst_FLT				sinCos_2;		// sine and cosine of the estimate two control loops before
+	SWLIBS_2Syst_FLT				dIDQ_1;			// demodulated response of the last control loop [A]
+	SWLIBS_2Syst_FLT				dIDQ;			// demodulated response, d: injection axis, q: quadrature [A]
+	tFloat							phaseErr;		// angle error of the estimate [rad]
+	tFloat							thRotEl;		// estimated electrical position [rad]
+	tFloat							wRotEl;			// estimated electrical speed [rad/s]
+	tFloat							wRotElFilt;		// filtered electrical speed [rad/s]
+	AMCLIB_TRACK_OBSRV_T_FLT		TrackObsrv;
+	GDFLIB_FILTER_MA_T_FLT			SpeedFilter;
+}hfiPospe_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void POSPE_HfiInit(hfiPospe_t *ptr, tFloat thRotEl, tFloat wRotEl);
+extern tFloat POSPE_HfiUpdate(hfiPospe_t *ptr, SWLIBS_2Syst_FLT *pIDQFund, const SWLIBS_2Syst_FLT *pIAlBe,
+							  const SWLIBS_2Syst_FLT *pSinCos);
+
+#endif /* POSPE_HFI_H_ */
@@ -0,0 +1,245 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pospe_ipd.c
+*
+* @date     March-28-2017
+*
+* @brief    Initial rotor position detection by inductive saliency
+*
+* @details	The current response to a short voltage pulse is inversely
+*			proportional to the inductance in the pulse direction,
+*				di(th) ~ (1/Ld + 1/Lq)/2 + (1/Ld - 1/Lq)/2*cos(2*(th - thRotEl))
+*			so the second harmonic of the responses over the electrical
+*			revolution points along the d-axis, modulo pi. The magnet
+*			polarity is resolved by two longer pulses along the axis, the
+*			stator flux adds to the magnet flux in the north direction,
+*			saturates the iron and gives the larger current.
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "pospe_ipd.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+/* Pulse sequence, the lead-in pulses in the directions of the last scan pulses
+ * settle the return gain before the scan */
+#define POSPE_IPD_LEAD_IN		2U
+#define POSPE_IPD_SCAN_END		(POSPE_IPD_LEAD_IN + POSPE_IPD_DIRS)
+#define POSPE_IPD_POL_POS		POSPE_IPD_SCAN_END
+#define POSPE_IPD_POL_NEG		(POSPE_IPD_SCAN_END + 1U)
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Sets the direction of the next pulse
+******************************************************************************/
+static void POSPE_IpdDirection(ipdPospe_t *ptr)
+{
+	tU16	dirIdx;
+	tFloat	thDir;
+
+	if (ptr->pulse >= POSPE_IPD_SCAN_END)
+	{
+		thDir = ptr->thAxis;
+		if (ptr->pulse == POSPE_IPD_POL_NEG)
+		{
+			thDir = MLIB_Add(thDir, (thDir < 0.0F) ? FLOAT_PI : -FLOAT_PI);
+		}
+	}
+	else
+	{
+		dirIdx = (ptr->pulse + POSPE_IPD_DIRS - POSPE_IPD_LEAD_IN) % POSPE_IPD_DIRS;
+		thDir  = MLIB_Sub(MLIB_Mul((tFloat)dirIdx, 2.0F * FLOAT_PI / (tFloat)POSPE_IPD_DIRS), FLOAT_PI);
+	}
+
+	GFLIB_SinCos_FLT(thDir, &ptr->dir, GFLIB_SINCOS_DEFAULT_FLT);
+}
+
+/**************************************************************************//*!
+@brief			Evaluates the scan, d-axis modulo pi and the saliency
+
+@return			false when the motor shows no current or no saliency
+******************************************************************************/
+static tBool POSPE_IpdAxis(ipdPospe_t *ptr)
+{
+	tFloat	amp2;
+
+	amp2			= GFLIB_Sqrt(MLIB_Add(MLIB_Mul(ptr->sum2.fltArg1, ptr->sum2.fltArg1),
+										  MLIB_Mul(ptr->sum2.fltArg2, ptr->sum2.fltArg2)));
+	ptr->thAxis		= MLIB_Mul(0.5F, GFLIB_AtanYX(ptr->sum2.fltArg1, ptr->sum2.fltArg2));
+	ptr->saliency	= (ptr->sum0 > 0.0F) ? MLIB_Div(amp2, ptr->sum0) : 0.0F;
+
+	return ((ptr->sum0 >= (POSPE_IPD_I_MIN * (tFloat)POSPE_IPD_DIRS)) && (ptr->saliency >= POSPE_IPD_SALIENCY_MIN));
+}
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Restarts the detection, the pulse parameters are kept
+
+@param[out]		ptr		Detection structure
+******************************************************************************/
+void POSPE_IpdInit(ipdPospe_t *ptr)
+{
+	ptr->pulse			= 0U;
+	ptr->step			= 0U;
+	ptr->iPre			= 0.0F;
+	ptr->iResp			= 0.0F;
+	ptr->retGain		= 1.0F;
+	ptr->sum0			= 0.0F;
+	ptr->sum2.fltArg1	= 0.0F;
+	ptr->sum2.fltArg2	= 0.0F;
+	ptr->iPolPos		= 0.0F;
+	ptr->iPolNeg		= 0.0F;
+	ptr->thAxis			= 0.0F;
+	ptr->saliency		= 0.0F;
+	ptr->polarity		= 0.0F;
+	ptr->thRotEl		= 0.0F;
+	ptr->status			= ipdBusy;
+}
+
+/**************************************************************************//*!
+@brief			One control loop of the detection
+
+@param[in,out]	ptr		Detection structure
+@param[out]		pUAlBe	Alpha/beta voltage request for the next control loop [V]
+@param[in]		pIAlBe	Alpha/beta current of this control loop [A]
+
+@return			ipdBusy during the pulses, ipdDone with thRotEl valid or
+				ipdFailed, the voltage request is zero then
+
+@details		The voltage requested in a control loop is applied in the next
+				one and the current is sampled in the first two PWM periods of
+				the one after, a pulse of n control loops takes 2n + 1 control
+				loops plus the rest.
+******************************************************************************/
+ipdStatus_t POSPE_IpdUpdate(ipdPospe_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe)
+{
+	tU16	pulseLen, restLen;
+	tFloat	iDir, uDir;
+
+	pUAlBe->fltArg1 = 0.0F;
+	pUAlBe->fltArg2 = 0.0F;
+
+	if (ptr->status != ipdBusy)
+	{
+		return (ptr->status);
+	}
+
+	if (ptr->pulse >= POSPE_IPD_SCAN_END)
+	{
+		pulseLen	= ptr->polPulseCnt;
+		restLen		= ptr->polRestCnt;
+	}
+	else
+	{
+		pulseLen	= ptr->pulseCnt;
+		restLen		= POSPE_IPD_REST_CNT;
+	}
+
+	if (ptr->step == 0U)
+	{
+		if (ptr->pulse > 0U)
+		{
+			// Current left by the last pulse, the return gain is corrected for the next one
+			iDir			= MLIB_Add(MLIB_Mul(pIAlBe->fltArg1, ptr->dir.fltArg2), MLIB_Mul(pIAlBe->fltArg2, ptr->dir.fltArg1));
+			ptr->retGain	= MLIB_Add(ptr->retGain, MLIB_Div(iDir, ptr->iResp));
+			if (ptr->retGain > 1.0F)					ptr->retGain = 1.0F;
+			if (ptr->retGain < POSPE_IPD_RET_GAIN_MIN)	ptr->retGain = POSPE_IPD_RET_GAIN_MIN;
+		}
+		if ((ptr->pulse == POSPE_IPD_POL_POS) && !POSPE_IpdAxis(ptr))
+		{
+			ptr->status = ipdFailed;
+			return (ptr->status);
+		}
+		POSPE_IpdDirection(ptr);
+	}
+
+	// Current in the pulse direction, taken in zero voltage PWM periods only
+	iDir = MLIB_Add(MLIB_Mul(pIAlBe->fltArg1, ptr->dir.fltArg2), MLIB_Mul(pIAlBe->fltArg2, ptr->dir.fltArg1));
+
+	if (ptr->step == 0U)
+	{
+		ptr->iPre = iDir;
+	}
+	else if (ptr->step == (pulseLen + 1U))
+	{
+		ptr->iResp = MLIB_Sub(iDir, ptr->iPre);
+
+		if (ptr->pulse == POSPE_IPD_POL_POS)
+		{
+			ptr->iPolPos = ptr->iResp;
+		}
+		else if (ptr->pulse == POSPE_IPD_POL_NEG)
+		{
+			ptr->iPolNeg = ptr->iResp;
+		}
+		else if (ptr->pulse >= POSPE_IPD_LEAD_IN)
+		{
+			// cos(2th) = cos^2 - sin^2, sin(2th) = 2*sin*cos
+			ptr->sum0			= MLIB_Add(ptr->sum0, ptr->iResp);
+			ptr->sum2.fltArg1	= MLIB_Add(ptr->sum2.fltArg1, MLIB_Mul(ptr->iResp,
+								  MLIB_Mul(2.0F, MLIB_Mul(ptr->dir.fltArg1, ptr->dir.fltArg2))));
+			ptr->sum2.fltArg2	= MLIB_Add(ptr->sum2.fltArg2, MLIB_Mul(ptr->iResp,
+								  MLIB_Sub(MLIB_Mul(ptr->dir.fltArg2, ptr->dir.fltArg2), MLIB_Mul(ptr->dir.fltArg1, ptr->dir.fltArg1))));
+		}
+	}
+
+	// Pulse, zero voltage for the peak sample, back by the return gain, rest
+	if (ptr->step < pulseLen)
+	{
+		uDir = ptr->pulseVoltage;
+	}
+	else if ((ptr->step > pulseLen) && (ptr->step <= (2U * pulseLen)))
+	{
+		uDir = MLIB_Neg(MLIB_Mul(ptr->pulseVoltage, ptr->retGain));
+	}
+	else
+	{
+		uDir = 0.0F;
+	}
+	pUAlBe->fltArg1 = MLIB_Mul(uDir, ptr->dir.fltArg2);
+	pUAlBe->fltArg2 = MLIB_Mul(uDir, ptr->dir.fltArg1);
+
+	if (++ptr->step >= ((2U * pulseLen) + 1U + restLen))
+	{
+		ptr->step = 0U;
+
+		if (ptr->pulse == POSPE_IPD_POL_NEG)
+		{
+			ptr->polarity = MLIB_Div(MLIB_Sub(ptr->iPolPos, ptr->iPolNeg), MLIB_Add(ptr->iPolPos, ptr->iPolNeg));
+
+			if (MLIB_Abs(ptr->polarity) < POSPE_IPD_POLARITY_MIN)
+			{
+				ptr->status = ipdFailed;
+			}
+			else
+			{
+				ptr->thRotEl = ptr->thAxis;
+				if (ptr->polarity < 0.0F)
+				{
+					ptr->thRotEl = MLIB_Add(ptr->thRotEl, (ptr->thRotEl < 0.0F) ? FLOAT_PI : -FLOAT_PI);
+				}
+				ptr->status = ipdDone;
+			}
+		}
+		else
+		{
+			ptr->pulse++;
+		}
+	}
+
+	return (ptr->status);
+}
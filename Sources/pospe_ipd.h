@@ -0,0 +1,101 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     pospe_ipd.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for the initial rotor position detection
+*
+*******************************************************************************/
+#ifndef POSPE_IPD_H_
+#define POSPE_IPD_H_
+
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "gflib.h"
+#include "gmclib.h"
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* POSPE_IPD	start-up position
+ *		0	StateAlign holds ALIGN_VOLTAGE on the d-axis for ALIGN_DURATION
+ *		1	StateAlign detects the rotor position by voltage pulses (13ms),
+ *			seeds the open loop and the tracking observer with it and falls back
+ *			to the alignment when the motor shows no saliency or polarity
+ * The detection needs a salient motor (Ld < Lq) at standstill, the polarity is
+ * taken from the saturation of the d-axis by the stator current. */
+#ifndef POSPE_IPD
+#define POSPE_IPD				0
+#endif
+
+#define POSPE_IPD_DIRS			12U			// scan directions over the electrical revolution
+#define POSPE_IPD_VOLTAGE		(5.0F)		// pulse voltage [V]
+#define POSPE_IPD_PULSE_CNT		1			// scan pulse length [MCAT control loops]
+#define POSPE_IPD_POL_PULSE_CNT	2			// polarity pulse length [MCAT control loops]
+#define POSPE_IPD_REST_CNT		1U			// zero voltage after each scan pulse [control loops]
+#define POSPE_IPD_POL_REST_CNT	10			// zero voltage after each polarity pulse [MCAT control loops]
+#define POSPE_IPD_RET_GAIN_MIN	(0.25F)		// least return to pulse volt-seconds
+#define POSPE_IPD_I_MIN			(0.3F)		// least mean scan response [A]
+#define POSPE_IPD_SALIENCY_MIN	(0.01F)		// least second harmonic to mean of the scan
+#define POSPE_IPD_POLARITY_MIN	(0.01F)	// least polarity pulse difference to sum
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+typedef enum
+{
+	ipdBusy			= 0,
+	ipdDone			= 1,
+	ipdFailed		= 2
+}ipdStatus_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Initial position detection
+
+@details	Each pulse applies pulseVoltage in its direction, zero voltage,
+			retGain of the volt-seconds back and zero voltage again. retGain
+			is corrected by the current left after every pulse, it covers
+			the decay by the resistance and the dead time. The current is
+			taken just before the pulse and after it, both samples fall into
+			zero voltage PWM periods, so the single-shunt reconstruction sees
+			no current slope. POSPE_IPD_DIRS scan pulses give the d-axis from
+			the second harmonic of the response, two longer pulses along it
+			the magnet polarity.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tFloat							pulseVoltage;	// pulse voltage [V]
+	tU16							pulseCnt;		// scan pulse length [control loops]
+	tU16							polPulseCnt;	// polarity pulse length [control loops]
+	tU16							polRestCnt;		// zero voltage after a polarity pulse [control loops]
+	tU16							pulse;			// running pulse, lead-in, scan, polarity
+	tU16							step;			// control loop within the pulse
+	SWLIBS_2Syst_FLT				dir;			// cos/sin of the pulse direction
+	tFloat							iPre;			// current before the pulse [A]
+	tFloat							iResp;			// response of the last pulse [A]
+	tFloat							retGain;		// return to pulse volt-seconds
+	tFloat							sum0;			// mean of the scan
+	SWLIBS_2Syst_FLT				sum2;			// second harmonic of the scan
+	tFloat							iPolPos;		// response along the d-axis [A]
+	tFloat							iPolNeg;		// response against the d-axis [A]
+	tFloat							thAxis;			// d-axis, polarity unknown [rad]
+	tFloat							saliency;		// second harmonic to mean of the scan
+	tFloat							polarity;		// polarity pulse difference to sum
+	tFloat							thRotEl;		// detected electrical position [rad]
+	ipdStatus_t						status;
+}ipdPospe_t;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void POSPE_IpdInit(ipdPospe_t *ptr);
+extern ipdStatus_t POSPE_IpdUpdate(ipdPospe_t *ptr, SWLIBS_2Syst_FLT *pUAlBe, const SWLIBS_2Syst_FLT *pIAlBe);
+
+#endif /* POSPE_IPD_H_ */
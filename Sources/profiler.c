@@ -0,0 +1,145 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     profiler.c
+*
+* @date     March-28-2017
+*
+* @brief    Execution time profiler of the fast control loop
+*
+*******************************************************************************/
+/******************************************************************************
+| Includes
+-----------------------------------------------------------------------------*/
+#include "profiler.h"
+#include "clock_manager.h"
+
+/******************************************************************************
+| External declarations
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Defines and macros            (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Global variable definitions   (scope: module-exported)
+-----------------------------------------------------------------------------*/
+profiler_t profiler;
+
+/******************************************************************************
+| Global variable definitions   (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Function prototypes           (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Function implementations      (scope: module-local)
+-----------------------------------------------------------------------------*/
+
+/******************************************************************************
+| Function implementations      (scope: module-exported)
+-----------------------------------------------------------------------------*/
+
+/**************************************************************************//*!
+@brief			Starts the cycle counter and clears the statistics
+
+@details		DWT CYCCNT runs at the core clock (80MHz). On the host the time
+				base is CLOCK_MONOTONIC in ns.
+******************************************************************************/
+void PROF_Init(void)
+{
+#if defined(__arm__)
+	tU32 freq = 0U;
+
+	PROF_DEMCR		|= PROF_DEMCR_TRCENA;
+	PROF_DWT_CYCCNT	 = 0U;
+	PROF_DWT_CTRL	|= PROF_DWT_CYCCNTENA;
+
+	CLOCK_SYS_GetFreq(CORE_CLK, &freq);
+	profiler.tickFreq = freq;
+#else
+	profiler.tickFreq = 1000000000UL;
+#endif
+
+	PROF_Clear(FALSE);
+	PROF_Clear(TRUE);
+	profiler.reset			= FALSE;
+	profiler.resetDeferred	= FALSE;
+}
+
+/**************************************************************************//*!
+@brief			Clears the statistics of the stages of one interrupt
+
+@param[in]		deferred	FALSE the ADC1_IRQHandler stages, TRUE the
+							SWI_IRQHandler ones
+
+@details		To be called from the interrupt that records the stages.
+******************************************************************************/
+void PROF_Clear(tBool deferred)
+{
+	tU32 i, j;
+
+	for (i = 0U; i < (tU32)PROF_STAGE_CNT; i++)
+	{
+		if ((tBool)PROF_IS_DEFERRED(i) != deferred)
+		{
+			continue;
+		}
+		profiler.stage[i].last	= 0U;
+		profiler.stage[i].min	= 0xFFFFFFFFUL;
+		profiler.stage[i].max	= 0U;
+		profiler.stage[i].mean	= 0U;
+		profiler.stage[i].count	= 0U;
+		profiler.stage[i].sum	= 0U;
+
+		for (j = 0U; j < PROF_HIST_BINS; j++)
+		{
+			profiler.stage[i].hist[j] = 0U;
+		}
+	}
+}
+
+/**************************************************************************//*!
+@brief			Adds one stage duration to the statistics
+
+@param[in]		stage	Profiled stage
+@param[in]		ticks	Stage duration in ticks
+
+@details		The mean needs a 64-bit division, it is refreshed once per
+				PROF_MEAN_PERIOD samples only.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+void PROF_Record(profStage_t stage, tU32 ticks)
+{
+	profStageStats_t	*ptr = &profiler.stage[stage];
+	tU32				bin;
+
+	ptr->last = ticks;
+	if (ticks < ptr->min)	ptr->min = ticks;
+	if (ticks > ptr->max)	ptr->max = ticks;
+
+	ptr->sum += ticks;
+	ptr->count++;
+	if ((ptr->count & (PROF_MEAN_PERIOD - 1U)) == 0U)
+	{
+		ptr->mean = (tU32)(ptr->sum / ptr->count);
+	}
+
+	bin = (ticks == 0U) ? 0U : (32U - (tU32)__builtin_clz(ticks));
+	if (bin >= PROF_HIST_BINS)
+	{
+		bin = PROF_HIST_BINS - 1U;
+	}
+	ptr->hist[bin]++;
+}
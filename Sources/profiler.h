@@ -0,0 +1,175 @@
+/*******************************************************************************
+*
+* Copyright 2006-2015 Freescale Semiconductor, Inc.
+* Copyright 2016-2017 NXP
+*
+****************************************************************************//*!
+*
+* @file     profiler.h
+*
+* @date     March-28-2017
+*
+* @brief    Header file for execution time profiler module
+*
+*******************************************************************************/
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "gflib.h"
+#if !defined(__arm__)
+#include <time.h>
+#endif
+
+/******************************************************************************
+| Defines and macros            (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/* PROF_ENABLE 1	Stage execution times of ADC1_IRQHandler are collected
+ * PROF_ENABLE 0	Profiler calls compile to nothing, the production build */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE			0
+#endif
+
+#define PROF_HIST_BINS		16U		// bin n counts durations within <2^(n-1);2^n) ticks
+#define PROF_MEAN_PERIOD	64U		// samples between mean updates, power of two
+
+/* Stages recorded in SWI_IRQHandler, see profStage_t */
+#define PROF_IS_DEFERRED(stage)	(((stage) >= PROF_STATE_LED) && ((stage) <= PROF_DEFERRED))
+
+/* Cortex-M4 data watchpoint and trace unit, not covered by the device header */
+#define PROF_DEMCR			(*(volatile tU32 *)0xE000EDFCU)
+#define PROF_DEMCR_TRCENA	(1UL << 24)
+#define PROF_DWT_CTRL		(*(volatile tU32 *)0xE0001000U)
+#define PROF_DWT_CYCCNTENA	(1UL << 0)
+#define PROF_DWT_CYCCNT		(*(volatile tU32 *)0xE0001004U)
+
+#if PROF_ENABLE
+#define PROF_BEGIN(stamp)		((stamp) = PROF_Now())
+#define PROF_END(stage, stamp)	PROF_Record((stage), PROF_Now() - (stamp))
+#define PROF_VALUE(stage, value)	PROF_Record((stage), (value))
+#else
+#define PROF_BEGIN(stamp)		((void)(stamp))
+#define PROF_END(stage, stamp)	((void)(stamp))
+#define PROF_VALUE(stage, value)	((void)(value))
+#endif
+
+/******************************************************************************
+| Typedefs and structures       (scope: module-exported)
+-----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//*!
+@brief  Profiled stages of the fast control loop
+
+@details	Stages called from the state machine (observers, FOC loops and
+			duty cycle update) are nested in PROF_STATE_TABLE, PROF_ISR_TOTAL
+			covers the whole ADC1_IRQHandler. The LED and recorder stages are
+			nested in PROF_DEFERRED, the low priority SWI_IRQHandler.
+			PROF_PWM_SHIFT is not a time, it collects the phase shift of
+			every duty cycle update in FTM counts. The deferred stages are
+			written by SWI_IRQHandler only, all others by ADC1_IRQHandler.
+*//*-------------------------------------------------------------------------*/
+typedef enum
+{
+	PROF_ISR_TOTAL			= 0,
+	PROF_MEAS_SAVE			= 1,	// MEAS_SaveAdcRawResult
+	PROF_MEAS_GET			= 2,	// MEAS_Get3PhCurrent, MEAS_GetIdcCurrent, MEAS_GetUdcVoltage
+	PROF_FAULT_DETECTION	= 3,
+	PROF_STATE_TABLE		= 4,	// StateTable dispatch
+	PROF_OBSERVERS			= 5,	// back-EMF and tracking observers
+	PROF_FOC_FAST			= 6,	// FocFastLoop
+	PROF_FOC_SLOW			= 7,	// FocSlowLoop
+	PROF_SET_DUTYCYCLE		= 8,	// ACTUATE_SetDutycycle
+	PROF_STATE_LED			= 9,	// in SWI_IRQHandler
+	PROF_RECORDER			= 10,	// FMSTR_Recorder, in SWI_IRQHandler
+	PROF_DEFERRED			= 11,	// SWI_IRQHandler, deferred work of ADC1_IRQHandler
+	PROF_PWM_SHIFT			= 12,	// actuatePwm_t phaseShiftCnt, FTM counts
+	PROF_STAGE_CNT			= 13
+}profStage_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Execution time statistics of one stage, all times in ticks
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	tU32	last;					// last measured duration
+	tU32	min;					// shortest duration
+	tU32	max;					// longest duration
+	tU32	mean;					// sum/count, refreshed every PROF_MEAN_PERIOD samples
+	tU32	count;					// number of samples
+	tU64	sum;					// sum of all durations
+	tU32	hist[PROF_HIST_BINS];	// log2 histogram of the durations
+}profStageStats_t;
+
+/*------------------------------------------------------------------------*//*!
+@brief  Profiler module structure
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	profStageStats_t	stage[PROF_STAGE_CNT];
+	tU32				tickFreq;		// ticks per second, core clock on target, 1e9 on host
+	tBool				reset;			// set to clear all statistics, ADC1_IRQHandler clears its stages at its end
+	tBool				resetDeferred;	// set by that clear, SWI_IRQHandler clears its stages at its end
+}profiler_t;
+
+/******************************************************************************
+| Exported Variables
+-----------------------------------------------------------------------------*/
+extern profiler_t profiler;
+
+/******************************************************************************
+| Exported function prototypes
+-----------------------------------------------------------------------------*/
+extern void PROF_Init(void);
+extern void PROF_Clear(tBool deferred);
+extern void PROF_Record(profStage_t stage, tU32 ticks);
+
+/******************************************************************************
+| Inline functions
+-----------------------------------------------------------------------------*/
+/**************************************************************************//*!
+@brief			Actual time stamp, core clock cycles on target, ns on host
+******************************************************************************/
+static inline tU32 PROF_Now(void)
+{
+#if defined(__arm__)
+	return (PROF_DWT_CYCCNT);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((tU32)((tU64)ts.tv_sec * 1000000000ULL + (tU64)ts.tv_nsec));
+#endif
+}
+
+/**************************************************************************//*!
+@brief			Clears the ADC1_IRQHandler stages when requested from FreeMASTER
+
+@details		Each interrupt clears only the stages it records itself, a clear
+				never meets a half written update of the other one. The
+				deferred stages follow at the end of the next SWI_IRQHandler.
+******************************************************************************/
+static inline void PROF_CheckReset(void)
+{
+#if PROF_ENABLE
+	if (profiler.reset)
+	{
+		PROF_Clear(FALSE);
+		profiler.reset			= FALSE;
+		profiler.resetDeferred	= TRUE;
+	}
+#endif
+}
+
+/**************************************************************************//*!
+@brief			Clears the SWI_IRQHandler stages after PROF_CheckReset()
+******************************************************************************/
+static inline void PROF_CheckResetDeferred(void)
+{
+#if PROF_ENABLE
+	if (profiler.resetDeferred)
+	{
+		PROF_Clear(TRUE);
+		profiler.resetDeferred	= FALSE;
+	}
+#endif
+}
+
+#endif /* _PROFILER_H_ */
@@ -16,26 +16,29 @@
 * Includes
 ******************************************************************************/
 #include "state_machine.h"
-
-/******************************************************************************
-| External declarations
------------------------------------------------------------------------------*/
+#include "motor_structure.h"
 
 /******************************************************************************
 | Defines and macros            (scope: module-local)
 -----------------------------------------------------------------------------*/
+#define SM_QUEUE_MASK		(SM_EVENT_QUEUE_SIZE - 1U)
+#define SM_SEQ_MASK			0x00FFFFFFUL		// sequence number in bits 31..8 of a slot
+#define SM_SLOT(seq, event)	((((seq) & SM_SEQ_MASK) << 8) | (tU32)(event))
 
 /******************************************************************************
 | Typedefs and structures       (scope: module-local)
 -----------------------------------------------------------------------------*/
 
-/******************************************************************************
-| Global variable definitions   (scope: module-exported)
------------------------------------------------------------------------------*/
-
 /******************************************************************************
 | Global variable definitions   (scope: module-local)
 -----------------------------------------------------------------------------*/
+/* Dispatch order of the pending events, highest priority first */
+static const AppEvents smEventOrder[SM_EVENT_CNT] =
+{
+	e_fault, e_fault_clear, e_app_off, e_app_on, e_init, e_init_done,
+	e_ready, e_calib, e_calib_done, e_ident, e_ident_done, e_align,
+	e_align_done, e_run
+};
 
 /******************************************************************************
 | Function prototypes           (scope: module-local)
@@ -50,24 +53,153 @@
 | Function implementations      (scope: module-exported)
 -----------------------------------------------------------------------------*/
 
+/**************************************************************************//*!
+@brief			Clears the event queue, every slot gets its sequence number
+
+@param[out]		queue	Event queue of an axis
+******************************************************************************/
+void SM_Init(smEventQueue_t *queue)
+{
+	tU32 i;
+
+	for (i = 0U; i < SM_EVENT_QUEUE_SIZE; i++)
+	{
+		queue->slot[i] = SM_SLOT(i, 0U);
+	}
+	queue->head			= 0U;
+	queue->tail			= 0U;
+	queue->pending		= 0U;
+	queue->highWater	= 0U;
+	queue->dropped		= 0U;
+}
+
+/**************************************************************************//*!
+@brief			Posts an event to the state machine
+
+@param[in,out]	queue	Event queue of the axis
+@param[in]		event	Application event
+
+@return			false when the queue is full and the event is dropped
+
+@details		Safe from any context. A slot is reserved by compare and swap
+				of head, so a preempting producer takes the next slot, and
+				published by a single store of its next sequence number.
+				The slot is free when its sequence number equals head, it is
+				still occupied by an undrained event one round ago when the
+				sequence number is behind.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+tBool SM_PostEvent(smEventQueue_t *queue, AppEvents event)
+{
+	tU32 head = queue->head;
+	tS32 diff;
+
+	for (;;)
+	{
+		diff = (tS32)(((queue->slot[head & SM_QUEUE_MASK] >> 8) - head) << 8);
+
+		if (diff < 0)
+		{
+			__atomic_fetch_add(&queue->dropped, 1U, __ATOMIC_RELAXED);
+			return (false);
+		}
+		if ((diff == 0) &&
+			__atomic_compare_exchange_n(&queue->head, &head, head + 1U, false,
+										__ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+		if (diff > 0)
+		{
+			// another producer took and published the slot, retry with the actual head
+			head = queue->head;
+		}
+	}
+
+	__atomic_store_n(&queue->slot[head & SM_QUEUE_MASK], SM_SLOT(head + 1U, event), __ATOMIC_RELEASE);
+
+	return (true);
+}
+
+/**************************************************************************//*!
+@brief			Runs the state machine of an axis once
+
+@param[in,out]	axis	Drive context, its event queue and state
+
+@details		The single consumer, called once per control loop. Drains the
+				published events (at most SM_EVENT_QUEUE_SIZE) into the pending
+				mask, the later one of app on and app off wins. The highest
+				priority pending event replaces the event the actual state
+				requested for itself; e_fault cancels all other pending
+				events. Exactly one state function is called.
+******************************************************************************/
+__attribute__((section (".code_ram")))		// inserting function to the RAM section
+void SM_Dispatch(pmsmAxis_t *axis)
+{
+	smEventQueue_t	*queue = &axis->smEventQueue;
+	tU32			tail = queue->tail;
+	tU32			slot, used, i;
+	AppEvents		event;
+
+	used = queue->head - tail;
+	if (used > queue->highWater)
+	{
+		queue->highWater = used;
+	}
+
+	for (i = 0U; i < SM_EVENT_QUEUE_SIZE; i++)
+	{
+		slot = __atomic_load_n(&queue->slot[tail & SM_QUEUE_MASK], __ATOMIC_ACQUIRE);
+		if ((slot >> 8) != ((tail + 1U) & SM_SEQ_MASK))
+		{
+			break;		// empty, or the next slot is reserved but not published yet
+		}
+
+		event = (AppEvents)(slot & 0xFFU);
+		if (event == e_app_on)	queue->pending &= ~(1UL << e_app_off);
+		if (event == e_app_off)	queue->pending &= ~(1UL << e_app_on);
+		queue->pending |= (1UL << event);
+
+		__atomic_store_n(&queue->slot[tail & SM_QUEUE_MASK], SM_SLOT(tail + SM_EVENT_QUEUE_SIZE, 0U),
+						 __ATOMIC_RELEASE);
+		tail++;
+	}
+	queue->tail = tail;
+
+	for (i = 0U; i < SM_EVENT_CNT; i++)
+	{
+		event = smEventOrder[i];
+		if (queue->pending & (1UL << event))
+		{
+			queue->pending = (event == e_fault) ? 0U : (queue->pending & ~(1UL << event));
+			axis->cntrState.event = event;
+			break;
+		}
+	}
+
+	StateTable[axis->cntrState.event][axis->cntrState.state](axis);
+}
+
 
-PFCN_VOID_STATES StateTable[12][6]={
-    /* Actual State ->         'Init'           'Fault'         'Ready'         'Calib'         'Align'         'Run'*/
-    /* e_fault          */ { StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
-    /* e_fault_clear    */ { StateFault,     StateInit,      StateFault,     StateFault,     StateFault,     StateFault},
-    /* e_init          	*/ { StateInit,      StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
-    /* e_init_done      */ { StateReady,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
-    /* e_ready          */ { StateFault,     StateFault,     StateReady,     StateFault,     StateFault,     StateFault},
-    /* e_app_on         */ { StateFault,     StateFault,     StateCalib,     StateFault,     StateFault,     StateFault},
-    /* e_calib          */ { StateFault,     StateFault,     StateFault,     StateCalib,     StateFault,     StateFault},
-    /* e_calib_done     */ { StateFault,     StateFault,     StateFault,     StateAlign,     StateFault,     StateFault},
-    /* e_align          */ { StateFault,     StateFault,     StateFault,     StateFault,     StateAlign,     StateFault},
-    /* e_align_done     */ { StateFault,     StateFault,     StateFault,     StateFault,     StateRun,       StateFault},
-    /* e_run            */ { StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateRun},
-    /* e_app_off        */ { StateFault,     StateFault,     StateReady,     StateInit,      StateInit,      StateInit}
+PFCN_VOID_STATES StateTable[14][7]={
+    /* Actual State ->         'Init'           'Fault'         'Ready'         'Calib'         'Align'         'Run'           'Ident'*/
+    /* e_fault          */ { StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_fault_clear    */ { StateFault,     StateInit,      StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_init          	*/ { StateInit,      StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_init_done      */ { StateReady,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_ready          */ { StateFault,     StateFault,     StateReady,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_app_on         */ { StateFault,     StateFault,     StateCalib,     StateFault,     StateFault,     StateFault,     StateFault},
+    /* e_calib          */ { StateFault,     StateFault,     StateFault,     StateCalib,     StateFault,     StateFault,     StateFault},
+    /* e_calib_done     */ { StateFault,     StateFault,     StateFault,     StateAlign,     StateFault,     StateFault,     StateFault},
+    /* e_align          */ { StateFault,     StateFault,     StateFault,     StateFault,     StateAlign,     StateFault,     StateFault},
+    /* e_align_done     */ { StateFault,     StateFault,     StateFault,     StateFault,     StateRun,       StateFault,     StateFault},
+    /* e_run            */ { StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateRun,       StateFault},
+    /* e_app_off        */ { StateFault,     StateFault,     StateReady,     StateInit,      StateInit,      StateInit,      StateInit},
+    /* e_ident          */ { StateFault,     StateFault,     StateFault,     StateIdent,     StateFault,     StateFault,     StateIdent},
+    /* e_ident_done     */ { StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateFault,     StateAlign}
 };
 
 
 
-/* Actual State ->         				'Init'			'Fault'			   'Ready'         			'Calib'					'Align'	         		'Run'*/
-PFCN_VOID_LED StateLED[6] = {StateRGBLedOFF, StateRGBLedRedON, StateRGBLedGreenON, StateRGBLedGreenFlashing, StateRGBLedGreenFlashing, StateRGBLedBlueON};
+/* Actual State ->         				'Init'			'Fault'			   'Ready'         			'Calib'					'Align'	         		'Run'				'Ident'*/
+PFCN_VOID_LED StateLED[7] = {StateRGBLedOFF, StateRGBLedRedON, StateRGBLedGreenON, StateRGBLedGreenFlashing, StateRGBLedGreenFlashing, StateRGBLedBlueON, StateRGBLedGreenFlashing};
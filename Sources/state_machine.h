@@ -18,6 +18,7 @@
 /******************************************************************************
 * Includes
 ******************************************************************************/
+#include "gflib.h"
 
 
 /******************************************************************************
@@ -34,6 +35,9 @@
 #define false ((tBool)0)
 #endif
 
+#define SM_EVENT_QUEUE_SIZE		8U			// posted events, power of two
+#define SM_EVENT_CNT			14U			// number of AppEvents
+
 
 typedef enum {
     init            = 0,
@@ -41,7 +45,8 @@ typedef enum {
     ready           = 2,
     calib           = 3,
     align           = 4,
-    run             = 5
+    run             = 5,
+    ident           = 6
 }AppStates;         /* Application state identification user type*/
 
 typedef enum {
@@ -56,28 +61,57 @@ typedef enum {
     e_align         = 8,
     e_align_done    = 9,
     e_run           = 10,
-    e_app_off       = 11
+    e_app_off       = 11,
+    e_ident         = 12,
+    e_ident_done    = 13
 }AppEvents;         /* Application event identification user type*/
 
-typedef void (*PFCN_VOID_STATES)(); /* pointer to function */
-typedef void (*PFCN_VOID_LED)(); /* pointer to function*/
+/*------------------------------------------------------------------------*//*!
+@brief  Bounded lock-free multi-producer event queue of the state machine
+
+@details	One queue per axis. Any context posts with SM_PostEvent(), the
+			control loop of the axis (or the background loop with the control
+			loop stopped) is the single consumer in SM_Dispatch(). Every slot holds its sequence number
+			in bits 31..8 and the event in bits 7..0, one store publishes
+			an event. Drained events wait in the pending mask until they are
+			dispatched, the highest priority first.
+*//*-------------------------------------------------------------------------*/
+typedef struct
+{
+	volatile tU32	slot[SM_EVENT_QUEUE_SIZE];
+	volatile tU32	head;			// next slot to reserve, producers
+	volatile tU32	tail;			// next slot to drain, consumer
+	tU32			pending;		// drained events not dispatched yet, bit per event
+	tU32			highWater;		// maximum number of queued events
+	volatile tU32	dropped;		// events lost on a full queue
+}smEventQueue_t;
+
+struct pmsmAxis_s;	/* drive context of one axis, see motor_structure.h */
+
+typedef void (*PFCN_VOID_STATES)(struct pmsmAxis_s *axis); /* pointer to function */
+typedef void (*PFCN_VOID_LED)(struct pmsmAxis_s *axis); /* pointer to function*/
+
+extern PFCN_VOID_STATES StateTable[14][7];
+extern PFCN_VOID_LED StateLED[7];
 
-extern PFCN_VOID_STATES StateTable[12][6];
-extern PFCN_VOID_LED StateLED[6];
+extern void SM_Init(smEventQueue_t *queue);
+extern tBool SM_PostEvent(smEventQueue_t *queue, AppEvents event);
+extern void SM_Dispatch(struct pmsmAxis_s *axis);
 
-extern void StateFault();
-extern void StateInit();
-extern void StateReady();
-extern void StateCalib();
-extern void StateAlign();
-extern void StateRun();
+extern void StateFault(struct pmsmAxis_s *axis);
+extern void StateInit(struct pmsmAxis_s *axis);
+extern void StateReady(struct pmsmAxis_s *axis);
+extern void StateCalib(struct pmsmAxis_s *axis);
+extern void StateAlign(struct pmsmAxis_s *axis);
+extern void StateRun(struct pmsmAxis_s *axis);
+extern void StateIdent(struct pmsmAxis_s *axis);
 
 /* LED application control*/
-extern void StateRGBLedOFF();
-extern void StateRGBLedBlueON();
-extern void StateRGBLedRedON();
-extern void StateRGBLedGreenON();
-extern void StateRGBLedGreenFlashing();
-extern void BoardButtons();
+extern void StateRGBLedOFF(struct pmsmAxis_s *axis);
+extern void StateRGBLedBlueON(struct pmsmAxis_s *axis);
+extern void StateRGBLedRedON(struct pmsmAxis_s *axis);
+extern void StateRGBLedGreenON(struct pmsmAxis_s *axis);
+extern void StateRGBLedGreenFlashing(struct pmsmAxis_s *axis);
+extern void BoardButtons(struct pmsmAxis_s *axis);
 
 #endif //_STATE_MACHINE_FRAME_H
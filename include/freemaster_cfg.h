@@ -97,7 +97,9 @@
 #define FMSTR_REC_BUFF_SIZE    2048   /* Built-in buffer size */
 
 /* Recorder time base, specifies how often the recorder is called in the user app. */
-#define FMSTR_REC_TIMEBASE     FMSTR_REC_BASE_MICROSEC(100) /* 0 = "unknown" */
+/* The recorder is called from ADC1 ISR once per control loop, see PMSM_apprate.h */
+#include "PMSM_apprate.h"
+#define FMSTR_REC_TIMEBASE     FMSTR_REC_BASE_MICROSEC(FOC_PERIOD_US) /* 0 = "unknown" */
 
 #define FMSTR_REC_FLOAT_TRIG   1    /* Enable/disable floating point triggering */
 